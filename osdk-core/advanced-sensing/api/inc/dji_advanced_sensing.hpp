@@ -95,6 +95,18 @@ public:
     RECV_FRONT_DEPTH  = 15,
   };
 
+  /*! @brief Callback receiving 240p and VGA stereo frames whose images
+   *  point into the USB receive buffer. Hold the frame to keep them.
+   */
+  typedef void (*StereoFrameCallBack)(Vehicle* vehiclePtr, StereoFramePtr frame,
+                                      UserData userData);
+
+  typedef struct StereoFrameCallBackHandler
+  {
+    StereoFrameCallBack callback;
+    UserData            userData;
+  } StereoFrameCallBackHandler;
+
 public:
   AdvancedSensing(Vehicle* vehiclePtr);
 
@@ -145,6 +157,18 @@ public:
    *  @platforms M210V2, M300
    */
   void unsubscribeVGAImages();
+  /*! @brief Receive the subscribed stereo frames without copies
+   *
+   *  @details Called from the USB read thread next to the VehicleCallBack
+   *  of the subscription. Images are only copied into the RecvContainer
+   *  for a VehicleCallBack, so subscribe with a NULL one to avoid the copy;
+   *  the default logging callbacks are not installed while this is set.
+   *
+   *  @platforms M210V2
+   *  @param callback callback function, NULL to stop
+   *  @param userData user data (void ptr)
+   */
+  void setStereoFrameCallback(StereoFrameCallBack callback, UserData userData = 0);
   /*! @brief
    *
    *  A default callback function for QVGA stereo images
@@ -244,6 +268,43 @@ public:
    *  @return true if a new image frame is ready, false if timeout
    */
   bool getMainCameraImage(CameraRGBImage& copyOfImage);
+  /*! @brief Get the new image from the FPV camera without copying it
+   *
+   *  @platforms M210V2, M300
+   *  @param frame Receives a read-only handle to the image. The image stays
+   *         valid while the handle is held, release it soon since the
+   *         decoder drops frames when all its buffers are held.
+   *  @note If a new image is not ready upon calling this function,
+   *        it will wait for 20ms till timeout.
+   *
+   *  @return true if a new image frame is ready, false if timeout
+   */
+  bool getFPVCameraFrame(CameraImageFramePtr& frame);
+  /*! @brief Get the new image from the main camera without copying it
+   *
+   *  @platforms M210V2, M300
+   *  @param frame Receives a read-only handle to the image, see
+   *         getFPVCameraFrame
+   *
+   *  @return true if a new image frame is ready, false if timeout
+   */
+  bool getMainCameraFrame(CameraImageFramePtr& frame);
+  /*! @brief Select the pixel layout of the decoded FPV camera images
+   *
+   *  @platforms M210V2, M300
+   *  @param format RGB24 by default. YUV420P, NV12 and GRAY8 skip colour
+   *         conversion. Images obtained as CameraRGBImage carry the
+   *         selected layout in rawData as well.
+   *  @return false if the format is unknown
+   */
+  bool setFPVCameraImageFormat(CameraImageFormat format);
+  /*! @brief Select the pixel layout of the decoded main camera images
+   *
+   *  @platforms M210V2, M300
+   *  @param format see setFPVCameraImageFormat
+   *  @return false if the format is unknown
+   */
+  bool setMainCameraImageFormat(CameraImageFormat format);
 
   /*! @brief
    *  Change the camera stream source from one payload device. (Beta API)
@@ -337,6 +398,8 @@ public:
 private:
   void sendCommonCmd(uint8_t *data, uint8_t data_len, uint8_t cmd_id);
 
+  void sendStereoImageSelection(const ImageSelection *select);
+
 private:
 AdvancedSensingProtocol* advancedSensingProtocol;
 Vehicle* vehicle_ptr;
@@ -353,6 +416,7 @@ AdvancedSensingProtocol* getAdvancedSensingProtocol();
 public:
 VehicleCallBackHandler stereoHandler;
 VehicleCallBackHandler vgaHandler;
+StereoFrameCallBackHandler stereoFrameHandler;
 };
 
 } // OSDK
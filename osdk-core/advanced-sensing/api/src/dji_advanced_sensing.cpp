@@ -23,6 +23,7 @@
 #include "dji_version.hpp"
 #include "dji_camera_stream_decoder.hpp"
 #include "dji_linker.hpp"
+#include <atomic>
 using namespace DJI;
 using namespace DJI::OSDK;
 
@@ -40,7 +41,8 @@ void parseVersion(uint8_t* ackPtr);
 // Variables
 Version::VersionData internal_drone_version;
 
-static pthread_t adv_pthread_handle;
+static pthread_t         adv_pthread_handle;
+static std::atomic<bool> adv_pthread_running(false);
 
 void *adv_pthread(void *p){
   DSTATUS("adv pthread created !!!!!!!!!!!!!!!!!!!!!!!");
@@ -49,14 +51,16 @@ void *adv_pthread(void *p){
     RecvContainer container = {0};
     RecvContainer* recvContainer = &container;
     Vehicle*       vehiclePtr    = (Vehicle *)p;
-    while (true)
+    //! receive() blocks in the USB driver until data comes or its read
+    //! timeout expires, so there is no sleep here and deinit() is seen
+    //! within one timeout
+    while (adv_pthread_running.load())
     {
       recvContainer = vehiclePtr->advancedSensing->getAdvancedSensingProtocol()->receive();
       if(recvContainer->recvInfo.cmd_id != 0xFF)
       {
         vehiclePtr->processAdvancedSensingImgs(recvContainer);
       }
-      usleep(10);
     }
   } else {
     DERROR("passing parameter error !");
@@ -68,11 +72,22 @@ void *adv_pthread(void *p){
 void AdvancedSensing::init()
 {
   if (!vehicle_ptr->isM300())
-  pthread_create(&adv_pthread_handle, NULL, adv_pthread, vehicle_ptr);
+  {
+    adv_pthread_running.store(true);
+    if (pthread_create(&adv_pthread_handle, NULL, adv_pthread, vehicle_ptr))
+    {
+      DERROR("Failed to create the advanced sensing read thread");
+      adv_pthread_running.store(false);
+    }
+  }
 }
 
 void AdvancedSensing::deinit()
 {
+  if (adv_pthread_running.exchange(false))
+  {
+    pthread_join(adv_pthread_handle, NULL);
+  }
 }
 
 AdvancedSensing::AdvancedSensing(Vehicle* vehiclePtr) :
@@ -87,13 +102,12 @@ AdvancedSensing::AdvancedSensing(Vehicle* vehiclePtr) :
   stereoHandler.userData  = 0;
   vgaHandler.callback     = 0;
   vgaHandler.userData     = 0;
+  stereoFrameHandler.callback = 0;
+  stereoFrameHandler.userData = 0;
   streamDecoder.clear();
   // call a closed-source version of getDroneVersion() to prevent hacking
   internalGetDroneVersion(vehiclePtr);
 
-  // wait for half sec
-  sleep(0.5);
-
   if (!versionPass())
   {
     DERROR("Please make sure the connected drone is a M210 and "
@@ -152,6 +166,9 @@ AdvancedSensing::AdvancedSensing(Vehicle* vehiclePtr) :
 
 AdvancedSensing::~AdvancedSensing()
 {
+  //! The read thread uses the protocol, stop it first
+  deinit();
+
   if (this->advancedSensingProtocol)
     delete this->advancedSensingProtocol;
 
@@ -213,6 +230,23 @@ AdvancedSensing::subscribeStereoImages(const ImageSelection *select, VehicleCall
   }
 */
 
+  if (callback)
+  {
+    stereoHandler.callback = callback;
+    stereoHandler.userData = userData;
+  }
+  else
+  {
+    stereoHandler.callback = stereoFrameHandler.callback ? NULL : &AdvancedSensing::stereoCallback;
+    stereoHandler.userData = NULL;
+  }
+
+  sendStereoImageSelection(select);
+}
+
+void
+AdvancedSensing::sendStereoImageSelection(const ImageSelection *select)
+{
   AdvancedSensingConfig config;
   memset(&config, 0, sizeof(config));
   config.is_stereo_img_subscribed = true;
@@ -228,22 +262,27 @@ AdvancedSensing::subscribeStereoImages(const ImageSelection *select, VehicleCall
 
   uint8_t* data = (uint8_t*)&(config.image_selected);
 
-  if (callback)
-  {
-    stereoHandler.callback = callback;
-    stereoHandler.userData = userData;
-  }
-  else
-  {
-    stereoHandler.callback = &AdvancedSensing::stereoCallback;
-    stereoHandler.userData = NULL;
-  }
-
   sendCommonCmd(data, sizeof(config.image_selected), AdvancedSensingProtocol::SELECT_IMG_CMD_ID);
 
   sendCommonCmd(NULL, 0, AdvancedSensingProtocol::START_CMD_ID);
 }
 
+void
+AdvancedSensing::setStereoFrameCallback(StereoFrameCallBack callback, UserData userData)
+{
+  stereoFrameHandler.callback = callback;
+  stereoFrameHandler.userData = userData;
+
+  //! The default callbacks only log, do not copy every image for them
+  if (callback)
+  {
+    if (stereoHandler.callback == &AdvancedSensing::stereoCallback)
+      stereoHandler.callback = NULL;
+    if (vgaHandler.callback == &AdvancedSensing::VGACallback)
+      vgaHandler.callback = NULL;
+  }
+}
+
 typedef struct M300VGAHandlerData {
   VehicleCallBackHandler handler;
   Vehicle* vehicle;
@@ -342,7 +381,7 @@ AdvancedSensing::subscribeFrontStereoVGA(const uint8_t freq,
       vgaHandler.callback = callback;
       vgaHandler.userData = userData;
     } else {
-      vgaHandler.callback = &AdvancedSensing::VGACallback;
+      vgaHandler.callback = stereoFrameHandler.callback ? NULL : &AdvancedSensing::VGACallback;
       vgaHandler.userData = NULL;
     }
 
@@ -388,7 +427,7 @@ AdvancedSensing::subscribeFrontStereoDisparity(VehicleCallBack callback, UserDat
   }
   else
   {
-    stereoHandler.callback = &AdvancedSensing::stereoCallback;
+    stereoHandler.callback = stereoFrameHandler.callback ? NULL : &AdvancedSensing::stereoCallback;
     stereoHandler.userData = NULL;
   }
 
@@ -592,6 +631,62 @@ bool AdvancedSensing::getFPVCameraImage(CameraRGBImage& copyOfImage)
   return ret;
 }
 
+bool AdvancedSensing::getMainCameraFrame(CameraImageFramePtr& frame)
+{
+  bool ret = false;
+  if (vehicle_ptr->isM300()) {
+    auto deocderPair = streamDecoder.find(LiveView::OSDK_CAMERA_POSITION_NO_1);
+    if ((deocderPair != streamDecoder.end()) && deocderPair->second) {
+      ret = deocderPair->second->decodedImageHandler.getNewFrameWithLock(frame, 20);
+    }
+  } else {
+    ret = mainCam_ptr->getCurrentFrame(frame);
+  }
+  return ret;
+}
+
+bool AdvancedSensing::getFPVCameraFrame(CameraImageFramePtr& frame)
+{
+  bool ret = false;
+  if (vehicle_ptr->isM300()) {
+    auto deocderPair = streamDecoder.find(LiveView::OSDK_CAMERA_POSITION_FPV);
+    if ((deocderPair != streamDecoder.end()) && deocderPair->second) {
+      ret = deocderPair->second->decodedImageHandler.getNewFrameWithLock(frame, 20);
+    }
+  } else {
+    ret = fpvCam_ptr->getCurrentFrame(frame);
+  }
+  return ret;
+}
+
+bool AdvancedSensing::setFPVCameraImageFormat(CameraImageFormat format)
+{
+  bool ret = false;
+  if (vehicle_ptr->isM300()) {
+    auto deocderPair = streamDecoder.find(LiveView::OSDK_CAMERA_POSITION_FPV);
+    if ((deocderPair != streamDecoder.end()) && deocderPair->second) {
+      ret = deocderPair->second->setOutputFormat(format);
+    }
+  } else {
+    ret = fpvCam_ptr->setImageFormat(format);
+  }
+  return ret;
+}
+
+bool AdvancedSensing::setMainCameraImageFormat(CameraImageFormat format)
+{
+  bool ret = false;
+  if (vehicle_ptr->isM300()) {
+    auto deocderPair = streamDecoder.find(LiveView::OSDK_CAMERA_POSITION_NO_1);
+    if ((deocderPair != streamDecoder.end()) && deocderPair->second) {
+      ret = deocderPair->second->setOutputFormat(format);
+    }
+  } else {
+    ret = mainCam_ptr->setImageFormat(format);
+  }
+  return ret;
+}
+
 void AdvancedSensing::setAcmDevicePath(const char *acm_path)
 {
     this->acm_dev=acm_path;
@@ -644,47 +739,48 @@ LiveView::LiveViewErrCode AdvancedSensing::stopH264Stream(
   }
 }
 
-void stereoImg240pHandlerCB(Vehicle *vehiclePtr, RecvContainer recvFrame, UserData userData)
+void stereoImg240pHandlerCB(Vehicle *vehiclePtr, StereoFramePtr frame, UserData userData)
 {
-  char *m210FLName = "front_left";
-  char *m210FRName = "front_right";
-  char *m210DBName = "down_back";
-  char *m210DFName = "down_front";
-  if (!userData) {
+  const char *m210FLName = "front_left";
+  const char *m210FRName = "front_right";
+  const char *m210DBName = "down_back";
+  const char *m210DFName = "down_front";
+  if (!userData || !frame) {
     DERROR("Invalid parameters.");
     return;
   }
   DSTATUS("sample stereoCallback receive an image at frame: %d and time stamp: %d",
-          recvFrame.recvData.stereoImgData->frame_index,
-          recvFrame.recvData.stereoImgData->time_stamp);
+          frame->frame_index, frame->time_stamp);
   CommonCallBackHandler *handler = (CommonCallBackHandler *)userData;
   Perception::PerceptionImageCB
       cb = (Perception::PerceptionImageCB) handler->callback;
-  for (int i = 0; i < recvFrame.recvData.stereoImgData->num_imgs; i++)
+  for (int i = 0; i < frame->num_imgs; i++)
   {
+    const StereoImageView &view = frame->img_vec[i];
     Perception::ImageInfoType type = {0};
-    type.rawInfo.height = 240;
-    type.rawInfo.width = 320;
-    type.sequence = recvFrame.recvData.stereoImgData->frame_index;
-    type.timeStamp = recvFrame.recvData.stereoImgData->time_stamp;
-    type.rawInfo.index = recvFrame.recvData.stereoImgData->frame_index;
-    if (!strncmp(recvFrame.recvData.stereoImgData->img_vec[i].name, m210FLName, strlen(m210FLName))) {
+    type.rawInfo.height = view.height;
+    type.rawInfo.width = view.width;
+    type.sequence = frame->frame_index;
+    type.timeStamp = frame->time_stamp;
+    type.rawInfo.index = frame->frame_index;
+    if (!strncmp(view.name, m210FLName, strlen(m210FLName))) {
       type.dataType = Perception::RAW_FRONT_LEFT;
       type.rawInfo.direction = Perception::RECTIFY_FRONT;
-    } else if (!strncmp(recvFrame.recvData.stereoImgData->img_vec[i].name, m210FRName, strlen(m210FRName))) {
+    } else if (!strncmp(view.name, m210FRName, strlen(m210FRName))) {
       type.dataType = Perception::RAW_FRONT_RIGHT;
       type.rawInfo.direction = Perception::RECTIFY_FRONT;
-    } else if (!strncmp(recvFrame.recvData.stereoImgData->img_vec[i].name, m210DBName, strlen(m210DBName))) {
+    } else if (!strncmp(view.name, m210DBName, strlen(m210DBName))) {
       type.dataType = Perception::RAW_DOWN_BACK;
       type.rawInfo.direction = Perception::RECTIFY_DOWN;
-    } else if (!strncmp(recvFrame.recvData.stereoImgData->img_vec[i].name, m210DFName, strlen(m210DFName))) {
+    } else if (!strncmp(view.name, m210DFName, strlen(m210DFName))) {
       type.dataType = Perception::RAW_DOWN_FRONT;
       type.rawInfo.direction = Perception::RECTIFY_DOWN;
     } else {
       DSTATUS("Get unknown stereo images flow");
       continue;
     }
-    cb(type, recvFrame.recvData.stereoImgData->img_vec[i].image, ACK::IMG_240P_SIZE, handler->userData);
+    //! The buffer belongs to this frame alone until it is released
+    cb(type, const_cast<uint8_t *>(view.image), view.size, handler->userData);
   }
 }
 
@@ -709,7 +805,10 @@ Perception::PerceptionErrCode AdvancedSensing::subscribePerceptionImage(
     handler.callback = (void *)cb;
     handler.userData = userData;
 
-    subscribeStereoImages(&image_select, &stereoImg240pHandlerCB, &handler);
+    //! Images are passed on straight from the receive buffer
+    stereoHandler.callback = NULL;
+    setStereoFrameCallback(&stereoImg240pHandlerCB, &handler);
+    sendStereoImageSelection(&image_select);
     return Perception::OSDK_PERCEPTION_PASS;
   } else if (vehicle_ptr->isM300()) {
     return perception->subscribePerceptionImage(direction, cb, userData);
@@ -723,6 +822,7 @@ Perception::PerceptionErrCode AdvancedSensing::unsubscribePerceptionImage(
     Perception::DirectionType direction) {
   if (vehicle_ptr->isM210V2()) {
     unsubscribeStereoImages();
+    setStereoFrameCallback(NULL);
     return Perception::OSDK_PERCEPTION_PASS;
   } else if (vehicle_ptr->isM300()) {
     return perception->unsubscribePerceptionImage(direction);
@@ -0,0 +1,122 @@
+/** @file dji_camera_frame_pool.cpp
+ *  @version 4.0.0
+ *  @date Oct 2026
+ *
+ *  @brief Fixed pool of reference-counted buffers for decoded camera frames
+ *
+ *  @copyright 2026 DJI. All rights reserved.
+ *
+ */
+
+#include "dji_camera_frame_pool.hpp"
+#include <time.h>
+
+struct DJICameraFramePool::State
+{
+  pthread_mutex_t                   mutex;
+  pthread_cond_t                    condv;
+  std::vector<std::vector<uint8_t> > buffers;
+  std::vector<int>                  freeList;
+
+  State(int poolSize)
+    : buffers(poolSize)
+  {
+    pthread_mutex_init(&mutex, NULL);
+    pthread_cond_init(&condv, NULL);
+    for (int i = poolSize - 1; i >= 0; --i)
+    {
+      freeList.push_back(i);
+    }
+  }
+
+  ~State()
+  {
+    pthread_mutex_destroy(&mutex);
+    pthread_cond_destroy(&condv);
+  }
+
+  void release(int index)
+  {
+    pthread_mutex_lock(&mutex);
+    freeList.push_back(index);
+    pthread_cond_signal(&condv);
+    pthread_mutex_unlock(&mutex);
+  }
+};
+
+DJICameraFramePool::DJICameraFramePool(int poolSize)
+  : m_state(new State(poolSize))
+{
+}
+
+DJICameraFramePool::~DJICameraFramePool()
+{
+}
+
+std::shared_ptr<CameraImageFrame>
+DJICameraFramePool::acquire(size_t size, int timeoutMilliSec)
+{
+  State* state = m_state.get();
+
+  pthread_mutex_lock(&state->mutex);
+  if (state->freeList.empty() && timeoutMilliSec > 0)
+  {
+    struct timespec absTimeout;
+    clock_gettime(CLOCK_REALTIME, &absTimeout);
+    absTimeout.tv_sec  += timeoutMilliSec / 1000;
+    absTimeout.tv_nsec += (long)(timeoutMilliSec % 1000) * 1000000;
+    if (absTimeout.tv_nsec >= 1000000000)
+    {
+      absTimeout.tv_sec  += 1;
+      absTimeout.tv_nsec -= 1000000000;
+    }
+    while (state->freeList.empty())
+    {
+      if (pthread_cond_timedwait(&state->condv, &state->mutex, &absTimeout))
+      {
+        break;
+      }
+    }
+  }
+
+  if (state->freeList.empty())
+  {
+    pthread_mutex_unlock(&state->mutex);
+    return std::shared_ptr<CameraImageFrame>();
+  }
+  int index = state->freeList.back();
+  state->freeList.pop_back();
+  pthread_mutex_unlock(&state->mutex);
+
+  // Only this thread owns the buffer now. It only grows, so after the
+  // first frame of a resolution no allocation is made.
+  std::vector<uint8_t>& buffer = state->buffers[index];
+  if (buffer.size() < size)
+  {
+    buffer.resize(size);
+  }
+
+  CameraImageFrame* frame = new CameraImageFrame;
+  frame->data             = buffer.data();
+  frame->size             = size;
+  frame->height           = 0;
+  frame->width            = 0;
+  frame->format           = CAMERA_IMAGE_FORMAT_RGB24;
+  frame->receiveTimeUs    = 0;
+
+  std::shared_ptr<State> owner = m_state;
+  return std::shared_ptr<CameraImageFrame>(
+    frame, [owner, index](CameraImageFrame* f) {
+      delete f;
+      owner->release(index);
+    });
+}
+
+int
+DJICameraFramePool::getFreeCount()
+{
+  pthread_mutex_lock(&m_state->mutex);
+  int count = m_state->freeList.size();
+  pthread_mutex_unlock(&m_state->mutex);
+  return count;
+}
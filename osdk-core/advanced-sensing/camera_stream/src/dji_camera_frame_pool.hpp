@@ -0,0 +1,43 @@
+/** @file dji_camera_frame_pool.hpp
+ *  @version 4.0.0
+ *  @date Oct 2026
+ *
+ *  @brief Fixed pool of reference-counted buffers for decoded camera frames
+ *
+ *  @copyright 2026 DJI. All rights reserved.
+ *
+ */
+
+#ifndef DJICAMERAFRAMEPOOL_HH
+#define DJICAMERAFRAMEPOOL_HH
+
+#include "pthread.h"
+#include "dji_camera_image.hpp"
+
+class DJICameraFramePool
+{
+public:
+  DJICameraFramePool(int poolSize);
+  ~DJICameraFramePool();
+
+  /*!
+   * @brief Take a free buffer of at least size bytes out of the pool
+   *
+   * @param timeoutMilliSec: How long to wait for a consumer to release a
+   * buffer when the pool is empty, 0 to return at once
+   * @return NULL if no buffer became free in time. The buffer goes back to
+   * the pool when the last copy of the handle is released, which may happen
+   * after the pool itself is destroyed.
+   */
+  std::shared_ptr<CameraImageFrame> acquire(size_t size, int timeoutMilliSec);
+
+  int getFreeCount();
+
+private:
+  // Shared with the handles, so frames held by the user outlive the pool
+  struct State;
+
+  std::shared_ptr<State> m_state;
+};
+
+#endif // DJICAMERAFRAMEPOOL_HH
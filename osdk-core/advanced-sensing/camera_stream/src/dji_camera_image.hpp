@@ -9,6 +9,7 @@
 #ifndef ADVANCED_SENSING_DJI_CAMERA_IMAGE_HPP
 #define ADVANCED_SENSING_DJI_CAMERA_IMAGE_HPP
 #include <cstdint>
+#include <memory>
 #include <vector>
 
 /*! @brief Data structure for the image frames from the
@@ -16,7 +17,8 @@
  */
 struct CameraRGBImage
 {
-  // rawData.size should be height x width x 3 x sizeof(char)
+  // rawData.size should be height x width x 3 x sizeof(char) for the
+  // default RGB24 format, see CameraImageFormat for the others
   std::vector<uint8_t> rawData;
   int height;
   int width;
@@ -27,6 +29,47 @@ struct CameraRGBImage
  */
 typedef void (*CameraImageCallback)(CameraRGBImage pImg, void* userData);
 
+/*! @brief Pixel layout of decoded frames, see
+ *  DJICameraStreamDecoder::setOutputFormat
+ */
+enum CameraImageFormat
+{
+  CAMERA_IMAGE_FORMAT_RGB24   = 0, /*!< Packed R, G, B, the default */
+  CAMERA_IMAGE_FORMAT_BGR24   = 1, /*!< Packed B, G, R, as used by OpenCV */
+  CAMERA_IMAGE_FORMAT_YUV420P = 2, /*!< Y plane, then U and V at half size */
+  CAMERA_IMAGE_FORMAT_NV12    = 3, /*!< Y plane, then interleaved UV */
+  CAMERA_IMAGE_FORMAT_GRAY8   = 4  /*!< Y plane only */
+};
+
+/*! @brief Decoded frame living in a buffer of the decoder's frame pool
+ *
+ *  @details The decoder writes each frame straight into a pooled buffer and
+ *  hands out shared read-only handles to it, so no copy is made for the
+ *  consumers. The buffer returns to the pool when the last handle is
+ *  released. Holding handles for long makes the decoder drop frames once
+ *  the pool is empty.
+ */
+struct CameraImageFrame
+{
+  // Tightly packed, size depends on format
+  uint8_t*          data;
+  size_t            size;
+  int               height;
+  int               width;
+  CameraImageFormat format;
+  // CLOCK_MONOTONIC time in microseconds at which the last of the frame's
+  // stream data arrived, for measuring delivery latency
+  uint64_t          receiveTimeUs;
+};
+
+typedef std::shared_ptr<const CameraImageFrame> CameraImageFramePtr;
+
+/*! @brief User callback function called by OSDK (in a dedicated thread)
+ *  when a new image frame from camera is received, without copying it.
+ */
+typedef void (*CameraImageFrameCallback)(CameraImageFramePtr frame,
+                                         void*               userData);
+
 /*! @brief User callback function called by OSDK (in a dedicated thread)
  *  when a H264 frame is received.
  */
@@ -24,8 +24,11 @@
  */
 
 #include "dji_camera_image_handler.hpp"
+#include <string.h>
 
-DJICameraImageHandler::DJICameraImageHandler():m_newImageFlag(false)
+DJICameraImageHandler::DJICameraImageHandler(int poolSize)
+  : m_pool(poolSize),
+    m_newImageFlag(false)
 {
   pthread_mutex_init(&m_mutex, NULL);
   pthread_cond_init(&m_condv, NULL);
@@ -37,41 +40,84 @@ DJICameraImageHandler::~DJICameraImageHandler()
   pthread_cond_destroy(&m_condv);
 }
 
-bool DJICameraImageHandler::getNewImageWithLock(CameraRGBImage & copyOfImage, int timeoutMilliSec)
+std::shared_ptr<CameraImageFrame> DJICameraImageHandler::acquireFrameBuffer(size_t size, int timeoutMilliSec)
+{
+  return m_pool.acquire(size, timeoutMilliSec);
+}
+
+void DJICameraImageHandler::publishFrameWithLock(const CameraImageFramePtr& frame)
 {
-  int result = -1;
+  CameraImageFramePtr previous;
+
+  pthread_mutex_lock(&m_mutex);
+  previous = m_frame;
+  m_frame = frame;
+  m_newImageFlag = true;
+  pthread_cond_signal(&m_condv);
+  pthread_mutex_unlock(&m_mutex);
+
+  /* previous is released here, outside the lock, which may hand its buffer
+   * back to the pool.
+   */
+}
+
+bool DJICameraImageHandler::getNewFrameWithLock(CameraImageFramePtr& frame, int timeoutMilliSec)
+{
+  int result = 0;
 
   /*! @note
    * Here result == 0 means successful.
    * Because this is the behavior of pthread_cond_timedwait.
    */
   pthread_mutex_lock(&m_mutex);
-  if(m_newImageFlag)
-  {
-    /* At this point, a copy of m_img is made, so it is safe to 
-     * do any modifications to copyOfImage in user code.
-     */
-    copyOfImage = m_img;
-    m_newImageFlag = false;
-    result = 0;
-  }
-  else
+  if(!m_newImageFlag)
   {
     struct timespec absTimeout;
     clock_gettime(CLOCK_REALTIME, &absTimeout);
-    absTimeout.tv_nsec += timeoutMilliSec * 1e6;
-    result = pthread_cond_timedwait(&m_condv, &m_mutex, &absTimeout);
-
-    if(result == 0)
+    absTimeout.tv_sec  += timeoutMilliSec / 1000;
+    absTimeout.tv_nsec += (long)(timeoutMilliSec % 1000) * 1000000;
+    if(absTimeout.tv_nsec >= 1000000000)
+    {
+      absTimeout.tv_sec  += 1;
+      absTimeout.tv_nsec -= 1000000000;
+    }
+    while(!m_newImageFlag && result == 0)
     {
-      copyOfImage = m_img;
-      m_newImageFlag = false;
+      result = pthread_cond_timedwait(&m_condv, &m_mutex, &absTimeout);
     }
   }
+
+  if(m_newImageFlag)
+  {
+    /* Only the handle is copied, the pixels stay in the pooled buffer and
+     * are never written again while the handle is held.
+     */
+    frame = m_frame;
+    m_newImageFlag = false;
+    result = 0;
+  }
   pthread_mutex_unlock(&m_mutex);
   return (result == 0) ? true : false;
 }
 
+bool DJICameraImageHandler::getNewImageWithLock(CameraRGBImage & copyOfImage, int timeoutMilliSec)
+{
+  CameraImageFramePtr frame;
+  if(!getNewFrameWithLock(frame, timeoutMilliSec))
+  {
+    return false;
+  }
+
+  /* The copy is made outside the lock, so the decoder is not blocked
+   * while it runs. It is safe to do any modifications to copyOfImage in
+   * user code.
+   */
+  copyOfImage.rawData.assign(frame->data, frame->data + frame->size);
+  copyOfImage.height = frame->height;
+  copyOfImage.width  = frame->width;
+  return true;
+}
+
 bool DJICameraImageHandler::newImageIsReady()
 {
   return m_newImageFlag;
@@ -79,14 +125,15 @@ bool DJICameraImageHandler::newImageIsReady()
 
 void DJICameraImageHandler::writeNewImageWithLock(uint8_t* buf, int bufSize, int width, int height)
 {
-  pthread_mutex_lock(&m_mutex);
-
-  m_img.rawData.assign(buf, buf+bufSize);
-  m_img.height = height;
-  m_img.width  = width;
-  m_newImageFlag = true;
+  std::shared_ptr<CameraImageFrame> frame = m_pool.acquire(bufSize, 0);
+  if(!frame)
+  {
+    // All buffers are held by consumers, drop the frame
+    return;
+  }
 
-  pthread_cond_signal(&m_condv);
-  pthread_mutex_unlock(&m_mutex);
+  memcpy(frame->data, buf, bufSize);
+  frame->height = height;
+  frame->width  = width;
+  publishFrameWithLock(frame);
 }
-
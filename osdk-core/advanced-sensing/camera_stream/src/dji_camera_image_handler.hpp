@@ -14,23 +14,46 @@
 
 #include "pthread.h"
 #include "dji_camera_image.hpp"
+#include "dji_camera_frame_pool.hpp"
 
 class DJICameraImageHandler
 {
 public:
-  DJICameraImageHandler();
+  DJICameraImageHandler(int poolSize = DEFAULT_POOL_SIZE);
   ~DJICameraImageHandler();
 
   bool newImageIsReady();
 
+  /*!
+   * @brief Get a pooled buffer to decode the next frame into, see
+   * DJICameraFramePool::acquire
+   */
+  std::shared_ptr<CameraImageFrame> acquireFrameBuffer(size_t size,
+                                                       int timeoutMilliSec);
+
+  /*!
+   * @brief Make frame the latest image and wake up a waiting reader. The
+   * previous latest image goes back to the pool once no reader holds it.
+   */
+  void publishFrameWithLock(const CameraImageFramePtr& frame);
+
+  /*!
+   * @brief Zero-copy version of getNewImageWithLock
+   */
+  bool getNewFrameWithLock(CameraImageFramePtr& frame, int timeoutMilliSec);
+
   void writeNewImageWithLock(uint8_t* buf, int bufSize, int width, int height);
   bool getNewImageWithLock(CameraRGBImage & copyOfImage, int timeoutMilliSec);
 
+  //! Frames in flight: one decoding, one latest and two held by consumers
+  static const int DEFAULT_POOL_SIZE = 4;
+
 private:
-  pthread_mutex_t m_mutex;
-  pthread_cond_t  m_condv;
-  CameraRGBImage  m_img;
-  bool            m_newImageFlag;
+  pthread_mutex_t     m_mutex;
+  pthread_cond_t      m_condv;
+  DJICameraFramePool  m_pool;
+  CameraImageFramePtr m_frame;
+  bool                m_newImageFlag;
 };
 
 #endif
@@ -107,6 +107,16 @@ bool DJICameraStream::getCurrentImage(CameraRGBImage& copyOfImage)
   return decoder->decodedImageHandler.getNewImageWithLock(copyOfImage, 20);
 }
 
+bool DJICameraStream::getCurrentFrame(CameraImageFramePtr& frame)
+{
+  return decoder->decodedImageHandler.getNewFrameWithLock(frame, 20);
+}
+
+bool DJICameraStream::setImageFormat(CameraImageFormat format)
+{
+  return decoder->setOutputFormat(format);
+}
+
 bool DJICameraStream::newImageIsReady()
 {
   return decoder->decodedImageHandler.newImageIsReady();
@@ -30,6 +30,10 @@ public:
 
   bool getCurrentImage(CameraRGBImage& copyOfImage);
 
+  bool getCurrentFrame(CameraImageFramePtr& frame);
+
+  bool setImageFormat(CameraImageFormat format);
+
   bool startCameraStream(CameraImageCallback cb = NULL, void * cbParam = NULL);
 
   void stopCameraStream();
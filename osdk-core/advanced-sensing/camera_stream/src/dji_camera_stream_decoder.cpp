@@ -24,91 +24,167 @@
  */
 
 #include "dji_camera_stream_decoder.hpp"
+#include "dji_image_converter.hpp"
 #include "dji_log.hpp"
 #include "unistd.h"
+#include <string.h>
+#include <time.h>
 #include "pthread.h"
 
+/* Packets the reader skips while waiting for a key frame after the queue
+ * overflowed. A stream that only refreshes with intra slices has no key
+ * frames, so decoding resumes after this many packets anyway.
+ */
+static const uint32_t MAX_KEY_FRAME_WAIT_PACKETS = 300;
+
+static uint64_t getMonotonicTimeUs()
+{
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (uint64_t)now.tv_sec * 1000000 + now.tv_nsec / 1000;
+}
+
 DJICameraStreamDecoder::DJICameraStreamDecoder()
   : initSuccess(false),
     cbThreadIsRunning(false),
     cbThreadStatus(-1),
     cb(NULL),
     cbUserParam(NULL),
+    frameCb(NULL),
+    frameCbUserParam(NULL),
+    decodeThreadIsRunning(false),
+    pParserCodecCtx(NULL),
+    pCodecParserCtx(NULL),
+    waitKeyFrame(false),
+    skippedPackets(0),
     pCodecCtx(NULL),
     pCodec(NULL),
-    pCodecParserCtx(NULL),
     pSwsCtx(NULL),
     pFrameYUV(NULL),
     pFrameRGB(NULL),
-    rgbBuf(NULL),
-    bufSize(0)
+    outputFormat(CAMERA_IMAGE_FORMAT_RGB24)
 {
+  config.threadCount     = 4;
+  config.frameThreading  = true;
+  config.packetQueueSize = 32;
+  config.latencyBudgetMs = 300;
+  memset(&stats, 0, sizeof(stats));
+
+  pthread_mutex_init(&parsermutex, NULL);
+  pthread_mutex_init(&queuemutex, NULL);
+  pthread_cond_init(&queuecondv, NULL);
   pthread_mutex_init(&decodemutex, NULL);
+  pthread_mutex_init(&statsmutex, NULL);
 }
 
 DJICameraStreamDecoder::~DJICameraStreamDecoder()
 {
-  pthread_mutex_destroy(&decodemutex);
-  if(cb)
+  if(cb || frameCb)
   {
     registerCallback(NULL, NULL);
+    registerFrameCallback(NULL, NULL);
   }
 
   cleanup();
+
+  pthread_mutex_destroy(&parsermutex);
+  pthread_mutex_destroy(&queuemutex);
+  pthread_cond_destroy(&queuecondv);
+  pthread_mutex_destroy(&decodemutex);
+  pthread_mutex_destroy(&statsmutex);
 }
 
 bool DJICameraStreamDecoder::init()
 {
+  pthread_mutex_lock(&parsermutex);
   pthread_mutex_lock(&decodemutex);
 
   if(true == initSuccess)
   {
+    pthread_mutex_unlock(&decodemutex);
+    pthread_mutex_unlock(&parsermutex);
     DSTATUS_PRIVATE("Decoder already initialized.\n");
     return true;
   }
 
-  avcodec_register_all();
-  pCodecCtx = avcodec_alloc_context3(NULL);
-  if (!pCodecCtx)
-  {
-    return false;
-  }
-
-  pCodecCtx->thread_count = 4;
-  pCodec = avcodec_find_decoder(AV_CODEC_ID_H264);
-  if (!pCodec || avcodec_open2(pCodecCtx, pCodec, NULL) < 0)
+  bool result = false;
+  do
   {
-    return false;
-  }
+    avcodec_register_all();
+    pCodec = avcodec_find_decoder(AV_CODEC_ID_H264);
+    if (!pCodec)
+    {
+      break;
+    }
 
-  pCodecParserCtx = av_parser_init(AV_CODEC_ID_H264);
-  if (!pCodecParserCtx)
-  {
-    return false;
-  }
+    pCodecCtx = avcodec_alloc_context3(pCodec);
+    pParserCodecCtx = avcodec_alloc_context3(pCodec);
+    if (!pCodecCtx || !pParserCodecCtx)
+    {
+      break;
+    }
 
-  pFrameYUV = av_frame_alloc();
-  if (!pFrameYUV)
-  {
-    return false;
-  }
+    /* Frame threading decodes threadCount frames in parallel and delays the
+     * output by as many frames, slice threading only helps for streams with
+     * several slices per frame but adds no delay.
+     */
+    pCodecCtx->thread_count = config.threadCount;
+    if(config.frameThreading)
+    {
+      pCodecCtx->thread_type = FF_THREAD_FRAME;
+    }
+    else
+    {
+      pCodecCtx->thread_type = FF_THREAD_SLICE;
+      pCodecCtx->flags      |= AV_CODEC_FLAG_LOW_DELAY;
+    }
+    pCodecCtx->flags2 |= AV_CODEC_FLAG2_SHOW_ALL;
+    if (avcodec_open2(pCodecCtx, pCodec, NULL) < 0)
+    {
+      break;
+    }
 
-  pFrameRGB = av_frame_alloc();
-  if (!pFrameRGB)
-  {
-    return false;
-  }
+    pCodecParserCtx = av_parser_init(AV_CODEC_ID_H264);
+    if (!pCodecParserCtx)
+    {
+      break;
+    }
 
-  pSwsCtx = NULL;
+    pFrameYUV = av_frame_alloc();
+    pFrameRGB = av_frame_alloc();
+    if (!pFrameYUV || !pFrameRGB)
+    {
+      break;
+    }
 
-  DSTATUS_PRIVATE("All components for decoding initialized ...\n");
-  DDEBUG_PRIVATE("Decoder Version = %d\n", avcodec_version());
+    pSwsCtx        = NULL;
+    waitKeyFrame   = false;
+    skippedPackets = 0;
 
-  pCodecCtx->flags2 |= AV_CODEC_FLAG2_SHOW_ALL;
-  initSuccess = true;
+    decodeThreadIsRunning = true;
+    if(0 != pthread_create(&decodeThread, NULL, decodeThreadEntry, this))
+    {
+      decodeThreadIsRunning = false;
+      DERROR_PRIVATE("Decode thread creation failed!\n");
+      break;
+    }
+    result = true;
+  } while(0);
 
+  initSuccess = result;
   pthread_mutex_unlock(&decodemutex);
+  pthread_mutex_unlock(&parsermutex);
 
+  if(!result)
+  {
+    DERROR_PRIVATE("Failed to initialize the decoder\n");
+    cleanup();
+    return false;
+  }
+
+  DSTATUS_PRIVATE("All components for decoding initialized ...\n");
+  DDEBUG_PRIVATE("Decoder Version = %d, %d %s threads\n", avcodec_version(),
+                 config.threadCount, config.frameThreading ? "frame" : "slice");
   return true;
 }
 
@@ -117,8 +193,26 @@ bool DJICameraStreamDecoder::getNewImage(CameraRGBImage & copyOfImage, int timeo
   return decodedImageHandler.getNewImageWithLock(copyOfImage, timeoutMilliSec);
 }
 
+bool DJICameraStreamDecoder::getNewFrame(CameraImageFramePtr & frame, int timeoutMilliSec)
+{
+  return decodedImageHandler.getNewFrameWithLock(frame, timeoutMilliSec);
+}
+
 void DJICameraStreamDecoder::cleanup()
 {
+  // Stop the decode thread first, it uses everything freed below
+  pthread_mutex_lock(&queuemutex);
+  bool joinDecodeThread = decodeThreadIsRunning;
+  decodeThreadIsRunning = false;
+  pthread_cond_broadcast(&queuecondv);
+  pthread_mutex_unlock(&queuemutex);
+  if(joinDecodeThread)
+  {
+    pthread_join(decodeThread, NULL);
+  }
+  flushPacketQueue();
+
+  pthread_mutex_lock(&parsermutex);
   pthread_mutex_lock(&decodemutex);
 
   initSuccess = false;
@@ -130,8 +224,7 @@ void DJICameraStreamDecoder::cleanup()
 
   if (NULL != pFrameYUV)
   {
-    av_free(pFrameYUV);
-    pFrameYUV = NULL;
+    av_frame_free(&pFrameYUV);
   }
 
   if (NULL != pCodecParserCtx)
@@ -140,31 +233,61 @@ void DJICameraStreamDecoder::cleanup()
     pCodecParserCtx = NULL;
   }
 
-  if (NULL != pCodec)
+  if (NULL != pParserCodecCtx)
   {
-    avcodec_close(pCodecCtx);
-    pCodec = NULL;
+    avcodec_free_context(&pParserCodecCtx);
   }
 
   if (NULL != pCodecCtx)
   {
-    av_free(pCodecCtx);
-    pCodecCtx = NULL;
+    avcodec_free_context(&pCodecCtx);
   }
+  pCodec = NULL;
 
-  if (NULL != rgbBuf )
+  if (NULL != pFrameRGB)
   {
-    av_free(rgbBuf);
-    rgbBuf = NULL;
+    av_frame_free(&pFrameRGB);
   }
 
-  if (NULL != pFrameRGB)
+  pthread_mutex_unlock(&decodemutex);
+  pthread_mutex_unlock(&parsermutex);
+}
+
+void DJICameraStreamDecoder::setConfig(const DecoderConfig& newConfig)
+{
+  pthread_mutex_lock(&parsermutex);
+  pthread_mutex_lock(&decodemutex);
+  config = newConfig;
+  if(config.threadCount < 0)
+  {
+    config.threadCount = 0;
+  }
+  if(config.packetQueueSize < 1)
+  {
+    config.packetQueueSize = 1;
+  }
+  if(config.latencyBudgetMs < 0)
   {
-    av_free(pFrameRGB);
-    pFrameRGB = NULL;
+    config.latencyBudgetMs = 0;
   }
+  pthread_mutex_unlock(&decodemutex);
+  pthread_mutex_unlock(&parsermutex);
+}
 
+DJICameraStreamDecoder::DecoderConfig DJICameraStreamDecoder::getConfig()
+{
+  pthread_mutex_lock(&decodemutex);
+  DecoderConfig copy = config;
   pthread_mutex_unlock(&decodemutex);
+  return copy;
+}
+
+DJICameraStreamDecoder::DecoderStats DJICameraStreamDecoder::getStats()
+{
+  pthread_mutex_lock(&statsmutex);
+  DecoderStats copy = stats;
+  pthread_mutex_unlock(&statsmutex);
+  return copy;
 }
 
 void* DJICameraStreamDecoder::callbackThreadEntry(void* p)
@@ -179,16 +302,28 @@ void DJICameraStreamDecoder::callbackThreadFunc()
 {
   while(cbThreadIsRunning)
   {
-    CameraRGBImage copyOfImage;
-    if(!decodedImageHandler.getNewImageWithLock(copyOfImage, 1000))
+    CameraImageFramePtr frame;
+    if(!decodedImageHandler.getNewFrameWithLock(frame, 1000))
     {
       DDEBUG_PRIVATE("Decoder Callback Thread: Get image time out\n");
       continue;
     }
 
+    if(frameCb)
+    {
+      (*frameCb)(frame, frameCbUserParam);
+    }
+
     if(cb)
     {
-      (*cb)(copyOfImage, cbUserParam);
+      /* The legacy callback owns its image, so one copy is needed here.
+       * It is moved into the by-value parameter.
+       */
+      CameraRGBImage copyOfImage;
+      copyOfImage.rawData.assign(frame->data, frame->data + frame->size);
+      copyOfImage.height = frame->height;
+      copyOfImage.width  = frame->width;
+      (*cb)(std::move(copyOfImage), cbUserParam);
     }
   }
   DSTATUS_PRIVATE("Decoder Callback Thread Stopped...\n");
@@ -199,78 +334,349 @@ void DJICameraStreamDecoder::decodeBuffer(uint8_t* buf, int bufLen)
   uint8_t* pData   = buf;
   int remainingLen = bufLen;
   int processedLen = 0;
+  uint8_t* pktData = NULL;
+  int      pktSize = 0;
 
-  AVPacket pkt;
-  av_init_packet(&pkt);
-  pthread_mutex_lock(&decodemutex);
+  pthread_mutex_lock(&parsermutex);
   while (remainingLen > 0)
   {
-    if (!pCodecParserCtx || !pCodecCtx) {
+    if (!pCodecParserCtx || !pParserCodecCtx) {
       //DSTATUS("Invalid decoder ctx.");
       break;
     }
-    processedLen = av_parser_parse2(pCodecParserCtx, pCodecCtx,
-                                    &pkt.data, &pkt.size,
+    processedLen = av_parser_parse2(pCodecParserCtx, pParserCodecCtx,
+                                    &pktData, &pktSize,
                                     pData, remainingLen,
                                     AV_NOPTS_VALUE, AV_NOPTS_VALUE, AV_NOPTS_VALUE);
     remainingLen -= processedLen;
     pData        += processedLen;
 
-    if (pkt.size > 0)
+    if (pktSize > 0)
     {
-      int gotPicture = 0;
-      avcodec_decode_video2(pCodecCtx, pFrameYUV, &gotPicture, &pkt);
+      enqueuePacket(pktData, pktSize, pCodecParserCtx->key_frame == 1);
+    }
+  }
+  pthread_mutex_unlock(&parsermutex);
+}
 
-      if (!gotPicture)
-      {
-        //DSTATUS_PRIVATE("Got Frame, but no picture\n");
-        continue;
-      }
-      else
-      {
-        int w = pFrameYUV->width;
-        int h = pFrameYUV->height;
-        //DSTATUS_PRIVATE("Got picture! size=%dx%d\n", w, h);
+/*! @note
+ * Called with parsermutex held. The packet is copied because the parser
+ * reuses its buffer, and stamped with its arrival time in pts, which the
+ * decoder passes on to the frame.
+ */
+void DJICameraStreamDecoder::enqueuePacket(const uint8_t* data, int size, bool keyFrame)
+{
+  if(waitKeyFrame)
+  {
+    if(!keyFrame && skippedPackets < MAX_KEY_FRAME_WAIT_PACKETS)
+    {
+      skippedPackets++;
+      return;
+    }
+    waitKeyFrame = false;
+  }
 
-        if(NULL == pSwsCtx)
-        {
-          pSwsCtx = sws_getContext(w, h, pCodecCtx->pix_fmt,
-                                   w, h, AV_PIX_FMT_RGB24,
-                                   4, NULL, NULL, NULL);
-        }
+  AVPacket* pkt = av_packet_alloc();
+  if(!pkt || av_new_packet(pkt, size) < 0)
+  {
+    av_packet_free(&pkt);
+    return;
+  }
+  memcpy(pkt->data, data, size);
+  pkt->pts = getMonotonicTimeUs();
 
-        if(NULL == rgbBuf)
-        {
-          bufSize = avpicture_get_size(AV_PIX_FMT_RGB24, w, h);
-          rgbBuf = (uint8_t*) av_malloc(bufSize);
-          avpicture_fill((AVPicture*)pFrameRGB, rgbBuf, AV_PIX_FMT_RGB24, w, h);
-        }
+  uint32_t dropped = 0;
+  pthread_mutex_lock(&queuemutex);
+  if((int)packetQueue.size() >= config.packetQueueSize)
+  {
+    /* The decoder cannot keep up. Every queued frame would be late anyway,
+     * so drop them all and restart at the next key frame, or the decoder
+     * would show corrupted pictures until then.
+     */
+    dropped = packetQueue.size();
+    while(!packetQueue.empty())
+    {
+      av_packet_free(&packetQueue.front());
+      packetQueue.pop_front();
+    }
+  }
+  if(dropped && !keyFrame)
+  {
+    av_packet_free(&pkt);
+    dropped++;
+    waitKeyFrame   = true;
+    skippedPackets = 0;
+  }
+  else
+  {
+    packetQueue.push_back(pkt);
+    pthread_cond_signal(&queuecondv);
+  }
+  pthread_mutex_unlock(&queuemutex);
 
-        if(NULL != pSwsCtx && NULL != rgbBuf)
-        {
-          sws_scale(pSwsCtx,
-                    (uint8_t const *const *) pFrameYUV->data, pFrameYUV->linesize, 0, pFrameYUV->height,
-                             pFrameRGB->data, pFrameRGB->linesize);
+  if(dropped)
+  {
+    pthread_mutex_lock(&statsmutex);
+    stats.droppedPackets += dropped;
+    uint32_t total = stats.droppedPackets;
+    pthread_mutex_unlock(&statsmutex);
+    DERROR_PRIVATE("Decoder queue full, %u packets dropped\n", total);
+  }
+}
 
-          pFrameRGB->height = h;
-          pFrameRGB->width = w;
+void DJICameraStreamDecoder::flushPacketQueue()
+{
+  pthread_mutex_lock(&queuemutex);
+  while(!packetQueue.empty())
+  {
+    av_packet_free(&packetQueue.front());
+    packetQueue.pop_front();
+  }
+  pthread_mutex_unlock(&queuemutex);
+}
 
-          decodedImageHandler.writeNewImageWithLock(pFrameRGB->data[0], bufSize, w, h);
+void* DJICameraStreamDecoder::decodeThreadEntry(void* p)
+{
+  static_cast<DJICameraStreamDecoder*>(p)->decodeThreadFunc();
+  return NULL;
+}
+
+void DJICameraStreamDecoder::decodeThreadFunc()
+{
+  DSTATUS_PRIVATE("Decode thread started\n");
+  while(true)
+  {
+    pthread_mutex_lock(&queuemutex);
+    while(decodeThreadIsRunning && packetQueue.empty())
+    {
+      pthread_cond_wait(&queuecondv, &queuemutex);
+    }
+    if(!decodeThreadIsRunning)
+    {
+      pthread_mutex_unlock(&queuemutex);
+      break;
+    }
+    AVPacket* pkt = packetQueue.front();
+    packetQueue.pop_front();
+    pthread_mutex_unlock(&queuemutex);
+
+    pthread_mutex_lock(&decodemutex);
+    int ret = avcodec_send_packet(pCodecCtx, pkt);
+    while(true)
+    {
+      int got = avcodec_receive_frame(pCodecCtx, pFrameYUV);
+      if(got < 0)
+      {
+        // EAGAIN: the decoder wants more input. Resend a packet it refused
+        // now that its output has been drained.
+        if(ret == AVERROR(EAGAIN))
+        {
+          ret = avcodec_send_packet(pCodecCtx, pkt);
+          if(ret == 0)
+          {
+            continue;
+          }
         }
+        break;
       }
+      handleDecodedFrame(pFrameYUV);
+      av_frame_unref(pFrameYUV);
     }
+    pthread_mutex_unlock(&decodemutex);
+
+    if(ret < 0 && ret != AVERROR(EAGAIN))
+    {
+      DDEBUG_PRIVATE("Decoder rejected packet, error %d\n", ret);
+    }
+    av_packet_free(&pkt);
   }
-  pthread_mutex_unlock(&decodemutex);
-  av_free_packet(&pkt);
+  DSTATUS_PRIVATE("Decode thread stopped\n");
+}
+
+/*! @note
+ * Called on the decode thread with decodemutex held.
+ */
+void DJICameraStreamDecoder::handleDecodedFrame(AVFrame* decoded)
+{
+  int w = decoded->width;
+  int h = decoded->height;
+  //DSTATUS_PRIVATE("Got picture! size=%dx%d\n", w, h);
+
+  uint64_t receiveTimeUs = (decoded->pts == AV_NOPTS_VALUE) ? 0 : decoded->pts;
+  uint32_t latencyMs     = 0;
+  if(receiveTimeUs)
+  {
+    latencyMs = (getMonotonicTimeUs() - receiveTimeUs) / 1000;
+  }
+  bool late = (config.latencyBudgetMs > 0 && latencyMs > (uint32_t)config.latencyBudgetMs);
+
+  std::shared_ptr<CameraImageFrame> frame;
+  if(!late)
+  {
+    /* Convert straight into a pooled buffer. If consumers hold every
+     * buffer, wait a little for one and drop the frame otherwise.
+     */
+    CameraImageFormat format = outputFormat;
+    size_t bufSize = DJIImageConverter::getImageSize(format, w, h);
+    frame = decodedImageHandler.acquireFrameBuffer(bufSize, 20);
+    if(frame)
+    {
+      frame->height        = h;
+      frame->width         = w;
+      frame->format        = format;
+      frame->receiveTimeUs = receiveTimeUs;
+    }
+  }
+
+  pthread_mutex_lock(&statsmutex);
+  stats.lastLatencyMs = latencyMs;
+  if(latencyMs > stats.maxLatencyMs)
+  {
+    stats.maxLatencyMs = latencyMs;
+  }
+  uint32_t noBufferFrames = stats.noBufferFrames;
+  if(late)
+  {
+    stats.lateFrames++;
+  }
+  else if(!frame)
+  {
+    noBufferFrames = ++stats.noBufferFrames;
+  }
+  else
+  {
+    stats.decodedFrames++;
+  }
+  pthread_mutex_unlock(&statsmutex);
+
+  if(!late && !frame && 1 == (noBufferFrames % 100))
+  {
+    DERROR_PRIVATE("No free frame buffer, %u frames dropped\n", noBufferFrames);
+  }
+
+  if(frame && convertFrame(decoded, frame.get()))
+  {
+    decodedImageHandler.publishFrameWithLock(frame);
+  }
+}
+
+static AVPixelFormat toAVPixelFormat(CameraImageFormat format)
+{
+  switch(format)
+  {
+    case CAMERA_IMAGE_FORMAT_BGR24:   return AV_PIX_FMT_BGR24;
+    case CAMERA_IMAGE_FORMAT_YUV420P: return AV_PIX_FMT_YUV420P;
+    case CAMERA_IMAGE_FORMAT_NV12:    return AV_PIX_FMT_NV12;
+    case CAMERA_IMAGE_FORMAT_GRAY8:   return AV_PIX_FMT_GRAY8;
+    case CAMERA_IMAGE_FORMAT_RGB24:
+    default:                          return AV_PIX_FMT_RGB24;
+  }
+}
+
+/*! @note
+ * H.264 decodes to YUV420P, so the YUV and gray formats are plain plane
+ * copies and RGB/BGR use the in-tree kernel. swscale only runs for other
+ * native formats, e.g. full range YUVJ420P to RGB.
+ */
+bool DJICameraStreamDecoder::convertFrame(AVFrame* src, CameraImageFrame* dst)
+{
+  int w  = src->width;
+  int h  = src->height;
+  int cw = (w + 1) / 2;
+  int ch = (h + 1) / 2;
+  uint8_t* luma   = dst->data;
+  uint8_t* chroma = dst->data + (size_t)w * h;
+
+  bool yuv420 = (pCodecCtx->pix_fmt == AV_PIX_FMT_YUV420P ||
+                 pCodecCtx->pix_fmt == AV_PIX_FMT_YUVJ420P);
+  bool limitedRange = (pCodecCtx->pix_fmt == AV_PIX_FMT_YUV420P);
+
+  switch(dst->format)
+  {
+    case CAMERA_IMAGE_FORMAT_GRAY8:
+      if(!yuv420) break;
+      DJIImageConverter::copyPlane(src->data[0], src->linesize[0], luma, w, w, h);
+      return true;
+    case CAMERA_IMAGE_FORMAT_YUV420P:
+      if(!yuv420) break;
+      DJIImageConverter::copyPlane(src->data[0], src->linesize[0], luma, w, w, h);
+      DJIImageConverter::copyPlane(src->data[1], src->linesize[1], chroma, cw, cw, ch);
+      DJIImageConverter::copyPlane(src->data[2], src->linesize[2], chroma + (size_t)cw * ch, cw, cw, ch);
+      return true;
+    case CAMERA_IMAGE_FORMAT_NV12:
+      if(!yuv420) break;
+      DJIImageConverter::copyPlane(src->data[0], src->linesize[0], luma, w, w, h);
+      DJIImageConverter::interleaveUV(src->data[1], src->linesize[1],
+                                      src->data[2], src->linesize[2],
+                                      chroma, 2 * cw, cw, ch);
+      return true;
+    case CAMERA_IMAGE_FORMAT_RGB24:
+    case CAMERA_IMAGE_FORMAT_BGR24:
+    default:
+      if(!limitedRange) break;
+      DJIImageConverter::yuv420pToRgb24(src->data[0], src->linesize[0],
+                                        src->data[1], src->linesize[1],
+                                        src->data[2], src->linesize[2],
+                                        dst->data, 3 * w, w, h,
+                                        dst->format == CAMERA_IMAGE_FORMAT_BGR24);
+      return true;
+  }
+
+  AVPixelFormat dstFormat = toAVPixelFormat(dst->format);
+  pSwsCtx = sws_getCachedContext(pSwsCtx, w, h, pCodecCtx->pix_fmt,
+                                 w, h, dstFormat,
+                                 SWS_BICUBIC, NULL, NULL, NULL);
+  if(NULL == pSwsCtx)
+  {
+    DERROR_PRIVATE("No conversion from pixel format %d to %d\n", pCodecCtx->pix_fmt, dstFormat);
+    return false;
+  }
+
+  av_image_fill_arrays(pFrameRGB->data, pFrameRGB->linesize, dst->data, dstFormat, w, h, 1);
+  sws_scale(pSwsCtx,
+            (uint8_t const *const *) src->data, src->linesize, 0, h,
+            pFrameRGB->data, pFrameRGB->linesize);
+  pFrameRGB->height = h;
+  pFrameRGB->width = w;
+  return true;
+}
+
+bool DJICameraStreamDecoder::setOutputFormat(CameraImageFormat format)
+{
+  if(format < CAMERA_IMAGE_FORMAT_RGB24 || format > CAMERA_IMAGE_FORMAT_GRAY8)
+  {
+    DERROR_PRIVATE("Unknown output format %d\n", format);
+    return false;
+  }
+  outputFormat = format;
+  DSTATUS_PRIVATE("Decoder output format %d, colour conversion kernel %s\n",
+                  format, DJIImageConverter::getKernelName());
+  return true;
+}
+
+CameraImageFormat DJICameraStreamDecoder::getOutputFormat()
+{
+  return outputFormat;
 }
 
 bool DJICameraStreamDecoder::registerCallback(CameraImageCallback f, void *param)
 {
   cb = f;
   cbUserParam = param;
+  return updateCallbackThread();
+}
+
+bool DJICameraStreamDecoder::registerFrameCallback(CameraImageFrameCallback f, void *param)
+{
+  frameCb = f;
+  frameCbUserParam = param;
+  return updateCallbackThread();
+}
 
+bool DJICameraStreamDecoder::updateCallbackThread()
+{
   /* When users register a non-NULL callback, we will start the callback thread. */
-  if(NULL != cb)
+  if(NULL != cb || NULL != frameCb)
   {
     if(!cbThreadIsRunning)
     {
@@ -305,4 +711,3 @@ bool DJICameraStreamDecoder::registerCallback(CameraImageCallback f, void *param
     return true;
   }
 }
-
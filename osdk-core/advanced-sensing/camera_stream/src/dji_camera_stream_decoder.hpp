@@ -14,8 +14,10 @@ extern "C"{
 #include <libavcodec/avcodec.h>
 #include <libavformat/avformat.h>
 #include <libswscale/swscale.h>
+#include <libavutil/imgutils.h>
 }
 
+#include <deque>
 #include "pthread.h"
 #include "dji_camera_image.hpp"
 #include "dji_camera_image_handler.hpp"
@@ -23,6 +25,28 @@ extern "C"{
 class DJICameraStreamDecoder
 {
 public:
+  /*! @brief Decoder tuning, applied by the next init() */
+  typedef struct DecoderConfig
+  {
+    int  threadCount;     /*!< Decoder threads, 0 for one per CPU */
+    bool frameThreading;  /*!< Frame threading decodes faster but adds
+                               threadCount - 1 frames of delay. Slice
+                               threading does not delay frames. */
+    int  packetQueueSize; /*!< Packets waiting for the decode thread */
+    int  latencyBudgetMs; /*!< Frames decoded later than this after their
+                               data arrived are dropped, 0 to keep all */
+  } DecoderConfig;
+
+  typedef struct DecoderStats
+  {
+    uint32_t decodedFrames;  /*!< Frames handed to consumers */
+    uint32_t lateFrames;     /*!< Frames over the latency budget */
+    uint32_t noBufferFrames; /*!< Frames dropped for lack of a pooled buffer */
+    uint32_t droppedPackets; /*!< Packets dropped on a full queue */
+    uint32_t lastLatencyMs;  /*!< Data arrival to decoded frame */
+    uint32_t maxLatencyMs;
+  } DecoderStats;
+
   DJICameraStreamDecoder();
   ~DJICameraStreamDecoder();
   bool init();
@@ -30,14 +54,37 @@ public:
 
   bool getNewImage(CameraRGBImage & copyOfImage, int timeoutMilliSec);
 
+  bool getNewFrame(CameraImageFramePtr & frame, int timeoutMilliSec);
+
   void callbackThreadFunc();
 
+  /*! @brief Split a chunk of the H.264 stream into packets and queue them
+   *  for the decode thread. Never waits for decoding.
+   */
   void decodeBuffer(uint8_t* pBuf, int len);
 
+  void setConfig(const DecoderConfig& config);
+  DecoderConfig getConfig();
+  DecoderStats getStats();
+
   static void* callbackThreadEntry(void *p); 
 
+  static void* decodeThreadEntry(void *p);
+
   bool registerCallback(CameraImageCallback f, void* param);
 
+  /*! @brief Same as registerCallback, but the frame is handed over without
+   *  copying it. Both callbacks may be registered at the same time.
+   */
+  bool registerFrameCallback(CameraImageFrameCallback f, void* param);
+
+  /*! @brief Select the pixel layout of decoded frames, RGB24 by default.
+   *  Applies from the next decoded frame. The legacy CameraRGBImage
+   *  interfaces carry the selected layout in rawData as well.
+   */
+  bool setOutputFormat(CameraImageFormat format);
+  CameraImageFormat getOutputFormat();
+
   DJICameraImageHandler decodedImageHandler;
 
 private:
@@ -50,16 +97,48 @@ private:
   CameraImageCallback cb;
   void*               cbUserParam;
 
+  CameraImageFrameCallback frameCb;
+  void*                    frameCbUserParam;
+
+  bool updateCallbackThread();
+
+  DecoderConfig config;
+
+  pthread_t decodeThread;
+  bool      decodeThreadIsRunning;
+
+  // Reader side: the parser has its own codec context so parsing never
+  // touches the context the decode thread works on
+  pthread_mutex_t       parsermutex;
+  AVCodecContext*       pParserCodecCtx;
+  AVCodecParserContext* pCodecParserCtx;
+  bool                  waitKeyFrame;
+  uint32_t              skippedPackets;
+
+  pthread_mutex_t        queuemutex;
+  pthread_cond_t         queuecondv;
+  std::deque<AVPacket*>  packetQueue;
+
+  // Decode thread side
   pthread_mutex_t       decodemutex;
   AVCodecContext*       pCodecCtx;
   AVCodec*              pCodec;
-  AVCodecParserContext* pCodecParserCtx;
   SwsContext*           pSwsCtx;
 
+  pthread_mutex_t statsmutex;
+  DecoderStats    stats;
+
+  void decodeThreadFunc();
+  void enqueuePacket(const uint8_t* data, int size, bool keyFrame);
+  void flushPacketQueue();
+  void handleDecodedFrame(AVFrame* decoded);
+
   AVFrame* pFrameYUV;
   AVFrame* pFrameRGB;
-  uint8_t* rgbBuf;
-  size_t   bufSize;
+
+  volatile CameraImageFormat outputFormat;
+
+  bool convertFrame(AVFrame* src, CameraImageFrame* dst);
 };
 
 #endif // DJICAMERASTREAMDECODER_HH
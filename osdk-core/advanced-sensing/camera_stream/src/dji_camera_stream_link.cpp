@@ -46,6 +46,8 @@ void* monitor(void* s);
 #define UDT_SERVER_PORT_MAIN 	"40001"
 #define UDT_SERVER_PORT_FPV  	"40003"
 #define RECEIVE_SIZE   128000
+// Upper bound of a wait for data, so stop() is noticed
+#define READ_WAIT_MS   100
 
 // Helper function to free the addresses
 void freeAddresses(struct addrinfo *local, struct addrinfo *peer)
@@ -58,6 +60,8 @@ DJICameraStreamLink::DJICameraStreamLink(CameraType c)
   : camType(c),
     ip(std::string(UDT_SERVER_IP)),
     fHandle(-1),
+    epollId(-1),
+    rcvBuffer(RECEIVE_SIZE),
     threadStatus(-1),
     isRunning(false),
     cb(NULL),
@@ -72,6 +76,13 @@ DJICameraStreamLink::~DJICameraStreamLink()
   cleanup();
 }
 
+void DJICameraStreamLink::setServerAddress(const std::string& serverIp,
+                                           const std::string& serverPort)
+{
+  ip   = serverIp;
+  port = serverPort;
+}
+
 bool DJICameraStreamLink::init()
 {
   UDT::startup();
@@ -136,6 +147,25 @@ bool DJICameraStreamLink::init()
   }
 
   freeAddresses(local, peer);
+
+  /* Reads never block, the reading thread sleeps in epoll until the
+   * socket has data and then drains it.
+   */
+  static bool nonBlocking = false;
+  UDT::setsockopt(fHandle, 0, UDT_RCVSYN, &nonBlocking, sizeof(bool));
+  if(-1 == epollId)
+  {
+    epollId = UDT::epoll_create();
+  }
+  int events = UDT_EPOLL_IN | UDT_EPOLL_ERR;
+  if(epollId < 0 || UDT::ERROR == UDT::epoll_add_usock(epollId, fHandle, &events))
+  {
+    DERROR_PRIVATE("Unable to watch %s link, Error: %s\n", camNameStr.c_str(),
+                   UDT::getlasterror().getErrorMessage());
+    unInit();
+    return false;
+  }
+
   DSTATUS_PRIVATE("Connect to %s successful\n", camNameStr.c_str());
   //cout << "init successful" << endl;
   return true;
@@ -143,6 +173,11 @@ bool DJICameraStreamLink::init()
 
 void DJICameraStreamLink::unInit()
 {
+  if(-1 != epollId)
+  {
+    UDT::epoll_release(epollId);
+    epollId = -1;
+  }
   if(-1 !=fHandle)
   {
     UDT::close(fHandle);
@@ -217,32 +252,28 @@ void DJICameraStreamLink::readThreadFunc()
 
   while (isRunning)
   {
-    int rcvLen=0;
-    char rcvBuffer[RECEIVE_SIZE];
-    if (UDT::ERROR != (rcvLen = UDT::recv(fHandle, rcvBuffer, RECEIVE_SIZE, 0)))
+    UDTSOCKET readable[1];
+    int       readableNum = 1;
+    bool      timedOut    = false;
+    if (UDT::ERROR == UDT::epoll_wait2(epollId, readable, &readableNum, NULL, NULL,
+                                       READ_WAIT_MS))
+    {
+      timedOut    = (CUDTException::ETIMEOUT == UDT::getlasterror().getErrorCode());
+      readableNum = 0;
+    }
+
+    if (readableNum > 0 && drainSocket())
     {
       retryReading = 0;
-      if(rcvLen)
-      {
-        //vector<uint8_t> temp(rcvBuffer, rcvBuffer+rcvLen);
-        //cout << "push to buffer: " << rcvLen << " bytes... ";
-        //streamBufferQueue.push(temp);
-        //cout << "done!" << endl;
-        if(cb)
-        {
-          (*cb)(cbParam, reinterpret_cast<uint8_t *>(&rcvBuffer[0]), rcvLen);
-        }
-      }
-      else
-      {
-        DDEBUG_PRIVATE("Reading length 0\n");
-      }
+      continue;
     }
-    else if ((retryReading++) > 10)
+
+    if ((retryReading++) > 10)
     {
       DSTATUS_PRIVATE("Unable to read from %s lost, retry connecting ...\n", camNameStr.c_str());
 
       retryConnect = 0;
+      unInit();
       while(!init() && isRunning)
       {
         usleep(1e5);
@@ -254,14 +285,56 @@ void DJICameraStreamLink::readThreadFunc()
           return;
         }
       }
+      retryReading = 0;
+    }
+    else if (!timedOut)
+    {
+      // A broken link reports readable at once, do not spin on it
+      usleep(READ_WAIT_MS * 1000);
     }
-    usleep(2e4); //50 Hz
   }
 
   unInit();
   DSTATUS_PRIVATE("**** %s reading thread stopped\n", camNameStr.c_str());
 }
 
+/*! @note
+ * Several UDT messages are usually waiting after a wakeup. They are packed
+ * into one buffer until it is full or the socket is empty, so the decoder
+ * sees a few large chunks rather than many small ones.
+ */
+bool DJICameraStreamLink::drainSocket()
+{
+  int filled = 0;
+  int rcvLen = 0;
+
+  while (true)
+  {
+    if (RECEIVE_SIZE == filled)
+    {
+      if (cb)
+      {
+        (*cb)(cbParam, &rcvBuffer[0], filled);
+      }
+      filled = 0;
+    }
+    rcvLen = UDT::recv(fHandle, reinterpret_cast<char *>(&rcvBuffer[filled]),
+                       RECEIVE_SIZE - filled, 0);
+    if (UDT::ERROR == rcvLen || 0 == rcvLen)
+    {
+      break;
+    }
+    filled += rcvLen;
+  }
+
+  if (filled && cb)
+  {
+    (*cb)(cbParam, &rcvBuffer[0], filled);
+  }
+  return (UDT::ERROR != rcvLen ||
+          CUDTException::EASYNCRCV == UDT::getlasterror().getErrorCode());
+}
+
 void DJICameraStreamLink::registerCallback(CAMCALLBACK f, void* param)
 {
   cb = f;
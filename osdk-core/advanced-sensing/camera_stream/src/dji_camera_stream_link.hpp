@@ -12,6 +12,7 @@
 #define DJICAMERASTREAMLINK_HH
 #include "netdb.h"
 #include <string>
+#include <vector>
 #include "pthread.h"
 
 #include "dji_camera_image.hpp"
@@ -23,6 +24,9 @@ class DJICameraStreamLink
 public:
   DJICameraStreamLink(CameraType c);
   ~DJICameraStreamLink();
+  /* Connect to another address than the camera's, before init() */
+  void setServerAddress(const std::string& serverIp, const std::string& serverPort);
+
   /* Establish link to camera */
   bool init();
 
@@ -49,6 +53,10 @@ private:
   std::string ip;
   std::string port;
   int fHandle;
+  int epollId;
+
+  // Reused for every read, filled with all data available per wakeup
+  std::vector<uint8_t> rcvBuffer;
 
   pthread_t readThread;
   int       threadStatus;
@@ -63,6 +71,9 @@ private:
 
   /* real function to read data from camera */
   void readThreadFunc();
+
+  /* read everything the socket holds without blocking, false if the link is lost */
+  bool drainSocket();
 };
 
 #endif // DJICAMERASTREAMLINK_HH
@@ -0,0 +1,245 @@
+/** @file dji_image_converter.cpp
+ *  @version 4.0.0
+ *  @date Oct 2026
+ *
+ *  @brief Colour conversion kernels for decoded camera frames
+ *
+ *  @copyright 2026 DJI. All rights reserved.
+ *
+ */
+
+#include "dji_image_converter.hpp"
+#include <string.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#endif
+
+/* BT.601 limited range coefficients in 6-bit fixed point. The products fit
+ * in int16, so the SIMD kernels work on 8 pixels per register.
+ */
+static const int COEF_Y  = 74;  // 1.164
+static const int COEF_RV = 102; // 1.596
+static const int COEF_GU = 25;  // 0.392
+static const int COEF_GV = 52;  // 0.813
+static const int COEF_BU = 129; // 2.017
+
+static inline uint8_t clampShift(int value)
+{
+  value >>= 6;
+  return (value < 0) ? 0 : ((value > 255) ? 255 : value);
+}
+
+size_t DJIImageConverter::getImageSize(CameraImageFormat format, int width, int height)
+{
+  size_t lumaSize   = (size_t)width * height;
+  size_t chromaSize = (size_t)((width + 1) / 2) * ((height + 1) / 2);
+
+  switch (format)
+  {
+    case CAMERA_IMAGE_FORMAT_GRAY8:
+      return lumaSize;
+    case CAMERA_IMAGE_FORMAT_YUV420P:
+    case CAMERA_IMAGE_FORMAT_NV12:
+      return lumaSize + 2 * chromaSize;
+    case CAMERA_IMAGE_FORMAT_RGB24:
+    case CAMERA_IMAGE_FORMAT_BGR24:
+    default:
+      return lumaSize * 3;
+  }
+}
+
+void DJIImageConverter::copyPlane(const uint8_t* src, int srcStride, uint8_t* dst,
+                                  int dstStride, int rowBytes, int rows)
+{
+  if (srcStride == rowBytes && dstStride == rowBytes)
+  {
+    memcpy(dst, src, (size_t)rowBytes * rows);
+    return;
+  }
+  for (int row = 0; row < rows; ++row)
+  {
+    memcpy(dst + (size_t)row * dstStride, src + (size_t)row * srcStride, rowBytes);
+  }
+}
+
+void DJIImageConverter::interleaveUV(const uint8_t* u, int uStride, const uint8_t* v,
+                                     int vStride, uint8_t* dst, int dstStride,
+                                     int width, int height)
+{
+  for (int row = 0; row < height; ++row)
+  {
+    const uint8_t* pu = u + (size_t)row * uStride;
+    const uint8_t* pv = v + (size_t)row * vStride;
+    uint8_t*       pd = dst + (size_t)row * dstStride;
+    int            x  = 0;
+#if defined(__SSE2__)
+    for (; x + 16 <= width; x += 16)
+    {
+      __m128i u8 = _mm_loadu_si128((const __m128i*)(pu + x));
+      __m128i v8 = _mm_loadu_si128((const __m128i*)(pv + x));
+      _mm_storeu_si128((__m128i*)(pd + 2 * x), _mm_unpacklo_epi8(u8, v8));
+      _mm_storeu_si128((__m128i*)(pd + 2 * x + 16), _mm_unpackhi_epi8(u8, v8));
+    }
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+    for (; x + 16 <= width; x += 16)
+    {
+      uint8x16x2_t uv;
+      uv.val[0] = vld1q_u8(pu + x);
+      uv.val[1] = vld1q_u8(pv + x);
+      vst2q_u8(pd + 2 * x, uv);
+    }
+#endif
+    for (; x < width; ++x)
+    {
+      pd[2 * x]     = pu[x];
+      pd[2 * x + 1] = pv[x];
+    }
+  }
+}
+
+void DJIImageConverter::yuvRowToRgb24Scalar(const uint8_t* y, const uint8_t* u,
+                                            const uint8_t* v, uint8_t* dst, int from,
+                                            int width, bool bgr)
+{
+  int rIndex = bgr ? 2 : 0;
+  int bIndex = bgr ? 0 : 2;
+  for (int x = from; x < width; ++x)
+  {
+    int yy = (y[x] - 16) * COEF_Y;
+    int uu = u[x >> 1] - 128;
+    int vv = v[x >> 1] - 128;
+
+    uint8_t* px   = dst + 3 * x;
+    px[rIndex]    = clampShift(yy + COEF_RV * vv);
+    px[1]         = clampShift(yy - COEF_GU * uu - COEF_GV * vv);
+    px[bIndex]    = clampShift(yy + COEF_BU * uu);
+  }
+}
+
+void DJIImageConverter::yuv420pToRgb24(const uint8_t* y, int yStride, const uint8_t* u,
+                                       int uStride, const uint8_t* v, int vStride,
+                                       uint8_t* dst, int dstStride, int width,
+                                       int height, bool bgr)
+{
+#if defined(__SSE2__)
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i c16  = _mm_set1_epi16(16);
+  const __m128i c128 = _mm_set1_epi16(128);
+  const __m128i cy   = _mm_set1_epi16(COEF_Y);
+  const __m128i crv  = _mm_set1_epi16(COEF_RV);
+  const __m128i cgu  = _mm_set1_epi16(COEF_GU);
+  const __m128i cgv  = _mm_set1_epi16(COEF_GV);
+  const __m128i cbu  = _mm_set1_epi16(COEF_BU);
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+  const int16x8_t c16  = vdupq_n_s16(16);
+  const int16x8_t c128 = vdupq_n_s16(128);
+  const int16x8_t cy   = vdupq_n_s16(COEF_Y);
+  const int16x8_t crv  = vdupq_n_s16(COEF_RV);
+  const int16x8_t cgu  = vdupq_n_s16(COEF_GU);
+  const int16x8_t cgv  = vdupq_n_s16(COEF_GV);
+  const int16x8_t cbu  = vdupq_n_s16(COEF_BU);
+#endif
+
+  for (int row = 0; row < height; ++row)
+  {
+    const uint8_t* py = y + (size_t)row * yStride;
+    const uint8_t* pu = u + (size_t)(row >> 1) * uStride;
+    const uint8_t* pv = v + (size_t)(row >> 1) * vStride;
+    uint8_t*       pd = dst + (size_t)row * dstStride;
+    int            x  = 0;
+
+#if defined(__SSE2__)
+    /* SSE2 has no byte shuffle to build packed RGB, so 16 pixels are
+     * computed in registers and interleaved from a small buffer.
+     */
+    for (; x + 16 <= width; x += 16)
+    {
+      __m128i y8 = _mm_loadu_si128((const __m128i*)(py + x));
+      __m128i uu = _mm_sub_epi16(
+        _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i*)(pu + x / 2)), zero), c128);
+      __m128i vv = _mm_sub_epi16(
+        _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i*)(pv + x / 2)), zero), c128);
+
+      __m128i rgb[3][2];
+      for (int half = 0; half < 2; ++half)
+      {
+        // Each chroma sample covers two neighbouring pixels
+        __m128i uh = half ? _mm_unpackhi_epi16(uu, uu) : _mm_unpacklo_epi16(uu, uu);
+        __m128i vh = half ? _mm_unpackhi_epi16(vv, vv) : _mm_unpacklo_epi16(vv, vv);
+        __m128i yh = half ? _mm_unpackhi_epi8(y8, zero) : _mm_unpacklo_epi8(y8, zero);
+        __m128i yy = _mm_mullo_epi16(_mm_sub_epi16(yh, c16), cy);
+
+        rgb[0][half] = _mm_srai_epi16(
+          _mm_adds_epi16(yy, _mm_mullo_epi16(vh, crv)), 6);
+        rgb[1][half] = _mm_srai_epi16(
+          _mm_subs_epi16(yy, _mm_adds_epi16(_mm_mullo_epi16(uh, cgu),
+                                            _mm_mullo_epi16(vh, cgv))), 6);
+        rgb[2][half] = _mm_srai_epi16(
+          _mm_adds_epi16(yy, _mm_mullo_epi16(uh, cbu)), 6);
+      }
+
+      uint8_t channel[3][16];
+      for (int c = 0; c < 3; ++c)
+      {
+        _mm_storeu_si128((__m128i*)channel[c],
+                         _mm_packus_epi16(rgb[c][0], rgb[c][1]));
+      }
+      const uint8_t* first = bgr ? channel[2] : channel[0];
+      const uint8_t* last  = bgr ? channel[0] : channel[2];
+      uint8_t*       px    = pd + 3 * x;
+      for (int i = 0; i < 16; ++i)
+      {
+        px[3 * i]     = first[i];
+        px[3 * i + 1] = channel[1][i];
+        px[3 * i + 2] = last[i];
+      }
+    }
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+    for (; x + 16 <= width; x += 16)
+    {
+      uint8x16_t y8 = vld1q_u8(py + x);
+      int16x8_t  uu = vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(vld1_u8(pu + x / 2))), c128);
+      int16x8_t  vv = vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(vld1_u8(pv + x / 2))), c128);
+      // Each chroma sample covers two neighbouring pixels
+      int16x8x2_t uz = vzipq_s16(uu, uu);
+      int16x8x2_t vz = vzipq_s16(vv, vv);
+
+      uint8x8_t rgb[3][2];
+      for (int half = 0; half < 2; ++half)
+      {
+        uint8x8_t yh = half ? vget_high_u8(y8) : vget_low_u8(y8);
+        int16x8_t yy =
+          vmulq_s16(vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(yh)), c16), cy);
+        int16x8_t uh = uz.val[half];
+        int16x8_t vh = vz.val[half];
+
+        rgb[0][half] = vqshrun_n_s16(vqaddq_s16(yy, vmulq_s16(vh, crv)), 6);
+        rgb[1][half] = vqshrun_n_s16(
+          vqsubq_s16(yy, vqaddq_s16(vmulq_s16(uh, cgu), vmulq_s16(vh, cgv))), 6);
+        rgb[2][half] = vqshrun_n_s16(vqaddq_s16(yy, vmulq_s16(uh, cbu)), 6);
+      }
+
+      uint8x16x3_t px;
+      px.val[0] = vcombine_u8(rgb[bgr ? 2 : 0][0], rgb[bgr ? 2 : 0][1]);
+      px.val[1] = vcombine_u8(rgb[1][0], rgb[1][1]);
+      px.val[2] = vcombine_u8(rgb[bgr ? 0 : 2][0], rgb[bgr ? 0 : 2][1]);
+      vst3q_u8(pd + 3 * x, px);
+    }
+#endif
+    yuvRowToRgb24Scalar(py, pu, pv, pd, x, width, bgr);
+  }
+}
+
+const char* DJIImageConverter::getKernelName()
+{
+#if defined(__SSE2__)
+  return "SSE2";
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+  return "NEON";
+#else
+  return "scalar";
+#endif
+}
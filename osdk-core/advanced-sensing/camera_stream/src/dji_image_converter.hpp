@@ -0,0 +1,63 @@
+/** @file dji_image_converter.hpp
+ *  @version 4.0.0
+ *  @date Oct 2026
+ *
+ *  @brief Colour conversion kernels for decoded camera frames
+ *
+ *  @copyright 2026 DJI. All rights reserved.
+ *
+ */
+
+#ifndef DJIIMAGECONVERTER_HH
+#define DJIIMAGECONVERTER_HH
+
+#include <cstddef>
+#include <cstdint>
+#include "dji_camera_image.hpp"
+
+class DJIImageConverter
+{
+public:
+  /*!
+   * @brief Bytes needed for a tightly packed image of the given format
+   */
+  static size_t getImageSize(CameraImageFormat format, int width, int height);
+
+  /*!
+   * @brief Copy one plane into a tightly packed destination
+   */
+  static void copyPlane(const uint8_t* src, int srcStride, uint8_t* dst,
+                        int dstStride, int rowBytes, int rows);
+
+  /*!
+   * @brief Interleave the U and V planes of YUV420P into the UV plane of
+   * NV12. width and height are the chroma plane size.
+   */
+  static void interleaveUV(const uint8_t* u, int uStride, const uint8_t* v,
+                           int vStride, uint8_t* dst, int dstStride,
+                           int width, int height);
+
+  /*!
+   * @brief Convert limited range BT.601 YUV420P to packed RGB24 or BGR24
+   *
+   * @details Uses SSE2 or NEON when the compiler targets them, a scalar loop
+   * otherwise. All variants use the same 6-bit fixed point math and give
+   * identical output.
+   */
+  static void yuv420pToRgb24(const uint8_t* y, int yStride, const uint8_t* u,
+                             int uStride, const uint8_t* v, int vStride,
+                             uint8_t* dst, int dstStride, int width,
+                             int height, bool bgr);
+
+  /*!
+   * @brief Name of the kernel yuv420pToRgb24 runs, for logs
+   */
+  static const char* getKernelName();
+
+private:
+  static void yuvRowToRgb24Scalar(const uint8_t* y, const uint8_t* u,
+                                  const uint8_t* v, uint8_t* dst, int from,
+                                  int width, bool bgr);
+};
+
+#endif // DJIIMAGECONVERTER_HH
@@ -39,21 +39,71 @@ namespace OSDK
 
 #define PRO_PURE_DATA_MAX_SIZE 1007 // 2^10 - header size
 
+/*! @brief Session buffers carved from a fixed arena, no heap
+ *
+ *  @details The arena is split in MEMORY_UNIT sized units, each free block
+ *  sits on the free list of its exact size in units and freeMap tells which
+ *  lists are not empty, so the best fitting class is a bit scan or two away.
+ *  A freed block merges with free neighbours through the boundary tags, both
+ *  allocMemory and freeMemory run in constant time. Only when enough bytes
+ *  are free but split up does allocMemory slide the used blocks together
+ *  first, as the old allocator did, and moves their pmem with them.
+ */
 class MMU
 {
 public:
+  typedef struct Stats
+  {
+    uint32_t allocCount;
+    uint32_t freeCount;
+    uint32_t failCount;
+    //! Allocations that had to compact the arena first
+    uint32_t compactCount;
+    uint16_t usedBytes;
+    uint16_t peakUsedBytes;
+    uint16_t freeBytes;
+    uint16_t largestFreeBlock;
+    uint8_t  freeBlocks;
+  } Stats;
+
   MMU();
   void setupMMU(void);
   void freeMemory(MMU_Tab* mmu_tab);
   MMU_Tab* allocMemory(uint16_t size);
+  void getStats(Stats& stats) const;
 
 public:
-  static const int MMU_TABLE_NUM = 32;
-  static const int MEMORY_SIZE   = 1024;
+  static const int MMU_TABLE_NUM  = 32;
+  static const int MEMORY_SIZE    = 1024;
+  static const int MEMORY_UNIT    = 8;
+  static const int MEMORY_UNITS   = MEMORY_SIZE / MEMORY_UNIT;
+  static const int FREE_MAP_WORDS = (MEMORY_UNITS + 63) / 64;
+
+private:
+  void    insertFree(uint8_t first, uint8_t units);
+  void    removeFree(uint8_t first);
+  uint8_t findFree(uint8_t units) const;
+  void    compact(void);
 
 private:
   MMU_Tab memoryTable[MMU_TABLE_NUM];
   uint8_t memory[MEMORY_SIZE];
+
+  //! Boundary tags: size at the first unit of a block, first unit at its last
+  uint8_t blockUnits[MEMORY_UNITS];
+  uint8_t blockFirst[MEMORY_UNITS];
+  uint8_t blockFree[MEMORY_UNITS];
+
+  //! Free lists, freeHead[n] holds the blocks of n + 1 units
+  uint8_t  freeNext[MEMORY_UNITS];
+  uint8_t  freePrev[MEMORY_UNITS];
+  uint8_t  freeHead[MEMORY_UNITS];
+  uint64_t freeMap[FREE_MAP_WORDS];
+
+  uint8_t freeTab[MMU_TABLE_NUM];
+  uint8_t freeTabCount;
+
+  Stats stats;
 };
 
 } // OSDK
@@ -38,6 +38,27 @@
 
 using namespace DJI::OSDK;
 
+#define MMU_NIL 0xFF
+
+//! Block offsets and sizes in units are kept in uint8_t, MMU_NIL included
+typedef char mmu_units_fit_uint8[(MMU::MEMORY_UNITS < MMU_NIL) ? 1 : -1];
+
+static inline uint8_t
+lowestBit(uint64_t x)
+{
+#if defined(__GNUC__)
+  return (uint8_t)__builtin_ctzll(x);
+#else
+  static const uint8_t debruijn[64] = {
+    0,  1,  48, 2,  57, 49, 28, 3,  61, 58, 50, 42, 38, 29, 17, 4,
+    62, 55, 59, 36, 53, 51, 43, 22, 45, 39, 33, 30, 24, 18, 12, 5,
+    63, 47, 56, 27, 60, 41, 37, 16, 54, 35, 52, 21, 44, 32, 23, 11,
+    46, 26, 40, 15, 34, 20, 31, 10, 25, 14, 19, 9,  13, 8,  7,  6
+  };
+  return debruijn[((x & (0 - x)) * 0x03F79D71B4CB0A89ULL) >> 58];
+#endif
+}
+
 MMU::MMU()
 {
 }
@@ -46,157 +67,258 @@ void
 MMU::setupMMU()
 {
   uint32_t i;
-  memoryTable[0].tabIndex  = 0;
-  memoryTable[0].usageFlag = 1;
-  memoryTable[0].pmem      = memory;
-  memoryTable[0].memSize   = 0;
-  for (i = 1; i < (MMU_TABLE_NUM - 1); i++)
+  for (i = 0; i < MMU_TABLE_NUM; i++)
   {
     memoryTable[i].tabIndex  = i;
     memoryTable[i].usageFlag = 0;
+    memoryTable[i].memSize   = 0;
+    memoryTable[i].pmem      = (uint8_t*)0;
+    freeTab[i]               = MMU_TABLE_NUM - 1 - i;
   }
-  memoryTable[MMU_TABLE_NUM - 1].tabIndex  = MMU_TABLE_NUM - 1;
-  memoryTable[MMU_TABLE_NUM - 1].usageFlag = 1;
-  memoryTable[MMU_TABLE_NUM - 1].pmem      = memory + MEMORY_SIZE;
-  memoryTable[MMU_TABLE_NUM - 1].memSize   = 0;
+  freeTabCount = MMU_TABLE_NUM;
+
+  memset(freeHead, MMU_NIL, sizeof(freeHead));
+  memset(freeMap, 0, sizeof(freeMap));
+  insertFree(0, MEMORY_UNITS);
+
+  memset(&stats, 0, sizeof(stats));
+  stats.freeBytes = MEMORY_SIZE;
 }
 
 void
-MMU::freeMemory(MMU_Tab* mmu_tab)
+MMU::insertFree(uint8_t first, uint8_t units)
 {
-  if (mmu_tab == (MMU_Tab*)0)
-  {
-    return;
-  }
-  if (mmu_tab->tabIndex == 0 || mmu_tab->tabIndex == (MMU_TABLE_NUM - 1))
+  uint8_t sizeClass = units - 1;
+
+  blockUnits[first]             = units;
+  blockFirst[first + units - 1] = first;
+  blockFree[first]              = 1;
+
+  freePrev[first] = MMU_NIL;
+  freeNext[first] = freeHead[sizeClass];
+  if (freeHead[sizeClass] != MMU_NIL)
   {
-    return;
+    freePrev[freeHead[sizeClass]] = first;
   }
-  mmu_tab->usageFlag = 0;
+  freeHead[sizeClass] = first;
+  freeMap[sizeClass / 64] |= (uint64_t)1 << (sizeClass % 64);
 }
 
-MMU_Tab*
-MMU::allocMemory(uint16_t size)
+void
+MMU::removeFree(uint8_t first)
 {
-  uint32_t mem_used = 0;
-  uint8_t  i;
-  uint8_t  j                = 0;
-  uint8_t  mmu_tab_used_num = 0;
-  uint8_t  mmu_tab_used_index[MMU_TABLE_NUM];
+  uint8_t sizeClass = blockUnits[first] - 1;
 
-  uint32_t temp32;
-  uint32_t temp_area[2] = { 0xFFFFFFFF, 0xFFFFFFFF };
+  if (freePrev[first] != MMU_NIL)
+  {
+    freeNext[freePrev[first]] = freeNext[first];
+  }
+  else
+  {
+    freeHead[sizeClass] = freeNext[first];
+  }
+  if (freeNext[first] != MMU_NIL)
+  {
+    freePrev[freeNext[first]] = freePrev[first];
+  }
+  if (freeHead[sizeClass] == MMU_NIL)
+  {
+    freeMap[sizeClass / 64] &= ~((uint64_t)1 << (sizeClass % 64));
+  }
+  blockFree[first] = 0;
+}
 
-  uint32_t record_temp32 = 0;
-  uint8_t  magic_flag    = 0;
+//! First unit of the smallest free block of at least units, or MMU_NIL
+uint8_t
+MMU::findFree(uint8_t units) const
+{
+  uint8_t  word = (units - 1) / 64;
+  uint64_t fits = freeMap[word] & (~(uint64_t)0 << ((units - 1) % 64));
 
-  if (size > PRO_PURE_DATA_MAX_SIZE || size > MEMORY_SIZE)
+  while (fits == 0 && ++word < FREE_MAP_WORDS)
   {
-    return (MMU_Tab *) 0;
+    fits = freeMap[word];
   }
+  if (fits == 0)
+  {
+    return MMU_NIL;
+  }
+  return freeHead[word * 64 + lowestBit(fits)];
+}
+
+//! Slides every used block down to the start of the arena, leaving one free
+//! block at the top. Blocks are walked in address order through their tags.
+void
+MMU::compact()
+{
+  uint8_t owner[MEMORY_UNITS];
+  uint8_t unit;
+  uint8_t units;
+  uint8_t top = 0;
+  uint8_t i;
 
+  memset(owner, MMU_NIL, sizeof(owner));
   for (i = 0; i < MMU_TABLE_NUM; i++)
   {
-    if (memoryTable[i].usageFlag == 1)
+    if (memoryTable[i].usageFlag)
     {
-      mem_used += memoryTable[i].memSize;
-      mmu_tab_used_index[mmu_tab_used_num++] = memoryTable[i].tabIndex;
+      owner[(memoryTable[i].pmem - memory) / MEMORY_UNIT] = i;
     }
   }
 
-  if (MEMORY_SIZE < (mem_used + size))
+  for (unit = 0; unit < MEMORY_UNITS; unit += units)
   {
-    return (MMU_Tab *) 0;
+    units = blockUnits[unit];
+    if (blockFree[unit])
+    {
+      continue;
+    }
+    if (unit != top)
+    {
+      memmove(memory + top * MEMORY_UNIT, memory + unit * MEMORY_UNIT,
+              units * MEMORY_UNIT);
+      memoryTable[owner[unit]].pmem = memory + top * MEMORY_UNIT;
+    }
+    blockUnits[top]             = units;
+    blockFirst[top + units - 1] = top;
+    blockFree[top]              = 0;
+    top += units;
   }
 
-  if (mem_used == 0)
+  memset(freeHead, MMU_NIL, sizeof(freeHead));
+  memset(freeMap, 0, sizeof(freeMap));
+  if (top < MEMORY_UNITS)
   {
-    memoryTable[1].pmem      = memoryTable[0].pmem;
-    memoryTable[1].memSize   = size;
-    memoryTable[1].usageFlag = 1;
-    return &memoryTable[1];
+    insertFree(top, MEMORY_UNITS - top);
   }
+}
 
-  for (i = 0; i < (mmu_tab_used_num - 1); i++)
+void
+MMU::freeMemory(MMU_Tab* mmu_tab)
+{
+  uint8_t first;
+  uint8_t units;
+  uint8_t next;
+  uint8_t prev;
+
+  if (mmu_tab == (MMU_Tab*)0)
   {
-    for (j = 0; j < (mmu_tab_used_num - i - 1); j++)
-    {
-      if (memoryTable[mmu_tab_used_index[j]].pmem >
-          memoryTable[mmu_tab_used_index[j + 1]].pmem)
-      {
-        mmu_tab_used_index[j + 1] ^= mmu_tab_used_index[j];
-        mmu_tab_used_index[j] ^= mmu_tab_used_index[j + 1];
-        mmu_tab_used_index[j + 1] ^= mmu_tab_used_index[j];
-      }
-    }
+    return;
   }
-  for (i = 0; i < (mmu_tab_used_num - 1); i++)
+  if (mmu_tab < memoryTable || mmu_tab >= memoryTable + MMU_TABLE_NUM ||
+      mmu_tab->usageFlag == 0)
   {
-    temp32 = static_cast<uint32_t>(memoryTable[mmu_tab_used_index[i + 1]].pmem -
-                                   memoryTable[mmu_tab_used_index[i]].pmem);
+    return;
+  }
 
-    if ((temp32 - memoryTable[mmu_tab_used_index[i]].memSize) >= size)
-    {
-      if (temp_area[1] > (temp32 - memoryTable[mmu_tab_used_index[i]].memSize))
-      {
-        temp_area[0] = memoryTable[mmu_tab_used_index[i]].tabIndex;
-        temp_area[1] = temp32 - memoryTable[mmu_tab_used_index[i]].memSize;
-      }
-    }
+  first = (uint8_t)((mmu_tab->pmem - memory) / MEMORY_UNIT);
+  units = blockUnits[first];
+  stats.freeBytes += units * MEMORY_UNIT;
+  stats.freeCount++;
 
-    record_temp32 += temp32 - memoryTable[mmu_tab_used_index[i]].memSize;
-    if (record_temp32 >= size && magic_flag == 0)
+  next = first + units;
+  if (next < MEMORY_UNITS && blockFree[next])
+  {
+    units += blockUnits[next];
+    removeFree(next);
+  }
+  if (first > 0)
+  {
+    prev = blockFirst[first - 1];
+    if (blockFree[prev])
     {
-      j          = i;
-      magic_flag = 1;
+      units += blockUnits[prev];
+      removeFree(prev);
+      first = prev;
     }
   }
+  insertFree(first, units);
+
+  mmu_tab->usageFlag = 0;
+  freeTab[freeTabCount++] = mmu_tab->tabIndex;
+}
+
+MMU_Tab*
+MMU::allocMemory(uint16_t size)
+{
+  uint8_t  units;
+  uint8_t  first;
+  uint8_t  found;
+  MMU_Tab* tab;
+
+  if (size > PRO_PURE_DATA_MAX_SIZE || size > MEMORY_SIZE ||
+      freeTabCount == 0)
+  {
+    stats.failCount++;
+    return (MMU_Tab*)0;
+  }
 
-  if (temp_area[0] == 0xFFFFFFFF && temp_area[1] == 0xFFFFFFFF)
+  units = (uint8_t)((size + MEMORY_UNIT - 1) / MEMORY_UNIT);
+  if (units == 0)
   {
-    for (i = 0; i < j; i++)
+    units = 1;
+  }
+
+  first = findFree(units);
+  if (first == MMU_NIL)
+  {
+    if (stats.freeBytes < units * MEMORY_UNIT)
     {
-      if (memoryTable[mmu_tab_used_index[i + 1]].pmem >
-          (memoryTable[mmu_tab_used_index[i]].pmem +
-           memoryTable[mmu_tab_used_index[i]].memSize))
-      {
-        memmove(memoryTable[mmu_tab_used_index[i]].pmem +
-                  memoryTable[mmu_tab_used_index[i]].memSize,
-                memoryTable[mmu_tab_used_index[i + 1]].pmem,
-                memoryTable[mmu_tab_used_index[i + 1]].memSize);
-        memoryTable[mmu_tab_used_index[i + 1]].pmem =
-          memoryTable[mmu_tab_used_index[i]].pmem +
-          memoryTable[mmu_tab_used_index[i]].memSize;
-      }
+      stats.failCount++;
+      return (MMU_Tab*)0;
     }
+    //! Enough bytes free, only not in one block
+    compact();
+    stats.compactCount++;
+    first = findFree(units);
+  }
 
-    for (i = 1; i < (MMU_TABLE_NUM - 1); i++)
-    {
-      if (memoryTable[i].usageFlag == 0)
-      {
-        memoryTable[i].pmem = memoryTable[mmu_tab_used_index[j]].pmem +
-                              memoryTable[mmu_tab_used_index[j]].memSize;
+  found = blockUnits[first];
+  removeFree(first);
+  if (found > units)
+  {
+    insertFree(first + units, found - units);
+  }
+  blockUnits[first]             = units;
+  blockFirst[first + units - 1] = first;
 
-        memoryTable[i].memSize   = size;
-        memoryTable[i].usageFlag = 1;
-        return &memoryTable[i];
-      }
-    }
-    return (MMU_Tab*)0;
+  stats.allocCount++;
+  stats.freeBytes -= units * MEMORY_UNIT;
+  if (MEMORY_SIZE - stats.freeBytes > stats.peakUsedBytes)
+  {
+    stats.peakUsedBytes = MEMORY_SIZE - stats.freeBytes;
   }
 
-  for (i = 1; i < (MMU_TABLE_NUM - 1); i++)
+  tab            = &memoryTable[freeTab[--freeTabCount]];
+  tab->pmem      = memory + first * MEMORY_UNIT;
+  tab->memSize   = size;
+  tab->usageFlag = 1;
+  return tab;
+}
+
+void
+MMU::getStats(Stats& out) const
+{
+  uint8_t  sizeClass;
+  uint8_t  first;
+  uint8_t  word;
+  uint64_t map;
+
+  out                  = stats;
+  out.usedBytes        = MEMORY_SIZE - stats.freeBytes;
+  out.largestFreeBlock = 0;
+  out.freeBlocks       = 0;
+  for (word = 0; word < FREE_MAP_WORDS; word++)
   {
-    if (memoryTable[i].usageFlag == 0)
+    for (map = freeMap[word]; map; map &= map - 1)
     {
-      memoryTable[i].pmem =
-        memoryTable[temp_area[0]].pmem + memoryTable[temp_area[0]].memSize;
-
-      memoryTable[i].memSize   = size;
-      memoryTable[i].usageFlag = 1;
-      return &memoryTable[i];
+      sizeClass            = word * 64 + lowestBit(map);
+      out.largestFreeBlock = (sizeClass + 1) * MEMORY_UNIT;
+      for (first = freeHead[sizeClass]; first != MMU_NIL;
+           first = freeNext[first])
+      {
+        out.freeBlocks++;
+      }
     }
   }
-
-  return (MMU_Tab*)0;
 }
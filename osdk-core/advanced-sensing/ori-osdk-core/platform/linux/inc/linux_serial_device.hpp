@@ -56,7 +56,9 @@ namespace OSDK
 class LinuxSerialDevice : public HardDriver
 {
 public:
-  static const int BUFFER_SIZE = 2048;
+  static const int BUFFER_SIZE     = 2048;
+  //! Longest a read waits for the first byte
+  static const int READ_TIMEOUT_MS = 50;
 
 public:
   LinuxSerialDevice(const char* device, uint32_t baudrate);
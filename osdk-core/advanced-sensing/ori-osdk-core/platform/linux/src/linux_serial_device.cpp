@@ -33,6 +33,7 @@
 #include "linux_serial_device.hpp"
 #include <algorithm>
 #include <iterator>
+#include <poll.h>
 #include <sys/time.h>
 
 using namespace DJI::OSDK;
@@ -354,15 +355,24 @@ LinuxSerialDevice::_serialWrite(const uint8_t* buf, int len)
 int
 LinuxSerialDevice::_serialRead(uint8_t* buf, int len)
 {
-  int ret = -1;
+  int           ret = -1;
+  struct pollfd pfd;
 
   if (NULL == buf)
   {
     return -1;
   }
-  else
+
+  //! The fd may be non blocking, wait here so read loops do not spin
+  pfd.fd      = m_serial_fd;
+  pfd.events  = POLLIN;
+  pfd.revents = 0;
+  ret         = poll(&pfd, 1, READ_TIMEOUT_MS);
+  if (ret <= 0)
   {
-    ret = read(m_serial_fd, buf, len);
     return ret;
   }
+
+  ret = read(m_serial_fd, buf, len);
+  return ret;
 }
@@ -54,4 +54,13 @@ void aes256_done(aes256_context* ctx);
 void aes256_encrypt_ecb(aes256_context* ctx, uint8_t* buf);
 void aes256_decrypt_ecb(aes256_context* ctx, uint8_t* buf);
 
+/*! Whole-buffer ECB with a 32 byte key, on AES-NI or the ARMv8 crypto
+ *  extensions when the CPU has them and they pass a known-answer check,
+ *  on the functions above otherwise.
+ */
+void aes256_encrypt_ecb_blocks(const uint8_t* k, uint8_t* buf, uint32_t blocks);
+void aes256_decrypt_ecb_blocks(const uint8_t* k, uint8_t* buf, uint32_t blocks);
+//! "AES-NI", "ARMv8" or "software"
+const char* aes256_backend_name(void);
+
 #endif // ONBOARDSDK_AES256_H
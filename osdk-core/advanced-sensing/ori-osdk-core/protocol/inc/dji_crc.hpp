@@ -27,6 +27,9 @@
 #ifndef ONBOARDSDK_DJI_CRC_H
 #define ONBOARDSDK_DJI_CRC_H
 
+#include <stddef.h>
+#include <stdint.h>
+
 namespace DJI
 {
 namespace OSDK
@@ -176,6 +179,17 @@ const uint8_t  CRC8_INIT  = 0x77;
 const uint16_t CRC16_INIT = 0x3692;
 const uint16_t CRC_INIT   = 0x3AA3;
 
+/*! @brief CRC of a whole buffer, bit-identical to feeding it byte by byte
+ *  through crc_tab16 / crc_tab32 starting from crc.
+ *
+ *  @details Eight bytes are folded per step with slicing-by-8 tables built
+ *  from crc_tab16 / crc_tab32 on first use. On AArch64 CPUs that have the
+ *  CRC32 instructions crc32Block uses them instead, they implement the same
+ *  polynomial. The choice is made once at runtime.
+ */
+uint16_t crc16Block(uint16_t crc, const uint8_t* pMsg, size_t nLen);
+uint32_t crc32Block(uint32_t crc, const uint8_t* pMsg, size_t nLen);
+
 } // OSDK
 } // DJI
 
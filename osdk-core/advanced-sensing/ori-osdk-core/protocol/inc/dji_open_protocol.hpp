@@ -185,6 +185,11 @@ private:
   //! A lot of ACK parsing logic
   bool appHandler(void* protocolHeader);
 
+  //! Bulk receive, see ProtocolBase::scanChunk()
+  uint32_t frameLength(const uint8_t* p_head);
+  bool verifyFrame(uint8_t* p_frame, uint32_t length);
+  bool dispatchFrame(uint8_t* p_frame, uint32_t length);
+
   //! For CMD-Frame data (push data) handling
   bool recvReqData(OpenHeader* protocolHeader);
 
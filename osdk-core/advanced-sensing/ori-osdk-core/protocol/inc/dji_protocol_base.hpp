@@ -159,6 +159,30 @@ protected:
   //! helper function for buffer management
   void reuseDataStream();
 
+  /************************** Bulk Receive Pipeline *************************/
+  //! Used by readPoll() instead of steps 2 - 8 when bulk_scan is set: the
+  //! SOF is searched with memchr over the whole readall() chunk, and frames
+  //! that lie in the chunk are checked and dispatched where they are. Only a
+  //! frame cut by the end of the chunk is copied to p_filter->recvBuf.
+protected:
+  virtual bool scanChunk();
+
+  //! Total length of the frame whose header starts at p_head, 0 if the
+  //! header is not valid. HEADER_LEN bytes are readable.
+  virtual uint32_t frameLength(const uint8_t* p_head);
+
+  //! Integrity check of a complete frame
+  virtual bool verifyFrame(uint8_t* p_frame, uint32_t length);
+
+  //! Hand a verified frame to the receive pipeline, may modify it in place.
+  //! @return true if the frame was a full frame for the caller
+  virtual bool dispatchFrame(uint8_t* p_frame, uint32_t length);
+
+private:
+  uint32_t checkedFrameLength(const uint8_t* p_head);
+  bool     finishCarriedFrame();
+  void     resyncCarriedFrame(uint32_t from);
+
   /********************************** CRC **********************************/
 protected:
   virtual int crcHeadCheck(uint8_t* pMsg, size_t nLen) = 0;
@@ -217,6 +241,12 @@ protected:
   //! A flag for large data protocol to avoid checking byte by byte
   bool is_large_data_protocol;
 
+  //! A flag to scan whole chunks, needs the frameLength(), verifyFrame()
+  //! and dispatchFrame() of the protocol
+  bool    bulk_scan;
+  //! First byte of every frame header
+  uint8_t bulk_sof;
+
 }; // class ProtocolBase
 
 } // OSDK
@@ -0,0 +1,390 @@
+/** @file dji_aes_accel.cpp
+ *  @version 4.0.0
+ *  @date Oct 2026
+ *
+ *  @brief AES-256 ECB on AES-NI / ARMv8 crypto, software fallback
+ *
+ *  @Copyright (c) 2026 DJI
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#include "dji_aes.hpp"
+
+#include <string.h>
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#include <wmmintrin.h>
+#define DJI_AES_NI
+#define DJI_AES_TARGET __attribute__((target("aes,sse2")))
+#elif defined(__aarch64__) && defined(__linux__) && defined(__GNUC__)
+#include <arm_neon.h>
+#include <sys/auxv.h>
+#ifndef HWCAP_AES
+#define HWCAP_AES (1 << 3)
+#endif
+#define DJI_AES_ARMV8
+#if defined(__clang__)
+#define DJI_AES_TARGET __attribute__((target("crypto")))
+#else
+#define DJI_AES_TARGET __attribute__((target("+crypto")))
+#endif
+#endif
+
+#define AES256_ROUNDS 14
+
+typedef void (*ptr_aes256_blocks)(const uint8_t* k, uint8_t* buf,
+                                  uint32_t blocks);
+
+typedef struct tagAES256Backend
+{
+  ptr_aes256_blocks encrypt;
+  ptr_aes256_blocks decrypt;
+  const char*       name;
+} aes256_backend;
+
+/* -------------------------------------------------------------------------- */
+static void
+aes256_sw_encrypt(const uint8_t* k, uint8_t* buf, uint32_t blocks)
+{
+  aes256_context ctx;
+
+  aes256_init(&ctx, (uint8_t*)k);
+  for (; blocks; --blocks, buf += 16)
+    aes256_encrypt_ecb(&ctx, buf);
+  aes256_done(&ctx);
+} /* aes256_sw_encrypt */
+
+/* -------------------------------------------------------------------------- */
+static void
+aes256_sw_decrypt(const uint8_t* k, uint8_t* buf, uint32_t blocks)
+{
+  aes256_context ctx;
+
+  aes256_init(&ctx, (uint8_t*)k);
+  for (; blocks; --blocks, buf += 16)
+    aes256_decrypt_ecb(&ctx, buf);
+  aes256_done(&ctx);
+} /* aes256_sw_decrypt */
+
+#ifdef DJI_AES_NI
+
+/* -------------------------------------------------------------------------- */
+//! Next four words of the schedule: w ^= (w << 32) ^ (w << 64) ^ (w << 96) ^ t
+DJI_AES_TARGET static inline __m128i
+aesni_expand_step(__m128i w, __m128i t)
+{
+  w = _mm_xor_si128(w, _mm_slli_si128(w, 4));
+  w = _mm_xor_si128(w, _mm_slli_si128(w, 8));
+  return _mm_xor_si128(w, t);
+} /* aesni_expand_step */
+
+//! Round keys i and i + 1 from i - 2 and i - 1, rcon has to be an immediate
+#define AESNI_EXPAND_PAIR(key, i, rcon)                                        \
+  do                                                                           \
+  {                                                                            \
+    key[i] = aesni_expand_step(                                                \
+      key[(i)-2], _mm_shuffle_epi32(                                           \
+                    _mm_aeskeygenassist_si128(key[(i)-1], rcon), 0xff));       \
+    if ((i) < AES256_ROUNDS)                                                   \
+      key[(i) + 1] = aesni_expand_step(                                        \
+        key[(i)-1],                                                            \
+        _mm_shuffle_epi32(_mm_aeskeygenassist_si128(key[i], 0x00), 0xaa));     \
+  } while (0)
+
+/* -------------------------------------------------------------------------- */
+DJI_AES_TARGET static void
+aesni_load_keys(const uint8_t* k, __m128i key[AES256_ROUNDS + 1])
+{
+  key[0] = _mm_loadu_si128((const __m128i*)k);
+  key[1] = _mm_loadu_si128((const __m128i*)(k + 16));
+  AESNI_EXPAND_PAIR(key, 2, 0x01);
+  AESNI_EXPAND_PAIR(key, 4, 0x02);
+  AESNI_EXPAND_PAIR(key, 6, 0x04);
+  AESNI_EXPAND_PAIR(key, 8, 0x08);
+  AESNI_EXPAND_PAIR(key, 10, 0x10);
+  AESNI_EXPAND_PAIR(key, 12, 0x20);
+  AESNI_EXPAND_PAIR(key, 14, 0x40);
+} /* aesni_load_keys */
+
+/* -------------------------------------------------------------------------- */
+DJI_AES_TARGET static void
+aesni_encrypt(const uint8_t* k, uint8_t* buf, uint32_t blocks)
+{
+  __m128i key[AES256_ROUNDS + 1];
+  __m128i s0, s1, s2, s3;
+  int     r;
+
+  aesni_load_keys(k, key);
+
+  //! ECB blocks are independent, four in flight hide the aesenc latency
+  for (; blocks >= 4; blocks -= 4, buf += 64)
+  {
+    s0 = _mm_xor_si128(_mm_loadu_si128((__m128i*)buf), key[0]);
+    s1 = _mm_xor_si128(_mm_loadu_si128((__m128i*)(buf + 16)), key[0]);
+    s2 = _mm_xor_si128(_mm_loadu_si128((__m128i*)(buf + 32)), key[0]);
+    s3 = _mm_xor_si128(_mm_loadu_si128((__m128i*)(buf + 48)), key[0]);
+    for (r = 1; r < AES256_ROUNDS; ++r)
+    {
+      s0 = _mm_aesenc_si128(s0, key[r]);
+      s1 = _mm_aesenc_si128(s1, key[r]);
+      s2 = _mm_aesenc_si128(s2, key[r]);
+      s3 = _mm_aesenc_si128(s3, key[r]);
+    }
+    _mm_storeu_si128((__m128i*)buf,
+                     _mm_aesenclast_si128(s0, key[AES256_ROUNDS]));
+    _mm_storeu_si128((__m128i*)(buf + 16),
+                     _mm_aesenclast_si128(s1, key[AES256_ROUNDS]));
+    _mm_storeu_si128((__m128i*)(buf + 32),
+                     _mm_aesenclast_si128(s2, key[AES256_ROUNDS]));
+    _mm_storeu_si128((__m128i*)(buf + 48),
+                     _mm_aesenclast_si128(s3, key[AES256_ROUNDS]));
+  }
+  for (; blocks; --blocks, buf += 16)
+  {
+    s0 = _mm_xor_si128(_mm_loadu_si128((__m128i*)buf), key[0]);
+    for (r = 1; r < AES256_ROUNDS; ++r)
+      s0 = _mm_aesenc_si128(s0, key[r]);
+    _mm_storeu_si128((__m128i*)buf,
+                     _mm_aesenclast_si128(s0, key[AES256_ROUNDS]));
+  }
+  memset(key, 0, sizeof(key));
+} /* aesni_encrypt */
+
+/* -------------------------------------------------------------------------- */
+DJI_AES_TARGET static void
+aesni_decrypt(const uint8_t* k, uint8_t* buf, uint32_t blocks)
+{
+  __m128i key[AES256_ROUNDS + 1];
+  __m128i s0, s1, s2, s3;
+  int     r;
+
+  //! Equivalent inverse cipher: reversed keys, inner ones InvMixColumn'ed
+  aesni_load_keys(k, key);
+  for (r = 0; r < AES256_ROUNDS / 2; ++r)
+  {
+    s0                     = key[r];
+    key[r]                 = key[AES256_ROUNDS - r];
+    key[AES256_ROUNDS - r] = s0;
+  }
+  for (r = 1; r < AES256_ROUNDS; ++r)
+    key[r] = _mm_aesimc_si128(key[r]);
+
+  for (; blocks >= 4; blocks -= 4, buf += 64)
+  {
+    s0 = _mm_xor_si128(_mm_loadu_si128((__m128i*)buf), key[0]);
+    s1 = _mm_xor_si128(_mm_loadu_si128((__m128i*)(buf + 16)), key[0]);
+    s2 = _mm_xor_si128(_mm_loadu_si128((__m128i*)(buf + 32)), key[0]);
+    s3 = _mm_xor_si128(_mm_loadu_si128((__m128i*)(buf + 48)), key[0]);
+    for (r = 1; r < AES256_ROUNDS; ++r)
+    {
+      s0 = _mm_aesdec_si128(s0, key[r]);
+      s1 = _mm_aesdec_si128(s1, key[r]);
+      s2 = _mm_aesdec_si128(s2, key[r]);
+      s3 = _mm_aesdec_si128(s3, key[r]);
+    }
+    _mm_storeu_si128((__m128i*)buf,
+                     _mm_aesdeclast_si128(s0, key[AES256_ROUNDS]));
+    _mm_storeu_si128((__m128i*)(buf + 16),
+                     _mm_aesdeclast_si128(s1, key[AES256_ROUNDS]));
+    _mm_storeu_si128((__m128i*)(buf + 32),
+                     _mm_aesdeclast_si128(s2, key[AES256_ROUNDS]));
+    _mm_storeu_si128((__m128i*)(buf + 48),
+                     _mm_aesdeclast_si128(s3, key[AES256_ROUNDS]));
+  }
+  for (; blocks; --blocks, buf += 16)
+  {
+    s0 = _mm_xor_si128(_mm_loadu_si128((__m128i*)buf), key[0]);
+    for (r = 1; r < AES256_ROUNDS; ++r)
+      s0 = _mm_aesdec_si128(s0, key[r]);
+    _mm_storeu_si128((__m128i*)buf,
+                     _mm_aesdeclast_si128(s0, key[AES256_ROUNDS]));
+  }
+  memset(key, 0, sizeof(key));
+} /* aesni_decrypt */
+
+#endif // DJI_AES_NI
+
+#ifdef DJI_AES_ARMV8
+
+/* -------------------------------------------------------------------------- */
+//! Encryption round keys, each aes_expandEncKey step yields two of them
+static void
+aes256_round_keys(const uint8_t* k, uint8_t rk[AES256_ROUNDS + 1][16])
+{
+  uint8_t key[32];
+  uint8_t rcon = 1;
+  int     i;
+
+  memcpy(key, k, sizeof(key));
+  memcpy(rk[0], key, 16);
+  memcpy(rk[1], key + 16, 16);
+  for (i = 2; i <= AES256_ROUNDS; i += 2)
+  {
+    aes_expandEncKey(key, &rcon);
+    memcpy(rk[i], key, 16);
+    if (i < AES256_ROUNDS)
+      memcpy(rk[i + 1], key + 16, 16);
+  }
+  memset(key, 0, sizeof(key));
+} /* aes256_round_keys */
+
+/* -------------------------------------------------------------------------- */
+DJI_AES_TARGET static void
+armv8_encrypt(const uint8_t* k, uint8_t* buf, uint32_t blocks)
+{
+  uint8_t    rk[AES256_ROUNDS + 1][16];
+  uint8x16_t key[AES256_ROUNDS + 1];
+  uint8x16_t s;
+  int        r;
+
+  aes256_round_keys(k, rk);
+  for (r = 0; r <= AES256_ROUNDS; ++r)
+    key[r] = vld1q_u8(rk[r]);
+  memset(rk, 0, sizeof(rk));
+
+  //! AESE is AddRoundKey + SubBytes + ShiftRows, the last key is a plain xor
+  for (; blocks; --blocks, buf += 16)
+  {
+    s = vld1q_u8(buf);
+    for (r = 0; r < AES256_ROUNDS - 1; ++r)
+      s = vaesmcq_u8(vaeseq_u8(s, key[r]));
+    s = vaeseq_u8(s, key[AES256_ROUNDS - 1]);
+    vst1q_u8(buf, veorq_u8(s, key[AES256_ROUNDS]));
+  }
+  memset(key, 0, sizeof(key));
+} /* armv8_encrypt */
+
+/* -------------------------------------------------------------------------- */
+DJI_AES_TARGET static void
+armv8_decrypt(const uint8_t* k, uint8_t* buf, uint32_t blocks)
+{
+  uint8_t    rk[AES256_ROUNDS + 1][16];
+  uint8x16_t key[AES256_ROUNDS + 1];
+  uint8x16_t s;
+  int        r;
+
+  //! Equivalent inverse cipher: reversed keys, inner ones InvMixColumn'ed
+  aes256_round_keys(k, rk);
+  key[0]             = vld1q_u8(rk[AES256_ROUNDS]);
+  key[AES256_ROUNDS] = vld1q_u8(rk[0]);
+  for (r = 1; r < AES256_ROUNDS; ++r)
+    key[r] = vaesimcq_u8(vld1q_u8(rk[AES256_ROUNDS - r]));
+  memset(rk, 0, sizeof(rk));
+
+  for (; blocks; --blocks, buf += 16)
+  {
+    s = vld1q_u8(buf);
+    for (r = 0; r < AES256_ROUNDS - 1; ++r)
+      s = vaesimcq_u8(vaesdq_u8(s, key[r]));
+    s = vaesdq_u8(s, key[AES256_ROUNDS - 1]);
+    vst1q_u8(buf, veorq_u8(s, key[AES256_ROUNDS]));
+  }
+  memset(key, 0, sizeof(key));
+} /* armv8_decrypt */
+
+#endif // DJI_AES_ARMV8
+
+/* -------------------------------------------------------------------------- */
+//! FIPS-197 appendix C.3, a backend that gets it wrong is not used
+static int
+aes256_known_answer(const aes256_backend* b)
+{
+  static const uint8_t plain[16] = { 0x00, 0x11, 0x22, 0x33, 0x44, 0x55,
+                                     0x66, 0x77, 0x88, 0x99, 0xaa, 0xbb,
+                                     0xcc, 0xdd, 0xee, 0xff };
+  static const uint8_t cipher[16] = { 0x8e, 0xa2, 0xb7, 0xca, 0x51, 0x67,
+                                      0x45, 0xbf, 0xea, 0xfc, 0x49, 0x90,
+                                      0x4b, 0x49, 0x60, 0x89 };
+  uint8_t key[32];
+  uint8_t buf[5 * 16];
+  int     i;
+
+  for (i = 0; i < 32; ++i)
+    key[i] = (uint8_t)i;
+  //! five blocks cover both the interleaved and the single block loop
+  for (i = 0; i < 5; ++i)
+    memcpy(buf + 16 * i, plain, 16);
+
+  b->encrypt(key, buf, 5);
+  for (i = 0; i < 5; ++i)
+    if (memcmp(buf + 16 * i, cipher, 16) != 0)
+      return 0;
+  b->decrypt(key, buf, 5);
+  for (i = 0; i < 5; ++i)
+    if (memcmp(buf + 16 * i, plain, 16) != 0)
+      return 0;
+  return 1;
+} /* aes256_known_answer */
+
+/* -------------------------------------------------------------------------- */
+static aes256_backend
+aes256_select_backend(void)
+{
+  aes256_backend b = { aes256_sw_encrypt, aes256_sw_decrypt, "software" };
+
+#ifdef DJI_AES_NI
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("aes"))
+  {
+    aes256_backend hw = { aesni_encrypt, aesni_decrypt, "AES-NI" };
+    if (aes256_known_answer(&hw))
+      b = hw;
+  }
+#endif
+#ifdef DJI_AES_ARMV8
+  if (getauxval(AT_HWCAP) & HWCAP_AES)
+  {
+    aes256_backend hw = { armv8_encrypt, armv8_decrypt, "ARMv8" };
+    if (aes256_known_answer(&hw))
+      b = hw;
+  }
+#endif
+  return b;
+} /* aes256_select_backend */
+
+/* -------------------------------------------------------------------------- */
+static const aes256_backend&
+aes256_get_backend(void)
+{
+  static const aes256_backend backend = aes256_select_backend();
+  return backend;
+} /* aes256_get_backend */
+
+/* -------------------------------------------------------------------------- */
+void
+aes256_encrypt_ecb_blocks(const uint8_t* k, uint8_t* buf, uint32_t blocks)
+{
+  aes256_get_backend().encrypt(k, buf, blocks);
+} /* aes256_encrypt_ecb_blocks */
+
+/* -------------------------------------------------------------------------- */
+void
+aes256_decrypt_ecb_blocks(const uint8_t* k, uint8_t* buf, uint32_t blocks)
+{
+  aes256_get_backend().decrypt(k, buf, blocks);
+} /* aes256_decrypt_ecb_blocks */
+
+/* -------------------------------------------------------------------------- */
+const char*
+aes256_backend_name(void)
+{
+  return aes256_get_backend().name;
+} /* aes256_backend_name */
@@ -0,0 +1,167 @@
+/** @file dji_crc.cpp
+ *  @version 4.0.0
+ *  @date Oct 2026
+ *
+ *  @brief Block CRC16 / CRC32 kernels for the open protocol framing
+ *
+ *  @Copyright (c) 2026 DJI
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#include "dji_crc.hpp"
+
+#include <string.h>
+
+#if defined(__aarch64__) && defined(__linux__) && \
+  (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+#include <arm_acle.h>
+#include <sys/auxv.h>
+#ifndef HWCAP_CRC32
+#define HWCAP_CRC32 (1 << 7)
+#endif
+#define DJI_CRC32_ARMV8
+#if defined(__clang__)
+#define DJI_CRC32_TARGET __attribute__((target("crc")))
+#else
+#define DJI_CRC32_TARGET __attribute__((target("+crc")))
+#endif
+#endif
+
+using namespace DJI::OSDK;
+
+namespace
+{
+
+//! table[0] is the byte table, table[k] advances a byte k more positions
+template <typename T>
+struct SliceTables
+{
+  T table[8][256];
+
+  explicit SliceTables(const T* byteTable)
+  {
+    for (int i = 0; i < 256; ++i)
+    {
+      table[0][i] = byteTable[i];
+    }
+    for (int k = 1; k < 8; ++k)
+    {
+      for (int i = 0; i < 256; ++i)
+      {
+        T prev      = table[k - 1][i];
+        table[k][i] = (prev >> 8) ^ table[0][prev & 0xff];
+      }
+    }
+  }
+};
+
+const SliceTables<uint16_t>&
+crc16Tables()
+{
+  static const SliceTables<uint16_t> tables(crc_tab16);
+  return tables;
+}
+
+const SliceTables<uint32_t>&
+crc32Tables()
+{
+  static const SliceTables<uint32_t> tables(crc_tab32);
+  return tables;
+}
+
+uint32_t
+crc32Slice8(uint32_t crc, const uint8_t* p, size_t n)
+{
+  const uint32_t(*t)[256] = crc32Tables().table;
+
+  for (; n >= 8; n -= 8, p += 8)
+  {
+    uint32_t lo = crc ^ ((uint32_t)p[0] | (uint32_t)p[1] << 8 |
+                         (uint32_t)p[2] << 16 | (uint32_t)p[3] << 24);
+    crc = t[7][lo & 0xff] ^ t[6][(lo >> 8) & 0xff] ^ t[5][(lo >> 16) & 0xff] ^
+          t[4][lo >> 24] ^ t[3][p[4]] ^ t[2][p[5]] ^ t[1][p[6]] ^ t[0][p[7]];
+  }
+  for (; n; --n, ++p)
+  {
+    crc = (crc >> 8) ^ t[0][(crc ^ *p) & 0xff];
+  }
+  return crc;
+}
+
+#ifdef DJI_CRC32_ARMV8
+DJI_CRC32_TARGET uint32_t
+crc32Armv8(uint32_t crc, const uint8_t* p, size_t n)
+{
+  for (; n >= 8; n -= 8, p += 8)
+  {
+    uint64_t v;
+    memcpy(&v, p, sizeof(v));
+    crc = __crc32d(crc, v);
+  }
+  for (; n; --n, ++p)
+  {
+    crc = __crc32b(crc, *p);
+  }
+  return crc;
+}
+#endif
+
+typedef uint32_t (*Crc32Kernel)(uint32_t crc, const uint8_t* p, size_t n);
+
+Crc32Kernel
+selectCrc32Kernel()
+{
+#ifdef DJI_CRC32_ARMV8
+  if (getauxval(AT_HWCAP) & HWCAP_CRC32)
+  {
+    return crc32Armv8;
+  }
+#endif
+  return crc32Slice8;
+}
+
+} // namespace
+
+uint16_t
+DJI::OSDK::crc16Block(uint16_t crc, const uint8_t* pMsg, size_t nLen)
+{
+  const uint16_t(*t)[256] = crc16Tables().table;
+
+  //! The state is two bytes wide, only those mix with it
+  for (; nLen >= 8; nLen -= 8, pMsg += 8)
+  {
+    uint16_t lo = crc ^ ((uint16_t)pMsg[0] | (uint16_t)pMsg[1] << 8);
+    crc = t[7][lo & 0xff] ^ t[6][lo >> 8] ^ t[5][pMsg[2]] ^ t[4][pMsg[3]] ^
+          t[3][pMsg[4]] ^ t[2][pMsg[5]] ^ t[1][pMsg[6]] ^ t[0][pMsg[7]];
+  }
+  for (; nLen; --nLen, ++pMsg)
+  {
+    crc = (crc >> 8) ^ t[0][(crc ^ *pMsg) & 0xff];
+  }
+  return crc;
+}
+
+uint32_t
+DJI::OSDK::crc32Block(uint32_t crc, const uint8_t* pMsg, size_t nLen)
+{
+  static const Crc32Kernel kernel = selectCrc32Kernel();
+  return kernel(crc, pMsg, nLen);
+}
@@ -87,6 +87,9 @@ OpenProtocol::init(HardDriver* sDevice, MMU* mmuPtr, bool userCallbackThread)
   p_filter->encode     = 0;
   p_filter->recvBuf    = new uint8_t[MAX_RECV_LEN];
 
+  bulk_scan = true;
+  bulk_sof  = OpenProtocol::SOF;
+
   buf             = new uint8_t[BUFFER_SIZE];
   encodeSendData  = new uint8_t[BUFFER_SIZE];
 
@@ -171,6 +174,7 @@ OpenProtocol::freeSession(CMDSession* session)
   {
     DDEBUG("session id %d\n", session->sessionID);
     mmu->freeMemory(session->mmu);
+    session->mmu       = (MMU_Tab*)NULL;
     session->usageFlag = 0;
   }
 }
@@ -202,7 +206,9 @@ OpenProtocol::allocACK(uint16_t session_id, uint16_t size)
 void
 OpenProtocol::freeACK(ACKSession* session)
 {
+  //! The tab goes back to the pool, a second free would hit its next owner
   mmu->freeMemory(session->mmu);
+  session->mmu = (MMU_Tab*)NULL;
 }
 
 /******************** Send Pipeline **********************/
@@ -599,6 +605,45 @@ OpenProtocol::callApp()
   return isFrame;
 }
 
+uint32_t
+OpenProtocol::frameLength(const uint8_t* p_head)
+{
+  OpenHeader* p_open = (OpenHeader*)p_head;
+
+  //! Same checks as verifyHead()
+  if ((p_open->sof != OpenProtocol::SOF) || (p_open->version != 0) ||
+      (p_open->length >= OpenProtocol::MAX_RECV_LEN) ||
+      (p_open->reserved0 != 0) || (p_open->reserved1 != 0) ||
+      (crcHeadCheck((uint8_t*)p_open, sizeof(OpenHeader)) != 0))
+  {
+    return 0;
+  }
+  //! Frames with data always carry the CRC32
+  if ((p_open->length > sizeof(OpenHeader)) &&
+      (p_open->length < OpenProtocol::PackageMin))
+  {
+    return 0;
+  }
+  return p_open->length;
+}
+
+bool
+OpenProtocol::verifyFrame(uint8_t* p_frame, uint32_t length)
+{
+  if (length == sizeof(OpenHeader))
+  {
+    return true;
+  }
+  return crcTailCheck(p_frame, length) == 0;
+}
+
+bool
+OpenProtocol::dispatchFrame(uint8_t* p_frame, uint32_t length)
+{
+  encodeData((OpenHeader*)p_frame, aes256_decrypt_ecb);
+  return appHandler((OpenHeader*)p_frame);
+}
+
 //! Step 9
 bool
 OpenProtocol::appHandler(void* protocolHeader)
@@ -882,29 +927,13 @@ OpenProtocol::crc32Update(uint32_t crc, uint8_t ch)
 uint16_t
 OpenProtocol::crc16Calc(const uint8_t* pMsg, size_t nLen)
 {
-  size_t   i;
-  uint16_t wCRC = CRC_INIT;
-
-  for (i = 0; i < nLen; i++)
-  {
-    wCRC = crc16Update(wCRC, pMsg[i]);
-  }
-
-  return wCRC;
+  return crc16Block(CRC_INIT, pMsg, nLen);
 }
 
 uint32_t
 OpenProtocol::crc32Calc(const uint8_t* pMsg, size_t nLen)
 {
-  size_t   i;
-  uint32_t wCRC = CRC_INIT;
-
-  for (i = 0; i < nLen; i++)
-  {
-    wCRC = crc32Update(wCRC, pMsg[i]);
-  }
-
-  return wCRC;
+  return crc32Block(CRC_INIT, pMsg, nLen);
 }
 
 /******************* Encryption *********************/
@@ -912,12 +941,9 @@ OpenProtocol::crc32Calc(const uint8_t* pMsg, size_t nLen)
 void
 OpenProtocol::encodeData(OpenHeader* p_head, ptr_aes256_codec codec_func)
 {
-  aes256_context ctx;
-  uint32_t       buf_i;
-  uint32_t       loop_blk;
-  uint32_t       data_len;
-  uint32_t       data_idx;
-  uint8_t*       data_ptr;
+  uint32_t loop_blk;
+  uint32_t data_len;
+  uint8_t* data_ptr;
 
   if (p_head->enc == 0)
     return;
@@ -928,15 +954,12 @@ OpenProtocol::encodeData(OpenHeader* p_head, ptr_aes256_codec codec_func)
   data_len = p_head->length - OpenProtocol::PackageMin;
 
   loop_blk = data_len / 16;
-  data_idx = 0;
 
-  aes256_init(&ctx, p_filter->sdkKey);
-  for (buf_i = 0; buf_i < loop_blk; buf_i++)
-  {
-    codec_func(&ctx, data_ptr + data_idx);
-    data_idx += 16;
-  }
-  aes256_done(&ctx);
+  //! Whole frame in one call, the hardware backend keeps blocks in flight
+  if (codec_func == aes256_decrypt_ecb)
+    aes256_decrypt_ecb_blocks(p_filter->sdkKey, data_ptr, loop_blk);
+  else
+    aes256_encrypt_ecb_blocks(p_filter->sdkKey, data_ptr, loop_blk);
 
   if (codec_func == aes256_decrypt_ecb)
     p_head->length = p_head->length - p_head->padding; // minus padding length;
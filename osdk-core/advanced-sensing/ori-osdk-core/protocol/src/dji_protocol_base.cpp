@@ -35,6 +35,8 @@ using namespace DJI::OSDK;
 ProtocolBase::ProtocolBase()
   : reuse_buffer(true)
   , is_large_data_protocol(false)
+  , bulk_scan(false)
+  , bulk_sof(0)
   , BUFFER_SIZE(1024)
 {
 }
@@ -84,6 +86,11 @@ ProtocolBase::readPoll()
   totalRead += onceRead;
 #endif // API_BUFFER_DATA
 
+  if (bulk_scan)
+  {
+    return scanChunk();
+  }
+
   //! Step 2:
   //! For large data protocol, store the value and only verify the header
   //! For small data protocol, Go through the buffer and return when you
@@ -262,6 +269,193 @@ ProtocolBase::reuseDataStream()
   p_filter->reuseCount++;
 }
 
+/******************** Bulk Receive Pipeline **********************/
+
+bool
+ProtocolBase::scanChunk()
+{
+  //! readall failed or timed out, a carried frame waits for the next chunk
+  if (this->read_len <= 0)
+  {
+    this->read_len     = 0;
+    this->buf_read_pos = 0;
+    return false;
+  }
+
+  //! Step 1: A frame cut by the end of the last chunk goes on here
+  if (p_filter->recvIndex && finishCarriedFrame())
+  {
+    return true;
+  }
+
+  //! Step 2: Frames that lie in the chunk are used where they are
+  while (this->buf_read_pos < this->read_len)
+  {
+    uint8_t* p_sof = (uint8_t*)memchr(this->buf + this->buf_read_pos, bulk_sof,
+                                      this->read_len - this->buf_read_pos);
+    if (!p_sof)
+    {
+      this->buf_read_pos = this->read_len;
+      break;
+    }
+    this->buf_read_pos = p_sof - this->buf;
+
+    uint32_t avail  = this->read_len - this->buf_read_pos;
+    uint32_t length = (avail >= HEADER_LEN) ? checkedFrameLength(p_sof) : 0;
+    if ((avail < HEADER_LEN) || (length && (avail < length)))
+    {
+      //! Step 3: Keep the start of a frame for the next chunk
+      memcpy(p_filter->recvBuf, p_sof, avail);
+      p_filter->recvIndex = avail;
+      this->buf_read_pos  = this->read_len;
+      break;
+    }
+
+    if (!length || !verifyFrame(p_sof, length))
+    {
+      //! Not a frame, look for the next SOF after this one
+      this->buf_read_pos++;
+      continue;
+    }
+
+    this->buf_read_pos += length;
+    if (dispatchFrame(p_sof, length))
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+//! Takes bytes from the chunk until the carried frame is complete
+//! @return true if a frame was dispatched
+bool
+ProtocolBase::finishCarriedFrame()
+{
+  while (p_filter->recvIndex)
+  {
+    if (p_filter->recvBuf[0] != bulk_sof)
+    {
+      resyncCarriedFrame(0);
+      continue;
+    }
+
+    uint32_t need = HEADER_LEN;
+    if (p_filter->recvIndex >= HEADER_LEN)
+    {
+      need = checkedFrameLength(p_filter->recvBuf);
+      if (!need)
+      {
+        resyncCarriedFrame(1);
+        continue;
+      }
+    }
+
+    if (p_filter->recvIndex < need)
+    {
+      int      avail = this->read_len - this->buf_read_pos;
+      uint32_t count = need - p_filter->recvIndex;
+      if (avail <= 0)
+      {
+        return false;
+      }
+      if (count > (uint32_t)avail)
+      {
+        count = avail;
+      }
+      memcpy(p_filter->recvBuf + p_filter->recvIndex,
+             this->buf + this->buf_read_pos, count);
+      p_filter->recvIndex += count;
+      this->buf_read_pos += count;
+      if (p_filter->recvIndex < need)
+      {
+        return false;
+      }
+      //! Either the header is complete now or the whole frame
+      continue;
+    }
+
+    if (!verifyFrame(p_filter->recvBuf, need))
+    {
+      resyncCarriedFrame(1);
+      continue;
+    }
+
+    //! After a resync the buffer may hold bytes past the frame. They are
+    //! moved to the receive buffer in use after the dispatch, which may be
+    //! a fresh one.
+    uint8_t* p_frame  = p_filter->recvBuf;
+    uint32_t leftover = p_filter->recvIndex - need;
+    p_filter->recvIndex = 0;
+    bool isFrame = dispatchFrame(p_frame, need);
+    if (leftover)
+    {
+      memmove(p_filter->recvBuf, p_frame + need, leftover);
+      p_filter->recvIndex = leftover;
+    }
+    if (isFrame)
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+//! Drops the carried bytes before the next possible frame start at or after
+//! from. Candidates are checked in place, the bytes are moved only once.
+void
+ProtocolBase::resyncCarriedFrame(uint32_t from)
+{
+  uint8_t* p_end = p_filter->recvBuf + p_filter->recvIndex;
+  uint8_t* p_sof = p_filter->recvBuf + from;
+  while ((p_sof < p_end) &&
+         (p_sof = (uint8_t*)memchr(p_sof, bulk_sof, p_end - p_sof)))
+  {
+    if ((p_end - p_sof < HEADER_LEN) || checkedFrameLength(p_sof))
+    {
+      break;
+    }
+    p_sof++;
+  }
+  if (!p_sof || (p_sof >= p_end))
+  {
+    p_filter->recvIndex = 0;
+    return;
+  }
+  uint32_t skip = p_sof - p_filter->recvBuf;
+  p_filter->recvIndex -= skip;
+  memmove(p_filter->recvBuf, p_sof, p_filter->recvIndex);
+}
+
+uint32_t
+ProtocolBase::checkedFrameLength(const uint8_t* p_head)
+{
+  uint32_t length = frameLength(p_head);
+  if ((length < HEADER_LEN) || (length > (uint32_t)MAX_RECV_LEN))
+  {
+    return 0;
+  }
+  return length;
+}
+
+uint32_t
+ProtocolBase::frameLength(const uint8_t* p_head)
+{
+  return 0;
+}
+
+bool
+ProtocolBase::verifyFrame(uint8_t* p_frame, uint32_t length)
+{
+  return true;
+}
+
+bool
+ProtocolBase::dispatchFrame(uint8_t* p_frame, uint32_t length)
+{
+  return false;
+}
+
 HardDriver*
 ProtocolBase::getDriver() const
 {
@@ -0,0 +1,76 @@
+/*! @file linux_usb_bulk_reader.h
+ *  @version 4.0.0
+ *  @date Oct 2026
+ *
+ *  @brief Bulk IN reader keeping several libusb transfers in flight
+ *
+ *  @Copyright (c) 2026 DJI.
+ *  NOTE THAT this file is part of the advanced sensing
+ *  closed-source library. For licensing information,
+ *  please visit https://developer.dji.com/policies/eula/
+ * */
+
+#ifndef ONBOARDSDK_LINUX_USB_BULK_READER_H
+#define ONBOARDSDK_LINUX_USB_BULK_READER_H
+
+#include <stdint.h>
+#include <libusb.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*! A synchronous bulk read leaves the endpoint idle from the moment it
+ *  completes until the caller asks again. The reader keeps queueDepth
+ *  transfers submitted instead, completes them on its own event thread and
+ *  resubmits each buffer once the caller has consumed it. When the caller
+ *  falls behind, all transfers end up waiting to be read and the device is
+ *  throttled by USB flow control, nothing is dropped.
+ */
+typedef struct T_UsbBulkReader T_UsbBulkReader;
+
+typedef struct {
+  uint64_t totalBytes;         /*!< Bytes handed to the caller */
+  uint32_t completedTransfers;
+  uint32_t failedTransfers;
+  uint32_t inFlight;           /*!< Transfers submitted right now */
+  uint32_t ready;              /*!< Completed transfers not read yet */
+  uint32_t bytesPerSecond;     /*!< Over the last full second */
+  uint32_t lastLatencyUs;      /*!< Transfer completion to read */
+  uint32_t maxLatencyUs;
+} T_UsbBulkReaderStats;
+
+/*!
+ * @brief Start reading endpoint with queueDepth transfers of transferSize
+ * bytes. libusb events of the default context are handled on a thread
+ * owned by the reader.
+ * @return NULL if no transfer could be submitted
+ */
+T_UsbBulkReader *UsbBulkReader_Create(libusb_device_handle *handle,
+                                      uint8_t endpoint, int queueDepth,
+                                      int transferSize);
+
+/*!
+ * @brief Copy the oldest received data into buf. Returns at most the rest
+ * of one transfer, so data is split the same way a synchronous transfer of
+ * transferSize bytes would split it. Only one thread may read.
+ * @param timeoutMs: -1 to wait forever
+ * @return bytes copied, LIBUSB_ERROR_TIMEOUT or LIBUSB_ERROR_NO_DEVICE
+ */
+int UsbBulkReader_Read(T_UsbBulkReader *reader, uint8_t *buf, uint32_t len,
+                       int timeoutMs);
+
+void UsbBulkReader_GetStats(T_UsbBulkReader *reader,
+                            T_UsbBulkReaderStats *stats);
+
+/*!
+ * @brief Cancel the transfers and stop the event thread. Call it before
+ * closing the device handle.
+ */
+void UsbBulkReader_Destroy(T_UsbBulkReader *reader);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ONBOARDSDK_LINUX_USB_BULK_READER_H
@@ -19,6 +19,7 @@
 #include <libusb.h>
 
 #include "dji_hard_driver.hpp"
+#include "linux_usb_bulk_reader.h"
 
 
 namespace DJI
@@ -36,6 +37,7 @@ class LinuxUSBDevice : public HardDriver
   static const int TIMEOUT                  = 50;
   static const int OUT_END_PT               = 0x0A;
   static const int IN_END_PT                = 0x84;
+  static const int DEFAULT_READ_QUEUE_DEPTH = 4;
 
   typedef struct USBFilter
   {
@@ -59,6 +61,10 @@ public:
   size_t send(const uint8_t* buf, size_t len);
   size_t readall(uint8_t* buf, size_t maxlen);
 
+  /*! @brief Bulk reads kept in flight, applied when reading starts */
+  void setReadQueueDepth(int depth);
+  bool getReadStats(T_UsbBulkReaderStats* stats);
+
   time_ms getTimeStamp();
 private:
   libusb_device*        DJI_device;
@@ -68,6 +74,10 @@ private:
 
   bool                  deviceStatus;
   bool                  foundDJIDevice;
+
+  //! Created by the first readall(), whose length sets the transfer size
+  T_UsbBulkReader*      reader;
+  int                   readQueueDepth;
 };
 }
 }
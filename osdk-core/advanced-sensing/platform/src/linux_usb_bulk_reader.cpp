@@ -0,0 +1,462 @@
+/*
+ * DJI Onboard SDK Advanced Sensing APIs
+ *
+ * Copyright (c) 2026 DJI. All rights reserved.
+ *
+ * All information contained herein is, and remains, the property of DJI.
+ * The intellectual and technical concepts contained herein are proprietary
+ * to DJI and may be covered by U.S. and foreign patents, patents in process,
+ * and protected by trade secret or copyright law.  Dissemination of this
+ * information, including but not limited to data and other proprietary
+ * material(s) incorporated within the information, in any form, is strictly
+ * prohibited without the express written consent of DJI.
+ *
+ * If you receive this source code without DJI’s authorization, you may not
+ * further disseminate the information, and you must immediately remove the
+ * source code and notify DJI of its removal. DJI reserves the right to pursue
+ * legal actions against you for any loss(es) or damage(s) caused by your
+ * failure to do so.
+ */
+
+#include "linux_usb_bulk_reader.h"
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <vector>
+#include <errno.h>
+#include <pthread.h>
+#include <time.h>
+
+namespace
+{
+
+//! A failed transfer waits this long before it is submitted again
+const uint64_t RETRY_BACKOFF_US = 10 * 1000;
+
+struct Slot
+{
+  T_UsbBulkReader*  owner;
+  libusb_transfer*  transfer;
+  int               offset;      // bytes already read by the caller
+  uint64_t          completeTimeUs;
+};
+
+uint64_t
+getMonotonicTimeUs()
+{
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (uint64_t)now.tv_sec * 1000000 + now.tv_nsec / 1000;
+}
+
+//! CLOCK_REALTIME deadline for pthread_cond_timedwait
+struct timespec
+getDeadlineAfterUs(uint64_t us)
+{
+  struct timespec deadline;
+  clock_gettime(CLOCK_REALTIME, &deadline);
+  deadline.tv_sec  += us / 1000000;
+  deadline.tv_nsec += (long)(us % 1000000) * 1000;
+  if (deadline.tv_nsec >= 1000000000)
+  {
+    deadline.tv_sec  += 1;
+    deadline.tv_nsec -= 1000000000;
+  }
+  return deadline;
+}
+
+bool
+isBefore(const struct timespec& a, const struct timespec& b)
+{
+  return (a.tv_sec < b.tv_sec) ||
+         (a.tv_sec == b.tv_sec && a.tv_nsec < b.tv_nsec);
+}
+
+} // namespace
+
+struct T_UsbBulkReader
+{
+  libusb_device_handle* handle;
+  uint8_t               endpoint;
+  std::vector<Slot>     slots;
+  std::deque<Slot*>     ready;
+  std::vector<Slot*>    idle;    // failed, resubmitted by Read after a backoff
+  uint64_t              retryAtUs;
+  bool                  halted;  // a transfer stalled, clear it before retry
+
+  pthread_mutex_t mutex;
+  pthread_cond_t  condv;
+  pthread_t       eventThread;
+  volatile bool   running;
+  bool            deviceLost;
+  int             inFlight;
+
+  T_UsbBulkReaderStats stats;
+  uint64_t             windowStartUs;
+  uint64_t             windowBytes;
+};
+
+static void LIBUSB_CALL transferCallback(libusb_transfer* transfer);
+
+//! Called with the reader mutex
+static void
+parkSlot(T_UsbBulkReader* reader, Slot* slot)
+{
+  reader->idle.push_back(slot);
+  reader->retryAtUs = getMonotonicTimeUs() + RETRY_BACKOFF_US;
+  pthread_cond_broadcast(&reader->condv);
+}
+
+//! Called without the reader mutex
+static void
+submitSlot(T_UsbBulkReader* reader, Slot* slot)
+{
+  slot->offset = 0;
+
+  //! Counted before the submit, Destroy waits for it whatever happens next
+  pthread_mutex_lock(&reader->mutex);
+  bool stopping = !reader->running || reader->deviceLost;
+  if (!stopping)
+  {
+    reader->inFlight++;
+  }
+  pthread_mutex_unlock(&reader->mutex);
+  if (stopping)
+  {
+    return;
+  }
+
+  int ret = libusb_submit_transfer(slot->transfer);
+  if (ret == LIBUSB_SUCCESS)
+  {
+    //! Destroy may have cancelled all transfers between the check and the
+    //! submit, this one would never come back then
+    pthread_mutex_lock(&reader->mutex);
+    stopping = !reader->running;
+    pthread_mutex_unlock(&reader->mutex);
+    if (stopping)
+    {
+      libusb_cancel_transfer(slot->transfer);
+    }
+  }
+  else
+  {
+    pthread_mutex_lock(&reader->mutex);
+    reader->inFlight--;
+    reader->stats.failedTransfers++;
+    if (ret == LIBUSB_ERROR_NO_DEVICE)
+    {
+      reader->deviceLost = true;
+      pthread_cond_broadcast(&reader->condv);
+    }
+    else
+    {
+      parkSlot(reader, slot);
+    }
+    pthread_mutex_unlock(&reader->mutex);
+  }
+}
+
+static void LIBUSB_CALL
+transferCallback(libusb_transfer* transfer)
+{
+  Slot*            slot   = (Slot*)transfer->user_data;
+  T_UsbBulkReader* reader = slot->owner;
+  bool             resubmit = false;
+
+  pthread_mutex_lock(&reader->mutex);
+  reader->inFlight--;
+  switch (transfer->status)
+  {
+    case LIBUSB_TRANSFER_COMPLETED:
+      if (transfer->actual_length > 0)
+      {
+        slot->completeTimeUs = getMonotonicTimeUs();
+        reader->stats.completedTransfers++;
+        reader->ready.push_back(slot);
+        pthread_cond_signal(&reader->condv);
+      }
+      else
+      {
+        resubmit = true;
+      }
+      break;
+    case LIBUSB_TRANSFER_CANCELLED:
+      break;
+    case LIBUSB_TRANSFER_NO_DEVICE:
+      reader->stats.failedTransfers++;
+      reader->deviceLost = true;
+      pthread_cond_broadcast(&reader->condv);
+      break;
+    default:
+      //! STALL, ERROR, OVERFLOW: resubmitting right away fails the same way
+      reader->stats.failedTransfers++;
+      if (transfer->status == LIBUSB_TRANSFER_STALL)
+      {
+        reader->halted = true;
+      }
+      if (reader->running)
+      {
+        parkSlot(reader, slot);
+      }
+      break;
+  }
+  if (!reader->running)
+  {
+    //! Let Destroy see the last transfer come back
+    pthread_cond_broadcast(&reader->condv);
+  }
+  pthread_mutex_unlock(&reader->mutex);
+
+  if (resubmit)
+  {
+    submitSlot(reader, slot);
+  }
+}
+
+static void*
+eventThreadEntry(void* p)
+{
+  T_UsbBulkReader* reader = (T_UsbBulkReader*)p;
+  struct timeval   tv     = { 0, 100 * 1000 };
+  while (true)
+  {
+    pthread_mutex_lock(&reader->mutex);
+    bool done = !reader->running && reader->inFlight == 0;
+    pthread_mutex_unlock(&reader->mutex);
+    if (done)
+    {
+      break;
+    }
+    libusb_handle_events_timeout_completed(NULL, &tv, NULL);
+  }
+  return NULL;
+}
+
+T_UsbBulkReader*
+UsbBulkReader_Create(libusb_device_handle* handle, uint8_t endpoint,
+                     int queueDepth, int transferSize)
+{
+  if (!handle || queueDepth < 1 || transferSize < 1)
+  {
+    return NULL;
+  }
+
+  T_UsbBulkReader* reader = new T_UsbBulkReader;
+  reader->handle        = handle;
+  reader->endpoint      = endpoint;
+  reader->retryAtUs     = 0;
+  reader->halted        = false;
+  reader->running       = true;
+  reader->deviceLost    = false;
+  reader->inFlight      = 0;
+  reader->windowStartUs = getMonotonicTimeUs();
+  reader->windowBytes   = 0;
+  memset(&reader->stats, 0, sizeof(reader->stats));
+  pthread_mutex_init(&reader->mutex, NULL);
+  pthread_cond_init(&reader->condv, NULL);
+
+  reader->slots.resize(queueDepth);
+  for (int i = 0; i < queueDepth; ++i)
+  {
+    Slot& slot          = reader->slots[i];
+    slot.owner          = reader;
+    slot.offset         = 0;
+    slot.completeTimeUs = 0;
+    slot.transfer       = libusb_alloc_transfer(0);
+    uint8_t* buffer     = (uint8_t*)malloc(transferSize);
+    if (!slot.transfer || !buffer)
+    {
+      free(buffer);
+      reader->running = false;
+      UsbBulkReader_Destroy(reader);
+      return NULL;
+    }
+    libusb_fill_bulk_transfer(slot.transfer, handle, endpoint, buffer,
+                              transferSize, transferCallback, &slot, 0);
+  }
+
+  if (0 != pthread_create(&reader->eventThread, NULL, eventThreadEntry, reader))
+  {
+    reader->running = false;
+    UsbBulkReader_Destroy(reader);
+    return NULL;
+  }
+
+  for (int i = 0; i < queueDepth; ++i)
+  {
+    submitSlot(reader, &reader->slots[i]);
+  }
+  return reader;
+}
+
+int
+UsbBulkReader_Read(T_UsbBulkReader* reader, uint8_t* buf, uint32_t len,
+                   int timeoutMs)
+{
+  if (!reader || !buf || len == 0)
+  {
+    return LIBUSB_ERROR_INVALID_PARAM;
+  }
+
+  struct timespec deadline;
+  if (timeoutMs >= 0)
+  {
+    deadline = getDeadlineAfterUs((uint64_t)timeoutMs * 1000);
+  }
+
+  pthread_mutex_lock(&reader->mutex);
+  while (true)
+  {
+    //! Failed slots go back once the backoff is over, a stalled endpoint is
+    //! cleared first. That call blocks, so it is made here and not in the
+    //! event thread.
+    uint64_t nowUs = getMonotonicTimeUs();
+    if (!reader->idle.empty() && nowUs >= reader->retryAtUs)
+    {
+      std::vector<Slot*> retry;
+      retry.swap(reader->idle);
+      bool halted    = reader->halted;
+      reader->halted = false;
+      pthread_mutex_unlock(&reader->mutex);
+      if (halted)
+      {
+        libusb_clear_halt(reader->handle, reader->endpoint);
+      }
+      for (size_t i = 0; i < retry.size(); ++i)
+      {
+        submitSlot(reader, retry[i]);
+      }
+      pthread_mutex_lock(&reader->mutex);
+      continue;
+    }
+    if (!reader->ready.empty() || reader->deviceLost || !reader->running)
+    {
+      break;
+    }
+
+    //! Wake up for the retry too while slots are parked
+    bool            timed = (timeoutMs >= 0);
+    struct timespec wake  = deadline;
+    if (!reader->idle.empty())
+    {
+      struct timespec retryAt =
+        getDeadlineAfterUs(reader->retryAtUs - nowUs);
+      if (!timed || isBefore(retryAt, wake))
+      {
+        wake = retryAt;
+      }
+      timed = true;
+    }
+
+    if (!timed)
+    {
+      pthread_cond_wait(&reader->condv, &reader->mutex);
+    }
+    else if (pthread_cond_timedwait(&reader->condv, &reader->mutex, &wake) ==
+               ETIMEDOUT &&
+             timeoutMs >= 0 && !isBefore(getDeadlineAfterUs(0), deadline))
+    {
+      break;
+    }
+  }
+  if (reader->ready.empty())
+  {
+    int ret = reader->deviceLost ? LIBUSB_ERROR_NO_DEVICE : LIBUSB_ERROR_TIMEOUT;
+    pthread_mutex_unlock(&reader->mutex);
+    return ret;
+  }
+  //! Only the reading thread takes slots off the queue, so the front stays
+  //! put while it is copied without the lock
+  Slot* slot = reader->ready.front();
+  pthread_mutex_unlock(&reader->mutex);
+
+  uint64_t nowUs = getMonotonicTimeUs();
+  uint32_t n     = slot->transfer->actual_length - slot->offset;
+  if (n > len)
+  {
+    n = len;
+  }
+  memcpy(buf, slot->transfer->buffer + slot->offset, n);
+  slot->offset += n;
+  bool consumed = (slot->offset == slot->transfer->actual_length);
+
+  pthread_mutex_lock(&reader->mutex);
+  if (consumed)
+  {
+    reader->ready.pop_front();
+  }
+  reader->stats.totalBytes   += n;
+  reader->windowBytes        += n;
+  reader->stats.lastLatencyUs = nowUs - slot->completeTimeUs;
+  if (reader->stats.lastLatencyUs > reader->stats.maxLatencyUs)
+  {
+    reader->stats.maxLatencyUs = reader->stats.lastLatencyUs;
+  }
+  if (nowUs - reader->windowStartUs >= 1000000)
+  {
+    reader->stats.bytesPerSecond =
+      reader->windowBytes * 1000000 / (nowUs - reader->windowStartUs);
+    reader->windowBytes   = 0;
+    reader->windowStartUs = nowUs;
+  }
+  pthread_mutex_unlock(&reader->mutex);
+
+  if (consumed)
+  {
+    submitSlot(reader, slot);
+  }
+  return (int)n;
+}
+
+void
+UsbBulkReader_GetStats(T_UsbBulkReader* reader, T_UsbBulkReaderStats* stats)
+{
+  if (!reader || !stats)
+  {
+    return;
+  }
+  pthread_mutex_lock(&reader->mutex);
+  *stats          = reader->stats;
+  stats->inFlight = reader->inFlight;
+  stats->ready    = reader->ready.size();
+  pthread_mutex_unlock(&reader->mutex);
+}
+
+void
+UsbBulkReader_Destroy(T_UsbBulkReader* reader)
+{
+  if (!reader)
+  {
+    return;
+  }
+
+  pthread_mutex_lock(&reader->mutex);
+  bool threadStarted = reader->running;
+  reader->running    = false;
+  pthread_cond_broadcast(&reader->condv);
+  pthread_mutex_unlock(&reader->mutex);
+
+  if (threadStarted)
+  {
+    for (size_t i = 0; i < reader->slots.size(); ++i)
+    {
+      libusb_cancel_transfer(reader->slots[i].transfer);
+    }
+    //! The event thread runs until every cancelled transfer came back
+    pthread_join(reader->eventThread, NULL);
+  }
+
+  for (size_t i = 0; i < reader->slots.size(); ++i)
+  {
+    libusb_transfer* transfer = reader->slots[i].transfer;
+    if (transfer)
+    {
+      free(transfer->buffer);
+      libusb_free_transfer(transfer);
+    }
+  }
+  pthread_cond_destroy(&reader->condv);
+  pthread_mutex_destroy(&reader->mutex);
+  delete reader;
+}
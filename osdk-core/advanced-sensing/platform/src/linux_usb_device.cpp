@@ -21,13 +21,18 @@
 #include "linux_usb_device.hpp"
 #include <algorithm>
 #include <iterator>
+#include <unistd.h>
 
 #include "iostream"
 
 using namespace DJI::OSDK;
 
 LinuxUSBDevice::LinuxUSBDevice() :
-  foundDJIDevice(false)
+  DJI_dev_handle(NULL),
+  deviceStatus(false),
+  foundDJIDevice(false),
+  reader(NULL),
+  readQueueDepth(DEFAULT_READ_QUEUE_DEPTH)
 {
   DJI_usb_dev_filter[0].pid = 0x001F;  DJI_usb_dev_filter[0].vid = 0xFFF0;
   DJI_usb_dev_filter[1].pid = 0x0020;  DJI_usb_dev_filter[1].vid = 0xFFF0;
@@ -40,7 +45,9 @@ LinuxUSBDevice::LinuxUSBDevice() :
 LinuxUSBDevice::~LinuxUSBDevice()
 {
   // @todo maybe there's more steps
-  libusb_close(DJI_dev_handle);
+  UsbBulkReader_Destroy(reader);
+  if (DJI_dev_handle)
+    libusb_close(DJI_dev_handle);
 }
 
 void
@@ -170,18 +177,55 @@ LinuxUSBDevice::send(const uint8_t* buf, size_t len)
   return (size_t)-1;
 }
 
+/*! @note
+ *  The protocol always reads with the same length, so transfers of that
+ *  size split the stream exactly like the synchronous reads used to.
+ */
 size_t
 LinuxUSBDevice::readall(uint8_t* buf, size_t maxlen)
 {
-  int read_len = 0, ret;
-  ret = libusb_bulk_transfer(DJI_dev_handle, IN_END_PT,
-                             buf, maxlen, &read_len, TIMEOUT);
-  if (0 == ret)
-    return (size_t)read_len;
+  if (!reader && deviceStatus)
+  {
+    reader = UsbBulkReader_Create(DJI_dev_handle, IN_END_PT, readQueueDepth,
+                                  (int)maxlen);
+    if (!reader)
+    {
+      DERROR("Failed to start USB bulk reads\n");
+      deviceStatus = false;
+    }
+  }
+  //! Without a device a read still takes TIMEOUT, read loops have no
+  //! sleep of their own and would spin otherwise
+  if (!reader)
+  {
+    usleep(TIMEOUT * 1000);
+    return (size_t)-1;
+  }
+
+  int ret = UsbBulkReader_Read(reader, buf, maxlen, TIMEOUT);
+  if (ret >= 0)
+    return (size_t)ret;
+  if (ret == LIBUSB_ERROR_NO_DEVICE)
+    usleep(TIMEOUT * 1000);
 
   return (size_t)-1;
 }
 
+void
+LinuxUSBDevice::setReadQueueDepth(int depth)
+{
+  readQueueDepth = (depth < 1) ? 1 : depth;
+}
+
+bool
+LinuxUSBDevice::getReadStats(T_UsbBulkReaderStats* stats)
+{
+  if (!reader)
+    return false;
+  UsbBulkReader_GetStats(reader, stats);
+  return true;
+}
+
 time_ms
 LinuxUSBDevice::getTimeStamp()
 {
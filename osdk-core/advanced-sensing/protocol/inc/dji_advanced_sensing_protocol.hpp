@@ -17,6 +17,7 @@
 #include "dji_protocol_base.hpp"
 #include "linux_usb_device.hpp"
 #include "dji_ack.hpp"
+#include "dji_stereo_frame.hpp"
 
 /*! Platform includes:
  *  This set of macros figures out which files to include based on your
@@ -77,6 +78,8 @@ public:
   // max 5 pairs of stereo camera (2*BW_imgs + 1*depth) 240p
   // plus header_len: 12, metadata: 8, img_desc: 200
   static const int     USB_MAXRECV  = 5*(2+1)*240*320 + 12 + 8 + 200;
+  // One buffer receiving plus the ones lent to frames held by callbacks
+  static const int     STEREO_FRAME_BUFFERS = 4;
 
 
   /*******************************Send Pipeline*****************************/
@@ -117,6 +120,31 @@ private:
   //! A lot of ACK parsing logic
   bool appHandler(void *protocolHeader);
 
+  //! Bulk receive, see ProtocolBase::scanChunk()
+  uint32_t frameLength(const uint8_t* p_head);
+  bool dispatchFrame(uint8_t* p_frame, uint32_t length);
+
+  /*************************** Stereo frames ********************************/
+public:
+  /*! @brief Take the frame completed by the last receive()
+   *
+   *  @details Called from the USB read thread after receive() returned a
+   *  stereo frame.
+   *  @return NULL if the frame had to be copied because every receive
+   *  buffer was held by consumers. Its images are then only available in
+   *  the RecvContainer.
+   */
+  StereoFramePtr takeStereoFrame();
+
+  /*! @brief Copy the images of frame into the ACK::StereoImgData or
+   *  ACK::StereoVGAImgData of the RecvContainer, for VehicleCallBack users.
+   *  Nothing is copied for a NULL frame, its images are already there.
+   */
+  void fillLegacyImageData(const StereoFramePtr& frame);
+
+private:
+  void copyToLegacyImageData(const StereoFrame& frame);
+
   /********************************** CRC **********************************/
 private:
   int crcHeadCheck(uint8_t* pMsg, size_t nLen);
@@ -128,6 +156,12 @@ private:
   ACK::StereoImgData      *stereoImgData;
   ACK::StereoVGAImgData   *stereoVGAImgData;
 
+  StereoFrameBufferPool   *framePool;
+  StereoFramePtr           lastFrame;
+  //! Buffer to continue receiving in once the current one is lent out
+  uint8_t                 *nextRecvBuf;
+  uint32_t                 copiedFrames;
+
 }; // class AdvancedSensingProtocol
 
 } // namespace OSDK
@@ -0,0 +1,92 @@
+/*! @file dji_stereo_frame.hpp
+ *  @version 4.0.0
+ *  @date Oct 2026
+ *
+ *  @brief Stereo frames handed out as views into the USB receive buffer
+ *
+ *  @Copyright (c) 2026 DJI.
+ *  NOTE THAT this file is part of the advanced sensing
+ *  closed-source library. For licensing information,
+ *  please visit https://developer.dji.com/policies/eula/
+ * */
+
+#ifndef ONBOARDSDK_DJI_STEREO_FRAME_H
+#define ONBOARDSDK_DJI_STEREO_FRAME_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <pthread.h>
+
+namespace DJI
+{
+namespace OSDK
+{
+
+/*! @brief One image of a stereo frame
+ *
+ *  @details image points into the receive buffer the frame arrived in and
+ *  stays valid while the StereoFramePtr it came from is held.
+ */
+typedef struct StereoImageView
+{
+  const uint8_t* image;
+  int            size;
+  int            width;
+  int            height;
+  char           name[12];
+} StereoImageView;
+
+/*! @brief A 240p or VGA stereo frame, without copies of its images
+ *
+ *  @details Same fields as ACK::StereoImgData and ACK::StereoVGAImgData.
+ *  The receive buffer goes back to the protocol when the last handle is
+ *  released. Holding handles for long makes the protocol fall back to
+ *  copying frames once all of its buffers are in use.
+ */
+typedef struct StereoFrame
+{
+  uint8_t         cmd_id;    // PROCESS_IMG_CMD_ID or PROCESS_VGA_CMD_ID
+  uint32_t        frame_index;
+  uint32_t        time_stamp;
+  uint8_t         direction; // VGA only
+  uint64_t        img_desc;  // 240p only
+  uint8_t         num_imgs;
+  StereoImageView img_vec[4];
+} StereoFrame;
+
+typedef std::shared_ptr<const StereoFrame> StereoFramePtr;
+
+/*! @brief Fixed set of receive buffers lent out with the frames in them
+ */
+class StereoFrameBufferPool
+{
+public:
+  StereoFrameBufferPool(int poolSize, size_t bufferSize);
+  ~StereoFrameBufferPool();
+
+  /*! @return a free buffer, or NULL if every buffer is in use */
+  uint8_t* acquire();
+
+  /*! @brief Give back a buffer taken with acquire() */
+  void release(uint8_t* buffer);
+
+  /*! @brief Make frame the owner of buffer. The buffer is released with
+   *  the last copy of the handle, which may happen after the pool itself
+   *  is destroyed.
+   */
+  StereoFramePtr wrap(StereoFrame* frame, uint8_t* buffer);
+
+  int getFreeCount();
+
+private:
+  // Shared with the handles, so frames held by the user outlive the pool
+  struct State;
+
+  std::shared_ptr<State> m_state;
+};
+
+} // namespace OSDK
+} // namespace DJI
+
+#endif // ONBOARDSDK_DJI_STEREO_FRAME_H
@@ -61,6 +61,9 @@ typedef struct AdvancedSensingCmdContainer {
 AdvancedSensingProtocol::AdvancedSensingProtocol()
   : stereoImgData(NULL)
   , stereoVGAImgData(NULL)
+  , framePool(NULL)
+  , nextRecvBuf(NULL)
+  , copiedFrames(0)
 {
   //! Step 1: Initialize Hardware Driver
   this->deviceDriver = new LinuxUSBDevice();
@@ -86,6 +89,10 @@ AdvancedSensingProtocol::~AdvancedSensingProtocol()
   if (this->stereoVGAImgData)
     delete this->stereoVGAImgData;
 
+  //! p_filter->recvBuf belongs to the pool
+  if (this->framePool)
+    delete this->framePool;
+
   if (this->p_filter)
     delete this->p_filter;
 }
@@ -103,7 +110,8 @@ AdvancedSensingProtocol::init(HardDriver* Driver, MMU* mmuPtr, bool userCallback
   p_filter->reuseCount  = 0;
   p_filter->reuseIndex  = 0;
   p_filter->encode      = 0;
-  p_filter->recvBuf     = new uint8_t[MAX_RECV_LEN];
+  framePool             = new StereoFrameBufferPool(STEREO_FRAME_BUFFERS, MAX_RECV_LEN);
+  p_filter->recvBuf     = framePool->acquire();
 
   BUFFER_SIZE = 1024*600;
 
@@ -115,6 +123,11 @@ AdvancedSensingProtocol::init(HardDriver* Driver, MMU* mmuPtr, bool userCallback
   reuse_buffer = false;
 
   is_large_data_protocol = true;
+
+  //! A frame is larger than a chunk, its pieces are copied into the frame
+  //! buffer as a whole instead of byte by byte
+  bulk_scan = true;
+  bulk_sof  = AdvancedSensingProtocol::SOF1;
 }
 
 /******************** Send Pipeline **********************/
@@ -283,9 +296,57 @@ AdvancedSensingProtocol::callApp()
 {
 
   bool isFrame = appHandler((void *) p_filter->recvBuf);
-  prepareDataStream();
+  if (nextRecvBuf)
+  {
+    //! Same as prepareDataStream(), but the tail goes to the new buffer as
+    //! the frame owns the old one now
+    uint32_t bytes_to_move = HEADER_LEN - 1;
+    memcpy(nextRecvBuf, p_filter->recvBuf + p_filter->recvIndex - bytes_to_move,
+           bytes_to_move);
+    p_filter->recvBuf   = nextRecvBuf;
+    p_filter->recvIndex = bytes_to_move;
+    nextRecvBuf         = NULL;
+  }
+  else
+  {
+    prepareDataStream();
+  }
+
+
+  return isFrame;
+}
+
+uint32_t
+AdvancedSensingProtocol::frameLength(const uint8_t* p_head)
+{
+  AdvancedSensingHeader* p_sensing = (AdvancedSensingHeader*)p_head;
 
+  if ((p_sensing->header[0] != AdvancedSensingProtocol::SOF1) ||
+      (p_sensing->header[1] != AdvancedSensingProtocol::SOF2) ||
+      (p_sensing->length > (uint32_t)MAX_RECV_LEN))
+  {
+    return 0;
+  }
+  return p_sensing->length + sizeof(AdvancedSensingHeader);
+}
 
+bool
+AdvancedSensingProtocol::dispatchFrame(uint8_t* p_frame, uint32_t length)
+{
+  //! Frames are lent out with their buffer, so they have to be in one of
+  //! the pool. The read buffer is refilled by the next chunk, a frame found
+  //! whole in it, a 240p image included, is copied out once.
+  if (p_frame != p_filter->recvBuf)
+  {
+    memcpy(p_filter->recvBuf, p_frame, length);
+  }
+
+  bool isFrame = appHandler((void *) p_filter->recvBuf);
+  if (nextRecvBuf)
+  {
+    p_filter->recvBuf = nextRecvBuf;
+    nextRecvBuf       = NULL;
+  }
   return isFrame;
 }
 
@@ -308,6 +369,11 @@ AdvancedSensingProtocol::appHandler(void *protocolHeader)
   AdvancedSensingHeader header;
   memcpy(&header, &data_buf[0], sizeof(AdvancedSensingHeader));
 
+  //! The images stay in the receive buffer, the frame only points to them
+  StereoFrame frame;
+  memset(&frame, 0, sizeof(StereoFrame));
+  frame.cmd_id = header.cmd_id;
+
   if ( header.cmd_id == AdvancedSensingProtocol::PROCESS_IMG_CMD_ID )
   {
     //! this is complicated, plz refer to protocol documentation
@@ -318,46 +384,48 @@ AdvancedSensingProtocol::appHandler(void *protocolHeader)
 
     //! we are going to use a 8-byte uint64_t to represent a 200-byte long array
     //! 200-byte array uses 50 uint32_t, each of them is boolean
-    stereoImgData->img_desc = 0;
-    stereoImgData->num_imgs = 0;
+    const int maxImgs = sizeof(frame.img_vec) / sizeof(frame.img_vec[0]);
 
     int mem_location_offset = sizeof(AdvancedSensingHeader);
     for (int pair_idx = 0; pair_idx < CAMERA_PAIR_NUM; ++pair_idx) {
       for (int dir_idx = 0; dir_idx < IMAGE_TYPE_NUM; ++dir_idx) {
         if (img_desc[pair_idx][dir_idx])
         {
+          if (frame.num_imgs == maxImgs)
+          {
+            mem_location_offset += ACK::IMG_240P_SIZE;
+            continue;
+          }
+          StereoImageView& view = frame.img_vec[frame.num_imgs++];
 
           if (pair_idx == AdvancedSensingProtocol::FRONT){
             if (dir_idx == AdvancedSensingProtocol::LEFT)
-              memcpy(stereoImgData->img_vec[stereoImgData->num_imgs].name,
-                     "front_left\0", 12);
+              memcpy(view.name, "front_left\0", 12);
             if (dir_idx == AdvancedSensingProtocol::RIGHT)
-              memcpy(stereoImgData->img_vec[stereoImgData->num_imgs].name,
-                     "front_right\0", 12);
+              memcpy(view.name, "front_right\0", 12);
             if (dir_idx == AdvancedSensingProtocol::DISPARITY)
-              memcpy(stereoImgData->img_vec[stereoImgData->num_imgs].name,
-                     "front_depth\0", 12);
+              memcpy(view.name, "front_depth\0", 12);
           }else if (pair_idx == AdvancedSensingProtocol::DOWN){
             if (dir_idx == AdvancedSensingProtocol::LEFT)
-              memcpy(stereoImgData->img_vec[stereoImgData->num_imgs].name,
-                     "down_back\0", 10);
+              memcpy(view.name, "down_back\0", 10);
             if (dir_idx == AdvancedSensingProtocol::RIGHT)
-              memcpy(stereoImgData->img_vec[stereoImgData->num_imgs].name,
-                     "down_front\0", 11);
+              memcpy(view.name, "down_front\0", 11);
           }
 
-          memcpy(&stereoImgData->img_vec[stereoImgData->num_imgs++].image,
-                 &data_buf[mem_location_offset], ACK::IMG_240P_SIZE);
+          view.image  = &data_buf[mem_location_offset];
+          view.size   = ACK::IMG_240P_SIZE;
+          view.width  = 320;
+          view.height = 240;
 
-          stereoImgData->img_desc |= 1 << (pair_idx*IMAGE_TYPE_NUM + dir_idx);
+          frame.img_desc |= 1 << (pair_idx*IMAGE_TYPE_NUM + dir_idx);
 
           mem_location_offset += ACK::IMG_240P_SIZE;
         }
       }
     }
 
-    memcpy(&stereoImgData->frame_index, data_buf+mem_location_offset, sizeof(int));
-    memcpy(&stereoImgData->time_stamp, data_buf+mem_location_offset+sizeof(int), sizeof(int));
+    memcpy(&frame.frame_index, data_buf+mem_location_offset, sizeof(int));
+    memcpy(&frame.time_stamp, data_buf+mem_location_offset+sizeof(int), sizeof(int));
 
     p_recvContainer->recvData.stereoImgData = stereoImgData;
     p_recvContainer->recvInfo.cmd_id = header.cmd_id;
@@ -369,14 +437,18 @@ AdvancedSensingProtocol::appHandler(void *protocolHeader)
     VGADescription desc;
     memcpy(&desc, &data_buf[0+sizeof(AdvancedSensingHeader)+header.length-sizeof(VGADescription)], sizeof(VGADescription));
 
-    stereoVGAImgData->direction = desc.direction;
-    stereoVGAImgData->frame_index = desc.index;
-    stereoVGAImgData->time_stamp = desc.time_stamp;
-
-    memcpy(&stereoVGAImgData->img_vec[0], &data_buf[0+sizeof(AdvancedSensingHeader)],
-           ACK::IMG_VGA_SIZE);
-    memcpy(&stereoVGAImgData->img_vec[1], &data_buf[0+sizeof(AdvancedSensingHeader)+ACK::IMG_VGA_SIZE],
-           ACK::IMG_VGA_SIZE);
+    frame.direction = desc.direction;
+    frame.frame_index = desc.index;
+    frame.time_stamp = desc.time_stamp;
+
+    frame.num_imgs = 2;
+    for (int i = 0; i < 2; ++i)
+    {
+      frame.img_vec[i].image  = &data_buf[0+sizeof(AdvancedSensingHeader)+i*ACK::IMG_VGA_SIZE];
+      frame.img_vec[i].size   = ACK::IMG_VGA_SIZE;
+      frame.img_vec[i].width  = 640;
+      frame.img_vec[i].height = 480;
+    }
 
     p_recvContainer->recvData.stereoVGAImgData = stereoVGAImgData;
     p_recvContainer->recvInfo.cmd_id = header.cmd_id;
@@ -384,11 +456,76 @@ AdvancedSensingProtocol::appHandler(void *protocolHeader)
     isFrame = true;
   }
 
+  if (isFrame)
+  {
+    //! Lend the receive buffer to the frame if there is another one to
+    //! continue in. Otherwise the images are copied out as before.
+    nextRecvBuf = framePool->acquire();
+    if (nextRecvBuf)
+    {
+      lastFrame = framePool->wrap(new StereoFrame(frame), data_buf);
+    }
+    else
+    {
+      lastFrame.reset();
+      copyToLegacyImageData(frame);
+      if (0 == (copiedFrames++ % 100))
+      {
+        DSTATUS("All stereo frame buffers are held, %u frames copied", copiedFrames);
+      }
+    }
+  }
+
   threadHandle->freeRecvContainer();
 
   return isFrame;
 }
 
+StereoFramePtr
+AdvancedSensingProtocol::takeStereoFrame()
+{
+  StereoFramePtr frame;
+  frame.swap(lastFrame);
+  return frame;
+}
+
+void
+AdvancedSensingProtocol::fillLegacyImageData(const StereoFramePtr& frame)
+{
+  if (frame)
+  {
+    threadHandle->lockRecvContainer();
+    copyToLegacyImageData(*frame);
+    threadHandle->freeRecvContainer();
+  }
+}
+
+void
+AdvancedSensingProtocol::copyToLegacyImageData(const StereoFrame& frame)
+{
+  if (frame.cmd_id == AdvancedSensingProtocol::PROCESS_IMG_CMD_ID)
+  {
+    stereoImgData->frame_index = frame.frame_index;
+    stereoImgData->time_stamp  = frame.time_stamp;
+    stereoImgData->img_desc    = frame.img_desc;
+    stereoImgData->num_imgs    = frame.num_imgs;
+    for (int i = 0; i < frame.num_imgs; ++i)
+    {
+      memcpy(stereoImgData->img_vec[i].name, frame.img_vec[i].name, 12);
+      memcpy(&stereoImgData->img_vec[i].image, frame.img_vec[i].image,
+             ACK::IMG_240P_SIZE);
+    }
+  }
+  else if (frame.cmd_id == AdvancedSensingProtocol::PROCESS_VGA_CMD_ID)
+  {
+    stereoVGAImgData->direction   = frame.direction;
+    stereoVGAImgData->frame_index = frame.frame_index;
+    stereoVGAImgData->time_stamp  = frame.time_stamp;
+    memcpy(&stereoVGAImgData->img_vec[0], frame.img_vec[0].image, ACK::IMG_VGA_SIZE);
+    memcpy(&stereoVGAImgData->img_vec[1], frame.img_vec[1].image, ACK::IMG_VGA_SIZE);
+  }
+}
+
 int
 AdvancedSensingProtocol::crcHeadCheck(uint8_t* pMsg, size_t nLen)
 {
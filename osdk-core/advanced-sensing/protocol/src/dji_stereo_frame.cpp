@@ -0,0 +1,101 @@
+/*! @file dji_stereo_frame.cpp
+ *  @version 4.0.0
+ *  @date Oct 2026
+ *
+ *  @brief Stereo frames handed out as views into the USB receive buffer
+ *
+ *  @Copyright (c) 2026 DJI.
+ *  NOTE THAT this file is part of the advanced sensing
+ *  closed-source library. For licensing information,
+ *  please visit https://developer.dji.com/policies/eula/
+ * */
+
+#include "../inc/dji_stereo_frame.hpp"
+#include <vector>
+
+using namespace DJI;
+using namespace DJI::OSDK;
+
+struct StereoFrameBufferPool::State
+{
+  pthread_mutex_t        mutex;
+  std::vector<uint8_t*>  buffers;
+  std::vector<uint8_t*>  freeList;
+
+  State(int poolSize, size_t bufferSize)
+  {
+    pthread_mutex_init(&mutex, NULL);
+    for (int i = 0; i < poolSize; ++i)
+    {
+      buffers.push_back(new uint8_t[bufferSize]);
+    }
+    freeList = buffers;
+  }
+
+  ~State()
+  {
+    for (size_t i = 0; i < buffers.size(); ++i)
+    {
+      delete[] buffers[i];
+    }
+    pthread_mutex_destroy(&mutex);
+  }
+
+  void release(uint8_t* buffer)
+  {
+    pthread_mutex_lock(&mutex);
+    freeList.push_back(buffer);
+    pthread_mutex_unlock(&mutex);
+  }
+};
+
+StereoFrameBufferPool::StereoFrameBufferPool(int poolSize, size_t bufferSize)
+  : m_state(new State(poolSize, bufferSize))
+{
+}
+
+StereoFrameBufferPool::~StereoFrameBufferPool()
+{
+}
+
+uint8_t*
+StereoFrameBufferPool::acquire()
+{
+  uint8_t* buffer = NULL;
+  pthread_mutex_lock(&m_state->mutex);
+  if (!m_state->freeList.empty())
+  {
+    buffer = m_state->freeList.back();
+    m_state->freeList.pop_back();
+  }
+  pthread_mutex_unlock(&m_state->mutex);
+  return buffer;
+}
+
+void
+StereoFrameBufferPool::release(uint8_t* buffer)
+{
+  if (buffer)
+  {
+    m_state->release(buffer);
+  }
+}
+
+StereoFramePtr
+StereoFrameBufferPool::wrap(StereoFrame* frame, uint8_t* buffer)
+{
+  std::shared_ptr<State> owner = m_state;
+  return StereoFramePtr(frame, [owner, buffer](const StereoFrame* f) {
+    delete f;
+    owner->release(buffer);
+  });
+}
+
+int
+StereoFrameBufferPool::getFreeCount()
+{
+  pthread_mutex_lock(&m_state->mutex);
+  int count = m_state->freeList.size();
+  pthread_mutex_unlock(&m_state->mutex);
+  return count;
+}
@@ -30,6 +30,7 @@
 #ifndef DJIBROADCAST_H
 #define DJIBROADCAST_H
 
+#include "dji_seqlock.hpp"
 #include "dji_telemetry.hpp"
 #include "dji_vehicle_callback.hpp"
 
@@ -38,6 +39,39 @@ namespace DJI
 namespace OSDK
 {
 
+/*! @brief One coherent copy of every broadcast field
+ *
+ *  @details All fields come from the same broadcast package, with the
+ *  Matrice 100 and old Matrice 600 formats already converted the same way
+ *  the single getters of DataBroadcast convert them.
+ */
+typedef struct BroadcastSnapshot
+{
+  uint32_t sequence;      /*!< Counts published packages, 0 before the first */
+  uint32_t receiveTimeMs; /*!< Local time the package was unpacked */
+  uint16_t passFlag;      /*!< Topics present in the package, see DATA_ENABLE_FLAG */
+  // clang-format off
+  Telemetry::TimeStamp        timeStamp;
+  Telemetry::SyncStamp        syncStamp;
+  Telemetry::Quaternion       q;
+  Telemetry::Vector3f         a;
+  Telemetry::Vector3f         v;
+  Telemetry::VelocityInfo     vi;
+  Telemetry::Vector3f         w;
+  Telemetry::GlobalPosition   gp;
+  Telemetry::RelativePosition rp;
+  Telemetry::GPSInfo          gps;
+  Telemetry::RTK              rtk;
+  Telemetry::Mag              mag;
+  Telemetry::RC               rc;
+  Telemetry::Gimbal           gimbal;
+  Telemetry::Status           status;
+  Telemetry::Battery          battery;
+  Telemetry::SDKInfo          info;
+  Telemetry::Compass          compass;
+  // clang-format on
+} BroadcastSnapshot;
+
 /*! @brief Telemetry API through asynchronous "Broadcast"-style messages
  *
  *  @details Broadcast telemetry is sent by the FC as push data - whenever an
@@ -324,6 +358,22 @@ public:
   Telemetry::Compass     getCompassData();
     // clang-format on
 
+  /*! Get all broadcast fields of the newest package from local cache
+   *
+   *  @platforms M210V2, M300
+   *  @note Never blocks the receive thread. Unlike calling several getters
+   *  one after another, all fields are guaranteed to come from the same
+   *  package.
+   *  @param snapshot filled with the newest values
+   *  @return false if no broadcast package has been received yet
+   */
+  bool getSnapshot(BroadcastSnapshot& snapshot) const;
+
+  /*! @return sequence of the newest snapshot, to poll for new packages
+   *  without copying them
+   */
+  uint32_t getSnapshotSequence() const;
+
 public:
   /*! Non-blocking call for Frequency setting
    *
@@ -446,6 +496,20 @@ private:
 
   inline void unpackOne(FLAG flag, void* data, uint8_t*& buf, size_t size);
 
+  /*!
+   * @brief Copy the freshly unpacked fields into the published snapshot
+   * @note Called with m_msgLock held, right after an unpack.
+   */
+  void publishSnapshot();
+
+  template <typename T>
+  T readPublished(const T& field) const
+  {
+    T data;
+    snapshotLock.read(&data, &field, sizeof(T));
+    return data;
+  }
+
 public:
   void setBroadcastLength(uint16_t length);
   uint16_t getBroadcastLength();
@@ -489,6 +553,13 @@ private:
   void lockMSG();
   void freeMSG();
 
+  /*
+   * @note Only the receive thread writes the snapshot, the getters read it
+   * through the seqlock and never wait for an unpack to finish.
+   */
+  SeqLock           snapshotLock;
+  BroadcastSnapshot published;
+
   VehicleCallBackHandler userCbHandler;
 };
 
@@ -0,0 +1,266 @@
+/** @file dji_flight_recorder.hpp
+ *  @version 4.0.0
+ *  @date Oct 2026
+ *
+ *  @brief Raw capture of subscription and broadcast telemetry to disk
+ *
+ *  @Copyright (c) 2026 DJI
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef DJI_FLIGHT_RECORDER_H
+#define DJI_FLIGHT_RECORDER_H
+
+#include "dji_telemetry.hpp"
+
+#if defined(__linux__)
+#include <atomic>
+#include <pthread.h>
+#include <semaphore.h>
+#include <string>
+#endif
+
+namespace DJI
+{
+namespace OSDK
+{
+
+class SubscriptionPackage;
+
+/*
+ * A recording is a series of segment files <basePath>_0000.frec,
+ * <basePath>_0001.frec, ... Each segment stands alone:
+ *
+ *   FlightRecordSegmentHeader
+ *   FlightRecordIndexEntry[indexCapacity]
+ *   data, every record starting on an 8 byte boundary
+ *
+ * The index lists the records in the order they were written, so one topic
+ * can be pulled out by reading the index and only the bytes of that topic.
+ * Every segment repeats the layout of a subscription package before its
+ * first frame. Unused space is left sparse.
+ */
+#define FLIGHT_RECORD_MAGIC "DJIFREC1"
+
+static const uint32_t FLIGHT_RECORD_VERSION          = 1;
+static const uint8_t  FLIGHT_RECORD_SOURCE_BROADCAST = 0xFF;
+
+typedef enum FlightRecordType
+{
+  FLIGHT_RECORD_SUBSCRIPTION = 1, /*!< package data, without the package id */
+  FLIGHT_RECORD_BROADCAST    = 2, /*!< broadcast payload, passFlag first */
+  FLIGHT_RECORD_LAYOUT       = 3  /*!< FlightRecordLayout of a package */
+} FlightRecordType;
+
+typedef struct FlightRecordSegmentHeader
+{
+  char     magic[8];
+  uint32_t version;
+  uint32_t segmentNumber;
+  uint64_t startTimeUs;
+  uint32_t indexOffset;   /*!< from the start of the file */
+  uint32_t indexCapacity; /*!< entries */
+  uint32_t dataOffset;    /*!< from the start of the file */
+  uint32_t dataCapacity;  /*!< bytes */
+  uint32_t indexCount;    /*!< set when closed, 0 if the writer died */
+  uint32_t dataUsed;      /*!< set when closed */
+  uint32_t dropped;       /*!< records that did not fit, set when closed */
+  uint8_t  reserved[12];
+} FlightRecordSegmentHeader;
+
+typedef struct FlightRecordIndexEntry
+{
+  uint64_t timeUs;
+  uint32_t dataOffset; /*!< from dataOffset of the segment */
+  uint16_t length;     /*!< written last, 0 if the record was not committed */
+  uint8_t  type;       /*!< FlightRecordType */
+  uint8_t  source;     /*!< package id, or FLIGHT_RECORD_SOURCE_BROADCAST */
+} FlightRecordIndexEntry;
+
+typedef struct FlightRecordTopic
+{
+  uint32_t topic; /*!< Telemetry::TopicName */
+  uint32_t uid;
+  uint16_t offset; /*!< in the package data */
+  uint16_t size;
+} FlightRecordTopic;
+
+typedef struct FlightRecordLayout
+{
+  uint8_t  packageID;
+  uint8_t  config; /*!< 1 if the package data starts with a timestamp */
+  uint8_t  numberOfTopics;
+  uint8_t  reserved;
+  uint16_t freq;
+  uint16_t dataSize;
+  // followed by numberOfTopics FlightRecordTopic
+} FlightRecordLayout;
+
+#if defined(__linux__)
+
+/*! @brief Appends every subscription and broadcast frame to disk
+ *
+ *  @details The receive thread copies each frame into a memory-mapped
+ *  segment: one atomic add reserves the space, no lock is taken and no
+ *  system call is made. A background thread prepares the next segment in
+ *  advance and closes full ones, so rotation only swaps a pointer. When no
+ *  segment is ready the frame is dropped and counted.
+ */
+class FlightRecorder
+{
+public:
+  static const uint32_t DEFAULT_SEGMENT_SIZE = 32 * 1024 * 1024;
+
+  typedef struct Stats
+  {
+    uint64_t records;  /*!< frames and layouts written */
+    uint64_t bytes;    /*!< payload bytes written */
+    uint64_t dropped;  /*!< frames lost because no space was ready */
+    uint32_t segments; /*!< segments opened so far */
+  } Stats;
+
+  static FlightRecorder& instance();
+
+  /*!
+   * @brief Start recording
+   * @param basePath segment files are named <basePath>_NNNN.frec
+   * @param segmentSize size of each segment file
+   * @param maxSegments keep only this many newest segments, 0 keeps all
+   */
+  bool start(const char* basePath, uint32_t segmentSize = DEFAULT_SEGMENT_SIZE,
+             int maxSegments = 0);
+
+  //! Stop recording and close the segments
+  void stop();
+
+  bool isRecording() const
+  {
+    return recording.load(std::memory_order_acquire);
+  }
+
+  //! Called from the receive thread for every decoded package
+  void recordSubscription(SubscriptionPackage* pkg, const uint8_t* data,
+                          uint32_t length);
+
+  //! Called from the receive thread for every broadcast frame
+  void recordBroadcast(const uint8_t* data, uint32_t length);
+
+  Stats getStats() const;
+
+private:
+  FlightRecorder();
+
+  struct Segment;
+
+  typedef struct Part
+  {
+    uint8_t        type;
+    const uint8_t* data;
+    uint32_t       length;
+  } Part;
+
+  Segment* createSegment(uint32_t number);
+  void     closeSegment(Segment* segment, bool keep);
+  Segment* acquireSegment();
+  bool     append(Segment* segment, uint8_t source, uint64_t timeUs,
+                  const Part* parts, int count);
+  void     rotate(Segment* full);
+  bool     beginWrite();
+  void     endWrite();
+  void     writeSubscription(SubscriptionPackage* pkg, const uint8_t* data,
+                             uint32_t length);
+  void     writeBroadcast(const uint8_t* data, uint32_t length);
+  void     retire(Segment* segment);
+  std::string segmentPath(uint32_t number) const;
+
+  static void* segmentTask(void* arg);
+
+  //! Layout last written per package, touched by the receive thread only
+  typedef struct LayoutState
+  {
+    uint32_t version;
+    uint32_t segment;
+    bool     written;
+  } LayoutState;
+
+private:
+  std::string basePath;
+  uint32_t    segmentSize;
+  int         maxSegments;
+  uint32_t    nextNumber;
+
+  std::atomic<bool>     recording;
+  std::atomic<Segment*> current;
+  std::atomic<Segment*> spare;
+  std::atomic<Segment*> retired;
+
+  std::atomic<uint64_t> records;
+  std::atomic<uint64_t> bytes;
+  std::atomic<uint64_t> dropped;
+  std::atomic<uint32_t> segments;
+
+  LayoutState layouts[256];
+
+  //! Every segment ever created, freed by stop() only. A writer may still
+  //! look at a segment it lost the race for after it was closed.
+  Segment* allSegments;
+  //! Writers inside recordSubscription or recordBroadcast, stop() waits
+  //! for them before it closes and frees the segments
+  std::atomic<int> activeWriters;
+
+  std::atomic<bool> running;
+  pthread_t         worker;
+  sem_t             wakeSem;
+};
+
+/*! @brief Offline access to flight recorder segments */
+class FlightRecordReader
+{
+public:
+  typedef void (*TopicCallback)(Telemetry::TopicName topic, uint64_t timeUs,
+                                const uint8_t* data, uint32_t size,
+                                void* userData);
+  typedef void (*BroadcastCallback)(uint64_t timeUs, const uint8_t* data,
+                                    uint32_t size, void* userData);
+
+  /*!
+   * @brief Call callback for every sample of topic in one segment
+   * @details Only the index, the layouts and the bytes of the topic itself
+   * are read.
+   * @return number of samples, -1 if the file is not a valid segment
+   */
+  static int readTopic(const char* segmentPath, Telemetry::TopicName topic,
+                       TopicCallback callback, void* userData);
+
+  /*!
+   * @brief Call callback for every broadcast frame in one segment
+   * @return number of frames, -1 if the file is not a valid segment
+   */
+  static int readBroadcast(const char* segmentPath, BroadcastCallback callback,
+                           void* userData);
+};
+
+#endif // __linux__
+
+} // namespace OSDK
+} // namespace DJI
+
+#endif // DJI_FLIGHT_RECORDER_H
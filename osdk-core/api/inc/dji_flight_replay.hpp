@@ -0,0 +1,133 @@
+/** @file dji_flight_replay.hpp
+ *  @version 4.0.0
+ *  @date Oct 2026
+ *
+ *  @brief Feeds a flight recorder capture back through the telemetry decoders
+ *
+ *  @Copyright (c) 2026 DJI
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef DJI_FLIGHT_REPLAY_H
+#define DJI_FLIGHT_REPLAY_H
+
+#include "dji_flight_recorder.hpp"
+
+#if defined(__linux__)
+
+#include <atomic>
+#include <string>
+#include <vector>
+
+namespace DJI
+{
+namespace OSDK
+{
+
+class DataSubscription;
+class DataBroadcast;
+
+/*! @brief Replays segments written by FlightRecorder
+ *
+ *  @details Every recorded frame is handed to the same entry points the
+ *  linker handlers use, so it runs through the real decoders, the topic
+ *  history and the application callbacks. Subscription packages are started
+ *  locally from the recorded layouts, no aircraft is needed: a Vehicle that
+ *  was constructed but never set up is enough to own the DataSubscription
+ *  and DataBroadcast.
+ *
+ *  Frames are replayed in recording order on the thread calling run(), so
+ *  two runs over the same capture feed the same frames in the same order.
+ */
+class FlightReplay
+{
+public:
+  typedef struct Stats
+  {
+    uint64_t frames;     /*!< frames fed to the decoders */
+    uint64_t bytes;      /*!< payload bytes of those frames */
+    uint64_t skipped;    /*!< frames without a usable layout or decoder */
+    uint32_t segments;   /*!< segment files read */
+    uint64_t recordedUs; /*!< time span of the replayed frames */
+    uint64_t elapsedUs;  /*!< wall time run() took */
+  } Stats;
+
+  /*!
+   * @param subscription: receives subscription frames, may be NULL
+   * @param broadcast: receives broadcast frames, may be NULL. Its vehicle
+   * must be set.
+   */
+  FlightReplay(DataSubscription* subscription, DataBroadcast* broadcast);
+
+  /*!
+   * @brief Find the segments of a recording
+   * @param basePath the basePath passed to FlightRecorder::start
+   * @return false if there is no segment
+   */
+  bool open(const char* basePath);
+
+  /*!
+   * @brief Set the replay speed
+   * @param speed 1 replays at the recorded pace, 2 twice as fast and so on.
+   * 0 replays as fast as possible.
+   */
+  void setSpeed(float speed);
+
+  //! Replay all segments, blocks until done or stop() is called
+  Stats run();
+
+  //! Make run() return after the current frame, callable from any thread
+  void stop();
+
+private:
+  bool replaySegment(const std::string& path, Stats& stats);
+  void applyLayout(uint8_t packageID, const uint8_t* data, uint32_t length);
+  void feedSubscription(uint8_t packageID, const uint8_t* data,
+                        uint32_t length, Stats& stats);
+  void feedBroadcast(const uint8_t* data, uint32_t length, Stats& stats);
+  void pace(uint64_t timeUs);
+
+private:
+  DataSubscription* subscription;
+  DataBroadcast*    broadcast;
+
+  std::vector<std::string> segmentPaths;
+  float                    speed;
+  std::atomic<bool>        stopped;
+
+  //! First replayed frame, pacing is relative to it
+  bool     started;
+  uint64_t firstTimeUs;
+  uint64_t lastTimeUs;
+  uint64_t startWallUs;
+  uint16_t seqNum;
+
+  //! Layout in effect per package, empty until one was applied
+  std::vector<uint8_t> layouts[256];
+  bool                 layoutValid[256];
+};
+
+} // namespace OSDK
+} // namespace DJI
+
+#endif // __linux__
+
+#endif // DJI_FLIGHT_REPLAY_H
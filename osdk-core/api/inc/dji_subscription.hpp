@@ -31,10 +31,14 @@
 #define DJI_DATASUBSCRIPTION_H
 
 #include "dji_log.hpp"
+#include "dji_platform.hpp"
+#include "dji_seqlock.hpp"
 #include "dji_telemetry.hpp"
+#include "dji_topic_history.hpp"
 #include "dji_vehicle_callback.hpp"
 
 #ifdef __linux__
+#include <atomic>
 #include <cstring>
 #elif STM32
 //! handle array of characters
@@ -70,6 +74,22 @@ public:
   } PackageInfo;
 #pragma pack()
 
+  /*!
+   * @brief Upper bound of the topic data carried by one package, including
+   * the optional time stamp
+   */
+  const static uint8_t MAX_PACKAGE_DATA_LENGTH = 250;
+
+  /*!
+   * @brief Running totals of one package since startup, never reset
+   */
+  typedef struct PackageStats
+  {
+    uint32_t frameCount;     /*!< Packages received */
+    uint32_t byteCount;      /*!< Bytes on the link, protocol overhead included */
+    uint64_t callbackTimeUs; /*!< Time spent in the user unpack callback */
+  } PackageStats;
+
 public:
   SubscriptionPackage();
   ~SubscriptionPackage();
@@ -110,6 +130,56 @@ public:
   bool hasLeftOverData();
   void setLeftOverDataFlag(bool flag);
 
+  /*!
+   * @brief While set, removing and adding the package again keeps the
+   * TopicDataBase entries and the last received data, so readers see the
+   * last good values instead of an uninitialized topic.
+   */
+  bool isRenegotiating();
+  void setRenegotiating(bool status);
+
+  /*!
+   * @brief Publish a freshly received package. Called from the receive
+   * thread only, never blocks.
+   *
+   * @param data: Topic data of the package, getBufferSize() bytes long
+   */
+  void writeData(const uint8_t* data);
+
+  /*!
+   * @brief Copy size bytes starting at src, which must point inside the
+   * data buffer, as one consistent snapshot.
+   *
+   * @return The sequence number of the snapshot
+   */
+  uint32_t readData(void* dst, const uint8_t* src, uint32_t size);
+
+  /*!
+   * @brief Sequence number of the data buffer, incremented by two for every
+   * received package
+   */
+  uint32_t getSequence();
+
+  /*!
+   * @brief Changes every time the package is (re)allocated, so a consumer
+   * of raw frames can tell that the topic layout may have changed
+   */
+  uint32_t getLayoutVersion();
+
+  /*!
+   * @brief Account one received package of linkBytes bytes. Called from the
+   * receive thread only.
+   */
+  void recordFrame(uint32_t linkBytes);
+
+  /*!
+   * @brief Account the run time of the user unpack callback. Called from the
+   * receive thread only.
+   */
+  void recordCallbackTime(uint64_t timeUs);
+
+  PackageStats getStats();
+
   // Accessors to private variables:
   PackageInfo            getInfo();
   uint32_t*              getUidList(); // explicitly show it's a pointer
@@ -138,6 +208,7 @@ public:
 private: // Private variables
   bool        occupied;
   bool        leftOverDataFlag;
+  bool        renegotiating;
   PackageInfo info;
 
   // We have only 30 topics and 5 packages.
@@ -156,10 +227,27 @@ private: // Private variables
   uint32_t packageDataSize;
 
   /*!
-   * @brief The buffer to hold data from FC
+   * @brief The buffer to hold data from FC, points to dataStorage while the
+   * package is allocated and NULL otherwise
    */
   uint8_t* incomingDataBuffer;
 
+  /*!
+   * @brief Static storage behind incomingDataBuffer. It is never freed, so
+   * lock-free readers can not race with removePackage.
+   */
+  uint8_t dataStorage[MAX_PACKAGE_DATA_LENGTH];
+
+  /*!
+   * @brief Guards dataStorage between the receive thread and readers
+   */
+  SeqLock dataLock;
+
+  uint32_t layoutVersion;
+
+  PackageStats stats;
+  SeqLock      statsLock;
+
   /*!
    * @brief Advanced users can optionally register a callback function
    *        (for each package) to run after every package is received.
@@ -253,6 +341,39 @@ public: // public methods
    */
   ACK::ErrorCode removePackage(int packageID, int timeout); // blocking call
 
+  /*!
+   * @brief Blocking call starting several packages in one round trip
+   *
+   * @details All add commands are sent back to back and their ACKs are
+   * collected concurrently, so the call takes about one ACK round trip
+   * instead of one per package. Packages must be set up with
+   * initPackageFromTopicList first.
+   *
+   * @platforms M210V2, M300
+   * @param packageIDs: Packages to start, each at most once
+   * @param count: Number of entries in packageIDs
+   * @param results: Receives the result of each package, in the order of
+   * packageIDs. A package without ACK before the timeout reports
+   * NO_RESPONSE_ERROR.
+   * @param timeout: Upper bound of the whole call in seconds
+   * @return true if every package was started
+   */
+  bool startPackages(const int* packageIDs, int count,
+                     ACK::ErrorCode* results, int timeout); // blocking call
+
+  /*!
+   * @brief Blocking call removing several packages in one round trip
+   *
+   * @platforms M210V2, M300
+   * @param packageIDs: Packages to remove, each at most once
+   * @param count: Number of entries in packageIDs
+   * @param results: Receives the result of each package, see startPackages
+   * @param timeout: Upper bound of the whole call in seconds
+   * @return true if every package was removed
+   */
+  bool removePackages(const int* packageIDs, int count,
+                      ACK::ErrorCode* results, int timeout); // blocking call
+
   /*!
    * @brief Remove leftover incoming telemetry data due to unclean quit
    *
@@ -261,6 +382,16 @@ public: // public methods
    */
   void removeLeftOverPackages();
 
+  /*!
+   * @brief Drop every package the FC still sends from an unclean quit with
+   * one reset, without waiting for their data to show up first
+   *
+   * @platforms M210V2, M300
+   * @param timeout ACK timeout in seconds
+   * @return false if the reset was not acknowledged
+   */
+  bool resetLeftOverPackages(int timeout);
+
   /*!
    * @brief Remove all occupied packages
    *
@@ -296,10 +427,70 @@ public: // public methods
     int packageID, VehicleCallBack userFunctionAfterPackageExtraction,
     UserData userData = NULL);
 
+  /*!
+   * @brief Start recording every received sample of a topic into history,
+   * see Telemetry::TopicHistory. Replaces a previously enabled history of
+   * the same topic, which is no longer touched once this returns.
+   *
+   * @platforms M210V2, M300
+   * @param history: Caller-owned ring, must stay valid until
+   * disableTopicHistory is called for the topic
+   */
+  template <Telemetry::TopicName topic, uint16_t capacity>
+  void enableTopicHistory(Telemetry::TopicHistory<topic, capacity>* history)
+  {
+    setTopicHistory(topic, history);
+  }
+
+  /*!
+   * @brief Stop recording the history of a topic
+   *
+   * @details Waits for the receive thread to finish a sample it may be
+   * writing, the ring can be destroyed once this returns.
+   *
+   * @platforms M210V2, M300
+   * @param topic
+   */
+  void disableTopicHistory(Telemetry::TopicName topic);
+
+  /*!
+   * @brief Blocking call moving a started package to another frequency
+   *
+   * @details The FC has no command for this, so the package is removed and
+   * added again with the same topics, time stamp setting and unpack
+   * callback. No data arrives for about two ACK round trips, getValue keeps
+   * returning the last received values meanwhile. If the add at newFreq
+   * fails the package is added again at its old frequency.
+   *
+   * @platforms M210V2, M300
+   * @param packageID
+   * @param newFreq: Must not exceed the max frequency of any topic
+   * @param timeout: Timeout in seconds of each step
+   * @return The ACK of the add at newFreq. On an error the package still
+   * runs at its old frequency, unless isOccupied() of it is false, then
+   * the package is lost and has to be set up again.
+   */
+  ACK::ErrorCode changePackageFrequency(int packageID, uint16_t newFreq,
+                                        int timeout); // blocking call
+
+  /*!
+   * @brief Get the receive statistics of package[packageID]
+   *
+   * @platforms M210V2, M300
+   */
+  bool getPackageStats(int packageID, SubscriptionPackage::PackageStats* stats);
+
+  /*!
+   * @brief Get the info of package[packageID]. freq is 0 unless the package
+   * is set up.
+   *
+   * @platforms M210V2, M300
+   */
+  SubscriptionPackage::PackageInfo getPackageInfo(int packageID);
+
   // Not implemented yet
   // bool pausePackage(int packageID);
   // bool resumePackage(int packageID);
-  // bool changePackageFrequency(int packageID, uint16_t newFreq);
 
   /*!
    * @brief Callback function for non-blocking verify()
@@ -333,25 +524,119 @@ public: // public methods
   static void decodeCallback(Vehicle* vehiclePtr, RecvContainer rcvContainer,
                              UserData subscriptionPtr);
 
+  /*!
+   * @brief Register the subscription data handler on the linker.
+   *
+   * @details Packages are decoded straight from the linker's receive buffer
+   * into the package data buffer. The RecvContainer for
+   * registerUserPackageUnpackCallback is only built when such a callback is
+   * registered for the package.
+   *
+   * @platforms M210V2, M300
+   * @return true if the handler was registered
+   */
+  bool registerDataHandler();
+
+  /*!
+   * @brief Decode one subscription frame in place
+   *
+   * @param frame: Frame payload, starting with the package ID
+   * @param length: Length of the payload in bytes
+   * @return The package the frame was decoded into, NULL if it was dropped
+   */
+  SubscriptionPackage* decodeFrame(const uint8_t* frame, uint32_t length);
+
+  /*!
+   * @brief Decode one subscription frame and run the unpack callback of its
+   * package, as the handler registered on the linker does
+   *
+   * @param frame: Frame payload, starting with the package ID
+   * @param length: Length of the payload in bytes
+   * @param seqNum: Sequence number passed on in the RecvContainer
+   * @return The package the frame was decoded into, NULL if it was dropped
+   */
+  SubscriptionPackage* dispatchFrame(const uint8_t* frame, uint32_t length,
+                                     uint16_t seqNum = 0);
+
+  /*!
+   * @brief Set up and start a package without the flight controller
+   *
+   * @details The package is set up as if the flight controller had
+   * acknowledged it, a package already started is replaced. Used to feed
+   * recorded frames through dispatchFrame, see FlightReplay.
+   *
+   * @return false if the topic list is not valid
+   */
+  bool startPackageLocally(int packageID, int numberOfTopics,
+                           Telemetry::TopicName* topicList,
+                           bool sendTimeStamp, uint16_t freq);
+
   template <Telemetry::TopicName           topic>
   typename Telemetry::TypeMap<topic>::type getValue()
   {
     typename Telemetry::TypeMap<topic>::type ans;
 
-    void* p = Telemetry::TopicDataBase[topic].latest;
+    uint8_t* p     = Telemetry::TopicDataBase[topic].latest;
+    uint8_t  pkgID = Telemetry::TopicDataBase[topic].pkgID;
 
-    lockMSG();
-    if (p)
+    if (p && pkgID < MAX_NUMBER_OF_PACKAGE)
     {
-      ans = *reinterpret_cast<typename Telemetry::TypeMap<topic>::type*>(p);
-      freeMSG();
+      package[pkgID].readData(&ans, p, sizeof(ans));
       return ans;
     }
     else
     {
       DERROR("Topic 0x%X value memory not initialized, return default", topic);
     }
-    freeMSG();
+
+    memset(&ans, 0xFF, sizeof(ans));
+    return ans;
+  }
+
+  /*!
+   * @brief Copy all topics of package[packageID] as one consistent snapshot,
+   * without blocking the receive thread. Use getValueFromSnapshot to read
+   * single topics from the copy.
+   *
+   * @platforms M210V2, M300
+   * @param packageID
+   * @param buffer: Destination of the snapshot
+   * @param bufferSize: Size of buffer, at least
+   * SubscriptionPackage::MAX_PACKAGE_DATA_LENGTH is always enough
+   * @param sequence: Optional, receives the sequence number of the snapshot.
+   * Two snapshots with the same sequence number hold the same data.
+   * @return false if the package is not started or buffer is too small
+   */
+  bool getPackageSnapshot(int packageID, uint8_t* buffer, uint32_t bufferSize,
+                          uint32_t* sequence = NULL);
+
+  /*!
+   * @brief Read one topic out of a snapshot taken by getPackageSnapshot
+   *
+   * @platforms M210V2, M300
+   * @param packageID: The package the snapshot was taken from
+   * @param snapshot: The buffer filled by getPackageSnapshot
+   */
+  template <Telemetry::TopicName           topic>
+  typename Telemetry::TypeMap<topic>::type getValueFromSnapshot(
+    int packageID, const uint8_t* snapshot)
+  {
+    typename Telemetry::TypeMap<topic>::type ans;
+
+    uint8_t* p = Telemetry::TopicDataBase[topic].latest;
+
+    if (p && Telemetry::TopicDataBase[topic].pkgID == packageID &&
+        package[packageID].getDataBuffer())
+    {
+      memcpy(&ans, snapshot + (p - package[packageID].getDataBuffer()),
+             sizeof(ans));
+      return ans;
+    }
+    else
+    {
+      DERROR("Topic 0x%X is not in package %d, return default", topic,
+             packageID);
+    }
 
     memset(&ans, 0xFF, sizeof(ans));
     return ans;
@@ -361,16 +646,42 @@ public: // public variables
   const static uint8_t   MAX_NUMBER_OF_PACKAGE = 7;
   VehicleCallBackHandler subscriptionDataDecodeHandler;
 
+private: // private types
+  //! ACK state of one package inside a startPackages/removePackages batch
+  typedef struct BatchSlot
+  {
+    bool              add;
+    bool              pending;
+    //! Bumped for every send, the ACK must echo it to count
+    uint32_t          generation;
+    ACK::ErrorCode    ack;
+  } BatchSlot;
+
 private: // private variables
   Vehicle*            vehicle;
   SubscriptionPackage package[MAX_NUMBER_OF_PACKAGE];
+  BatchSlot           batchSlot[MAX_NUMBER_OF_PACKAGE];
+  T_OsdkMutexHandle   batchLock;
+  T_OsdkMutexHandle   batchSlotLock;
+  T_OsdkSemHandle     batchSem;
+  //! Bumped by the receive thread before and after it writes the histories
+#ifdef __linux__
+  std::atomic<uint32_t> historyPass;
+#else
+  volatile uint32_t   historyPass;
+#endif
 
 private: // private methods
-  void extractOnePackage(RecvContainer*       pRcvContainer,
+  void extractOnePackage(const uint8_t* data, uint32_t length,
                          SubscriptionPackage* pkg);
-  T_OsdkMutexHandle m_msgLock;
-  void lockMSG();
-  void freeMSG();
+  void recordTopicHistory(const uint8_t* data, SubscriptionPackage* pkg);
+  void setTopicHistory(Telemetry::TopicName topic,
+                       Telemetry::TopicHistoryBase* history);
+  bool runPackageBatch(const int* packageIDs, int count,
+                       ACK::ErrorCode* results, int timeout, bool add);
+  static void batchPackageCallback(Vehicle* vehiclePtr,
+                                   RecvContainer rcvContainer,
+                                   UserData tag);
 };
 }
 }
@@ -0,0 +1,179 @@
+/** @file dji_subscription_governor.hpp
+ *  @version 4.0.0
+ *  @date Oct 2026
+ *
+ *  @brief
+ *  Adaptive frequency control of Subscribe-style telemetry packages
+ *
+ *  @Copyright (c) 2026 DJI
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef DJI_SUBSCRIPTION_GOVERNOR_H
+#define DJI_SUBSCRIPTION_GOVERNOR_H
+
+#if defined(__linux__)
+#include <atomic>
+#endif
+#include "dji_platform.hpp"
+#include "dji_subscription.hpp"
+
+namespace DJI
+{
+namespace OSDK
+{
+
+/*! @brief Lowers and raises package frequencies to keep the link and the
+ *  receive thread out of saturation
+ *
+ *  @details Every update() measures, over the time since the previous one,
+ *  - the share of the link bandwidth used by all subscription packages
+ *  - the share of the receive thread time spent in the unpack callback of
+ *    each package
+ *
+ *  When either is above its high threshold for holdPeriods updates in a row,
+ *  the most expensive governed package is moved one frequency step down.
+ *  When both stay below their low threshold, the slowest governed package
+ *  is moved one step up, provided the predicted load stays below the high
+ *  thresholds. Only packages given bounds with setPackageBounds are touched,
+ *  and never outside those bounds. A change goes through
+ *  DataSubscription::changePackageFrequency.
+ *
+ *  @code
+ *  SubscriptionRateGovernor governor(vehicle->subscribe, 921600);
+ *  governor.setPackageBounds(0, 10, 200);
+ *  governor.start(1000);
+ *  @endcode
+ */
+class SubscriptionRateGovernor
+{
+public:
+  /*!
+   * @param subscription: The subscription to govern
+   * @param linkBaudRate: Baud rate of the FC link, 8N1 framing is assumed
+   */
+  SubscriptionRateGovernor(DataSubscription* subscription,
+                           uint32_t          linkBaudRate);
+  ~SubscriptionRateGovernor();
+
+  /*!
+   * @brief Let the governor change the frequency of package[packageID]
+   *
+   * @param minFreq: Lowest frequency the package may be moved to, in Hz
+   * @param maxFreq: Highest frequency the package may be moved to, in Hz
+   * @return false if the bounds are invalid
+   */
+  bool setPackageBounds(int packageID, uint16_t minFreq, uint16_t maxFreq);
+
+  /*!
+   * @brief Stop governing package[packageID], its frequency is kept
+   */
+  void clearPackageBounds(int packageID);
+
+  /*!
+   * @brief Thresholds on the share of the link bandwidth, default 0.4/0.7
+   */
+  bool setLinkThresholds(float low, float high);
+
+  /*!
+   * @brief Thresholds on the share of time spent in one unpack callback,
+   * default 0.2/0.5
+   */
+  bool setCallbackThresholds(float low, float high);
+
+  /*!
+   * @brief Number of updates in a row a condition must hold before a
+   * frequency is changed, default 3. The count restarts after every change.
+   */
+  void setHoldPeriods(uint8_t periods);
+
+  /*!
+   * @brief Run one measurement and control step. Blocks while a package
+   * is renegotiated, without holding off the other calls. An update()
+   * running meanwhile only measures.
+   */
+  void update();
+
+  /*!
+   * @brief Call update() every periodMs from an own task
+   */
+  bool start(uint32_t periodMs);
+  void stop();
+
+  /*!
+   * @brief Link bandwidth share measured by the last update()
+   */
+  float getLinkUtilisation();
+
+private:
+  typedef struct PackageState
+  {
+    bool                              governed;
+    uint16_t                          minFreq;
+    uint16_t                          maxFreq;
+    SubscriptionPackage::PackageStats lastStats;
+    float                             linkLoad;
+    float                             callbackLoad;
+  } PackageState;
+
+  static void* governorTask(void* arg);
+
+  uint16_t stepDown(uint16_t freq, uint16_t minFreq);
+  uint16_t stepUp(uint16_t freq, uint16_t maxFreq);
+  bool     lowerOnePackage(int* packageID, uint16_t* newFreq);
+  bool     raiseOnePackage(int* packageID, uint16_t* newFreq);
+  bool     applyFrequency(int packageID, uint16_t freq);
+
+  DataSubscription* subscription;
+  uint32_t          linkBytesPerSecond;
+  PackageState      state[DataSubscription::MAX_NUMBER_OF_PACKAGE];
+
+  float   linkLow;
+  float   linkHigh;
+  float   callbackLow;
+  float   callbackHigh;
+  uint8_t holdPeriods;
+  uint8_t overloadCount;
+  uint8_t underloadCount;
+
+  float    linkUtilisation;
+  uint32_t lastUpdateMs;
+  //! Set while an update() renegotiates a package outside stateLock
+  bool     renegotiating;
+
+  T_OsdkMutexHandle stateLock;
+  T_OsdkTaskHandle  taskHandle;
+  //! Cuts the sleep between updates short when stopping
+  T_OsdkSemHandle   wakeSem;
+  //! Posted by the task when it leaves its loop
+  T_OsdkSemHandle   exitSem;
+  uint32_t          periodMs;
+#if defined(__linux__)
+  std::atomic<bool> running;
+#else
+  volatile bool     running;
+#endif
+}; // class SubscriptionRateGovernor
+
+} // namespace OSDK
+} // namespace DJI
+
+#endif // DJI_SUBSCRIPTION_GOVERNOR_H
@@ -165,6 +165,8 @@ typedef enum
 } TOPIC_UID;
 
 // clang-format on
+class TopicHistoryBase;
+
 #pragma pack(1)
 
 /*!
@@ -180,6 +182,8 @@ typedef struct
   uint8_t         pkgID;   /* Package ID in which the topic is subscribed */
   /* Point to topic's address in the data buffer which stores the latest data */
   uint8_t* latest;
+  /* Optional sample history, see DataSubscription::enableTopicHistory */
+  TopicHistoryBase* history;
 } TopicInfo; // pack(1)
 
 /*!
@@ -813,63 +817,64 @@ typedef struct LegacyGPSInfo
 extern TopicInfo TopicDataBase[];
 
 /*! @brief template struct maps a topic name to the corresponding data
- * type
+ * type and the max frequency in Hz the FC provides for it
  *
  */
 template <TopicName T>
 struct TypeMap
 {
   typedef void type;
+  static const uint16_t maxFreq = 0;
 };
 
 // clang-format off
-template <> struct TypeMap<TOPIC_QUATERNION               > { typedef Quaternion      type;};
-template <> struct TypeMap<TOPIC_ACCELERATION_GROUND      > { typedef Vector3f        type;};
-template <> struct TypeMap<TOPIC_ACCELERATION_BODY        > { typedef Vector3f        type;};
-template <> struct TypeMap<TOPIC_ACCELERATION_RAW         > { typedef Vector3f        type;};
-template <> struct TypeMap<TOPIC_VELOCITY                 > { typedef Velocity        type;};
-template <> struct TypeMap<TOPIC_ANGULAR_RATE_FUSIONED    > { typedef Vector3f        type;};
-template <> struct TypeMap<TOPIC_ANGULAR_RATE_RAW         > { typedef Vector3f        type;};
-template <> struct TypeMap<TOPIC_ALTITUDE_FUSIONED        > { typedef float32_t       type;};
-template <> struct TypeMap<TOPIC_ALTITUDE_BAROMETER       > { typedef float32_t       type;};
-template <> struct TypeMap<TOPIC_ALTITUDE_OF_HOMEPOINT    > { typedef float32_t       type;};
-template <> struct TypeMap<TOPIC_HEIGHT_FUSION            > { typedef float32_t       type;};
-template <> struct TypeMap<TOPIC_GPS_FUSED                > { typedef GPSFused        type;};
-template <> struct TypeMap<TOPIC_GPS_DATE                 > { typedef uint32_t        type;};
-template <> struct TypeMap<TOPIC_GPS_TIME                 > { typedef uint32_t        type;};
-template <> struct TypeMap<TOPIC_GPS_POSITION             > { typedef Vector3d        type;};
-template <> struct TypeMap<TOPIC_GPS_VELOCITY             > { typedef Vector3f        type;};
-template <> struct TypeMap<TOPIC_GPS_DETAILS              > { typedef GPSDetail       type;};
-template <> struct TypeMap<TOPIC_RTK_POSITION             > { typedef PositionData    type;};
-template <> struct TypeMap<TOPIC_RTK_VELOCITY             > { typedef Vector3f        type;};
-template <> struct TypeMap<TOPIC_RTK_YAW                  > { typedef int16_t         type;};
-template <> struct TypeMap<TOPIC_RTK_POSITION_INFO        > { typedef uint8_t         type;};
-template <> struct TypeMap<TOPIC_RTK_YAW_INFO             > { typedef uint8_t         type;};
-template <> struct TypeMap<TOPIC_COMPASS                  > { typedef Mag             type;};
-template <> struct TypeMap<TOPIC_RC                       > { typedef RC              type;};
-template <> struct TypeMap<TOPIC_GIMBAL_ANGLES            > { typedef Vector3f        type;};
-template <> struct TypeMap<TOPIC_GIMBAL_STATUS            > { typedef GimbalStatus    type;};
-template <> struct TypeMap<TOPIC_STATUS_FLIGHT            > { typedef uint8_t         type;};
-template <> struct TypeMap<TOPIC_STATUS_DISPLAYMODE       > { typedef uint8_t         type;};
-template <> struct TypeMap<TOPIC_STATUS_LANDINGGEAR       > { typedef uint8_t         type;};
-template <> struct TypeMap<TOPIC_STATUS_MOTOR_START_ERROR > { typedef uint16_t        type;};
-template <> struct TypeMap<TOPIC_BATTERY_INFO             > { typedef Battery         type;};
-template <> struct TypeMap<TOPIC_CONTROL_DEVICE           > { typedef SDKInfo         type;};
-template <> struct TypeMap<TOPIC_HARD_SYNC                > { typedef HardSyncData    type;};
-template <> struct TypeMap<TOPIC_GPS_SIGNAL_LEVEL         > { typedef uint8_t         type;};
-template <> struct TypeMap<TOPIC_GPS_CONTROL_LEVEL        > { typedef uint8_t         type;};
-template <> struct TypeMap<TOPIC_RC_FULL_RAW_DATA         > { typedef RCFullRawData   type;};
-template <> struct TypeMap<TOPIC_RC_WITH_FLAG_DATA        > { typedef RCWithFlagData  type;};
-template <> struct TypeMap<TOPIC_ESC_DATA                 > { typedef EscData         type;};
-template <> struct TypeMap<TOPIC_RTK_CONNECT_STATUS       > { typedef RTKConnectStatus type;};
-template <> struct TypeMap<TOPIC_GIMBAL_CONTROL_MODE      > { typedef GimbalControlMode type;};
-template <> struct TypeMap<TOPIC_FLIGHT_ANOMALY           > { typedef FlightAnomaly   type;};
-template <> struct TypeMap<TOPIC_POSITION_VO              > { typedef LocalPositionVO type;};
-template <> struct TypeMap<TOPIC_AVOID_DATA               > { typedef RelativePosition type;};
-template <> struct TypeMap<TOPIC_HOME_POINT_SET_STATUS    > { typedef HomeLocationSetStatus type;};
-template <> struct TypeMap<TOPIC_HOME_POINT_INFO          > { typedef HomeLocationData type;};
-template <> struct TypeMap<TOPIC_DUAL_GIMBAL_DATA         > { typedef GimbalDualData   type;};
-template <> struct TypeMap<TOPIC_THREE_GIMBAL_DATA        > { typedef GimbalThreeData  type;};
+template <> struct TypeMap<TOPIC_QUATERNION               > { typedef Quaternion      type; static const uint16_t maxFreq = 200;};
+template <> struct TypeMap<TOPIC_ACCELERATION_GROUND      > { typedef Vector3f        type; static const uint16_t maxFreq = 200;};
+template <> struct TypeMap<TOPIC_ACCELERATION_BODY        > { typedef Vector3f        type; static const uint16_t maxFreq = 200;};
+template <> struct TypeMap<TOPIC_ACCELERATION_RAW         > { typedef Vector3f        type; static const uint16_t maxFreq = 400;};
+template <> struct TypeMap<TOPIC_VELOCITY                 > { typedef Velocity        type; static const uint16_t maxFreq = 200;};
+template <> struct TypeMap<TOPIC_ANGULAR_RATE_FUSIONED    > { typedef Vector3f        type; static const uint16_t maxFreq = 200;};
+template <> struct TypeMap<TOPIC_ANGULAR_RATE_RAW         > { typedef Vector3f        type; static const uint16_t maxFreq = 400;};
+template <> struct TypeMap<TOPIC_ALTITUDE_FUSIONED        > { typedef float32_t       type; static const uint16_t maxFreq = 200;};
+template <> struct TypeMap<TOPIC_ALTITUDE_BAROMETER       > { typedef float32_t       type; static const uint16_t maxFreq = 200;};
+template <> struct TypeMap<TOPIC_ALTITUDE_OF_HOMEPOINT    > { typedef float32_t       type; static const uint16_t maxFreq = 1  ;};
+template <> struct TypeMap<TOPIC_HEIGHT_FUSION            > { typedef float32_t       type; static const uint16_t maxFreq = 100;};
+template <> struct TypeMap<TOPIC_GPS_FUSED                > { typedef GPSFused        type; static const uint16_t maxFreq = 50 ;};
+template <> struct TypeMap<TOPIC_GPS_DATE                 > { typedef uint32_t        type; static const uint16_t maxFreq = 5  ;};
+template <> struct TypeMap<TOPIC_GPS_TIME                 > { typedef uint32_t        type; static const uint16_t maxFreq = 5  ;};
+template <> struct TypeMap<TOPIC_GPS_POSITION             > { typedef Vector3d        type; static const uint16_t maxFreq = 5  ;};
+template <> struct TypeMap<TOPIC_GPS_VELOCITY             > { typedef Vector3f        type; static const uint16_t maxFreq = 5  ;};
+template <> struct TypeMap<TOPIC_GPS_DETAILS              > { typedef GPSDetail       type; static const uint16_t maxFreq = 5  ;};
+template <> struct TypeMap<TOPIC_RTK_POSITION             > { typedef PositionData    type; static const uint16_t maxFreq = 5  ;};
+template <> struct TypeMap<TOPIC_RTK_VELOCITY             > { typedef Vector3f        type; static const uint16_t maxFreq = 5  ;};
+template <> struct TypeMap<TOPIC_RTK_YAW                  > { typedef int16_t         type; static const uint16_t maxFreq = 5  ;};
+template <> struct TypeMap<TOPIC_RTK_POSITION_INFO        > { typedef uint8_t         type; static const uint16_t maxFreq = 5  ;};
+template <> struct TypeMap<TOPIC_RTK_YAW_INFO             > { typedef uint8_t         type; static const uint16_t maxFreq = 5  ;};
+template <> struct TypeMap<TOPIC_COMPASS                  > { typedef Mag             type; static const uint16_t maxFreq = 100;};
+template <> struct TypeMap<TOPIC_RC                       > { typedef RC              type; static const uint16_t maxFreq = 50 ;};
+template <> struct TypeMap<TOPIC_GIMBAL_ANGLES            > { typedef Vector3f        type; static const uint16_t maxFreq = 50 ;};
+template <> struct TypeMap<TOPIC_GIMBAL_STATUS            > { typedef GimbalStatus    type; static const uint16_t maxFreq = 50 ;};
+template <> struct TypeMap<TOPIC_STATUS_FLIGHT            > { typedef uint8_t         type; static const uint16_t maxFreq = 50 ;};
+template <> struct TypeMap<TOPIC_STATUS_DISPLAYMODE       > { typedef uint8_t         type; static const uint16_t maxFreq = 50 ;};
+template <> struct TypeMap<TOPIC_STATUS_LANDINGGEAR       > { typedef uint8_t         type; static const uint16_t maxFreq = 50 ;};
+template <> struct TypeMap<TOPIC_STATUS_MOTOR_START_ERROR > { typedef uint16_t        type; static const uint16_t maxFreq = 50 ;};
+template <> struct TypeMap<TOPIC_BATTERY_INFO             > { typedef Battery         type; static const uint16_t maxFreq = 50 ;};
+template <> struct TypeMap<TOPIC_CONTROL_DEVICE           > { typedef SDKInfo         type; static const uint16_t maxFreq = 50 ;};
+template <> struct TypeMap<TOPIC_HARD_SYNC                > { typedef HardSyncData    type; static const uint16_t maxFreq = 400;};
+template <> struct TypeMap<TOPIC_GPS_SIGNAL_LEVEL         > { typedef uint8_t         type; static const uint16_t maxFreq = 50 ;};
+template <> struct TypeMap<TOPIC_GPS_CONTROL_LEVEL        > { typedef uint8_t         type; static const uint16_t maxFreq = 50 ;};
+template <> struct TypeMap<TOPIC_RC_FULL_RAW_DATA         > { typedef RCFullRawData   type; static const uint16_t maxFreq = 50 ;};
+template <> struct TypeMap<TOPIC_RC_WITH_FLAG_DATA        > { typedef RCWithFlagData  type; static const uint16_t maxFreq = 50 ;};
+template <> struct TypeMap<TOPIC_ESC_DATA                 > { typedef EscData         type; static const uint16_t maxFreq = 50 ;};
+template <> struct TypeMap<TOPIC_RTK_CONNECT_STATUS       > { typedef RTKConnectStatus type; static const uint16_t maxFreq = 50 ;};
+template <> struct TypeMap<TOPIC_GIMBAL_CONTROL_MODE      > { typedef GimbalControlMode type; static const uint16_t maxFreq = 50 ;};
+template <> struct TypeMap<TOPIC_FLIGHT_ANOMALY           > { typedef FlightAnomaly   type; static const uint16_t maxFreq = 50 ;};
+template <> struct TypeMap<TOPIC_POSITION_VO              > { typedef LocalPositionVO type; static const uint16_t maxFreq = 200;};
+template <> struct TypeMap<TOPIC_AVOID_DATA               > { typedef RelativePosition type; static const uint16_t maxFreq = 100;};
+template <> struct TypeMap<TOPIC_HOME_POINT_SET_STATUS    > { typedef HomeLocationSetStatus type; static const uint16_t maxFreq = 50 ;};
+template <> struct TypeMap<TOPIC_HOME_POINT_INFO          > { typedef HomeLocationData type; static const uint16_t maxFreq = 50 ;};
+template <> struct TypeMap<TOPIC_DUAL_GIMBAL_DATA         > { typedef GimbalDualData   type; static const uint16_t maxFreq = 50 ;};
+template <> struct TypeMap<TOPIC_THREE_GIMBAL_DATA        > { typedef GimbalThreeData  type; static const uint16_t maxFreq = 50 ;};
 // clang-format on
 }
 }
@@ -0,0 +1,209 @@
+/** @file dji_topic_history.hpp
+ *  @version 4.0.0
+ *  @date Oct 2026
+ *
+ *  @brief
+ *  Timestamped per-topic sample history for Subscribe-style telemetry
+ *
+ *  @Copyright (c) 2026 DJI
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef DJI_TOPIC_HISTORY_H
+#define DJI_TOPIC_HISTORY_H
+
+#include "dji_seqlock.hpp"
+#include "dji_telemetry.hpp"
+
+namespace DJI
+{
+namespace OSDK
+{
+namespace Telemetry
+{
+
+/*! @brief Type-erased interface used by DataSubscription to feed a history
+ *
+ *  @note This class is internal, use TopicHistory instead.
+ */
+class TopicHistoryBase
+{
+public:
+  virtual ~TopicHistoryBase()
+  {
+  }
+
+  /*!
+   * @brief Append one sample. Called from the receive thread only.
+   *
+   * @param data: Raw topic data inside the received package
+   * @param timeUs: Local receive time stamp, see getMonotonicTimeUs()
+   */
+  virtual void record(const uint8_t* data, uint64_t timeUs) = 0;
+
+  virtual TopicName getTopic() const = 0;
+};
+
+/*! @brief Fixed-size ring of the most recent samples of one topic
+ *
+ *  @details Every received sample is stored with its local receive time and
+ *  a per-topic sequence number starting at 1, so a consumer running slower
+ *  than the topic frequency can still fetch every sample it missed. All
+ *  storage lives inside the object; recording and reading never touch the
+ *  heap. The receive thread never blocks on readers.
+ *
+ *  Register an instance with DataSubscription::enableTopicHistory. The
+ *  object must outlive the registration.
+ *
+ *  @tparam topic: The topic to record
+ *  @tparam capacity: Number of samples kept
+ */
+template <TopicName topic, uint16_t capacity>
+class TopicHistory : public TopicHistoryBase
+{
+public:
+  typedef typename TypeMap<topic>::type ValueType;
+
+  typedef struct Sample
+  {
+    ValueType value;
+    uint64_t  timeUs;   /*!< Local receive time stamp */
+    uint32_t  sequence; /*!< Per-topic sample number, starting at 1 */
+  } Sample;
+
+  TopicHistory()
+    : latestSequence(0)
+  {
+  }
+
+  virtual void record(const uint8_t* data, uint64_t timeUs)
+  {
+    uint32_t seq  = latestSequence + 1;
+    Sample*  slot = &ring[seq % capacity];
+
+    lock.writeBegin();
+    memcpy(&slot->value, data, sizeof(ValueType));
+    slot->timeUs   = timeUs;
+    slot->sequence = seq;
+    latestSequence = seq;
+    lock.writeEnd();
+  }
+
+  virtual TopicName getTopic() const
+  {
+    return topic;
+  }
+
+  /*!
+   * @brief Sequence number of the newest sample, 0 if nothing was recorded
+   */
+  uint32_t getLatestSequence() const
+  {
+    uint32_t seq;
+    lock.read(&seq, &latestSequence, sizeof(seq));
+    return seq;
+  }
+
+  /*!
+   * @brief Copy all samples newer than sequence, oldest first
+   *
+   * @details If more than capacity samples arrived since sequence, the
+   * oldest ones are gone and the first returned sample has a sequence
+   * greater than sequence + 1.
+   *
+   * @param sequence: Sequence of the last sample already consumed, 0 for all
+   * @param samples: Destination array
+   * @param maxCount: Size of the destination array
+   * @return Number of samples copied
+   */
+  uint32_t getSamplesSince(uint32_t sequence, Sample* samples,
+                           uint32_t maxCount) const
+  {
+    uint32_t start;
+    uint32_t count;
+    do
+    {
+      start           = lock.readBegin();
+      uint32_t newest = latestSequence;
+      uint32_t first  = sequence + 1;
+      if (newest >= capacity && first <= newest - capacity)
+      {
+        first = newest - capacity + 1;
+      }
+      count = 0;
+      for (uint32_t seq = first; seq <= newest && count < maxCount; ++seq)
+      {
+        memcpy(&samples[count++], &ring[seq % capacity], sizeof(Sample));
+      }
+    } while (lock.readRetry(start));
+    return count;
+  }
+
+  /*!
+   * @brief Copy the sample whose receive time is closest to timeUs
+   *
+   * @param timeUs: Local time as returned by getMonotonicTimeUs()
+   * @param sample: Destination
+   * @return false if no sample was recorded yet
+   */
+  bool getSampleNearest(uint64_t timeUs, Sample* sample) const
+  {
+    uint32_t start;
+    bool     found;
+    do
+    {
+      start           = lock.readBegin();
+      uint32_t newest = latestSequence;
+      uint32_t oldest = (newest >= capacity) ? newest - capacity + 1 : 1;
+      found           = false;
+      // Samples are in receive order, walk back from the newest until the
+      // distance to timeUs starts growing
+      for (uint32_t seq = newest; seq >= oldest && seq > 0; --seq)
+      {
+        const Sample* s = &ring[seq % capacity];
+        if (found && distance(s->timeUs, timeUs) >
+                       distance(sample->timeUs, timeUs))
+        {
+          break;
+        }
+        memcpy(sample, s, sizeof(Sample));
+        found = true;
+      }
+    } while (lock.readRetry(start));
+    return found;
+  }
+
+private:
+  static uint64_t distance(uint64_t a, uint64_t b)
+  {
+    return (a > b) ? a - b : b - a;
+  }
+
+  Sample   ring[capacity];
+  uint32_t latestSequence;
+  SeqLock  lock;
+}; // class TopicHistory
+
+} // namespace Telemetry
+} // namespace OSDK
+} // namespace DJI
+
+#endif // DJI_TOPIC_HISTORY_H
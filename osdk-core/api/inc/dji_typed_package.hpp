@@ -0,0 +1,265 @@
+/** @file dji_typed_package.hpp
+ *  @version 4.0.0
+ *  @date Oct 2026
+ *
+ *  @brief
+ *  Compile-time typed packages for Subscribe-style telemetry
+ *
+ *  @Copyright (c) 2026 DJI
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef DJI_TYPED_PACKAGE_H
+#define DJI_TYPED_PACKAGE_H
+
+//! Needs <type_traits> and variadic templates, which ARMCC5 does not have
+#if defined(__linux__)
+
+#include <type_traits>
+#include "dji_subscription.hpp"
+
+namespace DJI
+{
+namespace OSDK
+{
+namespace Telemetry
+{
+
+/*! @brief Compile-time properties of a list of topics, in package order */
+template <TopicName... topics>
+struct TopicListInfo;
+
+template <>
+struct TopicListInfo<>
+{
+  static const uint32_t size    = 0;
+  static const uint16_t maxFreq = 0xFFFF;
+};
+
+template <TopicName head, TopicName... tail>
+struct TopicListInfo<head, tail...>
+{
+  static const uint32_t size =
+    sizeof(typename TypeMap<head>::type) + TopicListInfo<tail...>::size;
+  static const uint16_t maxFreq =
+    (TypeMap<head>::maxFreq < TopicListInfo<tail...>::maxFreq)
+      ? TypeMap<head>::maxFreq
+      : TopicListInfo<tail...>::maxFreq;
+};
+
+/*! @brief Byte offset of topic inside the data of a package made of topics */
+template <TopicName topic, TopicName... topics>
+struct TopicOffset;
+
+template <TopicName topic>
+struct TopicOffset<topic>
+{
+  static_assert(sizeof(TypeMap<topic>) == 0,
+                "Topic is not part of this TypedPackage");
+};
+
+template <TopicName topic, TopicName head, TopicName... tail>
+struct TopicOffsetAfter
+{
+  static const uint32_t value =
+    sizeof(typename TypeMap<head>::type) + TopicOffset<topic, tail...>::value;
+};
+
+// Only the selected branch is instantiated, so the search stops at the first
+// match and the static_assert above fires only for unknown topics
+template <TopicName topic, TopicName head, TopicName... tail>
+struct TopicOffset<topic, head, tail...>
+  : std::conditional<topic == head, std::integral_constant<uint32_t, 0>,
+                     TopicOffsetAfter<topic, head, tail...> >::type
+{
+};
+
+#pragma pack(1)
+/*! @brief Packed struct with one member per topic, laid out exactly like
+ * the data the FC sends for the package
+ */
+template <TopicName... topics>
+struct PackedTopics;
+
+template <TopicName head>
+struct PackedTopics<head>
+{
+  typename TypeMap<head>::type value;
+};
+
+template <TopicName head, TopicName... tail>
+struct PackedTopics<head, tail...>
+{
+  typename TypeMap<head>::type value;
+  PackedTopics<tail...>        next;
+};
+#pragma pack()
+
+} // namespace Telemetry
+
+/*! @brief Subscription package whose layout is fixed at compile time
+ *
+ *  @details The package size and the offset of every topic are computed
+ *  from Telemetry::TypeMap, so reading a topic is a load at a constant
+ *  offset instead of a TopicDataBase lookup. Topic lists that do not fit in
+ *  a package and frequencies given as template argument above the FC limit
+ *  are rejected by the compiler.
+ *
+ *  @code
+ *  TypedPackage<TOPIC_QUATERNION, TOPIC_VELOCITY> pkg(vehicle->subscribe, 0);
+ *  pkg.init<50>();
+ *  pkg.start(1);
+ *  TypedPackage<TOPIC_QUATERNION, TOPIC_VELOCITY>::Data data;
+ *  if (pkg.read(&data))
+ *  {
+ *    Telemetry::Quaternion q = pkg.get<TOPIC_QUATERNION>(data);
+ *  }
+ *  @endcode
+ *
+ *  @tparam topics: Topics of the package, in the order they are sent
+ */
+template <Telemetry::TopicName... topics>
+class TypedPackage
+{
+public:
+  typedef Telemetry::PackedTopics<topics...> Data;
+
+  static const uint8_t  NUMBER_OF_TOPICS = sizeof...(topics);
+  static const uint32_t DATA_SIZE = Telemetry::TopicListInfo<topics...>::size;
+  static const uint16_t MAX_FREQ =
+    Telemetry::TopicListInfo<topics...>::maxFreq;
+
+  static_assert(sizeof...(topics) > 0, "A package needs at least one topic");
+  static_assert(sizeof(Data) == DATA_SIZE, "Package view is not packed");
+  static_assert(DATA_SIZE <= SubscriptionPackage::MAX_PACKAGE_DATA_LENGTH,
+                "Too many topics for one package");
+
+  TypedPackage(DataSubscription* subscription, int packageID)
+    : subscription(subscription)
+    , packageID(packageID)
+    , sendTimeStamp(false)
+  {
+  }
+
+  /*!
+   * @brief Set up the package with a frequency checked at compile time
+   *
+   * @tparam freq: Frequency of the package in Hz
+   * @param sendTimeStamp: Ask the FC to prefix every package with a
+   * Telemetry::TimeStamp
+   */
+  template <uint16_t freq>
+  bool init(bool sendTimeStamp = false)
+  {
+    static_assert(freq > 0 && freq <= MAX_FREQ,
+                  "Frequency exceeds the max frequency of a topic");
+    return init(freq, sendTimeStamp);
+  }
+
+  /*!
+   * @brief Set up the package with a frequency only known at runtime
+   */
+  bool init(uint16_t freq, bool sendTimeStamp = false)
+  {
+    if (freq == 0 || freq > MAX_FREQ)
+    {
+      DERROR("Package %d frequency %d out of range, max %d", packageID, freq,
+             MAX_FREQ);
+      return false;
+    }
+    Telemetry::TopicName topicList[] = { topics... };
+    this->sendTimeStamp              = sendTimeStamp;
+    return subscription->initPackageFromTopicList(
+      packageID, NUMBER_OF_TOPICS, topicList, sendTimeStamp, freq);
+  }
+
+  ACK::ErrorCode start(int timeout)
+  {
+    return subscription->startPackage(packageID, timeout);
+  }
+
+  ACK::ErrorCode remove(int timeout)
+  {
+    return subscription->removePackage(packageID, timeout);
+  }
+
+  /*!
+   * @brief Copy the latest package as one consistent snapshot
+   *
+   * @param data: Destination view
+   * @param sequence: Optional, receives the sequence of the snapshot
+   * @return false if the package is not started
+   */
+  bool read(Data* data, uint32_t* sequence = NULL)
+  {
+    if (!sendTimeStamp)
+    {
+      return subscription->getPackageSnapshot(
+        packageID, reinterpret_cast<uint8_t*>(data), sizeof(Data), sequence);
+    }
+
+    uint8_t buffer[sizeof(Telemetry::TimeStamp) + sizeof(Data)];
+    if (!subscription->getPackageSnapshot(packageID, buffer, sizeof(buffer),
+                                          sequence))
+    {
+      return false;
+    }
+    memcpy(data, buffer + sizeof(Telemetry::TimeStamp), sizeof(Data));
+    return true;
+  }
+
+  /*!
+   * @brief Read one topic out of a view filled by read()
+   */
+  template <Telemetry::TopicName topic>
+  static typename Telemetry::TypeMap<topic>::type get(const Data& data)
+  {
+    typename Telemetry::TypeMap<topic>::type ans;
+    memcpy(&ans,
+           reinterpret_cast<const uint8_t*>(&data) +
+             Telemetry::TopicOffset<topic, topics...>::value,
+           sizeof(ans));
+    return ans;
+  }
+
+  int getPackageID() const
+  {
+    return packageID;
+  }
+
+private:
+  DataSubscription* subscription;
+  int               packageID;
+  bool              sendTimeStamp;
+}; // class TypedPackage
+
+template <Telemetry::TopicName... topics>
+const uint8_t TypedPackage<topics...>::NUMBER_OF_TOPICS;
+template <Telemetry::TopicName... topics>
+const uint32_t TypedPackage<topics...>::DATA_SIZE;
+template <Telemetry::TopicName... topics>
+const uint16_t TypedPackage<topics...>::MAX_FREQ;
+
+} // namespace OSDK
+} // namespace DJI
+
+#endif // __linux__
+#endif // DJI_TYPED_PACKAGE_H
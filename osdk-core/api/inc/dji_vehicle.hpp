@@ -32,6 +32,7 @@
 
 #include <stdio.h>
 #include <cstdint>
+#include <vector>
 #include "dji_status.hpp"
 #include "dji_ack.hpp"
 #include "dji_type.hpp"
@@ -44,6 +45,8 @@
 #include "dji_camera.hpp"
 #include "dji_control.hpp"
 #include "dji_subscription.hpp"
+#include "dji_typed_package.hpp"
+#include "dji_subscription_governor.hpp"
 #include "dji_mobile_device.hpp"
 #include "dji_payload_device.hpp"
 #include "dji_hardware_sync.hpp"
@@ -93,6 +96,32 @@ public:
   } ActivateData; // pack(1)
 #pragma pack()
 
+  /*! Flags for setStartupMode, may be or-ed together */
+  typedef enum StartupFlag
+  {
+    //! Bring the subsystems up one after another, the default
+    STARTUP_SEQUENTIAL = 0x00,
+    //! Run the subsystems that wait on the aircraft on their own tasks
+    STARTUP_PARALLEL   = 0x01,
+    //! Create the optional managers on their first get*() call only
+    STARTUP_LAZY       = 0x02,
+    //! Drop packages left on the FC with one subscription reset instead of
+    //! waiting 1.2 s for their data. The reset clears every package on the
+    //! FC, also those of another program, so only use it when this one is
+    //! the only subscriber.
+    STARTUP_RESET_SUBSCRIPTION = 0x04
+  } StartupFlag;
+
+  /*! One entry of the startup timeline */
+  typedef struct StartupStage
+  {
+    const char* name;
+    //! Relative to the start of functionalSetUp
+    uint32_t    startMs;
+    uint32_t    durationMs;
+    bool        success;
+  } StartupStage;
+
 public:
   Vehicle(Linker* linker);
   ~Vehicle();
@@ -129,6 +158,32 @@ public:
 
   DJIBattery*         djiBattery;
   int functionalSetUp();
+
+  /*! @brief Choose how functionalSetUp brings up the subsystems
+   *
+   *  @details Call before activate(). With STARTUP_LAZY the managers below
+   *  stay NULL until their getter is called the first time, so use the
+   *  getters instead of the members. STARTUP_PARALLEL needs a multi-thread
+   *  platform and is ignored otherwise.
+   *  @param flags or-ed StartupFlag values
+   */
+  void setStartupMode(uint8_t flags);
+
+  /*! @brief Time spent in every startup stage, including the ones done
+   *  lazily since
+   */
+  std::vector<StartupStage> getStartupTimeline();
+
+  MobileDevice*  getMobileDevice();
+  PayloadDevice* getPayloadDevice();
+  CameraManager* getCameraManager();
+  PSDKManager*   getPSDKManager();
+  GimbalManager* getGimbalManager();
+#if defined(__linux__)
+  WaypointV2MissionOperator* getWaypointV2Mission();
+  DJIHMS*        getDJIHms();
+  MopServer*     getMopServer();
+#endif
   ////////// Blocking calls ///////////
 
   /**
@@ -298,6 +353,7 @@ public:
    */
   bool initLegacyLinker();
   bool initSubscriber();
+  bool cleanSubscriber();
   bool initBroadcast();
   bool initControl();
   bool initCamera();
@@ -335,6 +391,50 @@ public:
 private:
   Firewall *firewall;
   bool initFirewall();
+#ifdef ADVANCED_SENSING
+  bool startAdvancedSensing();
+#endif
+
+  typedef bool (Vehicle::*InitFunc)();
+
+  //! One subsystem of init(). Stages of the same lane run in order, lane 0
+  //! on the calling thread and every other lane on its own task.
+  //! STARTUP_LANE_BEFORE and STARTUP_LANE_AFTER run on the calling thread
+  //! before the tasks start and after they are joined.
+  typedef struct StartupEntry
+  {
+    const char* name;
+    InitFunc    init;
+    int         lane;
+    bool        required;
+    bool        lazy;
+  } StartupEntry;
+
+  typedef struct StartupLane
+  {
+    Vehicle*            vehicle;
+    int                 lane;
+    bool                success;
+    T_OsdkTaskHandle    task;
+  } StartupLane;
+
+  static const int    STARTUP_LANES       = 4;
+  static const int    STARTUP_LANE_BEFORE = -1;
+  static const int    STARTUP_LANE_AFTER  = -2;
+  uint8_t             startupFlags;
+  uint32_t            startupBaseMs;
+  std::vector<StartupStage> startupTimeline;
+  T_OsdkMutexHandle   startupLock;
+  T_OsdkMutexHandle   lazyInitLock;
+  T_OsdkSemHandle     startupSem;
+
+  static const StartupEntry* getStartupEntries(size_t* count);
+  bool runStartupStage(const StartupEntry& entry);
+  bool runStartupLane(int lane);
+  static void* startupLaneTask(void* arg);
+  template <typename T>
+  T* getLazily(T* const& member, const char* name, InitFunc init);
+  void recordStartupStage(const char* name, uint32_t startMs, bool success);
 
   void setActivationStatus(bool is_activated);
   void initCMD_SetSupportMatrix();
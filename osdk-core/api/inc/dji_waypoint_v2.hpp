@@ -46,6 +46,22 @@ namespace OSDK
                                      const T_CmdInfo *cmdInfo,
                                      const uint8_t *cmdData, void *userData);
 
+  /*! @brief Counters of the last mission or action upload
+   *
+   *  @platforms M300
+   */
+  typedef struct WaypointV2UploadStats
+  {
+    /*! chunks acknowledged by the flight controller */
+    uint32_t chunks;
+    /*! chunks sent again after a timeout or a partial ACK */
+    uint32_t retransmissions;
+    /*! payload bytes acknowledged */
+    uint32_t bytes;
+    uint32_t elapsedMs;
+    uint32_t bytesPerSecond;
+  } WaypointV2UploadStats;
+
  /*! The waypoint operator is the only object that controls, runs and monitors
   *  Waypoint v2 Missions.
   */
@@ -53,6 +69,10 @@ namespace OSDK
   {
   public:
     const uint16_t MAX_WAYPOINT_NUM_SIGNAL_PUSH = 260;
+    static const int MAX_UPLOAD_WINDOW_SIZE = 8;
+    /*! Stop-and-wait until wider windows are validated on flight controller
+     *  firmware, see setUploadWindowSize */
+    static const int DEFAULT_UPLOAD_WINDOW_SIZE = 1;
 
     WaypointV2MissionOperator(Vehicle* vehiclePtr);
 
@@ -232,7 +252,43 @@ namespace OSDK
     */
     void RegisterMissionStateCallback(void *userData, PushCallback cb = NULL) ;
 
+    /*! @brief Set how many upload chunks may wait for their ACK at once
+     *
+     *  @platforms M300
+     *  @note Sizes above 1 have not been validated against flight controller
+     *  firmware yet and stay opt-in. Check the result with downloadMission.
+     *  @param size 1 to MAX_UPLOAD_WINDOW_SIZE, 1 uploads stop-and-wait
+     */
+    void setUploadWindowSize(int size);
+
+    /*! @brief Get the counters of the last uploadMission or uploadAction
+     *
+     *  @platforms M300
+     *  @return WaypointV2UploadStats counters
+     */
+    WaypointV2UploadStats getUploadStats();
+
   private:
+    static const int UPLOAD_BUFFER_SIZE = 400;
+
+    /*! One chunk of an upload, kept until the flight controller ACKs it */
+    typedef struct UploadSlot
+    {
+      WaypointV2MissionOperator *op;
+      T_CmdInfo cmdInfo;
+      uint8_t data[UPLOAD_BUFFER_SIZE];
+      uint16_t len;
+      /*! waypoint or action range carried by the chunk */
+      uint16_t startIndex;
+      uint16_t endIndex;
+      uint8_t transmissions;
+      bool inUse;
+      bool pending;
+      E_OsdkStat linkAck;
+      uint32_t ackLen;
+      UploadMissionRawAck ack;
+    } UploadSlot;
+
     std::vector<WaypointV2> missionV2;
     DJIWaypointV2MissionState currentState;
     DJIWaypointV2MissionState prevState;
@@ -240,8 +296,24 @@ namespace OSDK
 
     float32_t takeoffAltitude;
 
+    UploadSlot uploadSlot[MAX_UPLOAD_WINDOW_SIZE];
+    int uploadWindowSize;
+    WaypointV2UploadStats uploadStats;
+    T_OsdkMutexHandle uploadLock;
+    T_OsdkMutexHandle uploadSlotLock;
+    T_OsdkSemHandle uploadSem;
+
     void RegisterOSDInfoCallback(Vehicle *vehiclePtr);
 
+    ErrorCode::ErrorCodeType runWindowedUpload(
+        const uint8_t cmd[], const std::vector<WaypointV2Internal> *mission,
+        std::vector<DJIWaypointV2Action> *actions, int timeout);
+    void sendUploadSlot(UploadSlot &slot, uint32_t timeoutMs);
+    bool drainUploadSlots(uint32_t timeoutMs);
+    static void uploadAckCallback(const T_CmdInfo *cmdInfo,
+                                  const uint8_t *cmdData, void *userData,
+                                  E_OsdkStat cb_type);
+
   };
 
 } // namespace OSDK
@@ -28,6 +28,7 @@
  */
 
 #include "dji_broadcast.hpp"
+#include "dji_flight_recorder.hpp"
 #include "dji_vehicle.hpp"
 
 using namespace DJI;
@@ -39,6 +40,16 @@ DataBroadcast::unpackCallback(Vehicle* vehicle, RecvContainer recvFrame,
 {
   DataBroadcast* broadcastPtr = (DataBroadcast*)data;
 
+#if defined(__linux__)
+  if (FlightRecorder::instance().isRecording() &&
+      recvFrame.recvInfo.len > OpenProtocol::PackageMin)
+  {
+    FlightRecorder::instance().recordBroadcast(
+      recvFrame.recvData.raw_ack_array,
+      recvFrame.recvInfo.len - OpenProtocol::PackageMin);
+  }
+#endif
+
   if (broadcastPtr->getVehicle()->isLegacyM600())
   {
     broadcastPtr->unpackOldM600Data(&recvFrame);
@@ -68,6 +79,7 @@ DataBroadcast::DataBroadcast(Vehicle* vehiclePtr)
   userCbHandler.userData = 0;
 
   Platform::instance().mutexCreate(&m_msgLock);
+  memset(&published, 0, sizeof(published));
   if (vehiclePtr)
   {
     setVehicle(vehiclePtr);
@@ -85,284 +97,112 @@ DataBroadcast::~DataBroadcast()
 Telemetry::TimeStamp
 DataBroadcast::getTimeStamp()
 {
-  Telemetry::TimeStamp  data;
-  lockMSG();
-  if (vehicle->isLegacyM600())
-  {
-    // Supported Broadcast data in Matrice 600 old firmware
-    data.time_ms = legacyTimeStamp.time;
-    data.time_ns = legacyTimeStamp.nanoTime;
-  }
-  else if(vehicle->isM100())
-  {
-    // Supported Broadcast data in Matrice 100
-    data.time_ms = legacyTimeStamp.time;
-    data.time_ns = legacyTimeStamp.nanoTime;
-  }
-  else
-  {
-    data = timeStamp;
-  }
-  freeMSG();
-  return data;
+  return readPublished(published.timeStamp);
 }
 
 Telemetry::SyncStamp
 DataBroadcast::getSyncStamp()
 {
-  Telemetry::SyncStamp data = {0};
-  lockMSG();
-  if (vehicle->isLegacyM600())
-  {
-    // Supported Broadcast data in Matrice 600 old firmware
-    data.flag = legacyTimeStamp.syncFlag;
-  }
-  else if(vehicle->isM100())
-  {
-    // Supported Broadcast data in Matrice 100
-    data.flag = legacyTimeStamp.syncFlag;
-  }
-  else
-  {
-    data = syncStamp;
-  }
-  freeMSG();
-  return data;
+  return readPublished(published.syncStamp);
 }
 
 Telemetry::Quaternion
 DataBroadcast::getQuaternion()
 {
-  Telemetry::Quaternion data;
-  lockMSG();
-  data = q;
-  freeMSG();
-  return data;
+  return readPublished(published.q);
 }
 
 Telemetry::Vector3f
 DataBroadcast::getAcceleration()
 {
-  Telemetry::Vector3f data;
-  lockMSG();
-  data = a;
-  freeMSG();
-  return data;
+  return readPublished(published.a);
 }
 
 Telemetry::Vector3f
 DataBroadcast::getVelocity()
 {
-  Telemetry::Vector3f data;
-  lockMSG();
-  if (vehicle->isLegacyM600())
-  {
-    // Supported Broadcast data in Matrice 600 old firmware
-    data.x = legacyVelocity.x;
-    data.y = legacyVelocity.y;
-    data.z = legacyVelocity.z;
-  }
-  else if(vehicle->isM100())
-  {
-    // Supported Broadcast data in Matrice 100
-    data.x = legacyVelocity.x;
-    data.y = legacyVelocity.y;
-    data.z = legacyVelocity.z;
-  }
-  else
-  {
-    data = v;
-  }
-  freeMSG();
-  return data;
+  return readPublished(published.v);
 }
 
 Telemetry::VelocityInfo
 DataBroadcast::getVelocityInfo()
 {
-  Telemetry::VelocityInfo data;
-  lockMSG();
-  if (vehicle->isLegacyM600())
-  {
-    // Supported Broadcast data in Matrice 600 old firmware
-    data.health = legacyVelocity.health;
-    data.reserve = legacyVelocity.reserve;
-  }
-  else if(vehicle->isM100())
-  {
-    // Supported Broadcast data in Matrice 100
-    data.health = legacyVelocity.health;
-    data.reserve = legacyVelocity.reserve;
-    // TODO add sensorID (only M100)
-  }
-  else
-  {
-    data = vi;
-  }
-  freeMSG();
-  return data;
+  return readPublished(published.vi);
 }
 
 Telemetry::Vector3f
 DataBroadcast::getAngularRate()
 {
-  Telemetry::Vector3f data;
-  lockMSG();
-  data = w;
-  freeMSG();
-  return data;
+  return readPublished(published.w);
 }
 
 Telemetry::GlobalPosition
 DataBroadcast::getGlobalPosition()
 {
-  Telemetry::GlobalPosition data;
-  lockMSG();
-  data = gp;
-  freeMSG();
-  return data;
+  return readPublished(published.gp);
 }
 
 // Not supported on Matrice 100
 Telemetry::RelativePosition
 DataBroadcast::getRelativePosition()
 {
-  Telemetry::RelativePosition data;
-  lockMSG();
-  data = rp;
-  freeMSG();
-  return data;
+  return readPublished(published.rp);
 }
 
 // Not supported on Matrice 100
 Telemetry::GPSInfo
 DataBroadcast::getGPSInfo()
 {
-  Telemetry::GPSInfo data;
-  lockMSG();
-  if (vehicle->isLegacyM600())
-  {
-    // Supported Broadcast data in Matrice 600 old firmware
-    data.latitude = legacyGPSInfo.latitude;
-    data.longitude = legacyGPSInfo.longitude;
-    data.HFSL = legacyGPSInfo.HFSL;
-    data.velocityNED = legacyGPSInfo.velocityNED;
-    data.time = legacyGPSInfo.time;
-    //GPS details not supported.
-  }
-  else
-  {
-    data = gps;
-  }
-  freeMSG();
-  return data;
+  return readPublished(published.gps);
 }
 
 // Not supported on Matrice 100
 Telemetry::RTK
 DataBroadcast::getRTKInfo()
 {
-  Telemetry::RTK data;
-  lockMSG();
-  data = rtk;
-  freeMSG();
-  return data;
+  return readPublished(published.rtk);
 }
 
 Telemetry::Mag
 DataBroadcast::getMag()
 {
-  Telemetry::Mag data;
-  lockMSG();
-  data = mag;
-  freeMSG();
-  return data;
+  return readPublished(published.mag);
 }
 
 Telemetry::RC
 DataBroadcast::getRC()
 {
-  Telemetry::RC data;
-  lockMSG();
-  data = rc;
-  freeMSG();
-  return data;
+  return readPublished(published.rc);
 }
 
 Telemetry::Gimbal
 DataBroadcast::getGimbal()
 {
-  Telemetry::Gimbal data;
-  lockMSG();
-  data = gimbal;
-  freeMSG();
-  return data;
+  return readPublished(published.gimbal);
 }
 
 Telemetry::Status
 DataBroadcast::getStatus()
 {
-  Telemetry::Status data = {0};
-  lockMSG();
-  if (vehicle->isLegacyM600())
-  {
-    // Broadcast data on M600 old firmware. Only flight status is available.
-    data.flight = legacyStatus;
-  }
-  else if(vehicle->isM100())
-  {
-    // Supported Broadcast data in Matrice 100
-    data.flight = legacyStatus;
-  }
-  else
-  {
-    data = status;
-  }
-  freeMSG();
-  return data;
+  return readPublished(published.status);
 }
 
 Telemetry::Battery
 DataBroadcast::getBatteryInfo()
 {
-  Telemetry::Battery data = {0};
-  lockMSG();
-  if (vehicle->isLegacyM600())
-  {
-    // Only capacity is supported on old M600 FW
-    data.percentage = legacyBattery;
-  }
-  else if (vehicle->isM100())
-  {
-    // Supported Broadcast data in Matrice 100
-    data.percentage = legacyBattery;
-  }
-  else
-  {
-    data = battery;
-  }
-  freeMSG();
-  return data;
+  return readPublished(published.battery);
 }
 
 Telemetry::SDKInfo
 DataBroadcast::getSDKInfo()
 {
-  Telemetry::SDKInfo data;
-  lockMSG();
-  data = info;
-  freeMSG();
-  return data;
+  return readPublished(published.info);
 }
 
 Telemetry::Compass
 DataBroadcast::getCompassData()
 {
-    Telemetry::Compass data;
-    lockMSG();
-    data = compass;
-    freeMSG();
-    return data;
+  return readPublished(published.compass);
 }
 // clang-format on
 
@@ -448,6 +288,7 @@ DataBroadcast::unpackData(RecvContainer* pRecvFrame)
   unpackOne(FLAG_DEVICE      ,&info      ,pdata,sizeof(info      ));
   unpackOne(FLAG_COMPASS     ,&compass   ,pdata,sizeof(compass   ));
   // clang-format on
+  publishSnapshot();
   freeMSG();
 }
 
@@ -472,6 +313,7 @@ DataBroadcast::unpackM100Data(RecvContainer* pRecvFrame)
   unpackOne(FLAG_M100_BATTERY,&legacyBattery     ,pdata,sizeof(legacyBattery   ));
   unpackOne(FLAG_M100_DEVICE ,&info              ,pdata,sizeof(info            ));
   // clang-format on
+  publishSnapshot();
   freeMSG();
 }
 
@@ -498,6 +340,7 @@ DataBroadcast::unpackOldM600Data(RecvContainer* pRecvFrame)
   unpackOne(FLAG_BATTERY     ,&legacyBattery     ,pdata,sizeof(legacyBattery   ));
   unpackOne(FLAG_DEVICE      ,&info              ,pdata,sizeof(info            ));
   // clang-format on
+  publishSnapshot();
   freeMSG();
 }
 
@@ -512,6 +355,83 @@ DataBroadcast::unpackOne(DataBroadcast::FLAG flag, void* data, uint8_t*& buf,
   }
 }
 
+void
+DataBroadcast::publishSnapshot()
+{
+  BroadcastSnapshot next;
+  memset(&next, 0, sizeof(next));
+  next.sequence = published.sequence + 1;
+  OsdkOsal_GetTimeMs(&next.receiveTimeMs);
+  next.passFlag = passFlag;
+
+  // clang-format off
+  next.q        = q;
+  next.a        = a;
+  next.w        = w;
+  next.gp       = gp;
+  next.rp       = rp;
+  next.rtk      = rtk;
+  next.mag      = mag;
+  next.rc       = rc;
+  next.gimbal   = gimbal;
+  next.info     = info;
+  next.compass  = compass;
+  // clang-format on
+
+  if (vehicle->isLegacyM600() || vehicle->isM100())
+  {
+    // Old M600 firmware and Matrice 100 send the legacy formats
+    next.timeStamp.time_ms = legacyTimeStamp.time;
+    next.timeStamp.time_ns = legacyTimeStamp.nanoTime;
+    next.syncStamp.flag    = legacyTimeStamp.syncFlag;
+    next.v.x               = legacyVelocity.x;
+    next.v.y               = legacyVelocity.y;
+    next.v.z               = legacyVelocity.z;
+    next.vi.health         = legacyVelocity.health;
+    next.vi.reserve        = legacyVelocity.reserve;
+    next.status.flight     = legacyStatus;
+    next.battery.percentage = legacyBattery;
+  }
+  else
+  {
+    next.timeStamp = timeStamp;
+    next.syncStamp = syncStamp;
+    next.v         = v;
+    next.vi        = vi;
+    next.status    = status;
+    next.battery   = battery;
+  }
+
+  if (vehicle->isLegacyM600())
+  {
+    //GPS details not supported.
+    next.gps.latitude    = legacyGPSInfo.latitude;
+    next.gps.longitude   = legacyGPSInfo.longitude;
+    next.gps.HFSL        = legacyGPSInfo.HFSL;
+    next.gps.velocityNED = legacyGPSInfo.velocityNED;
+    next.gps.time        = legacyGPSInfo.time;
+  }
+  else
+  {
+    next.gps = gps;
+  }
+
+  snapshotLock.write(&published, &next, sizeof(published));
+}
+
+bool
+DataBroadcast::getSnapshot(BroadcastSnapshot& snapshot) const
+{
+  snapshotLock.read(&snapshot, &published, sizeof(snapshot));
+  return snapshot.sequence != 0;
+}
+
+uint32_t
+DataBroadcast::getSnapshotSequence() const
+{
+  return readPublished(published.sequence);
+}
+
 void
 DataBroadcast::setVersionDefaults(uint8_t* frequencyBuffer)
 {
@@ -0,0 +1,768 @@
+/** @file dji_flight_recorder.cpp
+ *  @version 4.0.0
+ *  @date Oct 2026
+ *
+ *  @brief Raw capture of subscription and broadcast telemetry to disk
+ *
+ *  @Copyright (c) 2026 DJI
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#include "dji_flight_recorder.hpp"
+
+#if defined(__linux__)
+
+#include "dji_log.hpp"
+#include "dji_subscription.hpp"
+#include "dji_time.hpp"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <sched.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <time.h>
+#include <unistd.h>
+#include <vector>
+
+using namespace DJI::OSDK;
+using namespace DJI::OSDK::Telemetry;
+
+// Index entries are sized for records of this many data bytes on average
+static const uint32_t AVERAGE_RECORD_SIZE = 32;
+// How often the worker checks for work when nobody wakes it up
+static const int SEGMENT_TASK_PERIOD_MS = 100;
+
+struct FlightRecorder::Segment
+{
+  uint32_t                   number;
+  int                        fd;
+  uint8_t*                   base;
+  FlightRecordSegmentHeader* header;
+  FlightRecordIndexEntry*    index;
+  uint8_t*                   data;
+  uint32_t                   indexCapacity;
+  uint32_t                   dataCapacity;
+
+  std::atomic<uint32_t> indexUsed;
+  std::atomic<uint32_t> dataUsed;
+  std::atomic<uint32_t> dropped;
+  std::atomic<int>      writers;
+
+  bool     unused; /*!< never became current, removed when closed */
+  bool     closed;
+  Segment* nextRetired;
+  Segment* nextAll;
+};
+
+static inline uint32_t
+align8(uint32_t size)
+{
+  return (size + 7) & ~(uint32_t)7;
+}
+
+FlightRecorder&
+FlightRecorder::instance()
+{
+  // Never destroyed, the receive thread may still record during exit
+  static FlightRecorder* recorder = new FlightRecorder();
+  return *recorder;
+}
+
+FlightRecorder::FlightRecorder()
+  : segmentSize(0)
+  , maxSegments(0)
+  , nextNumber(0)
+  , recording(false)
+  , current(NULL)
+  , spare(NULL)
+  , retired(NULL)
+  , records(0)
+  , bytes(0)
+  , dropped(0)
+  , segments(0)
+  , allSegments(NULL)
+  , activeWriters(0)
+  , running(false)
+{
+  memset(layouts, 0, sizeof(layouts));
+  sem_init(&wakeSem, 0, 0);
+}
+
+std::string
+FlightRecorder::segmentPath(uint32_t number) const
+{
+  char suffix[32];
+  snprintf(suffix, sizeof(suffix), "_%04u.frec", number);
+  return basePath + suffix;
+}
+
+bool
+FlightRecorder::start(const char* path, uint32_t size, int maxCount)
+{
+  if (isRecording() || running.load())
+  {
+    return false;
+  }
+  uint32_t minSize = sizeof(FlightRecordSegmentHeader) + 64 * 1024;
+  if (size < minSize)
+  {
+    DERROR("Flight recorder segment size must be at least %u bytes", minSize);
+    return false;
+  }
+
+  basePath    = path;
+  segmentSize = size;
+  maxSegments = maxCount;
+  nextNumber  = 0;
+  memset(layouts, 0, sizeof(layouts));
+  records.store(0);
+  bytes.store(0);
+  dropped.store(0);
+  segments.store(0);
+
+  Segment* first = createSegment(nextNumber++);
+  if (!first)
+  {
+    return false;
+  }
+  current.store(first);
+  segments.store(1);
+  spare.store(createSegment(nextNumber++));
+
+  running.store(true);
+  if (pthread_create(&worker, NULL, segmentTask, this) != 0)
+  {
+    running.store(false);
+    current.store(NULL);
+    closeSegment(first, false);
+    Segment* unusedSpare = spare.exchange(NULL);
+    if (unusedSpare)
+    {
+      closeSegment(unusedSpare, false);
+    }
+    return false;
+  }
+
+  recording.store(true, std::memory_order_release);
+  DSTATUS("Flight recorder writing to %s", segmentPath(0).c_str());
+  return true;
+}
+
+void
+FlightRecorder::stop()
+{
+  if (!recording.exchange(false))
+  {
+    return;
+  }
+
+  // A writer that saw recording set may still append, rotate or retire.
+  // Once they are out nothing but this thread touches the segments.
+  while (activeWriters.load() != 0)
+  {
+    sched_yield();
+  }
+
+  running.store(false);
+  sem_post(&wakeSem);
+  pthread_join(worker, NULL);
+
+  Segment* last = current.exchange(NULL);
+  for (Segment* s = retired.exchange(NULL); s; s = s->nextRetired)
+  {
+    closeSegment(s, !s->unused);
+  }
+  if (last)
+  {
+    closeSegment(last, true);
+  }
+  Segment* unusedSpare = spare.exchange(NULL);
+  if (unusedSpare)
+  {
+    closeSegment(unusedSpare, false);
+  }
+
+  // Every writer and the worker are gone, the segments can be freed
+  while (allSegments)
+  {
+    Segment* next = allSegments->nextAll;
+    delete allSegments;
+    allSegments = next;
+  }
+}
+
+FlightRecorder::Stats
+FlightRecorder::getStats() const
+{
+  Stats stats;
+  stats.records  = records.load(std::memory_order_relaxed);
+  stats.bytes    = bytes.load(std::memory_order_relaxed);
+  stats.dropped  = dropped.load(std::memory_order_relaxed);
+  stats.segments = segments.load(std::memory_order_relaxed);
+  return stats;
+}
+
+FlightRecorder::Segment*
+FlightRecorder::createSegment(uint32_t number)
+{
+  std::string path = segmentPath(number);
+  int fd = open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+  if (fd < 0)
+  {
+    DERROR("Flight recorder can not create %s: %s", path.c_str(),
+           strerror(errno));
+    return NULL;
+  }
+  if (ftruncate(fd, segmentSize) != 0)
+  {
+    DERROR("Flight recorder can not size %s: %s", path.c_str(),
+           strerror(errno));
+    close(fd);
+    unlink(path.c_str());
+    return NULL;
+  }
+
+  // Populated here, so the receive thread does not take the page faults
+  void* mapped = mmap(NULL, segmentSize, PROT_READ | PROT_WRITE,
+                      MAP_SHARED | MAP_POPULATE, fd, 0);
+  if (mapped == MAP_FAILED)
+  {
+    DERROR("Flight recorder can not map %s: %s", path.c_str(),
+           strerror(errno));
+    close(fd);
+    unlink(path.c_str());
+    return NULL;
+  }
+
+  // MAP_POPULATE maps shared pages read-only, the first write to each page
+  // would still fault on the receive thread. Write every page once here.
+  long page = sysconf(_SC_PAGESIZE);
+  for (uint32_t offset = 0; offset < segmentSize; offset += page)
+  {
+    ((volatile uint8_t*)mapped)[offset] = 0;
+  }
+
+  Segment* segment = new Segment;
+  segment->number  = number;
+  segment->fd      = fd;
+  segment->base    = (uint8_t*)mapped;
+
+  uint32_t headerSize    = sizeof(FlightRecordSegmentHeader);
+  segment->indexCapacity = (segmentSize - headerSize) /
+                           (sizeof(FlightRecordIndexEntry) + AVERAGE_RECORD_SIZE);
+  uint32_t dataOffset =
+    align8(headerSize + segment->indexCapacity * sizeof(FlightRecordIndexEntry));
+  segment->dataCapacity = segmentSize - dataOffset;
+  segment->header       = (FlightRecordSegmentHeader*)segment->base;
+  segment->index = (FlightRecordIndexEntry*)(segment->base + headerSize);
+  segment->data  = segment->base + dataOffset;
+  segment->indexUsed.store(0);
+  segment->dataUsed.store(0);
+  segment->dropped.store(0);
+  segment->writers.store(0);
+  segment->unused      = false;
+  segment->closed      = false;
+  segment->nextRetired = NULL;
+  segment->nextAll     = allSegments;
+  allSegments          = segment;
+
+  FlightRecordSegmentHeader* header = segment->header;
+  memcpy(header->magic, FLIGHT_RECORD_MAGIC, sizeof(header->magic));
+  header->version       = FLIGHT_RECORD_VERSION;
+  header->segmentNumber = number;
+  header->startTimeUs   = getMonotonicTimeUs();
+  header->indexOffset   = headerSize;
+  header->indexCapacity = segment->indexCapacity;
+  header->dataOffset    = dataOffset;
+  header->dataCapacity  = segment->dataCapacity;
+  header->indexCount    = 0;
+  header->dataUsed      = 0;
+  header->dropped       = 0;
+  return segment;
+}
+
+void
+FlightRecorder::closeSegment(Segment* segment, bool keep)
+{
+  // Writers that reserved space before the segment was swapped out
+  while (segment->writers.load() != 0)
+  {
+    sched_yield();
+  }
+
+  std::string path = segmentPath(segment->number);
+  if (keep)
+  {
+    uint32_t indexCount = segment->indexUsed.load();
+    uint32_t dataUsed   = segment->dataUsed.load();
+    segment->header->indexCount =
+      (indexCount < segment->indexCapacity) ? indexCount
+                                            : segment->indexCapacity;
+    segment->header->dataUsed =
+      (dataUsed < segment->dataCapacity) ? dataUsed : segment->dataCapacity;
+    segment->header->dropped = segment->dropped.load();
+    msync(segment->base, segmentSize, MS_SYNC);
+  }
+  munmap(segment->base, segmentSize);
+  close(segment->fd);
+  segment->closed = true;
+
+  if (!keep)
+  {
+    unlink(path.c_str());
+  }
+}
+
+FlightRecorder::Segment*
+FlightRecorder::acquireSegment()
+{
+  Segment* segment = current.load(std::memory_order_acquire);
+  if (!segment)
+  {
+    return NULL;
+  }
+  segment->writers.fetch_add(1);
+  if (current.load() != segment)
+  {
+    // Swapped out meanwhile, it may already be unmapped
+    segment->writers.fetch_sub(1);
+    return NULL;
+  }
+  return segment;
+}
+
+bool
+FlightRecorder::append(Segment* segment, uint8_t source, uint64_t timeUs,
+                       const Part* parts, int count)
+{
+  uint32_t total = 0;
+  for (int i = 0; i < count; ++i)
+  {
+    total += align8(parts[i].length);
+  }
+
+  uint32_t slot   = segment->indexUsed.fetch_add(count, std::memory_order_relaxed);
+  uint32_t offset = segment->dataUsed.fetch_add(total, std::memory_order_relaxed);
+  if (slot + count > segment->indexCapacity ||
+      offset + total > segment->dataCapacity)
+  {
+    return false;
+  }
+
+  for (int i = 0; i < count; ++i)
+  {
+    memcpy(segment->data + offset, parts[i].data, parts[i].length);
+
+    FlightRecordIndexEntry* entry = &segment->index[slot + i];
+    entry->timeUs                 = timeUs;
+    entry->dataOffset             = offset;
+    entry->type                   = parts[i].type;
+    entry->source                 = source;
+    // The length commits the record
+    __atomic_store_n(&entry->length, (uint16_t)parts[i].length,
+                     __ATOMIC_RELEASE);
+    offset += align8(parts[i].length);
+  }
+  return true;
+}
+
+void
+FlightRecorder::rotate(Segment* full)
+{
+  Segment* next = spare.exchange(NULL);
+  if (next)
+  {
+    Segment* expected = full;
+    if (current.compare_exchange_strong(expected, next))
+    {
+      segments.fetch_add(1, std::memory_order_relaxed);
+      retire(full);
+    }
+    else
+    {
+      // Another writer rotated first, give the spare back
+      Segment* none = NULL;
+      if (!spare.compare_exchange_strong(none, next))
+      {
+        next->unused = true;
+        retire(next);
+      }
+    }
+  }
+  sem_post(&wakeSem);
+}
+
+void
+FlightRecorder::retire(Segment* segment)
+{
+  Segment* head = retired.load();
+  do
+  {
+    segment->nextRetired = head;
+  } while (!retired.compare_exchange_weak(head, segment));
+}
+
+bool
+FlightRecorder::beginWrite()
+{
+  // Pairs with stop(): it clears recording before it waits for the count,
+  // a writer counts itself before it checks recording
+  activeWriters.fetch_add(1);
+  if (!recording.load())
+  {
+    activeWriters.fetch_sub(1);
+    return false;
+  }
+  return true;
+}
+
+void
+FlightRecorder::endWrite()
+{
+  activeWriters.fetch_sub(1);
+}
+
+void
+FlightRecorder::recordSubscription(SubscriptionPackage* pkg,
+                                   const uint8_t* data, uint32_t length)
+{
+  if (beginWrite())
+  {
+    writeSubscription(pkg, data, length);
+    endWrite();
+  }
+}
+
+void
+FlightRecorder::recordBroadcast(const uint8_t* data, uint32_t length)
+{
+  if (beginWrite())
+  {
+    writeBroadcast(data, length);
+    endWrite();
+  }
+}
+
+void
+FlightRecorder::writeSubscription(SubscriptionPackage* pkg,
+                                  const uint8_t* data, uint32_t length)
+{
+  SubscriptionPackage::PackageInfo info = pkg->getInfo();
+  uint32_t     layoutVersion = pkg->getLayoutVersion();
+  LayoutState& state         = layouts[info.packageID];
+  uint64_t     timeUs        = getMonotonicTimeUs();
+
+  uint8_t  layout[sizeof(FlightRecordLayout) +
+                 TOTAL_TOPIC_NUMBER * sizeof(FlightRecordTopic)];
+  uint32_t layoutSize = 0;
+
+  for (int attempt = 0; attempt < 2; ++attempt)
+  {
+    Segment* segment = acquireSegment();
+    if (!segment)
+    {
+      continue;
+    }
+
+    Part parts[2];
+    int  count      = 0;
+    bool withLayout = !state.written || state.version != layoutVersion ||
+                      state.segment != segment->number;
+    if (withLayout)
+    {
+      if (!layoutSize)
+      {
+        FlightRecordLayout* l = (FlightRecordLayout*)layout;
+        l->packageID          = info.packageID;
+        l->config             = info.config;
+        l->numberOfTopics     = info.numberOfTopics;
+        l->reserved           = 0;
+        l->freq               = info.freq;
+        l->dataSize           = pkg->getBufferSize();
+
+        FlightRecordTopic* topics = (FlightRecordTopic*)(l + 1);
+        for (int i = 0; i < info.numberOfTopics; ++i)
+        {
+          TopicName topic   = pkg->getTopicList()[i];
+          topics[i].topic   = topic;
+          topics[i].uid     = pkg->getUidList()[i];
+          topics[i].offset  = pkg->getOffsetList()[i];
+          topics[i].size    = TopicDataBase[topic].size;
+        }
+        layoutSize = sizeof(FlightRecordLayout) +
+                     info.numberOfTopics * sizeof(FlightRecordTopic);
+      }
+      parts[count].type   = FLIGHT_RECORD_LAYOUT;
+      parts[count].data   = layout;
+      parts[count].length = layoutSize;
+      ++count;
+    }
+    parts[count].type   = FLIGHT_RECORD_SUBSCRIPTION;
+    parts[count].data   = data;
+    parts[count].length = length;
+    ++count;
+
+    bool     written = append(segment, info.packageID, timeUs, parts, count);
+    uint32_t number  = segment->number;
+    segment->writers.fetch_sub(1);
+
+    if (written)
+    {
+      if (withLayout)
+      {
+        state.written = true;
+        state.version = layoutVersion;
+        state.segment = number;
+      }
+      records.fetch_add(count, std::memory_order_relaxed);
+      bytes.fetch_add(length + (withLayout ? layoutSize : 0),
+                      std::memory_order_relaxed);
+      return;
+    }
+    segment->dropped.fetch_add(1, std::memory_order_relaxed);
+    rotate(segment);
+  }
+  dropped.fetch_add(1, std::memory_order_relaxed);
+}
+
+void
+FlightRecorder::writeBroadcast(const uint8_t* data, uint32_t length)
+{
+  uint64_t timeUs = getMonotonicTimeUs();
+  Part     part;
+  part.type   = FLIGHT_RECORD_BROADCAST;
+  part.data   = data;
+  part.length = length;
+
+  for (int attempt = 0; attempt < 2; ++attempt)
+  {
+    Segment* segment = acquireSegment();
+    if (!segment)
+    {
+      continue;
+    }
+    bool written =
+      append(segment, FLIGHT_RECORD_SOURCE_BROADCAST, timeUs, &part, 1);
+    segment->writers.fetch_sub(1);
+    if (written)
+    {
+      records.fetch_add(1, std::memory_order_relaxed);
+      bytes.fetch_add(length, std::memory_order_relaxed);
+      return;
+    }
+    segment->dropped.fetch_add(1, std::memory_order_relaxed);
+    rotate(segment);
+  }
+  dropped.fetch_add(1, std::memory_order_relaxed);
+}
+
+void*
+FlightRecorder::segmentTask(void* arg)
+{
+  FlightRecorder* self = (FlightRecorder*)arg;
+
+  while (self->running.load())
+  {
+    struct timespec absTimeout;
+    clock_gettime(CLOCK_REALTIME, &absTimeout);
+    absTimeout.tv_nsec += (long)SEGMENT_TASK_PERIOD_MS * 1000000;
+    if (absTimeout.tv_nsec >= 1000000000)
+    {
+      absTimeout.tv_sec += 1;
+      absTimeout.tv_nsec -= 1000000000;
+    }
+    sem_timedwait(&self->wakeSem, &absTimeout);
+
+    // Close in the order the segments were filled
+    std::vector<Segment*> full;
+    for (Segment* s = self->retired.exchange(NULL); s; s = s->nextRetired)
+    {
+      full.insert(full.begin(), s);
+    }
+    for (size_t i = 0; i < full.size(); ++i)
+    {
+      self->closeSegment(full[i], !full[i]->unused);
+      uint32_t number = full[i]->number;
+      if (!full[i]->unused && self->maxSegments > 0 &&
+          number + 1 >= (uint32_t)self->maxSegments)
+      {
+        // The current segment counts towards maxSegments too
+        unlink(self->segmentPath(number + 1 - self->maxSegments).c_str());
+      }
+    }
+
+    if (self->running.load() && !self->spare.load())
+    {
+      Segment* next = self->createSegment(self->nextNumber++);
+      Segment* none = NULL;
+      if (next && !self->spare.compare_exchange_strong(none, next))
+      {
+        self->closeSegment(next, false);
+      }
+    }
+  }
+  return NULL;
+}
+
+int
+FlightRecordReader::readTopic(const char* segmentPath, TopicName topic,
+                              TopicCallback callback, void* userData)
+{
+  int fd = open(segmentPath, O_RDONLY | O_CLOEXEC);
+  if (fd < 0)
+  {
+    return -1;
+  }
+
+  FlightRecordSegmentHeader header;
+  if (pread(fd, &header, sizeof(header), 0) != (ssize_t)sizeof(header) ||
+      memcmp(header.magic, FLIGHT_RECORD_MAGIC, sizeof(header.magic)) != 0 ||
+      header.version != FLIGHT_RECORD_VERSION)
+  {
+    close(fd);
+    return -1;
+  }
+
+  uint32_t count = header.indexCount ? header.indexCount : header.indexCapacity;
+  std::vector<FlightRecordIndexEntry> index(count);
+  ssize_t indexBytes = (ssize_t)count * sizeof(FlightRecordIndexEntry);
+  if (count && pread(fd, &index[0], indexBytes, header.indexOffset) != indexBytes)
+  {
+    close(fd);
+    return -1;
+  }
+
+  // Where the topic sits in each package, as of the last layout seen
+  struct
+  {
+    bool     present;
+    uint16_t offset;
+    uint16_t size;
+  } where[256];
+  memset(where, 0, sizeof(where));
+
+  std::vector<uint8_t> buffer;
+  int                  samples = 0;
+  for (uint32_t i = 0; i < count; ++i)
+  {
+    const FlightRecordIndexEntry& entry = index[i];
+    if (entry.length == 0)
+    {
+      continue;
+    }
+    off_t position = (off_t)header.dataOffset + entry.dataOffset;
+
+    if (entry.type == FLIGHT_RECORD_LAYOUT)
+    {
+      buffer.resize(entry.length);
+      if (entry.length < sizeof(FlightRecordLayout) ||
+          pread(fd, &buffer[0], entry.length, position) != entry.length)
+      {
+        continue;
+      }
+      const FlightRecordLayout* layout = (const FlightRecordLayout*)&buffer[0];
+      const FlightRecordTopic*  topics = (const FlightRecordTopic*)(layout + 1);
+      int available = (entry.length - sizeof(FlightRecordLayout)) /
+                      sizeof(FlightRecordTopic);
+      where[entry.source].present = false;
+      for (int t = 0; t < layout->numberOfTopics && t < available; ++t)
+      {
+        if (topics[t].topic == (uint32_t)topic)
+        {
+          where[entry.source].present = true;
+          where[entry.source].offset  = topics[t].offset;
+          where[entry.source].size    = topics[t].size;
+        }
+      }
+    }
+    else if (entry.type == FLIGHT_RECORD_SUBSCRIPTION &&
+             where[entry.source].present &&
+             where[entry.source].offset + where[entry.source].size <=
+               entry.length)
+    {
+      uint16_t size = where[entry.source].size;
+      buffer.resize(size);
+      if (pread(fd, &buffer[0], size, position + where[entry.source].offset) ==
+          size)
+      {
+        callback(topic, entry.timeUs, &buffer[0], size, userData);
+        ++samples;
+      }
+    }
+  }
+
+  close(fd);
+  return samples;
+}
+
+int
+FlightRecordReader::readBroadcast(const char* segmentPath,
+                                  BroadcastCallback callback, void* userData)
+{
+  int fd = open(segmentPath, O_RDONLY | O_CLOEXEC);
+  if (fd < 0)
+  {
+    return -1;
+  }
+
+  FlightRecordSegmentHeader header;
+  if (pread(fd, &header, sizeof(header), 0) != (ssize_t)sizeof(header) ||
+      memcmp(header.magic, FLIGHT_RECORD_MAGIC, sizeof(header.magic)) != 0 ||
+      header.version != FLIGHT_RECORD_VERSION)
+  {
+    close(fd);
+    return -1;
+  }
+
+  uint32_t count = header.indexCount ? header.indexCount : header.indexCapacity;
+  std::vector<FlightRecordIndexEntry> index(count);
+  ssize_t indexBytes = (ssize_t)count * sizeof(FlightRecordIndexEntry);
+  if (count && pread(fd, &index[0], indexBytes, header.indexOffset) != indexBytes)
+  {
+    close(fd);
+    return -1;
+  }
+
+  std::vector<uint8_t> buffer;
+  int                  frames = 0;
+  for (uint32_t i = 0; i < count; ++i)
+  {
+    const FlightRecordIndexEntry& entry = index[i];
+    if (entry.length == 0 || entry.type != FLIGHT_RECORD_BROADCAST)
+    {
+      continue;
+    }
+    buffer.resize(entry.length);
+    if (pread(fd, &buffer[0], entry.length,
+              (off_t)header.dataOffset + entry.dataOffset) == entry.length)
+    {
+      callback(entry.timeUs, &buffer[0], entry.length, userData);
+      ++frames;
+    }
+  }
+
+  close(fd);
+  return frames;
+}
+
+#endif // __linux__
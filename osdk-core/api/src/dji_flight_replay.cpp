@@ -0,0 +1,355 @@
+/** @file dji_flight_replay.cpp
+ *  @version 4.0.0
+ *  @date Oct 2026
+ *
+ *  @brief Feeds a flight recorder capture back through the telemetry decoders
+ *
+ *  @Copyright (c) 2026 DJI
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#include "dji_flight_replay.hpp"
+
+#if defined(__linux__)
+
+#include "dji_broadcast.hpp"
+#include "dji_linker.hpp"
+#include "dji_subscription.hpp"
+#include "dji_time.hpp"
+#include "osdk_command.h"
+
+#include <algorithm>
+#include <fcntl.h>
+#include <glob.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+using namespace DJI::OSDK;
+using namespace DJI::OSDK::Telemetry;
+
+// Defined in dji_legacy_linker.cpp
+RecvContainer recvFrameAdapting(const T_CmdInfo &cmdInfo, const uint8_t *cmdData);
+
+FlightReplay::FlightReplay(DataSubscription* subscription,
+                           DataBroadcast*    broadcast)
+  : subscription(subscription)
+  , broadcast(broadcast)
+  , speed(1.0f)
+  , stopped(false)
+  , started(false)
+  , firstTimeUs(0)
+  , lastTimeUs(0)
+  , startWallUs(0)
+  , seqNum(0)
+{
+  memset(layoutValid, 0, sizeof(layoutValid));
+}
+
+bool
+FlightReplay::open(const char* basePath)
+{
+  segmentPaths.clear();
+
+  // Zero padded numbers, so name order is recording order
+  std::string pattern = std::string(basePath) + "_*.frec";
+  glob_t      found;
+  if (glob(pattern.c_str(), 0, NULL, &found) == 0)
+  {
+    for (size_t i = 0; i < found.gl_pathc; ++i)
+    {
+      segmentPaths.push_back(found.gl_pathv[i]);
+    }
+  }
+  globfree(&found);
+  std::sort(segmentPaths.begin(), segmentPaths.end());
+
+  if (segmentPaths.empty())
+  {
+    DERROR("No flight recorder segment matches %s", pattern.c_str());
+    return false;
+  }
+  return true;
+}
+
+void
+FlightReplay::setSpeed(float speed)
+{
+  this->speed = (speed > 0) ? speed : 0;
+}
+
+void
+FlightReplay::stop()
+{
+  stopped.store(true);
+}
+
+FlightReplay::Stats
+FlightReplay::run()
+{
+  Stats stats;
+  memset(&stats, 0, sizeof(stats));
+
+  stopped.store(false);
+  started    = false;
+  lastTimeUs = 0;
+  seqNum     = 0;
+  memset(layoutValid, 0, sizeof(layoutValid));
+  for (int i = 0; i < 256; ++i)
+  {
+    layouts[i].clear();
+  }
+
+  uint64_t beginUs = getMonotonicTimeUs();
+  for (size_t i = 0; i < segmentPaths.size() && !stopped.load(); ++i)
+  {
+    if (replaySegment(segmentPaths[i], stats))
+    {
+      stats.segments++;
+    }
+  }
+  stats.elapsedUs  = getMonotonicTimeUs() - beginUs;
+  stats.recordedUs = started ? lastTimeUs - firstTimeUs : 0;
+  return stats;
+}
+
+bool
+FlightReplay::replaySegment(const std::string& path, Stats& stats)
+{
+  int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0)
+  {
+    DERROR("Can not open %s", path.c_str());
+    return false;
+  }
+  struct stat st;
+  if (fstat(fd, &st) != 0 ||
+      (size_t)st.st_size < sizeof(FlightRecordSegmentHeader))
+  {
+    close(fd);
+    return false;
+  }
+
+  // Populated up front, page faults would show up in the replay timing
+  size_t size   = st.st_size;
+  void*  mapped = mmap(NULL, size, PROT_READ, MAP_PRIVATE | MAP_POPULATE, fd, 0);
+  close(fd);
+  if (mapped == MAP_FAILED)
+  {
+    DERROR("Can not map %s", path.c_str());
+    return false;
+  }
+
+  const uint8_t*                   base = (const uint8_t*)mapped;
+  const FlightRecordSegmentHeader* header =
+    (const FlightRecordSegmentHeader*)base;
+  if (memcmp(header->magic, FLIGHT_RECORD_MAGIC, sizeof(header->magic)) != 0 ||
+      header->version != FLIGHT_RECORD_VERSION ||
+      header->indexOffset +
+          (uint64_t)header->indexCapacity * sizeof(FlightRecordIndexEntry) >
+        size ||
+      header->dataOffset + (uint64_t)header->dataCapacity > size)
+  {
+    DERROR("%s is not a flight recorder segment", path.c_str());
+    munmap(mapped, size);
+    return false;
+  }
+
+  // A segment that was not closed has no count, its unused entries are 0
+  uint32_t count = header->indexCount ? header->indexCount
+                                      : header->indexCapacity;
+  const FlightRecordIndexEntry* index =
+    (const FlightRecordIndexEntry*)(base + header->indexOffset);
+  const uint8_t* data = base + header->dataOffset;
+
+  for (uint32_t i = 0; i < count && !stopped.load(); ++i)
+  {
+    const FlightRecordIndexEntry& entry = index[i];
+    if (entry.length == 0 ||
+        entry.dataOffset + (uint64_t)entry.length > header->dataCapacity)
+    {
+      continue;
+    }
+
+    switch (entry.type)
+    {
+      case FLIGHT_RECORD_LAYOUT:
+        applyLayout(entry.source, data + entry.dataOffset, entry.length);
+        break;
+      case FLIGHT_RECORD_SUBSCRIPTION:
+        pace(entry.timeUs);
+        feedSubscription(entry.source, data + entry.dataOffset, entry.length,
+                         stats);
+        break;
+      case FLIGHT_RECORD_BROADCAST:
+        pace(entry.timeUs);
+        feedBroadcast(data + entry.dataOffset, entry.length, stats);
+        break;
+      default:
+        break;
+    }
+  }
+
+  munmap(mapped, size);
+  return true;
+}
+
+void
+FlightReplay::applyLayout(uint8_t packageID, const uint8_t* data,
+                          uint32_t length)
+{
+  if (!subscription || length < sizeof(FlightRecordLayout))
+  {
+    return;
+  }
+  // Every segment repeats the layout, only a change restarts the package
+  if (layoutValid[packageID] && layouts[packageID].size() == length &&
+      memcmp(&layouts[packageID][0], data, length) == 0)
+  {
+    return;
+  }
+  layouts[packageID].assign(data, data + length);
+  layoutValid[packageID] = false;
+
+  const FlightRecordLayout* layout = (const FlightRecordLayout*)data;
+  const FlightRecordTopic*  topics = (const FlightRecordTopic*)(layout + 1);
+  if (packageID >= DataSubscription::MAX_NUMBER_OF_PACKAGE ||
+      layout->numberOfTopics > TOTAL_TOPIC_NUMBER ||
+      length < sizeof(FlightRecordLayout) +
+                 layout->numberOfTopics * sizeof(FlightRecordTopic))
+  {
+    DERROR("Invalid layout recorded for package %d", packageID);
+    return;
+  }
+
+  // The recording must have been made with the same topic sizes
+  TopicName topicList[TOTAL_TOPIC_NUMBER];
+  uint32_t  offset = layout->config ? 8 : 0;
+  for (int i = 0; i < layout->numberOfTopics; ++i)
+  {
+    TopicName topic = (TopicName)topics[i].topic;
+    if (topics[i].topic >= TOTAL_TOPIC_NUMBER ||
+        TopicDataBase[topic].uid != topics[i].uid ||
+        TopicDataBase[topic].size != topics[i].size ||
+        topics[i].offset != offset)
+    {
+      DERROR("Topic %u of package %d does not match this OSDK, package "
+             "skipped",
+             topics[i].topic, packageID);
+      return;
+    }
+    topicList[i] = topic;
+    offset += topics[i].size;
+  }
+
+  layoutValid[packageID] = subscription->startPackageLocally(
+    packageID, layout->numberOfTopics, topicList, layout->config == 1,
+    layout->freq);
+  if (!layoutValid[packageID])
+  {
+    DERROR("Can not start package %d for replay", packageID);
+  }
+}
+
+void
+FlightReplay::feedSubscription(uint8_t packageID, const uint8_t* data,
+                               uint32_t length, Stats& stats)
+{
+  if (!subscription || !layoutValid[packageID] ||
+      length > SubscriptionPackage::MAX_PACKAGE_DATA_LENGTH)
+  {
+    stats.skipped++;
+    return;
+  }
+
+  // On the link the package ID comes first
+  uint8_t frame[1 + SubscriptionPackage::MAX_PACKAGE_DATA_LENGTH];
+  frame[0] = packageID;
+  memcpy(frame + 1, data, length);
+  subscription->dispatchFrame(frame, length + 1, seqNum++);
+
+  stats.frames++;
+  stats.bytes += length;
+}
+
+void
+FlightReplay::feedBroadcast(const uint8_t* data, uint32_t length,
+                            Stats& stats)
+{
+  if (!broadcast || !broadcast->getVehicle() ||
+      length > MAX_INCOMING_DATA_SIZE)
+  {
+    stats.skipped++;
+    return;
+  }
+
+  // What the legacy linker adapter hands to the broadcast callback
+  T_CmdInfo cmdInfo;
+  memset(&cmdInfo, 0, sizeof(cmdInfo));
+  cmdInfo.cmdSet  = OpenProtocolCMD::CMDSet::Broadcast::broadcast[0];
+  cmdInfo.cmdId   = OpenProtocolCMD::CMDSet::Broadcast::broadcast[1];
+  cmdInfo.seqNum  = seqNum++;
+  cmdInfo.dataLen = length;
+
+  RecvContainer recvFrame = recvFrameAdapting(cmdInfo, data);
+  DataBroadcast::unpackCallback(broadcast->getVehicle(), recvFrame, broadcast);
+
+  stats.frames++;
+  stats.bytes += length;
+}
+
+void
+FlightReplay::pace(uint64_t timeUs)
+{
+  if (!started)
+  {
+    started     = true;
+    firstTimeUs = timeUs;
+    startWallUs = getMonotonicTimeUs();
+  }
+  // Writers may commit slightly out of order, never go back in time
+  if (timeUs < lastTimeUs)
+  {
+    timeUs = lastTimeUs;
+  }
+  lastTimeUs = timeUs;
+
+  if (speed <= 0)
+  {
+    return;
+  }
+
+  uint64_t targetUs =
+    startWallUs + (uint64_t)((timeUs - firstTimeUs) / (double)speed);
+  uint64_t nowUs = getMonotonicTimeUs();
+  if (targetUs > nowUs)
+  {
+    uint64_t        waitUs = targetUs - nowUs;
+    struct timespec wait;
+    wait.tv_sec  = waitUs / 1000000;
+    wait.tv_nsec = (waitUs % 1000000) * 1000;
+    nanosleep(&wait, NULL);
+  }
+}
+
+#endif // __linux__
@@ -28,7 +28,14 @@
  */
 
 #include "dji_subscription.hpp"
+#include "dji_flight_recorder.hpp"
 #include "dji_vehicle.hpp"
+#include "dji_linker.hpp"
+#include "dji_time.hpp"
+#include "osdk_command.h"
+#if defined(__linux__)
+#include <sched.h>
+#endif
 
 using namespace DJI::OSDK;
 using namespace DJI::OSDK::Telemetry;
@@ -41,56 +48,78 @@ const uint32_t DBVersion               = 0x00000100;
 // clang-format off
 TopicInfo Telemetry::TopicDataBase[] =
 {  // Topic Name ,                     UID,
-  {TOPIC_QUATERNION                , UID_QUATERNION               , sizeof(TypeMap<TOPIC_QUATERNION              >::type), 200,   0,  255,  0},
-  {TOPIC_ACCELERATION_GROUND       , UID_ACCELERATION_GROUND      , sizeof(TypeMap<TOPIC_ACCELERATION_GROUND     >::type), 200,   0,  255,  0},
-  {TOPIC_ACCELERATION_BODY         , UID_ACCELERATION_BODY        , sizeof(TypeMap<TOPIC_ACCELERATION_BODY       >::type), 200,   0,  255,  0},
-  {TOPIC_ACCELERATION_RAW          , UID_ACCELERATION_RAW         , sizeof(TypeMap<TOPIC_ACCELERATION_RAW        >::type), 400,   0,  255,  0},
-  {TOPIC_VELOCITY                  , UID_VELOCITY                 , sizeof(TypeMap<TOPIC_VELOCITY                >::type), 200,   0,  255,  0},
-  {TOPIC_ANGULAR_RATE_FUSIONED     , UID_ANGULAR_RATE_FUSIONED    , sizeof(TypeMap<TOPIC_ANGULAR_RATE_FUSIONED   >::type), 200,   0,  255,  0},
-  {TOPIC_ANGULAR_RATE_RAW          , UID_ANGULAR_RATE_RAW         , sizeof(TypeMap<TOPIC_ANGULAR_RATE_RAW        >::type), 400,   0,  255,  0},
-  {TOPIC_ALTITUDE_FUSIONED         , UID_ALTITUDE_FUSIONED        , sizeof(TypeMap<TOPIC_ALTITUDE_FUSIONED       >::type), 200,   0,  255,  0},
-  {TOPIC_ALTITUDE_BAROMETER        , UID_ALTITUDE_BAROMETER       , sizeof(TypeMap<TOPIC_ALTITUDE_BAROMETER      >::type), 200,   0,  255,  0},
-  {TOPIC_ALTITUDE_OF_HOMEPOINT     , UID_ALTITUDE_OF_HOMEPOINT    , sizeof(TypeMap<TOPIC_ALTITUDE_OF_HOMEPOINT   >::type), 1  ,   0,  255,  0},
-  {TOPIC_HEIGHT_FUSION             , UID_HEIGHT_FUSION            , sizeof(TypeMap<TOPIC_HEIGHT_FUSION           >::type), 100,   0,  255,  0},
-  {TOPIC_GPS_FUSED                 , UID_GPS_FUSED                , sizeof(TypeMap<TOPIC_GPS_FUSED               >::type), 50 ,   0,  255,  0},
-  {TOPIC_GPS_DATE                  , UID_GPS_DATE                 , sizeof(TypeMap<TOPIC_GPS_DATE                >::type), 5  ,   0,  255,  0},
-  {TOPIC_GPS_TIME                  , UID_GPS_TIME                 , sizeof(TypeMap<TOPIC_GPS_TIME                >::type), 5  ,   0,  255,  0},
-  {TOPIC_GPS_POSITION              , UID_GPS_POSITION             , sizeof(TypeMap<TOPIC_GPS_POSITION            >::type), 5  ,   0,  255,  0},
-  {TOPIC_GPS_VELOCITY              , UID_GPS_VELOCITY             , sizeof(TypeMap<TOPIC_GPS_VELOCITY            >::type), 5  ,   0,  255,  0},
-  {TOPIC_GPS_DETAILS               , UID_GPS_DETAILS              , sizeof(TypeMap<TOPIC_GPS_DETAILS             >::type), 5  ,   0,  255,  0},
-  {TOPIC_RTK_POSITION              , UID_RTK_POSITION             , sizeof(TypeMap<TOPIC_RTK_POSITION            >::type), 5  ,   0,  255,  0},
-  {TOPIC_RTK_VELOCITY              , UID_RTK_VELOCITY             , sizeof(TypeMap<TOPIC_RTK_VELOCITY            >::type), 5  ,   0,  255,  0},
-  {TOPIC_RTK_YAW                   , UID_RTK_YAW                  , sizeof(TypeMap<TOPIC_RTK_YAW                 >::type), 5  ,   0,  255,  0},
-  {TOPIC_RTK_POSITION_INFO         , UID_RTK_POSITION_INFO        , sizeof(TypeMap<TOPIC_RTK_POSITION_INFO       >::type), 5  ,   0,  255,  0},
-  {TOPIC_RTK_YAW_INFO              , UID_RTK_YAW_INFO             , sizeof(TypeMap<TOPIC_RTK_YAW_INFO            >::type), 5  ,   0,  255,  0},
-  {TOPIC_COMPASS                   , UID_COMPASS                  , sizeof(TypeMap<TOPIC_COMPASS                 >::type), 100,   0,  255,  0},
-  {TOPIC_RC                        , UID_RC                       , sizeof(TypeMap<TOPIC_RC                      >::type), 50 ,   0,  255,  0},
-  {TOPIC_GIMBAL_ANGLES             , UID_GIMBAL_ANGLES            , sizeof(TypeMap<TOPIC_GIMBAL_ANGLES           >::type), 50 ,   0,  255,  0},
-  {TOPIC_GIMBAL_STATUS             , UID_GIMBAL_STATUS            , sizeof(TypeMap<TOPIC_GIMBAL_STATUS           >::type), 50 ,   0,  255,  0},
-  {TOPIC_STATUS_FLIGHT             , UID_STATUS_FLIGHT            , sizeof(TypeMap<TOPIC_STATUS_FLIGHT           >::type), 50 ,   0,  255,  0},
-  {TOPIC_STATUS_DISPLAYMODE        , UID_STATUS_DISPLAYMODE       , sizeof(TypeMap<TOPIC_STATUS_DISPLAYMODE      >::type), 50 ,   0,  255,  0},
-  {TOPIC_STATUS_LANDINGGEAR        , UID_STATUS_LANDINGGEAR       , sizeof(TypeMap<TOPIC_STATUS_LANDINGGEAR      >::type), 50 ,   0,  255,  0},
-  {TOPIC_STATUS_MOTOR_START_ERROR  , UID_STATUS_MOTOR_START_ERROR , sizeof(TypeMap<TOPIC_STATUS_MOTOR_START_ERROR>::type), 50 ,   0,  255,  0},
-  {TOPIC_BATTERY_INFO              , UID_BATTERY_INFO             , sizeof(TypeMap<TOPIC_BATTERY_INFO            >::type), 50 ,   0,  255,  0},
-  {TOPIC_CONTROL_DEVICE            , UID_CONTROL_DEVICE           , sizeof(TypeMap<TOPIC_CONTROL_DEVICE          >::type), 50 ,   0,  255,  0},
-  {TOPIC_HARD_SYNC                 , UID_HARD_SYNC                , sizeof(TypeMap<TOPIC_HARD_SYNC               >::type), 400,   0,  255,  0},
-  {TOPIC_GPS_SIGNAL_LEVEL          , UID_GPS_SIGNAL_LEVEL         , sizeof(TypeMap<TOPIC_GPS_SIGNAL_LEVEL        >::type), 50 ,   0,  255,  0},
-  {TOPIC_GPS_CONTROL_LEVEL         , UID_GPS_CONTROL_LEVEL        , sizeof(TypeMap<TOPIC_GPS_CONTROL_LEVEL       >::type), 50 ,   0,  255,  0},
-  {TOPIC_RC_FULL_RAW_DATA          , UID_RC_FULL_RAW_DATA         , sizeof(TypeMap<TOPIC_RC_FULL_RAW_DATA        >::type), 50 ,   0,  255,  0},
-  {TOPIC_RC_WITH_FLAG_DATA         , UID_RC_WITH_FLAG_DATA        , sizeof(TypeMap<TOPIC_RC_WITH_FLAG_DATA       >::type), 50 ,   0,  255,  0},
-  {TOPIC_ESC_DATA                  , UID_ESC_DATA                 , sizeof(TypeMap<TOPIC_ESC_DATA                >::type), 50 ,   0,  255,  0},
-  {TOPIC_RTK_CONNECT_STATUS        , UID_RTK_CONNECT_STATUS       , sizeof(TypeMap<TOPIC_RTK_CONNECT_STATUS      >::type), 50 ,   0,  255,  0},
-  {TOPIC_GIMBAL_CONTROL_MODE       , UID_GIMBAL_CONTROL_MODE      , sizeof(TypeMap<TOPIC_GIMBAL_CONTROL_MODE     >::type), 50 ,   0,  255,  0},
-  {TOPIC_FLIGHT_ANOMALY            , UID_FLIGHT_ANOMALY           , sizeof(TypeMap<TOPIC_FLIGHT_ANOMALY          >::type), 50 ,   0,  255,  0},
-  {TOPIC_POSITION_VO               , UID_POSITION_VO              , sizeof(TypeMap<TOPIC_POSITION_VO             >::type), 200,   0,  255,  0},
-  {TOPIC_AVOID_DATA                , UID_AVOID_DATA               , sizeof(TypeMap<TOPIC_AVOID_DATA              >::type), 100,   0,  255,  0},
-  {TOPIC_HOME_POINT_SET_STATUS     , UID_HOME_POINT_SET_STATUS    , sizeof(TypeMap<TOPIC_HOME_POINT_SET_STATUS   >::type), 50  ,  0,  255,  0},
-  {TOPIC_HOME_POINT_INFO           , UID_HOME_POINT_INFO          , sizeof(TypeMap<TOPIC_HOME_POINT_INFO         >::type), 50  ,  0,  255,  0},
-  {TOPIC_DUAL_GIMBAL_DATA          , UID_DUAL_GIMBAL_FULL_DATA    , sizeof(TypeMap<TOPIC_DUAL_GIMBAL_DATA        >::type), 50  ,  0,  255,  0},
-  {TOPIC_THREE_GIMBAL_DATA         , UID_THREE_GIMBAL_FULL_DATA   , sizeof(TypeMap<TOPIC_THREE_GIMBAL_DATA       >::type), 50  ,  0,  255,  0},
+  {TOPIC_QUATERNION                , UID_QUATERNION               , sizeof(TypeMap<TOPIC_QUATERNION              >::type), TypeMap<TOPIC_QUATERNION              >::maxFreq,   0,  255,  0, NULL},
+  {TOPIC_ACCELERATION_GROUND       , UID_ACCELERATION_GROUND      , sizeof(TypeMap<TOPIC_ACCELERATION_GROUND     >::type), TypeMap<TOPIC_ACCELERATION_GROUND     >::maxFreq,   0,  255,  0, NULL},
+  {TOPIC_ACCELERATION_BODY         , UID_ACCELERATION_BODY        , sizeof(TypeMap<TOPIC_ACCELERATION_BODY       >::type), TypeMap<TOPIC_ACCELERATION_BODY       >::maxFreq,   0,  255,  0, NULL},
+  {TOPIC_ACCELERATION_RAW          , UID_ACCELERATION_RAW         , sizeof(TypeMap<TOPIC_ACCELERATION_RAW        >::type), TypeMap<TOPIC_ACCELERATION_RAW        >::maxFreq,   0,  255,  0, NULL},
+  {TOPIC_VELOCITY                  , UID_VELOCITY                 , sizeof(TypeMap<TOPIC_VELOCITY                >::type), TypeMap<TOPIC_VELOCITY                >::maxFreq,   0,  255,  0, NULL},
+  {TOPIC_ANGULAR_RATE_FUSIONED     , UID_ANGULAR_RATE_FUSIONED    , sizeof(TypeMap<TOPIC_ANGULAR_RATE_FUSIONED   >::type), TypeMap<TOPIC_ANGULAR_RATE_FUSIONED   >::maxFreq,   0,  255,  0, NULL},
+  {TOPIC_ANGULAR_RATE_RAW          , UID_ANGULAR_RATE_RAW         , sizeof(TypeMap<TOPIC_ANGULAR_RATE_RAW        >::type), TypeMap<TOPIC_ANGULAR_RATE_RAW        >::maxFreq,   0,  255,  0, NULL},
+  {TOPIC_ALTITUDE_FUSIONED         , UID_ALTITUDE_FUSIONED        , sizeof(TypeMap<TOPIC_ALTITUDE_FUSIONED       >::type), TypeMap<TOPIC_ALTITUDE_FUSIONED       >::maxFreq,   0,  255,  0, NULL},
+  {TOPIC_ALTITUDE_BAROMETER        , UID_ALTITUDE_BAROMETER       , sizeof(TypeMap<TOPIC_ALTITUDE_BAROMETER      >::type), TypeMap<TOPIC_ALTITUDE_BAROMETER      >::maxFreq,   0,  255,  0, NULL},
+  {TOPIC_ALTITUDE_OF_HOMEPOINT     , UID_ALTITUDE_OF_HOMEPOINT    , sizeof(TypeMap<TOPIC_ALTITUDE_OF_HOMEPOINT   >::type), TypeMap<TOPIC_ALTITUDE_OF_HOMEPOINT   >::maxFreq,   0,  255,  0, NULL},
+  {TOPIC_HEIGHT_FUSION             , UID_HEIGHT_FUSION            , sizeof(TypeMap<TOPIC_HEIGHT_FUSION           >::type), TypeMap<TOPIC_HEIGHT_FUSION           >::maxFreq,   0,  255,  0, NULL},
+  {TOPIC_GPS_FUSED                 , UID_GPS_FUSED                , sizeof(TypeMap<TOPIC_GPS_FUSED               >::type), TypeMap<TOPIC_GPS_FUSED               >::maxFreq,   0,  255,  0, NULL},
+  {TOPIC_GPS_DATE                  , UID_GPS_DATE                 , sizeof(TypeMap<TOPIC_GPS_DATE                >::type), TypeMap<TOPIC_GPS_DATE                >::maxFreq,   0,  255,  0, NULL},
+  {TOPIC_GPS_TIME                  , UID_GPS_TIME                 , sizeof(TypeMap<TOPIC_GPS_TIME                >::type), TypeMap<TOPIC_GPS_TIME                >::maxFreq,   0,  255,  0, NULL},
+  {TOPIC_GPS_POSITION              , UID_GPS_POSITION             , sizeof(TypeMap<TOPIC_GPS_POSITION            >::type), TypeMap<TOPIC_GPS_POSITION            >::maxFreq,   0,  255,  0, NULL},
+  {TOPIC_GPS_VELOCITY              , UID_GPS_VELOCITY             , sizeof(TypeMap<TOPIC_GPS_VELOCITY            >::type), TypeMap<TOPIC_GPS_VELOCITY            >::maxFreq,   0,  255,  0, NULL},
+  {TOPIC_GPS_DETAILS               , UID_GPS_DETAILS              , sizeof(TypeMap<TOPIC_GPS_DETAILS             >::type), TypeMap<TOPIC_GPS_DETAILS             >::maxFreq,   0,  255,  0, NULL},
+  {TOPIC_RTK_POSITION              , UID_RTK_POSITION             , sizeof(TypeMap<TOPIC_RTK_POSITION            >::type), TypeMap<TOPIC_RTK_POSITION            >::maxFreq,   0,  255,  0, NULL},
+  {TOPIC_RTK_VELOCITY              , UID_RTK_VELOCITY             , sizeof(TypeMap<TOPIC_RTK_VELOCITY            >::type), TypeMap<TOPIC_RTK_VELOCITY            >::maxFreq,   0,  255,  0, NULL},
+  {TOPIC_RTK_YAW                   , UID_RTK_YAW                  , sizeof(TypeMap<TOPIC_RTK_YAW                 >::type), TypeMap<TOPIC_RTK_YAW                 >::maxFreq,   0,  255,  0, NULL},
+  {TOPIC_RTK_POSITION_INFO         , UID_RTK_POSITION_INFO        , sizeof(TypeMap<TOPIC_RTK_POSITION_INFO       >::type), TypeMap<TOPIC_RTK_POSITION_INFO       >::maxFreq,   0,  255,  0, NULL},
+  {TOPIC_RTK_YAW_INFO              , UID_RTK_YAW_INFO             , sizeof(TypeMap<TOPIC_RTK_YAW_INFO            >::type), TypeMap<TOPIC_RTK_YAW_INFO            >::maxFreq,   0,  255,  0, NULL},
+  {TOPIC_COMPASS                   , UID_COMPASS                  , sizeof(TypeMap<TOPIC_COMPASS                 >::type), TypeMap<TOPIC_COMPASS                 >::maxFreq,   0,  255,  0, NULL},
+  {TOPIC_RC                        , UID_RC                       , sizeof(TypeMap<TOPIC_RC                      >::type), TypeMap<TOPIC_RC                      >::maxFreq,   0,  255,  0, NULL},
+  {TOPIC_GIMBAL_ANGLES             , UID_GIMBAL_ANGLES            , sizeof(TypeMap<TOPIC_GIMBAL_ANGLES           >::type), TypeMap<TOPIC_GIMBAL_ANGLES           >::maxFreq,   0,  255,  0, NULL},
+  {TOPIC_GIMBAL_STATUS             , UID_GIMBAL_STATUS            , sizeof(TypeMap<TOPIC_GIMBAL_STATUS           >::type), TypeMap<TOPIC_GIMBAL_STATUS           >::maxFreq,   0,  255,  0, NULL},
+  {TOPIC_STATUS_FLIGHT             , UID_STATUS_FLIGHT            , sizeof(TypeMap<TOPIC_STATUS_FLIGHT           >::type), TypeMap<TOPIC_STATUS_FLIGHT           >::maxFreq,   0,  255,  0, NULL},
+  {TOPIC_STATUS_DISPLAYMODE        , UID_STATUS_DISPLAYMODE       , sizeof(TypeMap<TOPIC_STATUS_DISPLAYMODE      >::type), TypeMap<TOPIC_STATUS_DISPLAYMODE      >::maxFreq,   0,  255,  0, NULL},
+  {TOPIC_STATUS_LANDINGGEAR        , UID_STATUS_LANDINGGEAR       , sizeof(TypeMap<TOPIC_STATUS_LANDINGGEAR      >::type), TypeMap<TOPIC_STATUS_LANDINGGEAR      >::maxFreq,   0,  255,  0, NULL},
+  {TOPIC_STATUS_MOTOR_START_ERROR  , UID_STATUS_MOTOR_START_ERROR , sizeof(TypeMap<TOPIC_STATUS_MOTOR_START_ERROR>::type), TypeMap<TOPIC_STATUS_MOTOR_START_ERROR>::maxFreq,   0,  255,  0, NULL},
+  {TOPIC_BATTERY_INFO              , UID_BATTERY_INFO             , sizeof(TypeMap<TOPIC_BATTERY_INFO            >::type), TypeMap<TOPIC_BATTERY_INFO            >::maxFreq,   0,  255,  0, NULL},
+  {TOPIC_CONTROL_DEVICE            , UID_CONTROL_DEVICE           , sizeof(TypeMap<TOPIC_CONTROL_DEVICE          >::type), TypeMap<TOPIC_CONTROL_DEVICE          >::maxFreq,   0,  255,  0, NULL},
+  {TOPIC_HARD_SYNC                 , UID_HARD_SYNC                , sizeof(TypeMap<TOPIC_HARD_SYNC               >::type), TypeMap<TOPIC_HARD_SYNC               >::maxFreq,   0,  255,  0, NULL},
+  {TOPIC_GPS_SIGNAL_LEVEL          , UID_GPS_SIGNAL_LEVEL         , sizeof(TypeMap<TOPIC_GPS_SIGNAL_LEVEL        >::type), TypeMap<TOPIC_GPS_SIGNAL_LEVEL        >::maxFreq,   0,  255,  0, NULL},
+  {TOPIC_GPS_CONTROL_LEVEL         , UID_GPS_CONTROL_LEVEL        , sizeof(TypeMap<TOPIC_GPS_CONTROL_LEVEL       >::type), TypeMap<TOPIC_GPS_CONTROL_LEVEL       >::maxFreq,   0,  255,  0, NULL},
+  {TOPIC_RC_FULL_RAW_DATA          , UID_RC_FULL_RAW_DATA         , sizeof(TypeMap<TOPIC_RC_FULL_RAW_DATA        >::type), TypeMap<TOPIC_RC_FULL_RAW_DATA        >::maxFreq,   0,  255,  0, NULL},
+  {TOPIC_RC_WITH_FLAG_DATA         , UID_RC_WITH_FLAG_DATA        , sizeof(TypeMap<TOPIC_RC_WITH_FLAG_DATA       >::type), TypeMap<TOPIC_RC_WITH_FLAG_DATA       >::maxFreq,   0,  255,  0, NULL},
+  {TOPIC_ESC_DATA                  , UID_ESC_DATA                 , sizeof(TypeMap<TOPIC_ESC_DATA                >::type), TypeMap<TOPIC_ESC_DATA                >::maxFreq,   0,  255,  0, NULL},
+  {TOPIC_RTK_CONNECT_STATUS        , UID_RTK_CONNECT_STATUS       , sizeof(TypeMap<TOPIC_RTK_CONNECT_STATUS      >::type), TypeMap<TOPIC_RTK_CONNECT_STATUS      >::maxFreq,   0,  255,  0, NULL},
+  {TOPIC_GIMBAL_CONTROL_MODE       , UID_GIMBAL_CONTROL_MODE      , sizeof(TypeMap<TOPIC_GIMBAL_CONTROL_MODE     >::type), TypeMap<TOPIC_GIMBAL_CONTROL_MODE     >::maxFreq,   0,  255,  0, NULL},
+  {TOPIC_FLIGHT_ANOMALY            , UID_FLIGHT_ANOMALY           , sizeof(TypeMap<TOPIC_FLIGHT_ANOMALY          >::type), TypeMap<TOPIC_FLIGHT_ANOMALY          >::maxFreq,   0,  255,  0, NULL},
+  {TOPIC_POSITION_VO               , UID_POSITION_VO              , sizeof(TypeMap<TOPIC_POSITION_VO             >::type), TypeMap<TOPIC_POSITION_VO             >::maxFreq,   0,  255,  0, NULL},
+  {TOPIC_AVOID_DATA                , UID_AVOID_DATA               , sizeof(TypeMap<TOPIC_AVOID_DATA              >::type), TypeMap<TOPIC_AVOID_DATA              >::maxFreq,   0,  255,  0, NULL},
+  {TOPIC_HOME_POINT_SET_STATUS     , UID_HOME_POINT_SET_STATUS    , sizeof(TypeMap<TOPIC_HOME_POINT_SET_STATUS   >::type), TypeMap<TOPIC_HOME_POINT_SET_STATUS   >::maxFreq,  0,  255,  0, NULL},
+  {TOPIC_HOME_POINT_INFO           , UID_HOME_POINT_INFO          , sizeof(TypeMap<TOPIC_HOME_POINT_INFO         >::type), TypeMap<TOPIC_HOME_POINT_INFO         >::maxFreq,  0,  255,  0, NULL},
+  {TOPIC_DUAL_GIMBAL_DATA          , UID_DUAL_GIMBAL_FULL_DATA    , sizeof(TypeMap<TOPIC_DUAL_GIMBAL_DATA        >::type), TypeMap<TOPIC_DUAL_GIMBAL_DATA        >::maxFreq,  0,  255,  0, NULL},
+  {TOPIC_THREE_GIMBAL_DATA         , UID_THREE_GIMBAL_FULL_DATA   , sizeof(TypeMap<TOPIC_THREE_GIMBAL_DATA       >::type), TypeMap<TOPIC_THREE_GIMBAL_DATA       >::maxFreq,  0,  255,  0, NULL},
 };
 // clang-format on
 
+// Defined in dji_legacy_linker.cpp
+RecvContainer recvFrameAdapting(const T_CmdInfo &cmdInfo, const uint8_t *cmdData);
+
+
+static E_OsdkStat subscriptionDataRecvCallback(struct _CommandHandle *cmdHandle,
+                                               const T_CmdInfo *cmdInfo,
+                                               const uint8_t *cmdData,
+                                               void *userData)
+{
+  (void)cmdHandle;
+  DataSubscription *subscriptionHandle = (DataSubscription *)userData;
+  if (!cmdInfo || !cmdData || !subscriptionHandle)
+  {
+    DERROR("Parameter invalid.");
+    return OSDK_STAT_ERR_PARAM;
+  }
+
+  subscriptionHandle->dispatchFrame(cmdData, cmdInfo->dataLen,
+                                    cmdInfo->seqNum);
+  return OSDK_STAT_OK;
+}
+
 /*!
  * @details 1. Initialize the api member
  *          2. Set each package[i] entry with packageID = i
@@ -98,21 +127,35 @@ TopicInfo Telemetry::TopicDataBase[] =
  */
 DataSubscription::DataSubscription(Vehicle* vehiclePtr)
   : vehicle(vehiclePtr)
+  , historyPass(0)
 {
   for (int i = 0; i < MAX_NUMBER_OF_PACKAGE; i++)
   {
     package[i].setPackageID(i);
   }
 
+  for (int i = 0; i < MAX_NUMBER_OF_PACKAGE; i++)
+  {
+    batchSlot[i].add          = false;
+    batchSlot[i].pending      = false;
+    batchSlot[i].generation   = 0;
+  }
+  Platform::instance().mutexCreate(&batchLock);
+  Platform::instance().mutexCreate(&batchSlotLock);
+  Platform::instance().semaphoreCreate(&batchSem, 0);
+
   subscriptionDataDecodeHandler.callback = decodeCallback;
   subscriptionDataDecodeHandler.userData = this;
-  Platform::instance().mutexCreate(&m_msgLock);
 }
 
 DataSubscription::~DataSubscription()
 {
   subscriptionDataDecodeHandler.callback = 0;
   subscriptionDataDecodeHandler.userData = 0;
+
+  Platform::instance().semaphoreDestroy(batchSem);
+  Platform::instance().mutexDestroy(batchSlotLock);
+  Platform::instance().mutexDestroy(batchLock);
 }
 
 Vehicle*
@@ -133,29 +176,135 @@ DataSubscription::decodeCallback(Vehicle*      vehiclePtr,
 {
   DataSubscription* subscriptionHandle = (DataSubscription*)subPtr;
 
+  uint32_t length = 0;
+  if (rcvContainer.recvInfo.len > OpenProtocol::PackageMin)
+  {
+    length = rcvContainer.recvInfo.len - OpenProtocol::PackageMin;
+  }
+
+  SubscriptionPackage* p = subscriptionHandle->decodeFrame(
+    rcvContainer.recvData.raw_ack_array, length);
+  if (p)
+  {
+    VehicleCallBackHandler h = p->getUnpackHandler();
+    if (NULL != h.callback)
+    {
+      uint64_t startUs = getMonotonicTimeUs();
+      (*(h.callback))(vehiclePtr, rcvContainer, h.userData);
+      p->recordCallbackTime(getMonotonicTimeUs() - startUs);
+    }
+  }
+}
+
+bool
+DataSubscription::registerDataHandler()
+{
+  static T_RecvCmdHandle recvCmdHandle;
+  static T_RecvCmdItem   recvCmdItem;
+
+  recvCmdItem.cmdSet   = OpenProtocolCMD::CMDSet::Broadcast::subscribe[0];
+  recvCmdItem.cmdId    = OpenProtocolCMD::CMDSet::Broadcast::subscribe[1];
+  recvCmdItem.mask     = MASK_HOST_XXXXXX_SET_ID;
+  recvCmdItem.userData = this;
+  recvCmdItem.pFunc    = subscriptionDataRecvCallback;
+
+  recvCmdHandle.cmdList   = &recvCmdItem;
+  recvCmdHandle.protoType = PROTOCOL_SDK;
+  recvCmdHandle.cmdCount  = 1;
+
+  return vehicle->linker->registerCmdHandler(&recvCmdHandle);
+}
+
+/*!
+ * @details Same as the handler registered on the linker. Only the fields
+ * recvFrameAdapting reads are filled in.
+ */
+SubscriptionPackage*
+DataSubscription::dispatchFrame(const uint8_t* frame, uint32_t length,
+                                uint16_t seqNum)
+{
+  SubscriptionPackage* p = decodeFrame(frame, length);
+  if (p)
+  {
+    VehicleCallBackHandler h = p->getUnpackHandler();
+    if (NULL != h.callback)
+    {
+      // Only pay for the RecvContainer copy when somebody consumes it
+      T_CmdInfo cmdInfo;
+      memset(&cmdInfo, 0, sizeof(cmdInfo));
+      cmdInfo.cmdSet  = OpenProtocolCMD::CMDSet::Broadcast::subscribe[0];
+      cmdInfo.cmdId   = OpenProtocolCMD::CMDSet::Broadcast::subscribe[1];
+      cmdInfo.seqNum  = seqNum;
+      cmdInfo.dataLen = length;
+
+      uint64_t      startUs   = getMonotonicTimeUs();
+      RecvContainer recvFrame = recvFrameAdapting(cmdInfo, frame);
+      (*(h.callback))(vehicle, recvFrame, h.userData);
+      p->recordCallbackTime(getMonotonicTimeUs() - startUs);
+    }
+  }
+  return p;
+}
+
+bool
+DataSubscription::startPackageLocally(int packageID, int numberOfTopics,
+                                      TopicName* topicList, bool sendTimeStamp,
+                                      uint16_t freq)
+{
+  if (packageID < 0 || packageID >= MAX_NUMBER_OF_PACKAGE)
+  {
+    return false;
+  }
+  if (package[packageID].isOccupied())
+  {
+    // Keep the callback the application registered for the package
+    VehicleCallBackHandler h = package[packageID].getUnpackHandler();
+    package[packageID].packageRemoveSuccessHandler();
+    package[packageID].setUserUnpackCallback(h.callback, h.userData);
+  }
+  if (!initPackageFromTopicList(packageID, numberOfTopics, topicList,
+                                sendTimeStamp, freq))
+  {
+    return false;
+  }
+  package[packageID].allocateDataBuffer();
+  package[packageID].packageAddSuccessHandler();
+  return true;
+}
+
+/*!
+ * @details The frame is read where the linker received it. The only copy is
+ * the publish into the package data buffer, which outlives the frame.
+ */
+SubscriptionPackage*
+DataSubscription::decodeFrame(const uint8_t* frame, uint32_t length)
+{
+  if (length < 1)
+  {
+    DERROR("Empty subscription frame received.");
+    return NULL;
+  }
+
   // uint8_t pkgID = *(((uint8_t *)header) + sizeof(OpenHeader) + 2);
-  uint8_t pkgID = rcvContainer.recvData.subscribeACK;
+  uint8_t pkgID = frame[0];
 
   if (pkgID >= MAX_NUMBER_OF_PACKAGE)
   {
     DERROR("Unexpected package id %d received.", pkgID);
-    return;
+    return NULL;
   }
 
-  SubscriptionPackage* p = &subscriptionHandle->package[pkgID];
+  SubscriptionPackage* p = &package[pkgID];
 
   /*
    *  TODO: handle the case that the FC is already sending subscription packages
    * when the program starts,
    */
 
-  subscriptionHandle->extractOnePackage(&rcvContainer, p);
+  // skip the package ID
+  extractOnePackage(frame + 1, length - 1, p);
 
-  VehicleCallBackHandler h = p->getUnpackHandler();
-  if (NULL != h.callback)
-  {
-    (*(h.callback))(vehiclePtr, rcvContainer, h.userData);
-  }
+  return p;
 }
 
 /*!
@@ -364,30 +513,31 @@ DataSubscription::startPackage(int packageID, int timeout)
 
 // adapted from DataSubscribe::Package::unpack
 void
-DataSubscription::extractOnePackage(RecvContainer*       pRcvContainer,
+DataSubscription::extractOnePackage(const uint8_t* data, uint32_t length,
                                     SubscriptionPackage* pkg)
 {
-  //  uint8_t *data = ((uint8_t *)header) + sizeof(OpenHeader) + 2;
-  //  DDEBUG(
-  //          "%d unpacking %d %d 0x%x 0x%x.", pkg->getBufferSize(),
-  //          header->length - CoreAPI::PackageMin - 3, *((uint8_t *)data + 1),
-  //          *((uint32_t *)data), *((uint32_t *)data + 1));
-  //  data++;
-
-  uint8_t* data = pRcvContainer->recvData.raw_ack_array;
-  data++; // skip the package ID
-
   /*
    * TODO: Handle the time stamp field if it exists
    */
 
-  lockMSG();
   if (pkg->getDataBuffer())
   {
-    // TODO: the length needs to come from the header, not package
-    memcpy(pkg->getDataBuffer(), data, pkg->getBufferSize());
-    // memcpy(pkg->getDataBuffer(), data, header->length - CoreAPI::PackageMin -
-    // 3);
+    if (length < pkg->getBufferSize())
+    {
+      DERROR("Package %d is %d bytes, expected %d, dropped.",
+             pkg->getInfo().packageID, length, pkg->getBufferSize());
+      return;
+    }
+    pkg->writeData(data);
+    // Package ID byte and protocol framing around the data
+    pkg->recordFrame(length + 1 + OpenProtocol::PackageMin);
+    recordTopicHistory(data, pkg);
+#if defined(__linux__)
+    if (FlightRecorder::instance().isRecording())
+    {
+      FlightRecorder::instance().recordSubscription(pkg, data, length);
+    }
+#endif
   }
   else
   {
@@ -399,7 +549,109 @@ DataSubscription::extractOnePackage(RecvContainer*       pRcvContainer,
       DDEBUG("This was due to unclean quit of the program without restarting the drone.\n");
     }
   }
-  freeMSG();
+}
+
+void
+DataSubscription::recordTopicHistory(const uint8_t*       data,
+                                     SubscriptionPackage* pkg)
+{
+  uint64_t timeUs   = 0;
+  bool     hasStamp = false;
+
+  // Odd while the rings are in use, see setTopicHistory
+#if defined(__linux__)
+  historyPass.fetch_add(1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+#else
+  historyPass = historyPass + 1;
+  __sync_synchronize();
+#endif
+  for (int i = 0; i < pkg->getInfo().numberOfTopics; i++)
+  {
+    TopicHistoryBase* history = TopicDataBase[pkg->getTopicList()[i]].history;
+    if (!history)
+    {
+      continue;
+    }
+    // Only query the clock when at least one topic records its history
+    if (!hasStamp)
+    {
+      timeUs   = getMonotonicTimeUs();
+      hasStamp = true;
+    }
+    history->record(data + pkg->getOffsetList()[i], timeUs);
+  }
+#if defined(__linux__)
+  historyPass.fetch_add(1, std::memory_order_release);
+#else
+  __sync_synchronize();
+  historyPass = historyPass + 1;
+#endif
+}
+
+void
+DataSubscription::setTopicHistory(TopicName topic, TopicHistoryBase* history)
+{
+  TopicDataBase[topic].history = history;
+
+  // A pass that started before the swap may still hold the old ring, wait
+  // for it to end. Later passes see the new one. A pass only copies a few
+  // topics, so give the CPU to the receive thread rather than sleeping.
+#if defined(__linux__)
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  uint32_t pass = historyPass.load(std::memory_order_relaxed);
+  while ((pass & 1) &&
+         historyPass.load(std::memory_order_acquire) == pass)
+  {
+    sched_yield();
+  }
+#else
+  __sync_synchronize();
+  uint32_t pass = historyPass;
+  while ((pass & 1) && historyPass == pass)
+  {
+    Platform::instance().taskSleepMs(1);
+  }
+#endif
+}
+
+void
+DataSubscription::disableTopicHistory(TopicName topic)
+{
+  setTopicHistory(topic, NULL);
+}
+
+bool
+DataSubscription::getPackageSnapshot(int packageID, uint8_t* buffer,
+                                     uint32_t bufferSize, uint32_t* sequence)
+{
+  if (packageID < 0 || packageID >= MAX_NUMBER_OF_PACKAGE)
+  {
+    DERROR("Invalid package id %d.", packageID);
+    return false;
+  }
+
+  SubscriptionPackage* pkg = &package[packageID];
+  if (!pkg->isOccupied() || !pkg->getDataBuffer())
+  {
+    DERROR("Package [%d] is not started.", packageID);
+    return false;
+  }
+  if (bufferSize < pkg->getBufferSize())
+  {
+    DERROR("Snapshot buffer of %d bytes is too small for package [%d] of %d "
+           "bytes.",
+           bufferSize, packageID, pkg->getBufferSize());
+    return false;
+  }
+
+  uint32_t seq =
+    pkg->readData(buffer, pkg->getDataBuffer(), pkg->getBufferSize());
+  if (sequence)
+  {
+    *sequence = seq;
+  }
+  return true;
 }
 
 void
@@ -469,6 +721,318 @@ DataSubscription::removePackage(int packageID, int timeout)
   return ack;
 }
 
+bool
+DataSubscription::startPackages(const int* packageIDs, int count,
+                                ACK::ErrorCode* results, int timeout)
+{
+  return runPackageBatch(packageIDs, count, results, timeout, true);
+}
+
+bool
+DataSubscription::removePackages(const int* packageIDs, int count,
+                                 ACK::ErrorCode* results, int timeout)
+{
+  return runPackageBatch(packageIDs, count, results, timeout, false);
+}
+
+/*!
+ * @details 1. Send the add/remove command of every package without waiting
+ *          2. Wait on batchSem until every slot got its ACK or the timeout
+ *             is spent. ACKs arrive in any order on the linker thread.
+ *          3. Slots still pending get NO_RESPONSE_ERROR. A late ACK still
+ *             updates the package state but is not reported.
+ */
+bool
+DataSubscription::runPackageBatch(const int* packageIDs, int count,
+                                  ACK::ErrorCode* results, int timeout,
+                                  bool add)
+{
+  const uint8_t* cmd = add ? OpenProtocolCMD::CMDSet::Subscribe::addPackage
+                           : OpenProtocolCMD::CMDSet::Subscribe::removePackage;
+  uint32_t timeoutMs = timeout * 1000;
+  uint32_t startMs   = 0;
+  bool     sent[MAX_NUMBER_OF_PACKAGE] = { false };
+
+  Platform::instance().getTimeMs(&startMs);
+  Platform::instance().mutexLock(batchLock);
+
+  for (int i = 0; i < count; i++)
+  {
+    int packageID           = packageIDs[i];
+    results[i].info.cmd_set = OpenProtocolCMD::CMDSet::subscribe;
+    results[i].info.cmd_id  = cmd[1];
+
+    if (packageID < 0 || packageID >= MAX_NUMBER_OF_PACKAGE || sent[packageID])
+    {
+      DERROR("Invalid or repeated package id %d in batch.", packageID);
+      results[i].data = ErrorCode::CommonACK::SYSTEM_ERROR;
+      continue;
+    }
+
+    uint8_t buffer[ADD_PACKAGE_DATA_LENGTH];
+    int     bufferLength;
+    if (add)
+    {
+      // Same guard as startPackage, see there
+      if (package[packageID].isOccupied())
+      {
+        DERROR("Cannot start package [%d] which "
+               "is being occupied. Call "
+               "removePackage first.",
+               packageID);
+        results[i].data =
+          OpenProtocolCMD::ErrorCode::SubscribeACK::MULTIPLE_SUBSCRIBE;
+        continue;
+      }
+      bufferLength = package[packageID].serializePackageInfo(buffer);
+      package[packageID].allocateDataBuffer();
+    }
+    else
+    {
+      buffer[0]    = packageID;
+      bufferLength = 1;
+    }
+
+    // The ACK may come back before sendAsync returns
+    Platform::instance().mutexLock(batchSlotLock);
+    batchSlot[packageID].add     = add;
+    batchSlot[packageID].pending = true;
+    uint32_t generation          = ++batchSlot[packageID].generation;
+    Platform::instance().mutexUnlock(batchSlotLock);
+    sent[packageID] = true;
+
+    // The ACK carries the package and generation it answers, so a late ACK
+    // of an earlier timed out batch is not taken for this one
+    vehicle->legacyLinker->sendAsync(
+      cmd, buffer, bufferLength, timeoutMs, 1, batchPackageCallback,
+      (UserData)(uintptr_t)((generation << 8) | packageID));
+  }
+
+  while (true)
+  {
+    int pendingCount = 0;
+    Platform::instance().mutexLock(batchSlotLock);
+    for (int id = 0; id < MAX_NUMBER_OF_PACKAGE; id++)
+    {
+      if (sent[id] && batchSlot[id].pending)
+      {
+        pendingCount++;
+      }
+    }
+    Platform::instance().mutexUnlock(batchSlotLock);
+
+    uint32_t nowMs = 0;
+    Platform::instance().getTimeMs(&nowMs);
+    if (pendingCount == 0 || nowMs - startMs >= timeoutMs)
+    {
+      break;
+    }
+    // Posts left over from an earlier batch only cause one more recount
+    Platform::instance().semaphoreTimedWait(batchSem,
+                                            timeoutMs - (nowMs - startMs));
+  }
+
+  bool allSuccess = true;
+  Platform::instance().mutexLock(batchSlotLock);
+  for (int i = 0; i < count; i++)
+  {
+    int packageID = packageIDs[i];
+    if (packageID >= 0 && packageID < MAX_NUMBER_OF_PACKAGE &&
+        sent[packageID])
+    {
+      if (batchSlot[packageID].pending)
+      {
+        batchSlot[packageID].pending = false;
+        results[i].data = ErrorCode::CommonACK::NO_RESPONSE_ERROR;
+      }
+      else
+      {
+        results[i] = batchSlot[packageID].ack;
+      }
+      // Only report each package once
+      sent[packageID] = false;
+    }
+    if (ACK::getError(results[i]))
+    {
+      allSuccess = false;
+    }
+  }
+  Platform::instance().mutexUnlock(batchSlotLock);
+  Platform::instance().mutexUnlock(batchLock);
+
+  DSTATUS("%s %d packages %s.", add ? "Start" : "Remove", count,
+          allSuccess ? "successful" : "failed");
+  return allSuccess;
+}
+
+void
+DataSubscription::batchPackageCallback(Vehicle*      vehiclePtr,
+                                       RecvContainer rcvContainer,
+                                       UserData      tag)
+{
+  DataSubscription* subscription = vehiclePtr->subscribe;
+  int               packageID    = (int)((uintptr_t)tag & 0xFF);
+  uint32_t          generation   = (uint32_t)((uintptr_t)tag >> 8);
+  if (!subscription || packageID >= MAX_NUMBER_OF_PACKAGE)
+  {
+    return;
+  }
+  BatchSlot*           slot          = &subscription->batchSlot[packageID];
+  SubscriptionPackage* packageHandle = &subscription->package[packageID];
+
+  ACK::ErrorCode ackErrorCode;
+  ackErrorCode.info = rcvContainer.recvInfo;
+  ackErrorCode.data = rcvContainer.recvData.subscribeACK;
+
+  bool wake = false;
+  Platform::instance().mutexLock(subscription->batchSlotLock);
+  if (slot->pending &&
+      (slot->generation & ((uint32_t)~0 >> 8)) == generation)
+  {
+    // Handled before the batch can see the slot done, as startPackage does
+    if (!ACK::getError(ackErrorCode))
+    {
+      if (slot->add)
+      {
+        packageHandle->packageAddSuccessHandler();
+      }
+      else
+      {
+        packageHandle->packageRemoveSuccessHandler();
+        packageHandle->setLeftOverDataFlag(false);
+      }
+    }
+    else
+    {
+      ACK::getErrorCodeMessage(ackErrorCode, __func__);
+    }
+    slot->ack     = ackErrorCode;
+    slot->pending = false;
+    wake          = true;
+  }
+  else
+  {
+    DDEBUG("Dropped a late ACK of package %d.", packageID);
+  }
+  Platform::instance().mutexUnlock(subscription->batchSlotLock);
+
+  if (wake)
+  {
+    Platform::instance().semaphorePost(subscription->batchSem);
+  }
+}
+
+ACK::ErrorCode
+DataSubscription::changePackageFrequency(int packageID, uint16_t newFreq,
+                                         int timeout)
+{
+  ACK::ErrorCode ack;
+  ack.info.cmd_set = OpenProtocolCMD::CMDSet::subscribe;
+  ack.info.cmd_id  = OpenProtocolCMD::CMDSet::Subscribe::addPackage[1];
+
+  if (packageID < 0 || packageID >= MAX_NUMBER_OF_PACKAGE ||
+      !package[packageID].isOccupied())
+  {
+    DERROR("Package [%d] is not started.", packageID);
+    ack.data = ErrorCode::CommonACK::SYSTEM_ERROR;
+    return ack;
+  }
+
+  // removePackage wipes the package, keep what is needed to add it again
+  SubscriptionPackage::PackageInfo info = package[packageID].getInfo();
+  VehicleCallBackHandler handler = package[packageID].getUnpackHandler();
+  TopicName              topicList[TOTAL_TOPIC_NUMBER];
+  memcpy(topicList, package[packageID].getTopicList(),
+         info.numberOfTopics * sizeof(TopicName));
+
+  for (int i = 0; i < info.numberOfTopics; i++)
+  {
+    if (TopicDataBase[topicList[i]].maxFreq < newFreq)
+    {
+      DERROR("Package [%d] can not run at %d Hz, topic 0x%X max is %d Hz.",
+             packageID, newFreq, topicList[i],
+             TopicDataBase[topicList[i]].maxFreq);
+      ack.data = ErrorCode::CommonACK::SYSTEM_ERROR;
+      return ack;
+    }
+  }
+
+  // Keep the TopicDataBase entries pointing at the last good data while the
+  // package is removed and added again
+  package[packageID].setRenegotiating(true);
+  ack = removePackage(packageID, timeout);
+  if (ACK::getError(ack))
+  {
+    package[packageID].setRenegotiating(false);
+    return ack;
+  }
+
+  // Try the new frequency first, then fall back to the old one, so a
+  // rejected or timed out add does not lose the package
+  uint16_t freqs[2] = { newFreq, info.freq };
+  for (int attempt = 0; attempt < 2; attempt++)
+  {
+    if (!initPackageFromTopicList(packageID, info.numberOfTopics, topicList,
+                                  info.config == 1, freqs[attempt]))
+    {
+      ack.data = ErrorCode::CommonACK::SYSTEM_ERROR;
+      continue;
+    }
+    package[packageID].setUserUnpackCallback(handler.callback,
+                                             handler.userData);
+
+    ACK::ErrorCode startAck = startPackage(packageID, timeout);
+    if (!ACK::getError(startAck))
+    {
+      package[packageID].setRenegotiating(false);
+      if (attempt == 0)
+      {
+        return startAck;
+      }
+      DERROR("Package [%d] could not run at %d Hz, restored %d Hz.",
+             packageID, newFreq, info.freq);
+      return ack;
+    }
+    ack = startAck;
+    package[packageID].clearDataBuffer();
+  }
+
+  // Both adds failed, the package is gone. Stop pointing readers at it.
+  package[packageID].setRenegotiating(false);
+  for (int i = 0; i < info.numberOfTopics; i++)
+  {
+    if (TopicDataBase[topicList[i]].pkgID == packageID)
+    {
+      TopicDataBase[topicList[i]].freq   = 0;
+      TopicDataBase[topicList[i]].pkgID  = 255;
+      TopicDataBase[topicList[i]].latest = NULL;
+    }
+  }
+  package[packageID].cleanUpPackage();
+  DERROR("Package [%d] was lost while changing its frequency to %d Hz.",
+         packageID, newFreq);
+  return ack;
+}
+
+bool
+DataSubscription::getPackageStats(int                                packageID,
+                                  SubscriptionPackage::PackageStats* stats)
+{
+  if (packageID < 0 || packageID >= MAX_NUMBER_OF_PACKAGE)
+  {
+    DERROR("Invalid package id %d.", packageID);
+    return false;
+  }
+  *stats = package[packageID].getStats();
+  return true;
+}
+
+SubscriptionPackage::PackageInfo
+DataSubscription::getPackageInfo(int packageID)
+{
+  return package[packageID].getInfo();
+}
+
 void DataSubscription::removeLeftOverPackages()
 {
   ACK::ErrorCode ack;
@@ -492,18 +1056,44 @@ void DataSubscription::removeLeftOverPackages()
   }
 }
 
+bool DataSubscription::resetLeftOverPackages(int timeout)
+{
+  ACK::ErrorCode ack = reset(timeout);
+  if(ACK::getError(ack) != ACK::SUCCESS)
+  {
+    return false;
+  }
+  for(int packageID = 0; packageID < MAX_NUMBER_OF_PACKAGE; packageID++)
+  {
+    if(!package[packageID].isOccupied())
+    {
+      package[packageID].setLeftOverDataFlag(false);
+    }
+  }
+  return true;
+}
+
 void DataSubscription::removeAllExistingPackages()
 {
-  ACK::ErrorCode ack;
+  int            packageIDs[MAX_NUMBER_OF_PACKAGE];
+  ACK::ErrorCode acks[MAX_NUMBER_OF_PACKAGE];
+  int            count = 0;
   for(int packageID=0; packageID<MAX_NUMBER_OF_PACKAGE; packageID++)
   {
     if(package[packageID].hasLeftOverData() || package[packageID].isOccupied())
     {
-      ack = removePackage(packageID, 1);
-      if(ACK::FAIL == ACK::getError(ack))
-      {
-        DERROR("failed to remove package %d", packageID);
-      }
+      packageIDs[count++] = packageID;
+    }
+  }
+  if(count == 0 || removePackages(packageIDs, count, acks, 1))
+  {
+    return;
+  }
+  for(int i = 0; i < count; i++)
+  {
+    if(ACK::FAIL == ACK::getError(acks[i]))
+    {
+      DERROR("failed to remove package %d", packageIDs[i]);
     }
   }
 }
@@ -558,25 +1148,21 @@ DataSubscription::reset(int timeout)
   return ack;
 }
 
-void
-DataSubscription::lockMSG() {
-  Platform::instance().mutexLock(m_msgLock);
-}
-
-void
-DataSubscription::freeMSG() {
-  Platform::instance().mutexUnlock(m_msgLock);
-}
-
 //////////////////////
 SubscriptionPackage::SubscriptionPackage()
   : occupied(false)
   , leftOverDataFlag(false)
+  , renegotiating(false)
   , incomingDataBuffer(NULL)
   , packageDataSize(0)
+  , layoutVersion(0)
 {
   userUnpackHandler.callback = NULL;
   userUnpackHandler.userData = NULL;
+  info.freq                  = 0;
+  info.config                = 0;
+  info.numberOfTopics        = 0;
+  memset(&stats, 0, sizeof(stats));
 }
 
 SubscriptionPackage::~SubscriptionPackage()
@@ -620,6 +1206,18 @@ SubscriptionPackage::setLeftOverDataFlag(bool flag)
   leftOverDataFlag = flag;
 }
 
+bool
+SubscriptionPackage::isRenegotiating()
+{
+  return renegotiating;
+}
+
+void
+SubscriptionPackage::setRenegotiating(bool status)
+{
+  renegotiating = status;
+}
+
 /*
  * Fill in the necessary information for ADD_PACKAGE call
  */
@@ -646,7 +1244,7 @@ SubscriptionPackage::setTopicList(TopicName* topics, int numberOfTopics,
       return false;
     }
     totalSize += TopicDataBase[topics[i]].size;
-    if (totalSize > ADD_PACKAGE_DATA_LENGTH)
+    if (totalSize > MAX_PACKAGE_DATA_LENGTH)
     {
       DERROR(
         "Too many topics, data payload of the first %d topic is already %d", i,
@@ -673,13 +1271,19 @@ SubscriptionPackage::setTopicList(TopicName* topics, int numberOfTopics,
 void
 SubscriptionPackage::allocateDataBuffer()
 {
-  if (incomingDataBuffer)
+  // The storage is owned by the package and outlives every reader, only
+  // (re)publish it. Readers may still be copying the previous content.
+  dataLock.writeBegin();
+  if (!renegotiating)
   {
-    delete[] incomingDataBuffer;
-    incomingDataBuffer = NULL;
+    // The topic layout is unchanged while renegotiating, keep the last
+    // good data readable until the first new package arrives
+    memset(dataStorage, 0, sizeof(dataStorage));
   }
+  layoutVersion++;
+  dataLock.writeEnd();
 
-  incomingDataBuffer = new uint8_t[packageDataSize];
+  incomingDataBuffer = dataStorage;
 }
 
 void
@@ -702,11 +1306,56 @@ SubscriptionPackage::cleanUpPackage()
 void
 SubscriptionPackage::clearDataBuffer()
 {
-  if (incomingDataBuffer)
-  {
-    delete[] incomingDataBuffer;
-    incomingDataBuffer = NULL;
-  }
+  incomingDataBuffer = NULL;
+}
+
+void
+SubscriptionPackage::writeData(const uint8_t* data)
+{
+  dataLock.write(incomingDataBuffer, data, packageDataSize);
+}
+
+void
+SubscriptionPackage::recordFrame(uint32_t linkBytes)
+{
+  statsLock.writeBegin();
+  stats.frameCount++;
+  stats.byteCount += linkBytes;
+  statsLock.writeEnd();
+}
+
+void
+SubscriptionPackage::recordCallbackTime(uint64_t timeUs)
+{
+  statsLock.writeBegin();
+  stats.callbackTimeUs += timeUs;
+  statsLock.writeEnd();
+}
+
+SubscriptionPackage::PackageStats
+SubscriptionPackage::getStats()
+{
+  PackageStats snapshot;
+  statsLock.read(&snapshot, &stats, sizeof(snapshot));
+  return snapshot;
+}
+
+uint32_t
+SubscriptionPackage::readData(void* dst, const uint8_t* src, uint32_t size)
+{
+  return dataLock.read(dst, src, size);
+}
+
+uint32_t
+SubscriptionPackage::getSequence()
+{
+  return dataLock.getSequence();
+}
+
+uint32_t
+SubscriptionPackage::getLayoutVersion()
+{
+  return layoutVersion;
 }
 
 int
@@ -793,8 +1442,9 @@ void
 SubscriptionPackage::packageRemoveSuccessHandler()
 {
   // Clean up
-  // Step 1. Clear fields in TopicDataBase
-  for (size_t i = 0; i < info.numberOfTopics; ++i)
+  // Step 1. Clear fields in TopicDataBase, unless the package is added again
+  // right away and readers should keep the last good data
+  for (size_t i = 0; !renegotiating && i < info.numberOfTopics; ++i)
   {
     TopicDataBase[topicList[i]].freq   = 0;
     TopicDataBase[topicList[i]].pkgID  = 255;  // Set pkgID to invalid
@@ -0,0 +1,442 @@
+/** @file dji_subscription_governor.cpp
+ *  @version 4.0.0
+ *  @date Oct 2026
+ *
+ *  @brief
+ *  Adaptive frequency control of Subscribe-style telemetry packages
+ *
+ *  @Copyright (c) 2026 DJI
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#include "dji_subscription_governor.hpp"
+
+using namespace DJI::OSDK;
+
+//! Package frequencies accepted by the FC, in Hz
+static const uint16_t FREQ_STEPS[] = { 1, 5, 10, 20, 50, 100, 200, 400 };
+static const int      FREQ_STEP_COUNT =
+  sizeof(FREQ_STEPS) / sizeof(FREQ_STEPS[0]);
+
+//! Timeout in seconds of each step of a renegotiation
+static const int RENEGOTIATE_TIMEOUT = 1;
+
+SubscriptionRateGovernor::SubscriptionRateGovernor(
+  DataSubscription* subscription, uint32_t linkBaudRate)
+  : subscription(subscription)
+  , linkBytesPerSecond(linkBaudRate / 10)
+  , linkLow(0.4f)
+  , linkHigh(0.7f)
+  , callbackLow(0.2f)
+  , callbackHigh(0.5f)
+  , holdPeriods(3)
+  , overloadCount(0)
+  , underloadCount(0)
+  , linkUtilisation(0)
+  , lastUpdateMs(0)
+  , renegotiating(false)
+  , taskHandle(NULL)
+  , periodMs(0)
+  , running(false)
+{
+  memset(state, 0, sizeof(state));
+  Platform::instance().mutexCreate(&stateLock);
+  Platform::instance().semaphoreCreate(&wakeSem, 0);
+  Platform::instance().semaphoreCreate(&exitSem, 0);
+}
+
+SubscriptionRateGovernor::~SubscriptionRateGovernor()
+{
+  stop();
+  Platform::instance().semaphoreDestroy(exitSem);
+  Platform::instance().semaphoreDestroy(wakeSem);
+  Platform::instance().mutexDestroy(stateLock);
+}
+
+bool
+SubscriptionRateGovernor::setPackageBounds(int packageID, uint16_t minFreq,
+                                           uint16_t maxFreq)
+{
+  if (packageID < 0 || packageID >= DataSubscription::MAX_NUMBER_OF_PACKAGE ||
+      minFreq == 0 || minFreq > maxFreq)
+  {
+    DERROR("Invalid bounds [%d, %d] Hz for package %d.", minFreq, maxFreq,
+           packageID);
+    return false;
+  }
+
+  Platform::instance().mutexLock(stateLock);
+  state[packageID].governed = true;
+  state[packageID].minFreq  = minFreq;
+  state[packageID].maxFreq  = maxFreq;
+  Platform::instance().mutexUnlock(stateLock);
+  return true;
+}
+
+void
+SubscriptionRateGovernor::clearPackageBounds(int packageID)
+{
+  if (packageID < 0 || packageID >= DataSubscription::MAX_NUMBER_OF_PACKAGE)
+  {
+    return;
+  }
+  Platform::instance().mutexLock(stateLock);
+  state[packageID].governed = false;
+  Platform::instance().mutexUnlock(stateLock);
+}
+
+bool
+SubscriptionRateGovernor::setLinkThresholds(float low, float high)
+{
+  if (low < 0 || low >= high)
+  {
+    DERROR("Invalid link thresholds %f/%f.", low, high);
+    return false;
+  }
+  Platform::instance().mutexLock(stateLock);
+  linkLow  = low;
+  linkHigh = high;
+  Platform::instance().mutexUnlock(stateLock);
+  return true;
+}
+
+bool
+SubscriptionRateGovernor::setCallbackThresholds(float low, float high)
+{
+  if (low < 0 || low >= high)
+  {
+    DERROR("Invalid callback thresholds %f/%f.", low, high);
+    return false;
+  }
+  Platform::instance().mutexLock(stateLock);
+  callbackLow  = low;
+  callbackHigh = high;
+  Platform::instance().mutexUnlock(stateLock);
+  return true;
+}
+
+void
+SubscriptionRateGovernor::setHoldPeriods(uint8_t periods)
+{
+  Platform::instance().mutexLock(stateLock);
+  holdPeriods = periods ? periods : 1;
+  Platform::instance().mutexUnlock(stateLock);
+}
+
+float
+SubscriptionRateGovernor::getLinkUtilisation()
+{
+  Platform::instance().mutexLock(stateLock);
+  float utilisation = linkUtilisation;
+  Platform::instance().mutexUnlock(stateLock);
+  return utilisation;
+}
+
+/*!
+ * @details 1. Turn the stats deltas since the last update into loads
+ *          2. Count how many updates in a row the loads were too high or
+ *             low, anything in between resets both counts
+ *          3. Change at most one package per update
+ */
+void
+SubscriptionRateGovernor::update()
+{
+  uint32_t nowMs = 0;
+  Platform::instance().getTimeMs(&nowMs);
+
+  Platform::instance().mutexLock(stateLock);
+
+  uint32_t elapsedMs = nowMs - lastUpdateMs;
+  bool     first     = (lastUpdateMs == 0);
+  lastUpdateMs       = nowMs;
+
+  float linkLoad     = 0;
+  bool  callbackHot  = false;
+  bool  callbackIdle = true;
+  for (int id = 0; id < DataSubscription::MAX_NUMBER_OF_PACKAGE; id++)
+  {
+    SubscriptionPackage::PackageStats stats;
+    subscription->getPackageStats(id, &stats);
+
+    if (!first && elapsedMs > 0)
+    {
+      uint32_t bytes = stats.byteCount - state[id].lastStats.byteCount;
+      uint64_t callbackUs =
+        stats.callbackTimeUs - state[id].lastStats.callbackTimeUs;
+
+      state[id].linkLoad =
+        (float)bytes * 1000 / elapsedMs / linkBytesPerSecond;
+      state[id].callbackLoad = (float)callbackUs / 1000 / elapsedMs;
+      linkLoad += state[id].linkLoad;
+
+      if (state[id].governed)
+      {
+        callbackHot  = callbackHot || state[id].callbackLoad > callbackHigh;
+        callbackIdle = callbackIdle && state[id].callbackLoad < callbackLow;
+      }
+    }
+    state[id].lastStats = stats;
+  }
+
+  if (first || elapsedMs == 0)
+  {
+    Platform::instance().mutexUnlock(stateLock);
+    return;
+  }
+  linkUtilisation = linkLoad;
+
+  if (linkLoad > linkHigh || callbackHot)
+  {
+    overloadCount  = (overloadCount < 0xFF) ? overloadCount + 1 : 0xFF;
+    underloadCount = 0;
+  }
+  else if (linkLoad < linkLow && callbackIdle)
+  {
+    underloadCount = (underloadCount < 0xFF) ? underloadCount + 1 : 0xFF;
+    overloadCount  = 0;
+  }
+  else
+  {
+    overloadCount  = 0;
+    underloadCount = 0;
+  }
+
+  // Only decide under stateLock. The renegotiation blocks for up to two
+  // ACK round trips, setters and getters must not wait for it.
+  int      packageID = -1;
+  uint16_t freq      = 0;
+  bool     decided   = false;
+  if (!renegotiating)
+  {
+    if (overloadCount >= holdPeriods)
+    {
+      decided = lowerOnePackage(&packageID, &freq);
+    }
+    else if (underloadCount >= holdPeriods)
+    {
+      decided = raiseOnePackage(&packageID, &freq);
+    }
+  }
+  renegotiating = renegotiating || decided;
+  Platform::instance().mutexUnlock(stateLock);
+
+  if (!decided)
+  {
+    return;
+  }
+  bool changed = applyFrequency(packageID, freq);
+
+  Platform::instance().mutexLock(stateLock);
+  renegotiating = false;
+  if (changed)
+  {
+    overloadCount  = 0;
+    underloadCount = 0;
+  }
+  Platform::instance().mutexUnlock(stateLock);
+}
+
+uint16_t
+SubscriptionRateGovernor::stepDown(uint16_t freq, uint16_t minFreq)
+{
+  uint16_t next = minFreq;
+  for (int i = 0; i < FREQ_STEP_COUNT; i++)
+  {
+    if (FREQ_STEPS[i] < freq && FREQ_STEPS[i] > next)
+    {
+      next = FREQ_STEPS[i];
+    }
+  }
+  return (next < freq) ? next : freq;
+}
+
+uint16_t
+SubscriptionRateGovernor::stepUp(uint16_t freq, uint16_t maxFreq)
+{
+  uint16_t next = maxFreq;
+  for (int i = FREQ_STEP_COUNT - 1; i >= 0; i--)
+  {
+    if (FREQ_STEPS[i] > freq && FREQ_STEPS[i] < next)
+    {
+      next = FREQ_STEPS[i];
+    }
+  }
+  return (next > freq) ? next : freq;
+}
+
+/*!
+ * @details A package whose own callback is too slow goes first, otherwise
+ * the package using the most link bandwidth.
+ */
+bool
+SubscriptionRateGovernor::lowerOnePackage(int* packageID, uint16_t* newFreq)
+{
+  int   victim     = -1;
+  float victimCost = 0;
+  bool  victimHot  = false;
+
+  for (int id = 0; id < DataSubscription::MAX_NUMBER_OF_PACKAGE; id++)
+  {
+    uint16_t freq = subscription->getPackageInfo(id).freq;
+    if (!state[id].governed || freq == 0 ||
+        stepDown(freq, state[id].minFreq) == freq)
+    {
+      continue;
+    }
+    bool  hot  = state[id].callbackLoad > callbackHigh;
+    float cost = hot ? state[id].callbackLoad : state[id].linkLoad;
+    if ((hot && !victimHot) || (hot == victimHot && cost > victimCost))
+    {
+      victim     = id;
+      victimCost = cost;
+      victimHot  = hot;
+    }
+  }
+
+  if (victim < 0)
+  {
+    DDEBUG("Subscription overloaded, all governed packages at min frequency.");
+    return false;
+  }
+  *packageID = victim;
+  *newFreq   = stepDown(subscription->getPackageInfo(victim).freq,
+                        state[victim].minFreq);
+  return true;
+}
+
+/*!
+ * @details The slowest package goes first. The loads of a package scale
+ * with its frequency, so the step is skipped when it would push the link or
+ * the callback above the high threshold and cause the next lowering.
+ */
+bool
+SubscriptionRateGovernor::raiseOnePackage(int* packageID, uint16_t* newFreq)
+{
+  int      candidate     = -1;
+  uint16_t candidateFreq = 0;
+
+  for (int id = 0; id < DataSubscription::MAX_NUMBER_OF_PACKAGE; id++)
+  {
+    uint16_t freq = subscription->getPackageInfo(id).freq;
+    if (!state[id].governed || freq == 0 ||
+        stepUp(freq, state[id].maxFreq) == freq)
+    {
+      continue;
+    }
+    if (candidate < 0 || freq < candidateFreq)
+    {
+      candidate     = id;
+      candidateFreq = freq;
+    }
+  }
+
+  if (candidate < 0)
+  {
+    return false;
+  }
+
+  uint16_t next  = stepUp(candidateFreq, state[candidate].maxFreq);
+  float    ratio = (float)next / candidateFreq;
+  if (linkUtilisation + state[candidate].linkLoad * (ratio - 1) > linkHigh ||
+      state[candidate].callbackLoad * ratio > callbackHigh)
+  {
+    return false;
+  }
+  *packageID = candidate;
+  *newFreq   = next;
+  return true;
+}
+
+bool
+SubscriptionRateGovernor::applyFrequency(int packageID, uint16_t freq)
+{
+  uint16_t oldFreq = subscription->getPackageInfo(packageID).freq;
+  DSTATUS("Moving package %d from %d Hz to %d Hz, link utilisation %f.",
+          packageID, oldFreq, freq, linkUtilisation);
+
+  ACK::ErrorCode ack = subscription->changePackageFrequency(
+    packageID, freq, RENEGOTIATE_TIMEOUT);
+  if (ACK::getError(ack))
+  {
+    DERROR("Failed to move package %d to %d Hz.", packageID, freq);
+    return false;
+  }
+  return true;
+}
+
+bool
+SubscriptionRateGovernor::start(uint32_t periodMs)
+{
+  if (running)
+  {
+    return true;
+  }
+  this->periodMs = periodMs;
+  running        = true;
+
+  E_OsdkStat osdkStat = OsdkOsal_TaskCreate(
+    &taskHandle, (void* (*)(void*))(governorTask),
+    OSDK_TASK_STACK_SIZE_DEFAULT, this);
+  if (osdkStat != OSDK_STAT_OK)
+  {
+    DERROR("Subscription governor task create error:%d", osdkStat);
+    running = false;
+    return false;
+  }
+  return true;
+}
+
+void
+SubscriptionRateGovernor::stop()
+{
+  if (!running)
+  {
+    return;
+  }
+  running = false;
+  // The task is never cancelled, it may be in a renegotiation. Wake it from
+  // its sleep and wait until it leaves the loop, then the destroy only
+  // reaps it.
+  Platform::instance().semaphorePost(wakeSem);
+  Platform::instance().semaphoreWait(exitSem);
+  OsdkOsal_TaskDestroy(taskHandle);
+  taskHandle = NULL;
+
+  Platform::instance().mutexLock(stateLock);
+  lastUpdateMs   = 0;
+  overloadCount  = 0;
+  underloadCount = 0;
+  Platform::instance().mutexUnlock(stateLock);
+}
+
+void*
+SubscriptionRateGovernor::governorTask(void* arg)
+{
+  SubscriptionRateGovernor* governor = (SubscriptionRateGovernor*)arg;
+  while (governor->running)
+  {
+    governor->update();
+    Platform::instance().semaphoreTimedWait(governor->wakeSem,
+                                            governor->periodMs);
+  }
+  Platform::instance().semaphorePost(governor->exitSem);
+  return NULL;
+}
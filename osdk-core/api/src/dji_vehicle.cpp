@@ -99,173 +99,333 @@ Vehicle::Vehicle(Linker* linker)
 #endif
 {
   ackErrorCode.data = OpenProtocolCMD::ErrorCode::CommonACK::NO_RESPONSE_ERROR;
+  droneVersionACK.data.fwVersion = 0;
   sendHeartbeatToFCHandle = NULL;
+  startupFlags  = STARTUP_SEQUENTIAL;
+  startupBaseMs = 0;
+  Platform::instance().mutexCreate(&startupLock);
+  Platform::instance().mutexCreate(&lazyInitLock);
+  Platform::instance().semaphoreCreate(&startupSem, 0);
+}
+
+/*!
+ * @details Stages keep the order init() always had. Lane 0 runs on the
+ *          calling thread. In parallel mode the stages that wait on the
+ *          aircraft move to lanes 1..3, one task each:
+ *          1. Subscriber clears the packages left over on the FC
+ *          2. CameraManager asks for the lens info push
+ *          3. The firewall policy update on M300
+ *          STARTUP_LANE_BEFORE stages run before the tasks start, as other
+ *          lanes and the push handlers read what they create.
+ *          STARTUP_LANE_AFTER stages run once every task is joined. Advanced
+ *          sensing waits for the firewall and queries the version again,
+ *          which rewrites the vehicle version the other lanes read.
+ *          Lazy stages are skipped in lazy mode and created by their getter.
+ */
+const Vehicle::StartupEntry*
+Vehicle::getStartupEntries(size_t* count)
+{
+  //! name, init, lane, required, lazy
+  static const StartupEntry entries[] = {
+    { "subscriber",         &Vehicle::initSubscriber,        STARTUP_LANE_BEFORE, true,  false },
+    { "subscriber cleanup", &Vehicle::cleanSubscriber,       1,                   true,  false },
+    { "Broadcast",          &Vehicle::initBroadcast,         0,                   true,  false },
+    { "Control",            &Vehicle::initControl,           0,                   true,  false },
+    { "Camera",             &Vehicle::initCamera,            0,                   true,  false },
+    { "MFIO",               &Vehicle::initMFIO,              0,                   true,  false },
+    { "Gimbal",             &Vehicle::initGimbal,            0,                   true,  false },
+    { "Mobile Device",      &Vehicle::initMobileDevice,      0,                   false, true  },
+    { "Payload Device",     &Vehicle::initPayloadDevice,     0,                   false, true  },
+    { "CameraManager",      &Vehicle::initCameraManager,     2,                   false, true  },
+    { "PSDKManager",        &Vehicle::initPSDKManager,       0,                   false, true  },
+    { "GimbalManager",      &Vehicle::initGimbalManager,     0,                   false, true  },
+    { "Mission Manager",    &Vehicle::initMissionManager,    0,                   true,  false },
+#if defined(__linux__)
+    { "WaypointV2Mission",  &Vehicle::initWaypointV2Mission, 0,                   true,  true  },
+#endif
+    { "HardSync",           &Vehicle::initHardSync,          0,                   true,  false },
+    { "FlightController",   &Vehicle::initFlightController,  0,                   true,  false },
+    { "firewall",           &Vehicle::initFirewall,          3,                   true,  false },
+#if defined(__linux__)
+    { "DJIHMS",             &Vehicle::initDJIHms,            0,                   true,  true  },
+#endif
+    { "DJIBattery",         &Vehicle::initDJIBattery,        0,                   true,  false },
+#ifdef ADVANCED_SENSING
+    { "AdvancedSensing",    &Vehicle::startAdvancedSensing,  STARTUP_LANE_AFTER,  true,  false },
+#endif
+#if defined(__linux__)
+    { "MopServer",          &Vehicle::initMopServer,         STARTUP_LANE_AFTER,  false, true  },
+#endif
+  };
+  *count = sizeof(entries) / sizeof(entries[0]);
+  return entries;
+}
+
+void
+Vehicle::setStartupMode(uint8_t flags)
+{
+  startupFlags = flags;
+}
+
+std::vector<Vehicle::StartupStage>
+Vehicle::getStartupTimeline()
+{
+  Platform::instance().mutexLock(startupLock);
+  std::vector<StartupStage> timeline = startupTimeline;
+  Platform::instance().mutexUnlock(startupLock);
+  return timeline;
+}
+
+void
+Vehicle::recordStartupStage(const char* name, uint32_t startMs, bool success)
+{
+  uint32_t     nowMs = 0;
+  StartupStage stage;
+  Platform::instance().getTimeMs(&nowMs);
+  stage.name       = name;
+  stage.startMs    = startMs - startupBaseMs;
+  stage.durationMs = nowMs - startMs;
+  stage.success    = success;
+  DDEBUG("Startup stage %s: %d ms at +%d ms", name, stage.durationMs,
+         stage.startMs);
+
+  Platform::instance().mutexLock(startupLock);
+  startupTimeline.push_back(stage);
+  Platform::instance().mutexUnlock(startupLock);
 }
 
 bool
-Vehicle::init()
+Vehicle::runStartupStage(const StartupEntry& entry)
 {
-  if (!initOSDKHeartBeatThread())
+  if (entry.lazy && (startupFlags & STARTUP_LAZY))
   {
-    DERROR("Failed to initialize OSDKHeartBeatThread!\n");
-    return false;
+    return true;
   }
 
-  if (!initLegacyLinker())
+  uint32_t startMs = 0;
+  Platform::instance().getTimeMs(&startMs);
+  bool ret = (this->*entry.init)();
+  recordStartupStage(entry.name, startMs, ret);
+  if (!ret)
   {
-    DERROR("Failed to initialize LegacyLinker!\n");
-    return false;
+    DERROR("Failed to initialize %s!\n", entry.name);
   }
+  return ret;
+}
 
-  /*
-   * Initialize subscriber if supported
-   */
-  if (!initSubscriber())
+bool
+Vehicle::runStartupLane(int lane)
+{
+  size_t              count   = 0;
+  const StartupEntry* entries = getStartupEntries(&count);
+  for (size_t i = 0; i < count; i++)
   {
-    DERROR("Failed to initialize subscriber!\n");
-    return false;
+    if (entries[i].lane == lane && !runStartupStage(entries[i]) &&
+        entries[i].required)
+    {
+      return false;
+    }
   }
+  return true;
+}
 
-  /*
-   * Initialize broadcast if supported
-   */
-  if (!initBroadcast())
-  {
-    DERROR("Failed to initialize Broadcast!\n");
-    return false;
-  }
+void*
+Vehicle::startupLaneTask(void* arg)
+{
+  StartupLane* lane = (StartupLane*)arg;
+  lane->success     = lane->vehicle->runStartupLane(lane->lane);
+  Platform::instance().semaphorePost(lane->vehicle->startupSem);
+  return NULL;
+}
 
-  /*
-   * @note Initialize Movement Control,
-   * @note it will be replaced by FlightActions and FlightController in the future.
-   */
-  if (!initControl())
+/*!
+ * @details The member is only read under lazyInitLock, the lock publishes
+ *          what the init function built to every getter.
+ */
+template <typename T>
+T*
+Vehicle::getLazily(T* const& member, const char* name, InitFunc init)
+{
+  StartupEntry entry = { name, init, 0, false, false };
+  Platform::instance().mutexLock(lazyInitLock);
+  if (!member)
   {
-    DERROR("Failed to initialize Control!\n");
-    return false;
+    runStartupStage(entry);
   }
+  T* ret = member;
+  Platform::instance().mutexUnlock(lazyInitLock);
+  return ret;
+}
 
-  /*
-   * @note Initialize external components
-   * like Camera and MFIO
-   */
-  if (!initCamera())
-  {
-    DERROR("Failed to initialize Camera!\n");
-    return false;
-  }
+MobileDevice*
+Vehicle::getMobileDevice()
+{
+  return getLazily(mobileDevice, "Mobile Device", &Vehicle::initMobileDevice);
+}
 
-  /*
-   * Initialize MFIO if supported
-   */
-  if (!initMFIO())
-  {
-    DERROR("Failed to initialize MFIO!\n");
-    return false;
-  }
+PayloadDevice*
+Vehicle::getPayloadDevice()
+{
+  return getLazily(payloadDevice,
+                   "Payload Device", &Vehicle::initPayloadDevice);
+}
 
-  if(!initGimbal())
-  {
-    DERROR("Failed to initialize Gimbal!\n");
-    return false;
-  }
+CameraManager*
+Vehicle::getCameraManager()
+{
+  return getLazily(cameraManager, "CameraManager", &Vehicle::initCameraManager);
+}
 
-  /*
-   * Initialize Mobile Device Abstraction
-   */
-  if (!initMobileDevice())
-  {
-    DERROR("Failed to initialize Mobile Device!\n");
-  }
+PSDKManager*
+Vehicle::getPSDKManager()
+{
+  return getLazily(psdkManager, "PSDKManager", &Vehicle::initPSDKManager);
+}
 
-  if (!initPayloadDevice())
-  {
-    DERROR("Failed to initialize Payload Device!\n");
-  }
+GimbalManager*
+Vehicle::getGimbalManager()
+{
+  return getLazily(gimbalManager, "GimbalManager", &Vehicle::initGimbalManager);
+}
 
-  if (!initCameraManager())
-  {
-    DERROR("Failed to initialize PayloadManager!\n");
-  }
+#if defined(__linux__)
+WaypointV2MissionOperator*
+Vehicle::getWaypointV2Mission()
+{
+  return getLazily(waypointV2Mission,
+                   "WaypointV2Mission", &Vehicle::initWaypointV2Mission);
+}
 
-  if (!initPSDKManager())
-  {
-    DERROR("Failed to initialize PSDKManager!\n");
-  }
+DJIHMS*
+Vehicle::getDJIHms()
+{
+  return getLazily(djiHms, "DJIHMS", &Vehicle::initDJIHms);
+}
+
+MopServer*
+Vehicle::getMopServer()
+{
+  return getLazily(mopServer, "MopServer", &Vehicle::initMopServer);
+}
+#endif
 
-  if (!initGimbalManager())
+bool
+Vehicle::init()
+{
+  if (startupBaseMs == 0)
   {
-    DERROR("Failed to initialize GimbalManager!\n");
+    Platform::instance().getTimeMs(&startupBaseMs);
   }
 
-  if (!initMissionManager())
+  if (!initOSDKHeartBeatThread())
   {
-    DERROR("Failed to initialize Mission Manager!\n");
+    DERROR("Failed to initialize OSDKHeartBeatThread!\n");
     return false;
   }
-#if defined(__linux__)
-  if (!initWaypointV2Mission())
+
+  if (!initLegacyLinker())
   {
-    DERROR("Failed to initialize WaypointV2Mission!\n");
+    DERROR("Failed to initialize LegacyLinker!\n");
     return false;
   }
+
+  bool success  = true;
+  bool parallel = false;
+#if defined(__linux__)
+  parallel = (startupFlags & STARTUP_PARALLEL) != 0;
 #endif
-  if (!initHardSync())
-  {
-    DERROR("Failed to initialize HardSync!\n");
-    return false;
-  }
 
-  if(!initFlightController())
+  if (!parallel)
   {
-    DERROR("Failed to initialize FlightController!\n");
-    return false;
+    size_t              count   = 0;
+    const StartupEntry* entries = getStartupEntries(&count);
+    for (size_t i = 0; i < count && success; i++)
+    {
+      success = runStartupStage(entries[i]) || !entries[i].required;
+    }
   }
-
-  if(!initFirewall())
+  else if (runStartupLane(STARTUP_LANE_BEFORE))
   {
-    DERROR("Failed to initialize firewall!\n");
-    return false;
+    StartupLane lanes[STARTUP_LANES];
+    for (int i = 1; i < STARTUP_LANES; i++)
+    {
+      lanes[i].vehicle = this;
+      lanes[i].lane    = i;
+      lanes[i].success = false;
+      lanes[i].task    = NULL;
+      if (OsdkOsal_TaskCreate(&lanes[i].task, startupLaneTask,
+                              OSDK_TASK_STACK_SIZE_DEFAULT,
+                              &lanes[i]) != OSDK_STAT_OK)
+      {
+        DERROR("Failed to create startup task %d, running it inline", i);
+        lanes[i].task = NULL;
+      }
+    }
+
+    success = runStartupLane(0);
+
+    for (int i = 1; i < STARTUP_LANES; i++)
+    {
+      if (lanes[i].task)
+      {
+        Platform::instance().semaphoreWait(startupSem);
+      }
+    }
+    for (int i = 1; i < STARTUP_LANES; i++)
+    {
+      if (lanes[i].task)
+      {
+        OsdkOsal_TaskDestroy(lanes[i].task);
+      }
+      else
+      {
+        lanes[i].success = runStartupLane(i);
+      }
+      success = success && lanes[i].success;
+    }
+
+    success = success && runStartupLane(STARTUP_LANE_AFTER);
   }
-#if defined(__linux__)
-  if(!initDJIHms())
+  else
   {
-    DERROR("Failed to initialize DJIHMS!\n");
-    return false;
+    success = false;
   }
-#endif
-  if(!initDJIBattery())
+
+  uint32_t     nowMs   = 0;
+  StartupStage slowest = { "none", 0, 0, true };
+  Platform::instance().getTimeMs(&nowMs);
+  std::vector<StartupStage> timeline = getStartupTimeline();
+  for (size_t i = 0; i < timeline.size(); i++)
   {
-    DERROR("Failed to initialize DJIBattery!\n");
-    return false;
+    if (timeline[i].durationMs >= slowest.durationMs)
+    {
+      slowest = timeline[i];
+    }
   }
+  DSTATUS("Vehicle startup took %d ms, slowest stage %s took %d ms",
+          nowMs - startupBaseMs, slowest.name, slowest.durationMs);
+
+  return success;
+}
 
 #ifdef ADVANCED_SENSING
+bool
+Vehicle::startAdvancedSensing()
+{
   /*! If M300 here will use a new linker to do usb bulk
    * */
   if (!linker->isUSBPlugged()) {
     DSTATUS( "USB is not plugged or initialized successfully. "
              "Advacned-Sensing will not run.");
-  } else {
-    if (!initAdvancedSensing()) {
-      DERROR("Failed to initialize AdvancedSensing!\n");
-      return false;
-    } else {
-      DSTATUS("Start advanced sensing initalization");
-    }
+    return true;
   }
-#endif
-
-#if defined(__linux__)
-  /*! mop init should be here */
-  if (!initMopServer())
-  {
-    DERROR("Failed to initialize MopServer!\n");
+  if (!initAdvancedSensing()) {
+    return false;
   }
-#endif
-
+  DSTATUS("Start advanced sensing initalization");
   return true;
 }
+#endif
 
 int
 Vehicle::functionalSetUp()
@@ -273,17 +433,30 @@ Vehicle::functionalSetUp()
   uint16_t tryTimes = 20;
   bool shakeHandRet = false;
 
+  Platform::instance().mutexLock(startupLock);
+  startupTimeline.clear();
+  Platform::instance().mutexUnlock(startupLock);
+  Platform::instance().getTimeMs(&startupBaseMs);
+
   for (uint16_t i = 0; i < tryTimes; i++) {
+    uint32_t tryStartMs = 0;
+    uint32_t nowMs      = 0;
+    Platform::instance().getTimeMs(&tryStartMs);
     shakeHandRet = initVersion();
     if (shakeHandRet == true) {
       DSTATUS("Shake hand with drone successfully by getting drone version.");
+      recordStartupStage("Version", tryStartMs, true);
       break;
     } else {
       DSTATUS("Shake hand with drone Fail ! Cannot get drone version. (%d/%d)",
               i + 1, tryTimes);
       DSTATUS("Try again after 1 second ......");
     }
-    Platform::instance().taskSleepMs(1000);
+    /*! A timed out query already waited, only a quick failure needs padding */
+    Platform::instance().getTimeMs(&nowMs);
+    if (nowMs - tryStartMs < 1000) {
+      Platform::instance().taskSleepMs(1000 - (nowMs - tryStartMs));
+    }
   }
 
   if (shakeHandRet == false) {
@@ -406,6 +579,9 @@ Vehicle::~Vehicle()
     delete this->advancedSensing;
 #endif
 
+  Platform::instance().semaphoreDestroy(startupSem);
+  Platform::instance().mutexDestroy(lazyInitLock);
+  Platform::instance().mutexDestroy(startupLock);
 }
 
 
@@ -492,21 +668,11 @@ Vehicle::initSubscriber()
       return false;
     }
 
-    bool ret = this->legacyLinker->registerCMDCallback(
-        OpenProtocolCMD::CMDSet::Broadcast::subscribe[0],
-        OpenProtocolCMD::CMDSet::Broadcast::subscribe[1],
-        this->subscribe->subscriptionDataDecodeHandler.callback,
-        this->subscribe->subscriptionDataDecodeHandler.userData);
-    /*
-     * Wait for 1.2 seconds, so we can detect all leftover
-     * packages from unclean quit, and remove them properly
-     */
+    bool ret = this->subscribe->registerDataHandler();
     if (!ret) {
       DERROR("Register broadcast callback fail.");
       return ret;
     }
-    Platform::instance().taskSleepMs(1200);
-    this->subscribe->removeLeftOverPackages();
   }
   else
   {
@@ -516,6 +682,30 @@ Vehicle::initSubscriber()
   return true;
 }
 
+bool
+Vehicle::cleanSubscriber()
+{
+  if (!this->subscribe)
+  {
+    return true;
+  }
+
+  /*
+   * With STARTUP_RESET_SUBSCRIPTION, packages left from an unclean quit
+   * are dropped by one reset, which is done when its ACK is back.
+   * Otherwise, or without the ACK, wait 1.2 seconds, so we can detect all
+   * leftover packages from their data and remove only those.
+   */
+  if ((startupFlags & STARTUP_RESET_SUBSCRIPTION) &&
+      this->subscribe->resetLeftOverPackages(1))
+  {
+    return true;
+  }
+  Platform::instance().taskSleepMs(1200);
+  this->subscribe->removeLeftOverPackages();
+  return true;
+}
+
 
 bool
 Vehicle::initBroadcast()
@@ -836,12 +1026,27 @@ Vehicle::initAdvancedSensing()
 void
 Vehicle::processAdvancedSensingImgs(RecvContainer* receivedFrame)
 {
+  AdvancedSensingProtocol* protocol =
+    this->advancedSensing->getAdvancedSensingProtocol();
+  //! Keeps the receive buffer the images are in until the callbacks return
+  StereoFramePtr frame = protocol->takeStereoFrame();
+  AdvancedSensing::StereoFrameCallBackHandler& frameHandler =
+    this->advancedSensing->stereoFrameHandler;
+
   if (receivedFrame->recvInfo.cmd_id == AdvancedSensingProtocol::PROCESS_IMG_CMD_ID)
   {
-    if (this->advancedSensing->stereoHandler.callback)
+    if (this->advancedSensing->stereoHandler.callback || frameHandler.callback)
     {
-      this->advancedSensing->stereoHandler.callback(
+      if (frameHandler.callback && frame)
+      {
+        frameHandler.callback(this, frame, frameHandler.userData);
+      }
+      if (this->advancedSensing->stereoHandler.callback)
+      {
+        protocol->fillLegacyImageData(frame);
+        this->advancedSensing->stereoHandler.callback(
           this, *receivedFrame, this->advancedSensing->stereoHandler.userData);
+      }
     }
     else
     {
@@ -858,10 +1063,18 @@ Vehicle::processAdvancedSensingImgs(RecvContainer* receivedFrame)
   else if (receivedFrame->recvInfo.cmd_id ==
            AdvancedSensingProtocol::PROCESS_VGA_CMD_ID)
   {
-    if (this->advancedSensing->vgaHandler.callback)
+    if (this->advancedSensing->vgaHandler.callback || frameHandler.callback)
     {
-      this->advancedSensing->vgaHandler.callback(this, *receivedFrame,
-                                                 this->advancedSensing->vgaHandler.userData);
+      if (frameHandler.callback && frame)
+      {
+        frameHandler.callback(this, frame, frameHandler.userData);
+      }
+      if (this->advancedSensing->vgaHandler.callback)
+      {
+        protocol->fillLegacyImageData(frame);
+        this->advancedSensing->vgaHandler.callback(this, *receivedFrame,
+                                                   this->advancedSensing->vgaHandler.userData);
+      }
     }
     else
     {
@@ -75,17 +75,14 @@ void elementDecode(Type &data, uint8_t *&tempPtr) {
   tempPtr += sizeof(Type);
 }
 
-bool missionEncode(const std::vector<WaypointV2Internal> &mission, uint8_t *pushPtr,
-                   uint16_t &len) {
-  if (mission.empty()) {
-    pushPtr = nullptr;
-    len = 0;
-    return true;
-  }
-
-  bool finished = false;
+/*! Encodes the waypoints from startIndex on into one upload chunk, about
+ * 200 bytes and no further than lastIndex. Returns the index of the first
+ * waypoint left out.
+ */
+uint16_t missionEncode(const std::vector<WaypointV2Internal> &mission,
+                       uint16_t startIndex, uint16_t lastIndex,
+                       uint8_t *pushPtr, uint16_t &len) {
   uint16_t tempTotalLen = 0;
-  static uint16_t startIndex = 0;
   uint16_t endIndex = 0;
   uint8_t *tempPtr = pushPtr;
 
@@ -96,8 +93,9 @@ bool missionEncode(const std::vector<WaypointV2Internal> &mission, uint8_t *push
 
   elementEncode<uint16_t>(endIndex, tempTotalLen, tempPtr);
   uint16_t i = 0;
-  for (i = startIndex; (tempTotalLen < 200) && i < mission.size(); ++i) {
-    WaypointV2Internal wp = mission[i];
+  for (i = startIndex;
+       (tempTotalLen < 200) && i <= lastIndex && i < mission.size(); ++i) {
+    const WaypointV2Internal &wp = mission[i];
     elementEncode<float32_t>(wp.positionX, tempTotalLen, tempPtr);
     elementEncode<float32_t>(wp.positionY, tempTotalLen, tempPtr);
     elementEncode<float32_t>(wp.positionZ, tempTotalLen, tempPtr);
@@ -130,15 +128,10 @@ bool missionEncode(const std::vector<WaypointV2Internal> &mission, uint8_t *push
   }
   len = tempTotalLen;
   endIndex = i - 1;
-  startIndex = endIndex + 1;
   memcpy(tempTempPtr, &endIndex, sizeof(endIndex));
-  DSTATUS("mis_upload_start_index:%d, mis_upload_end_index:%d, upload_len:%d",*pushPtr, *(pushPtr + 2), len);
-  if (endIndex >= mission.size() - 1) {
-    startIndex = 0;
-    endIndex = 0;
-    finished = true;
-  }
-  return finished;
+  DDEBUG("mis_upload_start_index:%d, mis_upload_end_index:%d, upload_len:%d",
+         startIndex, endIndex, len);
+  return i;
 }
 
 bool missionDecode(std::vector<WaypointV2Internal> &mission, uint8_t *const pullPtr,
@@ -350,16 +343,17 @@ void triggerEncode(const DJIWaypointV2Trigger &trigger, uint16_t &tempTotalLen,
   }
 }
 
-bool ActionsEncode(std::vector<DJIWaypointV2Action> &actions,
-                   uint8_t *pushPtr, uint16_t &len) {
+/*! Encodes the actions from startIndex on into one upload chunk of about
+ * 100 bytes. Returns the index of the first action left out.
+ */
+uint16_t ActionsEncode(const std::vector<DJIWaypointV2Action> &actions,
+                       uint16_t startIndex, uint8_t *pushPtr, uint16_t &len) {
   uint16_t i;
-  bool finished = false;
   uint16_t tempTotalLen = 0;
   uint8_t *tempPtr = pushPtr;
 
-  static uint16_t startIndex = 0;
   for (i = startIndex; (i < actions.size()) && (tempTotalLen < 100); ++i) {
-    DJIWaypointV2Action action = actions[i];
+    const DJIWaypointV2Action &action = actions[i];
 
     /*! actionId*/
     elementEncode<uint16_t>(action.actionId, tempTotalLen, tempPtr);
@@ -370,16 +364,11 @@ bool ActionsEncode(std::vector<DJIWaypointV2Action> &actions,
     /*! actuator*/
     actuatorEncode(action.actuator, tempTotalLen, tempPtr);
 
-    len = tempTotalLen;
-    DSTATUS("upload_action_ID:%d",action.actionId);
+    DDEBUG("upload_action_ID:%d",action.actionId);
   }
-  DSTATUS("total_len:%d",len);
-  startIndex = i;
-  if (startIndex > actions.size() - 1) {
-    finished = true;
-    startIndex = 0;
-  }
-  return finished;
+  len = tempTotalLen;
+  DDEBUG("total_len:%d",len);
+  return i;
 }
 
 T_CmdInfo setCmdInfoDefault(Vehicle *vehicle, const uint8_t cmd[],
@@ -478,9 +467,24 @@ WaypointV2MissionOperator::WaypointV2MissionOperator(Vehicle *vehiclePtr) {
   currentState = DJIWaypointV2MissionStateUnWaypointActionActuatorknown;
   prevState = DJIWaypointV2MissionStateUnWaypointActionActuatorknown;
   RegisterOSDInfoCallback(vehiclePtr);
+
+  memset(uploadSlot, 0, sizeof(uploadSlot));
+  memset(&uploadStats, 0, sizeof(uploadStats));
+  for (int i = 0; i < MAX_UPLOAD_WINDOW_SIZE; i++) {
+    uploadSlot[i].op = this;
+  }
+  uploadWindowSize = DEFAULT_UPLOAD_WINDOW_SIZE;
+  Platform::instance().mutexCreate(&uploadLock);
+  Platform::instance().mutexCreate(&uploadSlotLock);
+  Platform::instance().semaphoreCreate(&uploadSem, 0);
 }
 
 WaypointV2MissionOperator::~WaypointV2MissionOperator() {
+  /*! ACKs of an aborted upload may still be on their way */
+  drainUploadSlots(1000);
+  Platform::instance().semaphoreDestroy(uploadSem);
+  Platform::instance().mutexDestroy(uploadSlotLock);
+  Platform::instance().mutexDestroy(uploadLock);
 }
 
 ErrorCode::ErrorCodeType WaypointV2MissionOperator::init(WayPointV2InitSettings *info, int timeout)
@@ -568,40 +572,251 @@ ErrorCode::ErrorCodeType WaypointV2MissionOperator::uploadMission(
   int timeout) {
   std::vector<WaypointV2Internal> mission = transformMission2MisssionInternal(this->missionV2);
 
-  uint16_t dataLengthSinglePush = 0;
-  bool finished = false;
-  while (!finished) {
-    void *waypointPushPtr = malloc(400);
-    finished = missionEncode(mission, (uint8_t *) waypointPushPtr,
-                             dataLengthSinglePush);
-    T_CmdInfo ackInfo = {0};
-    RetCodeType ackData[1024] = {0};
+  return runWindowedUpload(V1ProtocolCMD::waypointV2::waypointUploadV2,
+                           &mission, NULL, timeout);
+}
 
-    T_CmdInfo cmdInfo =
-      setCmdInfoDefault(vehiclePtr, V1ProtocolCMD::waypointV2::waypointUploadV2,
-                        dataLengthSinglePush);
+void WaypointV2MissionOperator::setUploadWindowSize(int size) {
+  if (size < 1) size = 1;
+  if (size > MAX_UPLOAD_WINDOW_SIZE) size = MAX_UPLOAD_WINDOW_SIZE;
+  Platform::instance().mutexLock(uploadLock);
+  uploadWindowSize = size;
+  Platform::instance().mutexUnlock(uploadLock);
+}
 
-    E_OsdkStat linkAck =
-      vehiclePtr->linker->sendSync(&cmdInfo, (uint8_t *)waypointPushPtr, &ackInfo,
-                                   ackData, timeout * 1000, 4);
-    ErrorCode::ErrorCodeType ret = getWP2LinkerErrorCode(linkAck);
-    free(waypointPushPtr);
+WaypointV2UploadStats WaypointV2MissionOperator::getUploadStats() {
+  Platform::instance().mutexLock(uploadSlotLock);
+  WaypointV2UploadStats stats = uploadStats;
+  Platform::instance().mutexUnlock(uploadSlotLock);
+  return stats;
+}
 
-    if (ret != ErrorCode::SysCommonErr::Success) {
-      return ret;
+void WaypointV2MissionOperator::uploadAckCallback(const T_CmdInfo *cmdInfo,
+                                                  const uint8_t *cmdData,
+                                                  void *userData,
+                                                  E_OsdkStat cb_type) {
+  UploadSlot *slot = (UploadSlot *)userData;
+  WaypointV2MissionOperator *op = slot->op;
+
+  Platform::instance().mutexLock(op->uploadSlotLock);
+  slot->linkAck = cb_type;
+  slot->ackLen = 0;
+  memset(&slot->ack, 0, sizeof(slot->ack));
+  if ((cb_type == OSDK_STAT_OK) && cmdInfo && cmdData) {
+    slot->ackLen = cmdInfo->dataLen;
+    memcpy(&slot->ack, cmdData,
+           cmdInfo->dataLen < sizeof(slot->ack) ? cmdInfo->dataLen
+                                                : sizeof(slot->ack));
+  }
+  slot->pending = false;
+  Platform::instance().mutexUnlock(op->uploadSlotLock);
+  Platform::instance().semaphorePost(op->uploadSem);
+}
+
+void WaypointV2MissionOperator::sendUploadSlot(UploadSlot &slot,
+                                               uint32_t timeoutMs) {
+  /*! The ACK may come back before sendAsync returns */
+  Platform::instance().mutexLock(uploadSlotLock);
+  slot.pending = true;
+  slot.transmissions++;
+  Platform::instance().mutexUnlock(uploadSlotLock);
+
+  vehiclePtr->linker->sendAsync(&slot.cmdInfo, slot.data, uploadAckCallback,
+                                &slot, timeoutMs, 1);
+}
+
+bool WaypointV2MissionOperator::drainUploadSlots(uint32_t timeoutMs) {
+  uint32_t startMs = 0;
+  Platform::instance().getTimeMs(&startMs);
+
+  while (true) {
+    bool pending = false;
+    Platform::instance().mutexLock(uploadSlotLock);
+    for (int i = 0; i < MAX_UPLOAD_WINDOW_SIZE; i++) {
+      pending = pending || uploadSlot[i].pending;
     }
-    if (ackInfo.dataLen >= sizeof(RetCodeType)) {
-      auto *ackCode = (UploadMissionRawAck *)ackData;
-      // DSTATUS("mis_upload_result:%d,mis_ack_start_index:%d, mis_ack_end_index:%d",ackCode->result,ackCode->startIndex,ackCode->endIndex);
-      if (ackCode->result != 0)
-        return ErrorCode::getErrorCode(ErrorCode::MissionV2Module,
-                                       ErrorCode::MissionV2Common,
-                                       ackCode->result);
-    } else {
-      return ErrorCode::SysCommonErr::UnpackDataMismatch;
+    Platform::instance().mutexUnlock(uploadSlotLock);
+    if (!pending) {
+      break;
     }
+
+    uint32_t nowMs = 0;
+    Platform::instance().getTimeMs(&nowMs);
+    if (nowMs - startMs >= timeoutMs) {
+      return false;
+    }
+    Platform::instance().semaphoreTimedWait(uploadSem,
+                                            timeoutMs - (nowMs - startMs));
   }
-  return ErrorCode::SysCommonErr::Success;
+
+  for (int i = 0; i < MAX_UPLOAD_WINDOW_SIZE; i++) {
+    uploadSlot[i].inUse = false;
+  }
+  return true;
+}
+
+/*!
+ * @details Sliding window upload shared by missions and actions:
+ *          1. Encode chunks into free slots and send them without waiting
+ *             until uploadWindowSize chunks wait for their ACK.
+ *          2. Wait on uploadSem for ACKs, which arrive in any order on the
+ *             linker thread, and free the slot of every ACKed chunk.
+ *          3. A chunk that timed out is sent again on its own. A mission
+ *             chunk whose ACK covers only part of its waypoints is
+ *             re-encoded with the rest. Either gives up after
+ *             UPLOAD_MAX_TRANSMISSIONS sends.
+ *          4. An error from the flight controller stops the upload. Chunks
+ *             still in flight are drained before returning so their slots
+ *             can be reused by the next upload.
+ */
+ErrorCode::ErrorCodeType WaypointV2MissionOperator::runWindowedUpload(
+    const uint8_t cmd[], const std::vector<WaypointV2Internal> *mission,
+    std::vector<DJIWaypointV2Action> *actions, int timeout) {
+  const uint8_t UPLOAD_MAX_TRANSMISSIONS = 4;
+  uint32_t attemptMs = timeout * 1000 / UPLOAD_MAX_TRANSMISSIONS;
+  uint16_t total = mission ? mission->size() : actions->size();
+  uint16_t nextIndex = 0;
+  uint32_t startMs = 0;
+  uint32_t progressMs = 0;
+  ErrorCode::ErrorCodeType ret = ErrorCode::SysCommonErr::Success;
+
+  Platform::instance().mutexLock(uploadLock);
+  if (!drainUploadSlots(attemptMs)) {
+    DERROR("ACKs of the previous upload are still pending");
+    Platform::instance().mutexUnlock(uploadLock);
+    return ErrorCode::SysCommonErr::ReqTimeout;
+  }
+
+  Platform::instance().mutexLock(uploadSlotLock);
+  memset(&uploadStats, 0, sizeof(uploadStats));
+  Platform::instance().mutexUnlock(uploadSlotLock);
+  Platform::instance().getTimeMs(&startMs);
+  progressMs = startMs;
+
+  while (ret == ErrorCode::SysCommonErr::Success) {
+    /*! 1. fill the window */
+    bool inFlight = false;
+    for (int i = 0; i < uploadWindowSize; i++) {
+      UploadSlot &slot = uploadSlot[i];
+      if (!slot.inUse && nextIndex < total) {
+        uint16_t endIndex;
+        if (mission) {
+          endIndex = missionEncode(*mission, nextIndex, total - 1, slot.data,
+                                   slot.len);
+        } else {
+          endIndex = ActionsEncode(*actions, nextIndex, slot.data, slot.len);
+        }
+        slot.cmdInfo = setCmdInfoDefault(vehiclePtr, cmd, slot.len);
+        slot.startIndex = nextIndex;
+        slot.endIndex = endIndex - 1;
+        slot.transmissions = 0;
+        slot.inUse = true;
+        nextIndex = endIndex;
+        sendUploadSlot(slot, attemptMs);
+      }
+      inFlight = inFlight || slot.inUse;
+    }
+    if (!inFlight) {
+      break;
+    }
+
+    /*! 2. wait for at least one ACK */
+    Platform::instance().semaphoreTimedWait(uploadSem, attemptMs);
+
+    /*! 3. retire the ACKed chunks, resend the lost ones */
+    for (int i = 0; i < uploadWindowSize; i++) {
+      UploadSlot &slot = uploadSlot[i];
+      Platform::instance().mutexLock(uploadSlotLock);
+      bool done = slot.inUse && !slot.pending;
+      Platform::instance().mutexUnlock(uploadSlotLock);
+      if (!done) {
+        continue;
+      }
+      Platform::instance().getTimeMs(&progressMs);
+
+      ErrorCode::ErrorCodeType linkRet = getWP2LinkerErrorCode(slot.linkAck);
+      bool resend = false;
+      if (linkRet == ErrorCode::SysCommonErr::ReqTimeout) {
+        resend = true;
+      } else if (linkRet != ErrorCode::SysCommonErr::Success) {
+        ret = linkRet;
+      } else if (slot.ackLen < sizeof(RetCodeType)) {
+        ret = ErrorCode::SysCommonErr::UnpackDataMismatch;
+      } else if (slot.ack.result != 0) {
+        if (!mission) {
+          UploadActionsRawAck actionAck;
+          memcpy(&actionAck, &slot.ack, sizeof(actionAck));
+          DERROR("Upload action %d failed", actionAck.errorActionId);
+        }
+        ret = ErrorCode::getErrorCode(ErrorCode::MissionV2Module,
+                                      ErrorCode::MissionV2Common,
+                                      slot.ack.result);
+      } else if (mission && slot.ackLen >= sizeof(UploadMissionRawAck) &&
+                 slot.ack.startIndex == slot.startIndex &&
+                 slot.ack.endIndex >= slot.startIndex &&
+                 slot.ack.endIndex < slot.endIndex) {
+        /*! Only the head of the chunk was taken, send the tail again */
+        uint16_t from = slot.ack.endIndex + 1;
+        missionEncode(*mission, from, slot.endIndex, slot.data, slot.len);
+        slot.cmdInfo = setCmdInfoDefault(vehiclePtr, cmd, slot.len);
+        slot.startIndex = from;
+        slot.transmissions = 0;
+        resend = true;
+      } else {
+        Platform::instance().mutexLock(uploadSlotLock);
+        uploadStats.chunks++;
+        uploadStats.bytes += slot.len;
+        Platform::instance().mutexUnlock(uploadSlotLock);
+        slot.inUse = false;
+      }
+
+      if (resend) {
+        if (slot.transmissions >= UPLOAD_MAX_TRANSMISSIONS) {
+          DERROR("Upload of index %d-%d got no ACK", slot.startIndex,
+                 slot.endIndex);
+          ret = ErrorCode::SysCommonErr::ReqTimeout;
+        } else {
+          Platform::instance().mutexLock(uploadSlotLock);
+          uploadStats.retransmissions++;
+          Platform::instance().mutexUnlock(uploadSlotLock);
+          sendUploadSlot(slot, attemptMs);
+        }
+      }
+      if (ret != ErrorCode::SysCommonErr::Success) {
+        break;
+      }
+    }
+
+    /*! The linker reports every timeout, this only guards against an ACK
+     * callback that never comes */
+    uint32_t nowMs = 0;
+    Platform::instance().getTimeMs(&nowMs);
+    if (ret == ErrorCode::SysCommonErr::Success &&
+        nowMs - progressMs > attemptMs * (UPLOAD_MAX_TRANSMISSIONS + 1)) {
+      DERROR("Upload stalled");
+      ret = ErrorCode::SysCommonErr::ReqTimeout;
+    }
+  }
+
+  if (ret != ErrorCode::SysCommonErr::Success &&
+      !drainUploadSlots(attemptMs)) {
+    DERROR("ACKs of the aborted upload are still pending");
+  }
+
+  uint32_t endMs = 0;
+  Platform::instance().getTimeMs(&endMs);
+  Platform::instance().mutexLock(uploadSlotLock);
+  uploadStats.elapsedMs = endMs - startMs;
+  uploadStats.bytesPerSecond =
+      uploadStats.elapsedMs
+          ? (uint32_t)((uint64_t)uploadStats.bytes * 1000 / uploadStats.elapsedMs)
+          : 0;
+  DSTATUS("Uploaded %d chunks, %d bytes in %d ms (%d B/s, %d resent)",
+          uploadStats.chunks, uploadStats.bytes, uploadStats.elapsedMs,
+          uploadStats.bytesPerSecond, uploadStats.retransmissions);
+  Platform::instance().mutexUnlock(uploadSlotLock);
+  Platform::instance().mutexUnlock(uploadLock);
+  return ret;
 }
 
 ErrorCode::ErrorCodeType WaypointV2MissionOperator::downloadMission(
@@ -687,39 +902,10 @@ ErrorCode::ErrorCodeType WaypointV2MissionOperator::uploadAction(
   std::vector<DJIWaypointV2Action> &actions, int timeout) {
   if (actions.size() == 0) {
     DERROR("Action number is zero, please reset actions vector");
-  } else {
-    bool finished = false;
-    E_OsdkStat linkAck;
-    while (!finished) {
-      uint16_t dataLen = 0;
-      void *actionsPushPtr = malloc(400);
-      T_CmdInfo ackInfo = {0};
-      RetCodeType ackData[1024];
-
-      finished = ActionsEncode(actions, (uint8_t *) actionsPushPtr, dataLen);
-      T_CmdInfo cmdInfo = setCmdInfoDefault(
-          vehiclePtr, V1ProtocolCMD::waypointV2::waypointUploadActionV2, dataLen);
-
-      linkAck = vehiclePtr->linker->sendSync(&cmdInfo, (uint8_t *)actionsPushPtr, &ackInfo,
-                                 ackData, timeout * 1000 / 4, 4);
-      free(actionsPushPtr);
-      ErrorCode::ErrorCodeType ret = getWP2LinkerErrorCode(linkAck);
-
-      if (ret != ErrorCode::SysCommonErr::Success) {
-        return ret;
-      }
-      if (ackInfo.dataLen >= sizeof(RetCodeType)) {
-        auto *ackCode = (UploadActionsRawAck *)ackData;
-        if (ackCode->result != 0)
-          return ErrorCode::getErrorCode(ErrorCode::MissionV2Module,
-                                         ErrorCode::MissionV2Common,
-                                         ackCode->result);
-      } else {
-        return ErrorCode::SysCommonErr::UnpackDataMismatch;
-      }
-    }
+    return ErrorCode::SysCommonErr::Success;
   }
-  return ErrorCode::SysCommonErr::Success;
+  return runWindowedUpload(V1ProtocolCMD::waypointV2::waypointUploadActionV2,
+                           NULL, &actions, timeout);
 }
 
 ErrorCode::ErrorCodeType WaypointV2MissionOperator::getActionRemainMemory(
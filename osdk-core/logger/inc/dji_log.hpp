@@ -138,6 +138,59 @@ public:
    */
   void disableErrorLogging();
 
+  /*!
+   * @brief Write log output from a background thread
+   * @details The logging thread only formats its message into a ring of
+   * fixed-size records; the background thread writes them to stdout. If a
+   * thread logs faster than the output keeps up, its messages are dropped
+   * and counted instead of stalling it. Linux only.
+   * @param recordsPerThread ring size per logging thread, fixed by the
+   * first call
+   * @return false if the background thread could not be started or the
+   * platform is not supported
+   */
+  bool enableAsyncLogging(uint32_t recordsPerThread = 128);
+
+  /*!
+   * @brief Write queued messages and go back to printing on the calling thread
+   */
+  void disableAsyncLogging();
+
+  /*!
+   * @brief Write everything logged so far before returning
+   */
+  void flush();
+
+  /*!
+   * @brief Record log calls into a binary file instead of printing them
+   * @details Only the format string id, a microsecond timestamp and the raw
+   * arguments are stored; nothing is formatted at run time. Render the file
+   * with the djiosdk-log-decoder tool. Takes precedence over the text
+   * output while enabled. Linux only.
+   * @param path file to create, an existing file is overwritten
+   * @param fileSize size of the mapped file, records beyond it are dropped
+   */
+  bool enableBinaryLogging(const char* path,
+                           size_t      fileSize = 64 * 1024 * 1024);
+
+  /*!
+   * @brief Close the binary file and go back to text output
+   */
+  void disableBinaryLogging();
+
+  /*!
+   * @brief Number of messages dropped because a ring or the binary file
+   * was full
+   */
+  uint64_t getDroppedLogCount();
+
+  /*!
+   * @brief Write queued messages when the process crashes
+   * @details Handles SIGSEGV, SIGBUS, SIGFPE, SIGILL and SIGABRT and then
+   * lets the signal take its default action. Linux only.
+   */
+  bool installCrashFlushHandler();
+
   // Retrieve logging switches - used for global macros
   bool getStatusLogState();
   bool getDebugLogState();
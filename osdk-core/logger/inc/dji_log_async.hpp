@@ -0,0 +1,182 @@
+/** @file dji_log_async.hpp
+ *  @version 4.0.0
+ *  @date Oct 2026
+ *
+ *  @brief
+ *  Background writer for the DJI OSDK logger (Linux only).
+ *
+ *  @Copyright (c) 2026 DJI
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef DJI_LOG_ASYNC_H
+#define DJI_LOG_ASYNC_H
+
+#if defined(__linux__)
+
+#include <atomic>
+#include <pthread.h>
+#include <semaphore.h>
+#include <stdarg.h>
+#include <stdint.h>
+
+namespace DJI
+{
+namespace OSDK
+{
+
+/*! @brief Moves log output of DJI::OSDK::Log off the calling thread
+ *
+ *  @details Every logging thread owns a ring of fixed-size records. The
+ *  caller only formats its message into its ring and never takes a lock
+ *  or touches stdout. A background thread merges the rings in call order,
+ *  formats the headers and writes them out. When a ring is full the record
+ *  is dropped and counted instead of blocking the caller, so memory stays
+ *  bounded by MAX_THREADS rings.
+ *
+ *  The caller still pays for vsnprintf of its message. Arguments like
+ *  strings in stack buffers do not outlive the call, so they can not be
+ *  formatted later. Log::enableBinaryLogging avoids that cost.
+ */
+class AsyncLogBackend
+{
+public:
+  static const int      MAX_THREADS                = 32;
+  static const int      RECORD_TEXT_SIZE           = 300;
+  static const uint32_t DEFAULT_RECORDS_PER_THREAD = 128;
+
+  static AsyncLogBackend& instance();
+
+  /*!
+   * @brief Start the writer thread
+   * @param recordsPerThread ring size, rounded up to a power of two. It is
+   * fixed by the first call, later calls keep the first size.
+   */
+  bool start(uint32_t recordsPerThread);
+
+  //! Stop the writer thread after writing everything still queued
+  void stop();
+
+  bool isRunning() const
+  {
+    return running.load(std::memory_order_acquire);
+  }
+
+  //! Producer side, called by Log::title and Log::print
+  void title(int level, const char* prefix, const char* func, int line);
+  void print(const char* fmt, va_list args);
+  void printTitle();
+
+  //! Write everything queued so far before returning
+  void flush();
+
+  uint64_t getDroppedCount() const
+  {
+    return dropped.load(std::memory_order_relaxed);
+  }
+
+  /*!
+   * @brief Write the queued records to stdout when the process crashes
+   * @details Handles SIGSEGV, SIGBUS, SIGFPE, SIGILL and SIGABRT, then
+   * re-raises the signal with the default action. The records are already
+   * formatted, the handler only adds the headers by hand and writes them
+   * with write(2). It waits up to 100 ms for a drain in progress.
+   */
+  bool installCrashHandler();
+
+private:
+  AsyncLogBackend();
+
+  enum HeaderType
+  {
+    HEADER_NONE,
+    HEADER_FULL,
+    HEADER_PRIVATE
+  };
+
+  //! prefix and func are string literals, so only the pointers are kept
+  typedef struct LogHeader
+  {
+    HeaderType  type;
+    bool        valid;
+    uint32_t    timeMs;
+    int         level;
+    const char* prefix;
+    const char* func;
+    int         line;
+  } LogHeader;
+
+  typedef struct LogRecord
+  {
+    uint64_t  seq;
+    LogHeader header;
+    bool      newline;
+    uint16_t  len;
+    char      text[RECORD_TEXT_SIZE];
+  } LogRecord;
+
+  //! Single producer (the owning thread), single consumer (the drainer)
+  typedef struct LogRing
+  {
+    std::atomic<bool>     inUse;
+    std::atomic<uint32_t> head;
+    std::atomic<uint32_t> tail;
+    LogRecord*            records;
+  } LogRing;
+
+  //! Ring and pending title of the calling thread
+  struct ThreadState;
+  static thread_local ThreadState threadState;
+
+  LogRing* acquireRing();
+  void     fillRecord(LogRecord& record, const char* fmt, va_list* args,
+                      bool newline);
+  void     push(const char* fmt, va_list* args, bool newline);
+  int      formatRecord(const LogRecord& record, char* buf, int size);
+  int      drain(bool crashing);
+  void     writeOut(const char* buf, int len, bool crashing);
+
+  static void* writerTask(void* arg);
+  static void  onCrash(int sig);
+  static void  flushAtExit();
+
+private:
+  LogRing  rings[MAX_THREADS];
+  uint32_t capacity;
+
+  std::atomic<bool>     running;
+  std::atomic<bool>     sleeping;
+  std::atomic<uint64_t> nextSeq;
+  std::atomic<uint64_t> dropped;
+  uint64_t              reportedDropped;
+
+  pthread_t       writer;
+  pthread_mutex_t drainMutex;
+  sem_t           wakeSem;
+  bool            exitHookInstalled;
+};
+
+} // namespace OSDK
+} // namespace DJI
+
+#endif // __linux__
+
+#endif // DJI_LOG_ASYNC_H
@@ -0,0 +1,351 @@
+/** @file dji_log_binary.hpp
+ *  @version 4.0.0
+ *  @date Oct 2026
+ *
+ *  @brief
+ *  Binary log file with deferred formatting for the DJI OSDK logger.
+ *
+ *  @Copyright (c) 2026 DJI
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef DJI_LOG_BINARY_H
+#define DJI_LOG_BINARY_H
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(__linux__)
+#include <atomic>
+#endif
+
+namespace DJI
+{
+namespace OSDK
+{
+
+/*
+ * File layout, all fields in host byte order:
+ *
+ *   BinaryLogFileHeader
+ *   records, each starting with a BinaryLogRecordHeader on an 8 byte
+ *   boundary
+ *
+ * Format strings, prefixes and function names are written once as STRING
+ * records and referenced by id. An ENTRY record holds a BinaryLogEntry
+ * followed by the raw arguments in the order of the conversions of its
+ * format string: 8 bytes for every integer, pointer, '*' width and floating
+ * point value (as double), and uint16 length plus bytes for strings.
+ * A record whose size is still 0 was never committed, the decoder stops
+ * there.
+ */
+#define BINARY_LOG_MAGIC "DJIBLOG1"
+
+static const uint32_t BINARY_LOG_VERSION        = 1;
+static const uint32_t BINARY_LOG_NO_STRING      = 0xFFFFFFFF;
+static const int      BINARY_LOG_MAX_ARGS_SIZE  = 1024;
+static const int      BINARY_LOG_MAX_STRING_ARG = 255;
+
+typedef struct BinaryLogFileHeader
+{
+  char     magic[8];
+  uint32_t version;
+  uint32_t headerSize;
+  uint64_t startTimeUs;
+  uint64_t capacity;  /*!< bytes available for records */
+  uint64_t usedBytes; /*!< set when the file is closed cleanly, 0 otherwise */
+  uint64_t dropped;   /*!< records that did not fit, set on close */
+  uint8_t  reserved[16];
+} BinaryLogFileHeader;
+
+typedef enum BinaryLogRecordType
+{
+  BINARY_LOG_STRING = 1,
+  BINARY_LOG_ENTRY  = 2
+} BinaryLogRecordType;
+
+typedef struct BinaryLogRecordHeader
+{
+  uint16_t size;  /*!< whole record without padding, written last */
+  uint8_t  type;  /*!< BinaryLogRecordType */
+  uint8_t  level; /*!< log level of an entry, 0 if it has no title */
+  uint32_t id;    /*!< string id, or format string id of an entry */
+} BinaryLogRecordHeader;
+
+typedef struct BinaryLogEntry
+{
+  uint64_t timeUs;
+  uint32_t prefixId;
+  uint32_t funcId; /*!< BINARY_LOG_NO_STRING for titles without location */
+  int32_t  line;
+  uint32_t argsSize;
+} BinaryLogEntry;
+
+/*! @brief printf conversion parser shared by the sink and the decoder
+ *
+ *  @details Both sides walk a format string with next() and must agree on
+ *  which argument every conversion takes.
+ */
+class BinaryLogFormat
+{
+public:
+  typedef enum ArgType
+  {
+    ARG_NONE,   /*!< end of the format string */
+    ARG_INT,    /*!< signed integer of any length */
+    ARG_UINT,   /*!< unsigned integer, char or pointer */
+    ARG_DOUBLE, /*!< any floating point value */
+    ARG_STRING
+  } ArgType;
+
+  typedef enum Length
+  {
+    LEN_DEFAULT,
+    LEN_CHAR,
+    LEN_SHORT,
+    LEN_LONG,
+    LEN_LONG_LONG,
+    LEN_LONG_DOUBLE,
+    LEN_SIZE,
+    LEN_MAX,
+    LEN_PTRDIFF
+  } Length;
+
+  typedef struct Spec
+  {
+    const char* begin;     /*!< the '%' */
+    const char* end;       /*!< one past the conversion character */
+    const char* lengthPos; /*!< first character of the length modifier */
+    int         starCount; /*!< '*' widths and precisions, each an int */
+    Length      length;
+    char        conversion;
+    ArgType     type;
+  } Spec;
+
+  /*!
+   * @brief Find the next conversion that takes an argument
+   * @param pos advanced past the conversion
+   * @return false at the end of the format string
+   */
+  static bool next(const char*& pos, Spec& spec)
+  {
+    while (*pos)
+    {
+      if (*pos != '%')
+      {
+        ++pos;
+        continue;
+      }
+      spec.begin     = pos++;
+      spec.starCount = 0;
+      if (*pos == '%')
+      {
+        ++pos;
+        continue;
+      }
+      while (*pos && isFlagOrWidth(*pos))
+      {
+        if (*pos == '*')
+        {
+          ++spec.starCount;
+        }
+        ++pos;
+      }
+      spec.lengthPos = pos;
+      spec.length    = parseLength(pos);
+      if (!*pos)
+      {
+        break;
+      }
+      spec.conversion = *pos++;
+      spec.end        = pos;
+      spec.type       = typeOf(spec.conversion);
+      if (spec.type != ARG_NONE)
+      {
+        return true;
+      }
+    }
+    return false;
+  }
+
+private:
+  static bool isFlagOrWidth(char c)
+  {
+    return (c >= '0' && c <= '9') || c == '-' || c == '+' || c == ' ' ||
+           c == '#' || c == '.' || c == '*' || c == '\'';
+  }
+
+  static Length parseLength(const char*& pos)
+  {
+    switch (*pos)
+    {
+      case 'h':
+        ++pos;
+        if (*pos == 'h')
+        {
+          ++pos;
+          return LEN_CHAR;
+        }
+        return LEN_SHORT;
+      case 'l':
+        ++pos;
+        if (*pos == 'l')
+        {
+          ++pos;
+          return LEN_LONG_LONG;
+        }
+        return LEN_LONG;
+      case 'q':
+        ++pos;
+        return LEN_LONG_LONG;
+      case 'L':
+        ++pos;
+        return LEN_LONG_DOUBLE;
+      case 'z':
+        ++pos;
+        return LEN_SIZE;
+      case 'j':
+        ++pos;
+        return LEN_MAX;
+      case 't':
+        ++pos;
+        return LEN_PTRDIFF;
+      default:
+        return LEN_DEFAULT;
+    }
+  }
+
+  static ArgType typeOf(char conversion)
+  {
+    switch (conversion)
+    {
+      case 'd':
+      case 'i':
+        return ARG_INT;
+      case 'u':
+      case 'o':
+      case 'x':
+      case 'X':
+      case 'c':
+      case 'p':
+        return ARG_UINT;
+      case 'f':
+      case 'F':
+      case 'e':
+      case 'E':
+      case 'g':
+      case 'G':
+      case 'a':
+      case 'A':
+        return ARG_DOUBLE;
+      case 's':
+        return ARG_STRING;
+      default:
+        // %n and unknown conversions are not recorded
+        return ARG_NONE;
+    }
+  }
+};
+
+#if defined(__linux__)
+
+/*! @brief Records log calls into a memory-mapped file without formatting
+ *
+ *  @details A call copies its arguments next to the id of its format string
+ *  and a microsecond timestamp; the text is rendered offline by the
+ *  djiosdk-log-decoder tool. Writers reserve space with one atomic add, so
+ *  no lock is taken. The file is a shared mapping, so records written before
+ *  a crash are kept by the kernel. When the file is full, further records
+ *  are dropped and counted.
+ *
+ *  Format strings, prefixes and function names are interned by their
+ *  address, so they must be string literals or __func__, as the DLOG
+ *  macros pass them. A string built at run time would be recorded with the
+ *  text it had when it was first seen. Debug builds assert this.
+ */
+class BinaryLogSink
+{
+public:
+  static const size_t DEFAULT_FILE_SIZE = 64 * 1024 * 1024;
+
+  static BinaryLogSink& instance();
+
+  bool open(const char* path, size_t fileSize);
+  //! Truncate the file to what was written and unmap it
+  void close();
+
+  bool isOpen() const
+  {
+    return opened.load(std::memory_order_acquire);
+  }
+
+  //! Producer side, called by Log::title and Log::print
+  void title(int level, const char* prefix, const char* func, int line);
+  void print(const char* fmt, va_list args);
+
+  uint64_t getDroppedCount() const
+  {
+    return dropped.load(std::memory_order_relaxed);
+  }
+
+private:
+  BinaryLogSink();
+
+  static const int STRING_TABLE_SIZE = 4096;
+
+  struct ThreadState;
+  static thread_local ThreadState threadState;
+
+  /*!
+   * @brief Id of a literal, defining it in the file when it is first seen
+   * @return BINARY_LOG_NO_STRING if its STRING record could not be written,
+   * the next call tries again
+   */
+  uint32_t internString(const char* str);
+  bool     defineString(uint32_t id, const char* str);
+  bool     writeRecord(const BinaryLogRecordHeader& header,
+                       const void* payload, size_t payloadSize,
+                       const void* extra, size_t extraSize);
+
+private:
+  int      fd;
+  uint8_t* base;
+  size_t   mappedSize;
+  size_t   capacity;
+
+  std::atomic<bool>     opened;
+  std::atomic<int>      writers;
+  std::atomic<size_t>   used;
+  std::atomic<uint64_t> dropped;
+
+  //! Interned string pointers, the slot index is the string id
+  std::atomic<const char*> strings[STRING_TABLE_SIZE];
+  //! Set once the STRING record of the slot is in the file
+  std::atomic<bool>        defined[STRING_TABLE_SIZE];
+};
+
+#endif // __linux__
+
+} // namespace OSDK
+} // namespace DJI
+
+#endif // DJI_LOG_BINARY_H
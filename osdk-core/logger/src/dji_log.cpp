@@ -28,6 +28,8 @@
  */
 
 #include "dji_log.hpp"
+#include "dji_log_async.hpp"
+#include "dji_log_binary.hpp"
 
 #include <stdarg.h>
 #include <stdio.h>
@@ -56,6 +58,19 @@ Log::~Log()
 Log&
 Log::title(int level, const char* prefix, const char* func, int line)
 {
+#if defined(__linux__)
+  if (BinaryLogSink::instance().isOpen())
+  {
+    BinaryLogSink::instance().title(level, prefix, func, line);
+    return *this;
+  }
+  if (AsyncLogBackend::instance().isRunning())
+  {
+    AsyncLogBackend::instance().title(level, prefix, func, line);
+    return *this;
+  }
+#endif
+
   if(!initFlag)
   {
     mutex = new Mutex();
@@ -82,6 +97,19 @@ Log::title(int level, const char* prefix, const char* func, int line)
 Log&
 Log::title(int level, const char* prefix)
 {
+#if defined(__linux__)
+  if (BinaryLogSink::instance().isOpen())
+  {
+    BinaryLogSink::instance().title(level, prefix, NULL, 0);
+    return *this;
+  }
+  if (AsyncLogBackend::instance().isRunning())
+  {
+    AsyncLogBackend::instance().title(level, prefix, NULL, 0);
+    return *this;
+  }
+#endif
+
   if(!initFlag)
   {
     mutex = new Mutex();
@@ -105,6 +133,13 @@ Log::title(int level, const char* prefix)
 Log&
 Log::print()
 {
+#if defined(__linux__)
+  // The synchronous path printed the title already
+  if (AsyncLogBackend::instance().isRunning())
+  {
+    AsyncLogBackend::instance().printTitle();
+  }
+#endif
   return *this;
 }
 
@@ -113,6 +148,25 @@ Log::print(const char* fmt, ...)
 {
   char log[300] = {0};
 
+#if defined(__linux__)
+  if (!release && BinaryLogSink::instance().isOpen())
+  {
+    va_list args;
+    va_start(args, fmt);
+    BinaryLogSink::instance().print(fmt, args);
+    va_end(args);
+    return *this;
+  }
+  if (!release && AsyncLogBackend::instance().isRunning())
+  {
+    va_list args;
+    va_start(args, fmt);
+    AsyncLogBackend::instance().print(fmt, args);
+    va_end(args);
+    return *this;
+  }
+#endif
+
   if(!initFlag)
   {
     mutex = new Mutex();
@@ -279,6 +333,71 @@ Log::operator<<(uint8_t c)
   return *this;
 }
 
+bool
+Log::enableAsyncLogging(uint32_t recordsPerThread)
+{
+#if defined(__linux__)
+  return AsyncLogBackend::instance().start(recordsPerThread);
+#else
+  return false;
+#endif
+}
+
+void
+Log::disableAsyncLogging()
+{
+#if defined(__linux__)
+  AsyncLogBackend::instance().stop();
+#endif
+}
+
+void
+Log::flush()
+{
+#if defined(__linux__)
+  AsyncLogBackend::instance().flush();
+#endif
+}
+
+uint64_t
+Log::getDroppedLogCount()
+{
+#if defined(__linux__)
+  return AsyncLogBackend::instance().getDroppedCount() +
+         BinaryLogSink::instance().getDroppedCount();
+#else
+  return 0;
+#endif
+}
+
+bool
+Log::enableBinaryLogging(const char* path, size_t fileSize)
+{
+#if defined(__linux__)
+  return BinaryLogSink::instance().open(path, fileSize);
+#else
+  return false;
+#endif
+}
+
+void
+Log::disableBinaryLogging()
+{
+#if defined(__linux__)
+  BinaryLogSink::instance().close();
+#endif
+}
+
+bool
+Log::installCrashFlushHandler()
+{
+#if defined(__linux__)
+  return AsyncLogBackend::instance().installCrashHandler();
+#else
+  return false;
+#endif
+}
+
 // Various Toggles
 
 void
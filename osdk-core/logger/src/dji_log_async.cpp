@@ -0,0 +1,576 @@
+/** @file dji_log_async.cpp
+ *  @version 4.0.0
+ *  @date Oct 2026
+ *
+ *  @brief
+ *  Background writer for the DJI OSDK logger (Linux only).
+ *
+ *  @Copyright (c) 2026 DJI
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#include "dji_log_async.hpp"
+
+#if defined(__linux__)
+
+#include "dji_platform.hpp"
+
+#include <errno.h>
+#include <new>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+using namespace DJI::OSDK;
+
+// How long the writer sleeps when nobody wakes it up
+static const int WRITER_IDLE_MS = 1000;
+// How long the crash handler waits for a drain in progress to finish
+static const int CRASH_LOCK_WAIT_MS = 100;
+
+/* Records are rendered with the helpers below instead of snprintf, so the
+ * crash handler can use the same code. They only touch the buffer and
+ * never write past size - 1.
+ */
+static int
+appendString(char* buf, int size, int len, const char* str)
+{
+  while (*str && len < size - 1)
+  {
+    buf[len++] = *str++;
+  }
+  return len;
+}
+
+static int
+appendNumber(char* buf, int size, int len, long long value, int minDigits)
+{
+  char               digits[24];
+  int                count = 0;
+  unsigned long long rest =
+    (value < 0) ? -(unsigned long long)value : (unsigned long long)value;
+
+  do
+  {
+    digits[count++] = '0' + rest % 10;
+    rest /= 10;
+  } while (rest || count < minDigits);
+
+  if (value < 0 && len < size - 1)
+  {
+    buf[len++] = '-';
+  }
+  while (count > 0 && len < size - 1)
+  {
+    buf[len++] = digits[--count];
+  }
+  return len;
+}
+
+struct AsyncLogBackend::ThreadState
+{
+  LogRing*  ring;
+  LogHeader header;
+
+  ThreadState()
+    : ring(NULL)
+  {
+    memset(&header, 0, sizeof(header));
+  }
+
+  // The ring goes back to the pool, records still queued are written by the
+  // next drain as usual
+  ~ThreadState()
+  {
+    if (ring)
+    {
+      ring->inUse.store(false, std::memory_order_release);
+    }
+  }
+};
+
+thread_local AsyncLogBackend::ThreadState AsyncLogBackend::threadState;
+
+AsyncLogBackend&
+AsyncLogBackend::instance()
+{
+  // Never destroyed, threads may still log while static objects go away
+  static AsyncLogBackend* backend = new AsyncLogBackend();
+  return *backend;
+}
+
+AsyncLogBackend::AsyncLogBackend()
+  : capacity(0)
+  , running(false)
+  , sleeping(false)
+  , nextSeq(0)
+  , dropped(0)
+  , reportedDropped(0)
+  , exitHookInstalled(false)
+{
+  for (int i = 0; i < MAX_THREADS; ++i)
+  {
+    rings[i].inUse.store(false);
+    rings[i].head.store(0);
+    rings[i].tail.store(0);
+    rings[i].records = NULL;
+  }
+  pthread_mutex_init(&drainMutex, NULL);
+  sem_init(&wakeSem, 0, 0);
+}
+
+bool
+AsyncLogBackend::start(uint32_t recordsPerThread)
+{
+  if (isRunning())
+  {
+    return true;
+  }
+
+  if (capacity == 0)
+  {
+    capacity = 1;
+    while (capacity < recordsPerThread)
+    {
+      capacity <<= 1;
+    }
+  }
+
+  running.store(true, std::memory_order_release);
+  if (pthread_create(&writer, NULL, writerTask, this) != 0)
+  {
+    running.store(false, std::memory_order_release);
+    return false;
+  }
+
+  if (!exitHookInstalled)
+  {
+    atexit(flushAtExit);
+    exitHookInstalled = true;
+  }
+  return true;
+}
+
+void
+AsyncLogBackend::stop()
+{
+  if (!running.exchange(false))
+  {
+    return;
+  }
+  sem_post(&wakeSem);
+  pthread_join(writer, NULL);
+  flush();
+}
+
+void
+AsyncLogBackend::flush()
+{
+  pthread_mutex_lock(&drainMutex);
+  drain(false);
+  pthread_mutex_unlock(&drainMutex);
+}
+
+void
+AsyncLogBackend::title(int level, const char* prefix, const char* func,
+                       int line)
+{
+  LogHeader& header = threadState.header;
+
+  header.valid = (level != 0);
+  if (!header.valid)
+  {
+    return;
+  }
+  header.type   = func ? HEADER_FULL : HEADER_PRIVATE;
+  header.level  = level;
+  header.prefix = prefix;
+  header.func   = func;
+  header.line   = line;
+  header.timeMs = 0;
+  if (func)
+  {
+    OsdkOsal_GetTimeMs(&header.timeMs);
+  }
+}
+
+void
+AsyncLogBackend::print(const char* fmt, va_list args)
+{
+  if (threadState.header.valid)
+  {
+    va_list copy;
+    va_copy(copy, args);
+    push(fmt, &copy, true);
+    va_end(copy);
+  }
+}
+
+void
+AsyncLogBackend::printTitle()
+{
+  if (threadState.header.valid && threadState.header.type != HEADER_NONE)
+  {
+    push(NULL, NULL, false);
+  }
+}
+
+AsyncLogBackend::LogRing*
+AsyncLogBackend::acquireRing()
+{
+  if (threadState.ring)
+  {
+    return threadState.ring;
+  }
+
+  for (int i = 0; i < MAX_THREADS; ++i)
+  {
+    bool expected = false;
+    if (rings[i].inUse.compare_exchange_strong(expected, true))
+    {
+      // Records are published to the drainer through the release on head
+      if (!rings[i].records)
+      {
+        rings[i].records = new (std::nothrow) LogRecord[capacity];
+        if (!rings[i].records)
+        {
+          rings[i].inUse.store(false);
+          return NULL;
+        }
+      }
+      threadState.ring = &rings[i];
+      return threadState.ring;
+    }
+  }
+  return NULL;
+}
+
+void
+AsyncLogBackend::fillRecord(LogRecord& record, const char* fmt, va_list* args,
+                            bool newline)
+{
+  record.header  = threadState.header;
+  record.newline = newline;
+  record.len     = 0;
+  if (fmt)
+  {
+    int len = vsnprintf(record.text, sizeof(record.text), fmt, *args);
+    if (len > 0)
+    {
+      record.len = (len < RECORD_TEXT_SIZE) ? len : RECORD_TEXT_SIZE - 1;
+    }
+  }
+
+  // The title belongs to the first print after it only
+  threadState.header.type = HEADER_NONE;
+}
+
+void
+AsyncLogBackend::push(const char* fmt, va_list* args, bool newline)
+{
+  LogRing* ring = acquireRing();
+  if (!ring)
+  {
+    // More logging threads than rings, write this one in place
+    LogRecord record;
+    record.seq = nextSeq.fetch_add(1, std::memory_order_relaxed);
+    fillRecord(record, fmt, args, newline);
+
+    char line[RECORD_TEXT_SIZE + 256];
+    int  len = formatRecord(record, line, sizeof(line));
+    pthread_mutex_lock(&drainMutex);
+    writeOut(line, len, false);
+    pthread_mutex_unlock(&drainMutex);
+    return;
+  }
+
+  uint32_t head = ring->head.load(std::memory_order_relaxed);
+  if (head - ring->tail.load(std::memory_order_acquire) >= capacity)
+  {
+    dropped.fetch_add(1, std::memory_order_relaxed);
+    threadState.header.type = HEADER_NONE;
+    return;
+  }
+
+  LogRecord& record = ring->records[head & (capacity - 1)];
+  record.seq        = nextSeq.fetch_add(1, std::memory_order_relaxed);
+  fillRecord(record, fmt, args, newline);
+  ring->head.store(head + 1, std::memory_order_release);
+
+  // Pairs with the fence in writerTask: either the writer sees this record
+  // when it drains again, or this sees the writer sleeping.
+  // At most one post per sleep of the writer
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (sleeping.load(std::memory_order_relaxed) && sleeping.exchange(false))
+  {
+    sem_post(&wakeSem);
+  }
+}
+
+int
+AsyncLogBackend::formatRecord(const LogRecord& record, char* buf, int size)
+{
+  // Same output as "[%d.%03d]%s/%d @ %s, L%d: " and "%s/%d", but without
+  // snprintf, which is not async-signal-safe
+  int len = 0;
+
+  if (record.header.type == HEADER_FULL)
+  {
+    len = appendString(buf, size - 1, len, "[");
+    len = appendNumber(buf, size - 1, len, record.header.timeMs / 1000, 1);
+    len = appendString(buf, size - 1, len, ".");
+    len = appendNumber(buf, size - 1, len, record.header.timeMs % 1000, 3);
+    len = appendString(buf, size - 1, len, "]");
+    len = appendString(buf, size - 1, len, record.header.prefix);
+    len = appendString(buf, size - 1, len, "/");
+    len = appendNumber(buf, size - 1, len, record.header.level, 1);
+    len = appendString(buf, size - 1, len, " @ ");
+    len = appendString(buf, size - 1, len, record.header.func);
+    len = appendString(buf, size - 1, len, ", L");
+    len = appendNumber(buf, size - 1, len, record.header.line, 1);
+    len = appendString(buf, size - 1, len, ": ");
+  }
+  else if (record.header.type == HEADER_PRIVATE)
+  {
+    len = appendString(buf, size - 1, len, record.header.prefix);
+    len = appendString(buf, size - 1, len, "/");
+    len = appendNumber(buf, size - 1, len, record.header.level, 1);
+  }
+
+  int textLen = record.len;
+  if (textLen > size - 2 - len)
+  {
+    textLen = size - 2 - len;
+  }
+  memcpy(buf + len, record.text, textLen);
+  len += textLen;
+
+  if (record.newline)
+  {
+    buf[len++] = '\n';
+  }
+  return len;
+}
+
+int
+AsyncLogBackend::drain(bool crashing)
+{
+  char batch[8192];
+  char line[RECORD_TEXT_SIZE + 256];
+  int  used  = 0;
+  int  count = 0;
+
+  while (true)
+  {
+    // Merge the rings in call order
+    LogRing* next   = NULL;
+    uint64_t minSeq = 0;
+    for (int i = 0; i < MAX_THREADS; ++i)
+    {
+      LogRing& ring = rings[i];
+      uint32_t tail = ring.tail.load(std::memory_order_relaxed);
+      if (ring.head.load(std::memory_order_acquire) == tail)
+      {
+        continue;
+      }
+      uint64_t seq = ring.records[tail & (capacity - 1)].seq;
+      if (!next || seq < minSeq)
+      {
+        next   = &ring;
+        minSeq = seq;
+      }
+    }
+    if (!next)
+    {
+      break;
+    }
+
+    uint32_t tail = next->tail.load(std::memory_order_relaxed);
+    int      len =
+      formatRecord(next->records[tail & (capacity - 1)], line, sizeof(line));
+    next->tail.store(tail + 1, std::memory_order_release);
+
+    if (used + len > (int)sizeof(batch))
+    {
+      writeOut(batch, used, crashing);
+      used = 0;
+    }
+    memcpy(batch + used, line, len);
+    used += len;
+    ++count;
+  }
+
+  uint64_t droppedNow = dropped.load(std::memory_order_relaxed);
+  if (droppedNow != reportedDropped)
+  {
+    if (used + 64 > (int)sizeof(batch))
+    {
+      writeOut(batch, used, crashing);
+      used = 0;
+    }
+    int len = appendString(batch + used, 64, 0, "[log] ");
+    len = appendNumber(batch + used, 64, len,
+                       (long long)(droppedNow - reportedDropped), 1);
+    len = appendString(batch + used, 64, len, " messages dropped\n");
+    used += len;
+    reportedDropped = droppedNow;
+  }
+
+  if (used)
+  {
+    writeOut(batch, used, crashing);
+  }
+  return count;
+}
+
+void
+AsyncLogBackend::writeOut(const char* buf, int len, bool crashing)
+{
+  if (!crashing)
+  {
+    fwrite(buf, 1, len, stdout);
+    fflush(stdout);
+    return;
+  }
+
+  // stdio is not safe in a signal handler
+  while (len > 0)
+  {
+    ssize_t written = write(STDOUT_FILENO, buf, len);
+    if (written < 0 && errno == EINTR)
+    {
+      continue;
+    }
+    if (written <= 0)
+    {
+      return;
+    }
+    buf += written;
+    len -= written;
+  }
+}
+
+void*
+AsyncLogBackend::writerTask(void* arg)
+{
+  AsyncLogBackend* self = (AsyncLogBackend*)arg;
+
+  while (self->running.load(std::memory_order_acquire))
+  {
+    pthread_mutex_lock(&self->drainMutex);
+    int count = self->drain(false);
+    pthread_mutex_unlock(&self->drainMutex);
+    if (count)
+    {
+      continue;
+    }
+
+    // A record pushed before sleeping was set saw no sleeper and posted
+    // nothing, so drain once more before waiting
+    self->sleeping.store(true);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    pthread_mutex_lock(&self->drainMutex);
+    count = self->drain(false);
+    pthread_mutex_unlock(&self->drainMutex);
+    if (count)
+    {
+      self->sleeping.store(false);
+      continue;
+    }
+
+    struct timespec absTimeout;
+    clock_gettime(CLOCK_REALTIME, &absTimeout);
+    absTimeout.tv_sec += WRITER_IDLE_MS / 1000;
+    absTimeout.tv_nsec += (long)(WRITER_IDLE_MS % 1000) * 1000000;
+    if (absTimeout.tv_nsec >= 1000000000)
+    {
+      absTimeout.tv_sec += 1;
+      absTimeout.tv_nsec -= 1000000000;
+    }
+    while (sem_timedwait(&self->wakeSem, &absTimeout) != 0 && errno == EINTR)
+    {
+    }
+
+    self->sleeping.store(false);
+  }
+  return NULL;
+}
+
+bool
+AsyncLogBackend::installCrashHandler()
+{
+  static const int signals[] = { SIGSEGV, SIGBUS, SIGFPE, SIGILL, SIGABRT };
+
+  struct sigaction action;
+  memset(&action, 0, sizeof(action));
+  action.sa_handler = onCrash;
+  action.sa_flags   = SA_RESETHAND;
+  sigemptyset(&action.sa_mask);
+
+  for (size_t i = 0; i < sizeof(signals) / sizeof(signals[0]); ++i)
+  {
+    if (sigaction(signals[i], &action, NULL) != 0)
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+void
+AsyncLogBackend::onCrash(int sig)
+{
+  AsyncLogBackend& self = instance();
+
+  // Let a drain in progress finish, so its output is not interleaved with
+  // ours. The crashing thread may be the drainer itself, so only wait for
+  // a bounded time, then write anyway.
+  bool            locked = false;
+  struct timespec pause  = { 0, 1000000 };
+  for (int i = 0; i < CRASH_LOCK_WAIT_MS; ++i)
+  {
+    locked = (pthread_mutex_trylock(&self.drainMutex) == 0);
+    if (locked)
+    {
+      break;
+    }
+    nanosleep(&pause, NULL);
+  }
+  self.drain(true);
+  if (locked)
+  {
+    pthread_mutex_unlock(&self.drainMutex);
+  }
+
+  // SA_RESETHAND restored the default action
+  raise(sig);
+}
+
+void
+AsyncLogBackend::flushAtExit()
+{
+  instance().stop();
+}
+
+#endif // __linux__
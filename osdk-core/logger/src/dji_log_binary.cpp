@@ -0,0 +1,441 @@
+/** @file dji_log_binary.cpp
+ *  @version 4.0.0
+ *  @date Oct 2026
+ *
+ *  @brief
+ *  Binary log file with deferred formatting for the DJI OSDK logger.
+ *
+ *  @Copyright (c) 2026 DJI
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#include "dji_log_binary.hpp"
+
+#if defined(__linux__)
+
+#include "dji_time.hpp"
+
+#include <assert.h>
+#include <fcntl.h>
+#include <link.h>
+#include <sched.h>
+#include <stddef.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+using namespace DJI::OSDK;
+
+#ifndef NDEBUG
+static int
+findReadOnlySegment(struct dl_phdr_info* info, size_t size, void* data)
+{
+  (void)size;
+  uintptr_t addr = (uintptr_t)data;
+  for (int i = 0; i < info->dlpi_phnum; ++i)
+  {
+    const ElfW(Phdr)& phdr = info->dlpi_phdr[i];
+    uintptr_t start = info->dlpi_addr + phdr.p_vaddr;
+    if (phdr.p_type == PT_LOAD && !(phdr.p_flags & PF_W) && addr >= start &&
+        addr < start + phdr.p_memsz)
+    {
+      return 1;
+    }
+  }
+  return 0;
+}
+
+//! Literals and __func__ live in a read-only segment of a loaded image
+static bool
+isLiteral(const char* str)
+{
+  return dl_iterate_phdr(findReadOnlySegment, (void*)str) != 0;
+}
+#endif
+
+struct BinaryLogSink::ThreadState
+{
+  bool        valid;
+  bool        hasTitle;
+  int         level;
+  const char* prefix;
+  const char* func;
+  int         line;
+
+  ThreadState()
+    : valid(false)
+    , hasTitle(false)
+    , level(0)
+    , prefix(NULL)
+    , func(NULL)
+    , line(0)
+  {
+  }
+};
+
+thread_local BinaryLogSink::ThreadState BinaryLogSink::threadState;
+
+BinaryLogSink&
+BinaryLogSink::instance()
+{
+  // Never destroyed, threads may still log while static objects go away
+  static BinaryLogSink* sink = new BinaryLogSink();
+  return *sink;
+}
+
+BinaryLogSink::BinaryLogSink()
+  : fd(-1)
+  , base(NULL)
+  , mappedSize(0)
+  , capacity(0)
+  , opened(false)
+  , writers(0)
+  , used(0)
+  , dropped(0)
+{
+  for (int i = 0; i < STRING_TABLE_SIZE; ++i)
+  {
+    strings[i].store(NULL);
+    defined[i].store(false);
+  }
+}
+
+bool
+BinaryLogSink::open(const char* path, size_t fileSize)
+{
+  if (isOpen() || fileSize <= sizeof(BinaryLogFileHeader))
+  {
+    return false;
+  }
+
+  fd = ::open(path, O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+  if (fd < 0)
+  {
+    return false;
+  }
+  if (ftruncate(fd, fileSize) != 0)
+  {
+    ::close(fd);
+    fd = -1;
+    return false;
+  }
+  void* mapped =
+    mmap(NULL, fileSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  if (mapped == MAP_FAILED)
+  {
+    ::close(fd);
+    fd = -1;
+    return false;
+  }
+
+  base       = (uint8_t*)mapped;
+  mappedSize = fileSize;
+  capacity   = fileSize - sizeof(BinaryLogFileHeader);
+
+  BinaryLogFileHeader* header = (BinaryLogFileHeader*)base;
+  memcpy(header->magic, BINARY_LOG_MAGIC, sizeof(header->magic));
+  header->version     = BINARY_LOG_VERSION;
+  header->headerSize  = sizeof(BinaryLogFileHeader);
+  header->startTimeUs = getMonotonicTimeUs();
+  header->capacity  = capacity;
+  header->usedBytes = 0;
+  header->dropped   = 0;
+
+  // Ids are per file, a new file defines its strings again
+  for (int i = 0; i < STRING_TABLE_SIZE; ++i)
+  {
+    strings[i].store(NULL, std::memory_order_relaxed);
+    defined[i].store(false, std::memory_order_relaxed);
+  }
+  used.store(0);
+  dropped.store(0);
+  opened.store(true);
+  return true;
+}
+
+void
+BinaryLogSink::close()
+{
+  if (!opened.exchange(false))
+  {
+    return;
+  }
+  // Writers check opened after announcing themselves
+  while (writers.load() != 0)
+  {
+    sched_yield();
+  }
+
+  size_t usedBytes = used.load();
+  if (usedBytes > capacity)
+  {
+    usedBytes = capacity;
+  }
+  BinaryLogFileHeader* header = (BinaryLogFileHeader*)base;
+  header->usedBytes           = usedBytes;
+  header->dropped             = dropped.load();
+
+  msync(base, mappedSize, MS_SYNC);
+  munmap(base, mappedSize);
+  if (ftruncate(fd, sizeof(BinaryLogFileHeader) + usedBytes) != 0)
+  {
+    // The unused tail is zero and the decoder stops there anyway
+  }
+  ::close(fd);
+  fd   = -1;
+  base = NULL;
+}
+
+void
+BinaryLogSink::title(int level, const char* prefix, const char* func,
+                     int line)
+{
+  threadState.valid = (level != 0);
+  if (!threadState.valid)
+  {
+    return;
+  }
+  threadState.hasTitle = true;
+  threadState.level    = level;
+  threadState.prefix   = prefix;
+  threadState.func     = func;
+  threadState.line     = line;
+}
+
+void
+BinaryLogSink::print(const char* fmt, va_list args)
+{
+  if (!threadState.valid || !fmt)
+  {
+    return;
+  }
+
+  writers.fetch_add(1);
+  if (!isOpen())
+  {
+    writers.fetch_sub(1);
+    return;
+  }
+
+  BinaryLogRecordHeader header;
+  BinaryLogEntry        entry;
+  header.size  = 0;
+  header.type  = BINARY_LOG_ENTRY;
+  header.level = 0;
+  header.id    = internString(fmt);
+
+  entry.timeUs   = getMonotonicTimeUs();
+  entry.prefixId = BINARY_LOG_NO_STRING;
+  entry.funcId   = BINARY_LOG_NO_STRING;
+  entry.line     = 0;
+  if (threadState.hasTitle)
+  {
+    // The title belongs to the first print after it only
+    threadState.hasTitle = false;
+    header.level         = threadState.level;
+    entry.prefixId       = internString(threadState.prefix);
+    entry.funcId =
+      threadState.func ? internString(threadState.func) : BINARY_LOG_NO_STRING;
+    entry.line = threadState.line;
+  }
+
+  // Copy the raw arguments in the order the format string consumes them
+  uint8_t argsBuf[BINARY_LOG_MAX_ARGS_SIZE];
+  size_t  argsSize = 0;
+  va_list ap;
+  va_copy(ap, args);
+
+  const char*           pos = fmt;
+  BinaryLogFormat::Spec spec;
+  while (BinaryLogFormat::next(pos, spec))
+  {
+    if (argsSize + 8 * (spec.starCount + 1) > sizeof(argsBuf))
+    {
+      break;
+    }
+    for (int i = 0; i < spec.starCount; ++i)
+    {
+      int64_t star = va_arg(ap, int);
+      memcpy(argsBuf + argsSize, &star, 8);
+      argsSize += 8;
+    }
+
+    if (spec.type == BinaryLogFormat::ARG_STRING)
+    {
+      const char* str = va_arg(ap, const char*);
+      if (!str)
+      {
+        str = "(null)";
+      }
+      size_t len = strnlen(str, BINARY_LOG_MAX_STRING_ARG);
+      if (argsSize + 2 + len > sizeof(argsBuf))
+      {
+        break;
+      }
+      uint16_t len16 = len;
+      memcpy(argsBuf + argsSize, &len16, 2);
+      memcpy(argsBuf + argsSize + 2, str, len);
+      argsSize += 2 + len;
+      continue;
+    }
+
+    uint8_t* slot = argsBuf + argsSize;
+    argsSize += 8;
+    if (spec.type == BinaryLogFormat::ARG_DOUBLE)
+    {
+      double value = (spec.length == BinaryLogFormat::LEN_LONG_DOUBLE)
+                       ? (double)va_arg(ap, long double)
+                       : va_arg(ap, double);
+      memcpy(slot, &value, 8);
+      continue;
+    }
+
+    bool    isSigned = (spec.type == BinaryLogFormat::ARG_INT);
+    int64_t value;
+    if (spec.conversion == 'p')
+    {
+      value = (int64_t)(uintptr_t)va_arg(ap, void*);
+    }
+    else
+    {
+      switch (spec.length)
+      {
+        case BinaryLogFormat::LEN_LONG:
+          value = isSigned ? (int64_t)va_arg(ap, long)
+                           : (int64_t)va_arg(ap, unsigned long);
+          break;
+        case BinaryLogFormat::LEN_LONG_LONG:
+        case BinaryLogFormat::LEN_MAX:
+          value = isSigned ? (int64_t)va_arg(ap, long long)
+                           : (int64_t)va_arg(ap, unsigned long long);
+          break;
+        case BinaryLogFormat::LEN_SIZE:
+          value = isSigned ? (int64_t)va_arg(ap, ssize_t)
+                           : (int64_t)va_arg(ap, size_t);
+          break;
+        case BinaryLogFormat::LEN_PTRDIFF:
+          value = (int64_t)va_arg(ap, ptrdiff_t);
+          break;
+        default:
+          // char and short are promoted to int
+          value = isSigned ? (int64_t)va_arg(ap, int)
+                           : (int64_t)va_arg(ap, unsigned int);
+          break;
+      }
+    }
+    memcpy(slot, &value, 8);
+  }
+  va_end(ap);
+
+  entry.argsSize = argsSize;
+  writeRecord(header, &entry, sizeof(entry), argsBuf, argsSize);
+  writers.fetch_sub(1);
+}
+
+uint32_t
+BinaryLogSink::internString(const char* str)
+{
+  // Log strings are literals, so the pointer identifies the string
+  uint32_t slot = (uint32_t)(((uintptr_t)str >> 3) * 2654435761u);
+  for (int probe = 0; probe < STRING_TABLE_SIZE; ++probe)
+  {
+    uint32_t    index   = (slot + probe) % STRING_TABLE_SIZE;
+    const char* current = strings[index].load(std::memory_order_acquire);
+    if (current == str && defined[index].load(std::memory_order_acquire))
+    {
+      return index;
+    }
+    if (current && current != str)
+    {
+      continue;
+    }
+
+    // The first time the string is seen, or its STRING record is not in
+    // the file yet. That record was dropped or its writer is still at it,
+    // so write one more. The decoder keeps either copy.
+    assert(isLiteral(str));
+    const char* expected = NULL;
+    if (current == str ||
+        strings[index].compare_exchange_strong(expected, str) ||
+        expected == str)
+    {
+      return defineString(index, str) ? index : BINARY_LOG_NO_STRING;
+    }
+  }
+  return BINARY_LOG_NO_STRING;
+}
+
+/*!
+ * @details Records that use the id are only written after this returns
+ * true, so a reader of the file never finds an id without its string.
+ */
+bool
+BinaryLogSink::defineString(uint32_t id, const char* str)
+{
+  BinaryLogRecordHeader header;
+  header.size  = 0;
+  header.type  = BINARY_LOG_STRING;
+  header.level = 0;
+  header.id    = id;
+  if (!writeRecord(header, str, strlen(str) + 1, NULL, 0))
+  {
+    return false;
+  }
+  defined[id].store(true, std::memory_order_release);
+  return true;
+}
+
+bool
+BinaryLogSink::writeRecord(const BinaryLogRecordHeader& header,
+                           const void* payload, size_t payloadSize,
+                           const void* extra, size_t extraSize)
+{
+  size_t size = sizeof(header) + payloadSize + extraSize;
+  if (size > 0xFFFF)
+  {
+    dropped.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+
+  size_t aligned = (size + 7) & ~(size_t)7;
+  size_t offset  = used.fetch_add(aligned, std::memory_order_relaxed);
+  if (offset + aligned > capacity)
+  {
+    dropped.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+
+  uint8_t* dst = base + sizeof(BinaryLogFileHeader) + offset;
+  memcpy(dst + sizeof(header.size), (const uint8_t*)&header + sizeof(header.size),
+         sizeof(header) - sizeof(header.size));
+  memcpy(dst + sizeof(header), payload, payloadSize);
+  if (extraSize)
+  {
+    memcpy(dst + sizeof(header) + payloadSize, extra, extraSize);
+  }
+
+  // The size commits the record, a reader never sees a half written one
+  __atomic_store_n((uint16_t*)dst, (uint16_t)size, __ATOMIC_RELEASE);
+  return true;
+}
+
+#endif // __linux__
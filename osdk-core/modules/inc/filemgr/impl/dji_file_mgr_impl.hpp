@@ -44,6 +44,7 @@
 #include "dji_file_mgr_define.hpp"
 #include "dji_file_mgr.hpp"
 #include "mmap_file_buffer.hpp"
+#include "file_data_reassembler.hpp"
 
 #if 0
 #include "commondatarangehandler.h"
@@ -62,6 +63,7 @@ typedef enum DownloadStateEnum : int {
 
 // Forward Declaration
 class Linker;
+class FileMgrImpl;
 
 class DownloadListHandler {
  public:
@@ -76,19 +78,37 @@ class DownloadListHandler {
   std::atomic<uint32_t> updateTimeMs;
 };
 
+/*! One file download. FileMgrImpl keeps a few of them so that several files
+ *  can be downloaded at once, the packs are told apart by their session id.
+ */
 class DownloadDataHandler {
  public:
-  DownloadDataHandler();
+  DownloadDataHandler(FileMgrImpl *impl);
   ~DownloadDataHandler();
  public:
-  CommonDataRangeHandler *range_handler_;
-  MmapFileBuffer *mmap_file_buffer_;
+  FileMgrImpl *impl;
+  FileDataReassembler *reassembler_;
   FileMgr::FileDataReqCBType reqCB;
   void* reqCBUserData;
   std::atomic<uint32_t> updateTimeMs;
   std::string downloadPath;
   std::atomic<int> downloadState;
   std::atomic<int> curTargetFileIndex;
+  std::atomic<uint16_t> sessionId;
+  E_OSDKCommandDeiveType type;
+  uint8_t index;
+
+  /*! FILE_DATA_RUNNING while packs are accepted, then the E_OsdkStat the
+   *  download ends with. Whoever moves it away from running finishes it. */
+  std::atomic<int> finishStat;
+  /*! Set by the receiving thread when a hole shows up */
+  std::atomic<bool> nackPending;
+  /*! Wakes the monitor task up for a NACK or the end of the download */
+  T_OsdkSemHandle eventSem;
+  T_OsdkTaskHandle monitorHandle;
+
+  uint64_t lastPrintBytes;
+  uint32_t lastPrintMs;
 };
 
 class FileMgrImpl {
@@ -103,12 +123,17 @@ class FileMgrImpl {
 
   void HandlePushPack(dji_general_transfer_msg_ack *rsp);
   ErrorCode::ErrorCodeType SendReqFileListPack();
-  ErrorCode::ErrorCodeType SendReqFileDataPack(int fileIndex) ;
+  ErrorCode::ErrorCodeType SendReqFileDataPack(DownloadDataHandler *handler);
+
+  /*! Downloads of file data that may run at the same time */
+  static const int MAX_FILE_DATA_DOWNLOADS = 4;
 
  private:
-  ErrorCode::ErrorCodeType SendAbortPack(DJI_GENERAL_DOWNLOAD_FILE_TASK_TYPE taskId);
-  ErrorCode::ErrorCodeType SendACKPack(DJI_GENERAL_DOWNLOAD_FILE_TASK_TYPE taskId, dji_download_ack *ack);
-  ErrorCode::ErrorCodeType SendMissedAckPack(DJI_GENERAL_DOWNLOAD_FILE_TASK_TYPE taskId);
+  ErrorCode::ErrorCodeType SendAbortPack(DJI_GENERAL_DOWNLOAD_FILE_TASK_TYPE taskId,
+                                         E_OSDKCommandDeiveType type, uint8_t index,
+                                         uint16_t sessionId);
+  ErrorCode::ErrorCodeType SendACKPack(DownloadDataHandler *handler, dji_download_ack *ack);
+  ErrorCode::ErrorCodeType SendMissedAckPack(DownloadDataHandler *handler);
 
   private:
   enum FileNameRule {
@@ -119,7 +144,7 @@ class FileMgrImpl {
 
  private:
   DownloadListHandler *fileListHandler;
-  DownloadDataHandler *fileDataHandler;
+  DownloadDataHandler *fileDataHandlers[MAX_FILE_DATA_DOWNLOADS];
 
   Linker *linker;
   E_OSDKCommandDeiveType type;
@@ -136,7 +161,6 @@ class FileMgrImpl {
   } ConsumeDataBuffer;
   ConsumeDataBuffer ConsumeChunk(DataPointer data_pointer, size_t &chunk_index, size_t consumSize);
   FilePackage parseFileList(std::list<DataPointer> fullDataList);
-  bool parseFileData(dji_general_transfer_msg_ack *rsp);
 
  private:
   void OnReceiveAbortPack(dji_general_transfer_msg_ack *rsp);
@@ -145,6 +169,9 @@ class FileMgrImpl {
 
   void fileListRawDataCB(dji_general_transfer_msg_ack *rsp);
   void fileDataRawDataCB(dji_general_transfer_msg_ack *rsp);
+  DownloadDataHandler *findFileDataHandler(uint16_t sessionId);
+  bool isFileDataIdle();
+  static bool finishFileData(DownloadDataHandler *handler, E_OsdkStat stat);
 
   std::string GetFileName(MediaFile fileInfo);
   std::string GetSuffixByFileType(MediaFileType type);
@@ -154,10 +181,9 @@ class FileMgrImpl {
   uint16_t getCurReqSessionId() {return reqSessionId;};
   static std::atomic<uint16_t> reqSessionId;
   T_OsdkTaskHandle reqFileListHandle;
-  T_OsdkTaskHandle reqFileDataHandle;
   static void fileListMonitorTask(void *arg);
   static void fileDataMonitorTask(void *arg);
-  void printFileDownloadStatus();
+  void printFileDownloadStatus(DownloadDataHandler *handler);
   //只是用于测试
  private:
   uint8_t localSenderId;
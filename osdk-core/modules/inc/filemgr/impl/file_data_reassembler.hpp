@@ -0,0 +1,121 @@
+/** @file file_data_reassembler.hpp
+ *  @version 4.0.0
+ *  @date Oct 2026
+ *
+ *  @brief Places file download packs straight into the mapped target file
+ *
+ *  @Copyright (c) 2026 DJI
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef FILE_DATA_REASSEMBLER_HPP
+#define FILE_DATA_REASSEMBLER_HPP
+
+#include <map>
+#include <mutex>
+#include <string>
+#include "dji_file_mgr_internal_define.hpp"
+#include "mmap_file_buffer.hpp"
+
+namespace DJI {
+namespace OSDK {
+
+/*! @brief Reassembles one file download in place
+ *
+ *  @details Pack 0 carries the file size and maps the target file, every
+ *  other pack is copied to its own offset as soon as it arrives, so packs may
+ *  come in any order and nothing is queued. The offset of pack n is the data
+ *  size of pack 0 plus n-1 full chunks, all packs but the last one have the
+ *  same size. Packs arriving before that is known are dropped and show up as
+ *  lost, the NACK brings them back.
+ *
+ *  The received sequence numbers are kept as disjoint [first, end) intervals
+ *  in a map, a pack costs O(log n) in the number of holes, which stays small.
+ */
+class FileDataReassembler {
+ public:
+  typedef enum PackResult {
+    PACK_STORED,
+    PACK_DUPLICATE,
+    PACK_DROPPED,  /*!< can not be placed yet, will be requested again */
+    PACK_INVALID,  /*!< does not fit the file, the download can not go on */
+  } PackResult;
+
+  FileDataReassembler();
+  ~FileDataReassembler();
+
+  //! Start a new download to path, the file is created by pack 0
+  void reset(const std::string &path);
+
+  /*!
+   * @brief Copy one data pack into the file
+   * @param newGap set when the pack is ahead of all packs seen so far,
+   * leaving a hole behind it
+   */
+  PackResult insertPack(const dji_general_transfer_msg_ack *rsp,
+                        bool &newGap);
+
+  //! All packs up to the last one are in the file
+  bool isComplete();
+
+  /*!
+   * @brief Fill in a download ack describing the holes
+   * @param maxLoss size of ack->loss_desc
+   * @return the number of holes, may be more than were written
+   */
+  uint32_t fillAck(dji_download_ack *ack, uint8_t maxLoss);
+
+  void getProgress(uint64_t &recvBytes, uint64_t &fileSize,
+                   uint32_t &recvPacks, uint32_t &lossPacks);
+
+  //! Unmap the file, later packs are dropped
+  void close();
+
+ private:
+  bool isReceived(uint32_t seq) const;
+  void markReceived(uint32_t seq);
+  bool openFile(const dji_general_transfer_msg_ack *rsp, uint32_t dataSize);
+
+ private:
+  std::mutex mutex;
+  MmapFileBuffer file;
+  std::string path;
+  bool active;
+  bool fileOpened;
+
+  //! first seq -> end seq of every received run
+  std::map<uint32_t, uint32_t> received;
+  uint32_t recvPacks;
+  uint64_t recvBytes;
+  //! One past the highest seq seen, placed or not
+  uint32_t nextSeq;
+  bool lastKnown;
+  uint32_t lastSeq;
+
+  uint64_t fileSize;
+  uint32_t firstDataSize;
+  uint32_t chunkSize;
+};
+
+}  // namespace OSDK
+}  // namespace DJI
+
+#endif  // FILE_DATA_REASSEMBLER_HPP
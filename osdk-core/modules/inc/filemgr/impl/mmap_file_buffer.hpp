@@ -12,6 +12,7 @@
 #include <unistd.h>
 #include <memory>
 #include <atomic>
+#include <string>
 
 namespace DJI {
 namespace OSDK {
@@ -131,6 +131,8 @@ class Firewall {
 
  private:
   T_OsdkMutexHandle policyUpdatedMutex;
+  /*! posted whenever the policy becomes updated */
+  T_OsdkSemHandle policyUpdatedSem;
   T_OsdkMutexHandle appKeyBufferMutex;
   T_OsdkTaskHandle firewallTaskHandle;
   bool checkFireWallConnection();
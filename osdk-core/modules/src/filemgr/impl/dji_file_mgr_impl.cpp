@@ -97,40 +97,35 @@ E_OsdkStat downloadFileAckCB(struct _CommandHandle *cmdHandle,
   return OSDK_STAT_OK;
 }
 
-void FileMgrImpl::printFileDownloadStatus() {
+#define FILE_LIST_SESSION_ID 999
+#define FILE_DATA_RUNNING (-1)
+/*! Holes the camera is told about in one NACK */
+#define FILE_DATA_MAX_NACK_RANGES 8
 
-  uint32_t lossPackCnt = 0;
-  uint32_t recvPackCnt = 0;
+std::atomic<uint16_t> FileMgrImpl::reqSessionId(1000);
 
-  static uint64_t curFilePos = 0;
-  static uint64_t lastFilePos = 0;
-  static uint32_t curPrintMs = 0;
-  static uint32_t lastPrintMs = 0;
+void FileMgrImpl::printFileDownloadStatus(DownloadDataHandler *handler) {
+  uint64_t recvBytes = 0;
+  uint64_t fileSize = 0;
+  uint32_t recvPackCnt = 0;
+  uint32_t lossPackCnt = 0;
+  uint32_t curPrintMs = 0;
   char speedMsg[20] = {0};
 
-  curFilePos = fileDataHandler->mmap_file_buffer_->curFilePos;
+  handler->reassembler_->getProgress(recvBytes, fileSize, recvPackCnt, lossPackCnt);
   OsdkOsal_GetTimeMs(&curPrintMs);
-  if ((curPrintMs > lastPrintMs) && ((curPrintMs - lastPrintMs) < 600) &&
-      (curFilePos > lastFilePos) &&
-      curFilePos && lastFilePos && curPrintMs && lastPrintMs)
-    snprintf(speedMsg, sizeof(speedMsg), "%llu\tkB/s", (curFilePos - lastFilePos) / (curPrintMs - lastPrintMs));
+  if ((curPrintMs > handler->lastPrintMs) && ((curPrintMs - handler->lastPrintMs) < 600) &&
+      (recvBytes > handler->lastPrintBytes) && handler->lastPrintBytes && handler->lastPrintMs)
+    snprintf(speedMsg, sizeof(speedMsg), "%llu\tkB/s",
+             (unsigned long long) (recvBytes - handler->lastPrintBytes) / (curPrintMs - handler->lastPrintMs));
   else
     snprintf(speedMsg, sizeof(speedMsg), "--\tkB/s");
-  lastFilePos = curFilePos;
-  lastPrintMs = curPrintMs;
-
+  handler->lastPrintBytes = recvBytes;
+  handler->lastPrintMs = curPrintMs;
 
-  for (auto &msg : fileDataHandler->range_handler_->GetNoAckRanges()) {
-    lossPackCnt += msg.length;
-  }
-  recvPackCnt = fileDataHandler->range_handler_->GetLastNotReceiveSeq() - lossPackCnt;
-  float finishPercent =
-    fileDataHandler->mmap_file_buffer_->fdAddrSize == 0
-      ? 0
-      : (fileDataHandler->mmap_file_buffer_->curFilePos * 100.0f /
-         fileDataHandler->mmap_file_buffer_->fdAddrSize);
-  DSTATUS("\033[0;32m[Complete rate : %0.1f%%] (%s\t recv:\t%d packs\t loss:\t%d packs) \033[0m",
-          finishPercent, speedMsg, recvPackCnt, lossPackCnt);
+  float finishPercent = fileSize == 0 ? 0 : (recvBytes * 100.0f / fileSize);
+  DSTATUS("\033[0;32m[Session %d complete rate : %0.1f%%] (%s\t recv:\t%d packs\t loss:\t%d packs) \033[0m",
+          (int) handler->sessionId, finishPercent, speedMsg, recvPackCnt, lossPackCnt);
 }
 
 void FileMgrImpl::fileListMonitorTask(void *arg) {
@@ -154,7 +149,8 @@ void FileMgrImpl::fileListMonitorTask(void *arg) {
         DERROR("downloadMonitorTask timeout!! device type : %d index: %d", impl->type, impl->index);
 
           if (impl->fileListHandler->downloadState == RECVING_FILE_LIST) {
-            impl->SendAbortPack(DJI_GENERAL_DOWNLOAD_FILE_TASK_TYPE_LIST);
+            impl->SendAbortPack(DJI_GENERAL_DOWNLOAD_FILE_TASK_TYPE_LIST,
+                                impl->type, impl->index, FILE_LIST_SESSION_ID);
             auto cb = impl->fileListHandler->reqCB;
             void *udata = impl->fileListHandler->reqCBUserData;
               FilePackage defaultPack;
@@ -177,53 +173,68 @@ void FileMgrImpl::fileListMonitorTask(void *arg) {
 }
 
 
+/*! Holes are NACKed as soon as the receiving thread sees them, then again
+ *  every ackIntervalMs until they are filled. With no hole the same pack acks
+ *  the progress.
+ */
 void FileMgrImpl::fileDataMonitorTask(void *arg) {
   DSTATUS("OSDK download filedata monitor task created.");
   if(arg) {
     uint32_t curTimeMs = 0;
-    uint32_t preTimeMs = 0;
-    uint32_t pollTimeMsInterval = 500;
+    uint32_t lastAckMs = 0;
+    uint32_t lastPrintMs = 0;
+    uint32_t wakeUpMs = 50;
+    uint32_t minNackIntervalMs = 20;
+    uint32_t ackIntervalMs = 200;
+    uint32_t printIntervalMs = 500;
     uint32_t taskTimeOutMs = 3000;
-    FileMgrImpl *impl = (FileMgrImpl *)arg;
+    DownloadDataHandler *handler = (DownloadDataHandler *)arg;
+    FileMgrImpl *impl = handler->impl;
     OsdkOsal_GetTimeMs(&curTimeMs);
-    OsdkOsal_GetTimeMs(&preTimeMs);
-    impl->fileDataHandler->updateTimeMs = curTimeMs;
+    lastPrintMs = curTimeMs;
     for (;;)
     {
-      if (impl->fileDataHandler->downloadState == DOWNLOAD_IDLE) {
-        impl->printFileDownloadStatus();
-        return;
-      }
-      uint32_t refreshTimeMs = impl->fileDataHandler->updateTimeMs;
+      OsdkOsal_SemaphoreTimedWait(handler->eventSem, wakeUpMs);
       OsdkOsal_GetTimeMs(&curTimeMs);
 
       /*! Task timeout */
-      if (curTimeMs - refreshTimeMs >= taskTimeOutMs) {
-        DSTATUS("curTimeMs:%d refreshTimeMs:%d", curTimeMs, refreshTimeMs);
-        DERROR("downloadMonitorTask timeout!! device type : %d index: %d", impl->type, impl->index);
+      if ((handler->finishStat == FILE_DATA_RUNNING) &&
+          (curTimeMs - handler->updateTimeMs >= taskTimeOutMs)) {
+        DSTATUS("curTimeMs:%d refreshTimeMs:%d", curTimeMs, (uint32_t) handler->updateTimeMs);
+        DERROR("downloadMonitorTask timeout!! device type : %d index: %d session: %d",
+               handler->type, handler->index, (int) handler->sessionId);
+        finishFileData(handler, OSDK_STAT_ERR);
+      }
 
-        if (impl->fileDataHandler->downloadState == RECVING_FILE_DATA) {
-          impl->SendAbortPack(DJI_GENERAL_DOWNLOAD_FILE_TASK_TYPE_FILE);
-          auto cb = impl->fileDataHandler->reqCB;
-          void *udata = impl->fileDataHandler->reqCBUserData;
-          if (cb) cb(OSDK_STAT_ERR, udata);
-          DSTATUS("Finish req filedata task cause of timeout, reset downloadState to be DOWNLOAD_IDLE");
-          impl->fileDataHandler->downloadState = DOWNLOAD_IDLE;
-        }
+      int finishStat = handler->finishStat;
+      if (finishStat != FILE_DATA_RUNNING) {
+        handler->reassembler_->close();
+        impl->SendAbortPack(DJI_GENERAL_DOWNLOAD_FILE_TASK_TYPE_FILE,
+                            handler->type, handler->index, handler->sessionId);
+        impl->printFileDownloadStatus(handler);
+        auto cb = handler->reqCB;
+        void *udata = handler->reqCBUserData;
+        handler->reqCB = NULL;
+        if (cb) cb((E_OsdkStat) finishStat, udata);
+        DSTATUS("Finish req filedata task, reset downloadState to be DOWNLOAD_IDLE");
+        handler->downloadState = DOWNLOAD_IDLE;
+        return;
       }
 
-      if (curTimeMs - preTimeMs >=  pollTimeMsInterval)
-      {
-        /*! Here to send the miss ack packs*/
-        if (impl->fileDataHandler->downloadState == RECVING_FILE_DATA) {
-          impl->printFileDownloadStatus();
-          impl->SendMissedAckPack(DJI_GENERAL_DOWNLOAD_FILE_TASK_TYPE_FILE);
-        }
-        preTimeMs = curTimeMs;
+      bool nackPending = handler->nackPending.exchange(false);
+      uint32_t sinceAckMs = curTimeMs - lastAckMs;
+      if ((nackPending && (sinceAckMs >= minNackIntervalMs)) ||
+          (sinceAckMs >= ackIntervalMs)) {
+        impl->SendMissedAckPack(handler);
+        lastAckMs = curTimeMs;
+      } else if (nackPending) {
+        handler->nackPending = true;
       }
 
-      /*! TODO: with out sleep 100ms, the time will get the same as last time. */
-      OsdkOsal_TaskSleepMs(10);
+      if (curTimeMs - lastPrintMs >= printIntervalMs) {
+        impl->printFileDownloadStatus(handler);
+        lastPrintMs = curTimeMs;
+      }
     }
   } else {
     DERROR("task run failed because of the invalid"
@@ -231,11 +242,20 @@ void FileMgrImpl::fileDataMonitorTask(void *arg) {
   }
 }
 
+bool FileMgrImpl::finishFileData(DownloadDataHandler *handler, E_OsdkStat stat) {
+  int running = FILE_DATA_RUNNING;
+  if (!handler->finishStat.compare_exchange_strong(running, (int) stat))
+    return false;
+  OsdkOsal_SemaphorePost(handler->eventSem);
+  return true;
+}
+
 FileMgrImpl::FileMgrImpl(Linker *linker) : linker(linker) {
   type = OSDK_COMMAND_DEVICE_TYPE_NONE;
   index = 0;
   fileListHandler = new DownloadListHandler();
-  fileDataHandler = new DownloadDataHandler();
+  for (int i = 0; i < MAX_FILE_DATA_DOWNLOADS; i++)
+    fileDataHandlers[i] = new DownloadDataHandler(this);
   localSenderId = OSDK_COMMAND_DEVICE_ID(OSDK_COMMAND_DEVICE_TYPE_APP, 0);
   static bool registerCBFlag = false;
   if (!registerCBFlag) {
@@ -259,8 +279,8 @@ FileMgrImpl::~FileMgrImpl(){
   if (fileListHandler) {
     delete fileListHandler;
   }
-  if (fileDataHandler) {
-    delete fileDataHandler;
+  for (int i = 0; i < MAX_FILE_DATA_DOWNLOADS; i++) {
+    if (fileDataHandlers[i]) delete fileDataHandlers[i];
   }
 }
 
@@ -274,7 +294,7 @@ ErrorCode::ErrorCodeType FileMgrImpl::SendReqFileListPack() {
   setting->task_id = DJI_GENERAL_DOWNLOAD_FILE_TASK_TYPE_LIST;
   setting->func_id = DJI_GENERAL_DOWNLOAD_FILE_FUNC_TYPE_REQ;
   setting->msg_flag = 0;
-  setting->session_id = 999;
+  setting->session_id = FILE_LIST_SESSION_ID;
   setting->seq = 0;
 
   dji_file_list_download_req reqData = {0};
@@ -320,7 +340,7 @@ ErrorCode::ErrorCodeType FileMgrImpl::SendReqFileListPack() {
                                  ErrorCode::CameraCommon, ackData[0]);
 }
 
-ErrorCode::ErrorCodeType FileMgrImpl::SendReqFileDataPack(int fileIndex) {
+ErrorCode::ErrorCodeType FileMgrImpl::SendReqFileDataPack(DownloadDataHandler *handler) {
   uint8_t reqBuf[1024] = {0};
   dji_general_transfer_msg_req
       *setting = (dji_general_transfer_msg_req *) reqBuf;
@@ -329,12 +349,12 @@ ErrorCode::ErrorCodeType FileMgrImpl::SendReqFileDataPack(int fileIndex) {
   setting->task_id = DJI_GENERAL_DOWNLOAD_FILE_TASK_TYPE_FILE;
   setting->func_id = DJI_GENERAL_DOWNLOAD_FILE_FUNC_TYPE_REQ;
   setting->msg_flag = 0;
-  setting->session_id = 999;
+  setting->session_id = handler->sessionId;
   setting->seq = 0;
 
   dji_file_download_req reqData = {0};
   reqData.index.drive = 0;
-  reqData.index.index = fileIndex;
+  reqData.index.index = handler->curTargetFileIndex;
   reqData.count = 1;
   reqData.type = DJI_MEDIA;
   reqData.sub_index = 0;
@@ -355,7 +375,7 @@ ErrorCode::ErrorCodeType FileMgrImpl::SendReqFileDataPack(int fileIndex) {
   cmdInfo.needAck = OSDK_COMMAND_NEED_ACK_FINISH_ACK;
   cmdInfo.packetType = OSDK_COMMAND_PACKET_TYPE_REQUEST;
   cmdInfo.addr = GEN_ADDR(0, ADDR_V1_COMMAND_INDEX);
-  cmdInfo.receiver = OSDK_COMMAND_DEVICE_ID(type, index);
+  cmdInfo.receiver = OSDK_COMMAND_DEVICE_ID(handler->type, handler->index);
   cmdInfo.sender = localSenderId; //linker->getLocalSenderId();
 
   E_OsdkStat linkAck =
@@ -405,9 +425,15 @@ FileMgrImpl::FileNameRule FileMgrImpl::getNameRule() {
   }
 }
 
+bool FileMgrImpl::isFileDataIdle() {
+  for (int i = 0; i < MAX_FILE_DATA_DOWNLOADS; i++) {
+    if (fileDataHandlers[i]->downloadState != DOWNLOAD_IDLE) return false;
+  }
+  return true;
+}
+
 ErrorCode::ErrorCodeType FileMgrImpl::startReqFileList(FileMgr::FileListReqCBType cb, void* userData) {
-  if ((fileListHandler->downloadState == DOWNLOAD_IDLE) &&
-      (fileDataHandler->downloadState == DOWNLOAD_IDLE)) {
+  if ((fileListHandler->downloadState == DOWNLOAD_IDLE) && isFileDataIdle()) {
     nameRule = getNameRule();
     fileListHandler->downloadState = RECVING_FILE_LIST;
     if (fileListHandler->download_buffer_) {
@@ -434,32 +460,49 @@ ErrorCode::ErrorCodeType FileMgrImpl::startReqFileList(FileMgr::FileListReqCBTyp
 }
 
 ErrorCode::ErrorCodeType FileMgrImpl::startReqFileData(int fileIndex, std::string localPath, FileMgr::FileDataReqCBType cb, void* userData) {
-  if ((fileListHandler->downloadState == DOWNLOAD_IDLE) &&
-    (fileDataHandler->downloadState == DOWNLOAD_IDLE)) {
-    fileDataHandler->downloadState = RECVING_FILE_DATA;
-
-    fileDataHandler->downloadPath = localPath;
-    fileDataHandler->mmap_file_buffer_->currentLogFilePath = localPath;
-    DSTATUS("currentLogFilePath = %s", localPath.c_str());
+  if (fileListHandler->downloadState != DOWNLOAD_IDLE) {
+    DERROR("Current state cannot support to do downloading ...");
+    return ErrorCode::CameraCommonErr::InvalidState;
+  }
 
-    fileDataHandler->reqCB = cb;
-    fileDataHandler->reqCBUserData = userData;
-    fileDataHandler->curTargetFileIndex = fileIndex;
+  DownloadDataHandler *handler = NULL;
+  for (int i = 0; i < MAX_FILE_DATA_DOWNLOADS; i++) {
+    int idle = DOWNLOAD_IDLE;
+    if (fileDataHandlers[i]->downloadState.compare_exchange_strong(idle, RECVING_FILE_DATA)) {
+      handler = fileDataHandlers[i];
+      break;
+    }
+  }
+  if (!handler) {
+    DERROR("Already %d files downloading, cannot support one more ...", MAX_FILE_DATA_DOWNLOADS);
+    return ErrorCode::CameraCommonErr::InvalidState;
+  }
 
-    if (fileDataHandler->range_handler_)delete (fileDataHandler->range_handler_);
-    fileDataHandler->range_handler_ = new CommonDataRangeHandler();
-    if (!fileDataHandler->range_handler_) return ErrorCode::SysCommonErr::AllocMemoryFailed;
+  handler->downloadPath = localPath;
+  handler->reassembler_->reset(localPath);
+  DSTATUS("currentLogFilePath = %s", localPath.c_str());
+
+  handler->reqCB = cb;
+  handler->reqCBUserData = userData;
+  handler->curTargetFileIndex = fileIndex;
+  handler->sessionId = createNextReqSessionId();
+  handler->type = type;
+  handler->index = index;
+  handler->nackPending = false;
+  handler->lastPrintBytes = 0;
+  handler->lastPrintMs = 0;
+  uint32_t curMs = 0;
+  OsdkOsal_GetTimeMs(&curMs);
+  handler->updateTimeMs = curMs;
+  /*! From here on the packs of this session are accepted */
+  handler->finishStat = FILE_DATA_RUNNING;
 
-    /*! Create file data req task */
-    OsdkOsal_TaskCreate(&reqFileDataHandle,
-                        (void *(*)(void *)) (&fileDataMonitorTask),
-                        OSDK_TASK_STACK_SIZE_DEFAULT, this);
+  /*! Create file data req task */
+  OsdkOsal_TaskCreate(&handler->monitorHandle,
+                      (void *(*)(void *)) (&fileDataMonitorTask),
+                      OSDK_TASK_STACK_SIZE_DEFAULT, handler);
 
-    return SendReqFileDataPack(fileIndex);
-  } else {
-    DERROR("Current state cannot support to do downloading ...");
-    return ErrorCode::CameraCommonErr::InvalidState;
-  }
+  return SendReqFileDataPack(handler);
 }
 
 /**
@@ -717,111 +760,6 @@ FilePackage FileMgrImpl::parseFileList(std::list<DataPointer> fullDataList) {
   return pack;
 }
 
-#define SIZE_LIMIT 0
-bool FileMgrImpl::parseFileData(dji_general_transfer_msg_ack *rsp) {
-  MmapFileBuffer *mfile = fileDataHandler->mmap_file_buffer_;
-  if (rsp->seq == 0) {
-    /*! 1. 是第一包,parse文件大小 */
-    auto resp = (dji_file_data_download_resp *) (rsp->data);
-    /*! 2. 文件总大小计算 */
-    uint32_t file_size = resp->size - (sizeof(dji_file_data_download_resp) - sizeof(uint8_t));
-    mfile->init(fileDataHandler->downloadPath, file_size);
-    /*! 3. 本包数据总大小计算 */
-    uint32_t data_size = rsp->msg_length;
-    data_size -= sizeof(dji_general_transfer_msg_ack) - sizeof(uint8_t);
-    data_size -= sizeof(dji_file_data_download_resp) - sizeof(uint8_t);
-    if (mfile->InsertBlock(resp->file_data, data_size, mfile->curFilePos))
-      mfile->curFilePos += data_size;
-  }
-  else
-  {
-    /*! 1. 本包数据总大小计算 */
-    uint32_t data_size = rsp->msg_length;
-    data_size -= sizeof(dji_general_transfer_msg_ack) - sizeof(uint8_t);
-    if (mfile->InsertBlock(rsp->data, data_size, mfile->curFilePos))
-      mfile->curFilePos += data_size;
-  }
-
-#if 0
-    size_t chunk_index = 0;
-  ParsingFileListStateEnum parsingState = PARSING_TOTAL_HEADER;
-  DataPointer dataPtr = {
-      .data = rsp,
-      .length = rsp->msg_length
-  };
-
-  while (chunk_index < dataPtr.length) {
-    switch (parsingState) {
-      case PARSING_TOTAL_HEADER: {
-        chunk_index = 0;
-        uint32_t consumeBytes = sizeof(dji_general_transfer_msg_ack) - sizeof(uint8_t);
-        auto buffer = ConsumeChunk(dataPtr, chunk_index, consumeBytes);
-        if (buffer.index == consumeBytes) {
-          auto data = (dji_general_transfer_msg_ack *) (buffer.data);
-          parsingState = (data->seq == 0) ? PARSING_DATA_HEADER : PARSING_FILEDATA;
-        } else {
-          parsingState = PARSE_FINISH;
-        }
-        break;
-      }
-      case PARSING_DATA_HEADER: {
-        uint32_t consumeBytes = sizeof(dji_file_data_download_resp) - sizeof(uint8_t);
-        auto buffer = ConsumeChunk(dataPtr, chunk_index, consumeBytes);
-        if (buffer.index == consumeBytes) {
-          auto data = (dji_file_data_download_resp *) (buffer.data);
-          uint32_t file_size = data->size - (sizeof(dji_file_data_download_resp) - sizeof(uint8_t));
-          this->mmap_file_buffer_->init(this->currentLogFilePath, file_size);
-#if SIZE_LIMIT
-          uint32_t targetFileSize = *(uint32_t *)(buffer.data + 4);
-          uint32_t targetFileIndex = *(uint32_t *)(buffer.data + 8);
-          DSTATUS("### The size of the current target file (index:%d) : %d", targetFileIndex, targetFileSize);
-          if (targetFileSize > 2*1024*1024) {
-            DERROR("### The size of the current target file (index:%d) : %d", targetFileIndex, targetFileSize);
-            DERROR("### Current download function support only single file which is smaller than"
-                   "2MB. It will be optimized in the future.");
-            DERROR("### So sorry that this download request will go falied");
-            this->closeFile();
-            this->downloadState = DOWNLOAD_IDLE;
-            return false;
-          }
-#endif
-          parsingState = PARSING_FILEDATA;
-        } else {
-          parsingState = PARSE_FINISH;
-        }
-        break;
-      }
-      case PARSING_FILEDATA: {
-        uint32_t consumeBytes = dataPtr.length - chunk_index; // 消耗完
-        if (consumeBytes == 0) {
-          //DSTATUS("##Parse 完了");
-          parsingState = PARSE_FINISH;
-          break;
-        }
-        auto buffer = ConsumeChunk(dataPtr, chunk_index, consumeBytes);
-        if (buffer.index == consumeBytes) {
-          //DSTATUS("##記錄文件數據, %dBytes", buffer.index);
-          if (rsp->seq * 800 + buffer.index <= mmap_file_buffer_->fdAddrSize)
-            mmap_file_buffer_->InsertBlock(buffer.data, buffer.index, rsp->seq);
-          parsingState = PARSING_FILEDATA;
-        } else {
-          //DSTATUS("##Parse 完了");
-          parsingState = PARSE_FINISH;
-        }
-        break;
-      }
-      case PARSE_FINISH:
-        parsingState = PARSING_TOTAL_HEADER;
-        return true;
-        break;
-      default:break;
-    }
-  }
-#endif
-
-  return false;
-}
-
 void FileMgrImpl::fileListRawDataCB(dji_general_transfer_msg_ack *rsp) {
   int temp = fileListHandler->downloadState;
   if (fileListHandler->downloadState == DOWNLOAD_IDLE) return;
@@ -845,7 +783,7 @@ void FileMgrImpl::fileListRawDataCB(dji_general_transfer_msg_ack *rsp) {
       std::list<DataPointer> dataList = download_buffer_->DequeueAllBuffer();
       FilePackage file_package = parseFileList(dataList);
 
-      SendAbortPack(DJI_GENERAL_DOWNLOAD_FILE_TASK_TYPE_LIST);
+      SendAbortPack(DJI_GENERAL_DOWNLOAD_FILE_TASK_TYPE_LIST, type, index, FILE_LIST_SESSION_ID);
       if (fileListHandler->reqCB) {
         fileListHandler->reqCB(OSDK_STAT_OK, file_package, fileListHandler->reqCBUserData);
         fileListHandler->reqCB = NULL;
@@ -856,45 +794,49 @@ void FileMgrImpl::fileListRawDataCB(dji_general_transfer_msg_ack *rsp) {
     }
 }
 
-void FileMgrImpl::fileDataRawDataCB(dji_general_transfer_msg_ack *rsp) {
-  if (fileDataHandler->downloadState == DOWNLOAD_IDLE) return;
-  auto range_handler_ = fileDataHandler->range_handler_;
-  auto mmap_file_buffer_ = fileDataHandler->mmap_file_buffer_;
-  if (range_handler_) {
-    range_handler_->AddSeqIndex(rsp->seq, 0, (uint32_t)(-1));
+/*! Packs of a session go to its download. A camera that does not echo the
+ *  session id can only be served one file at a time.
+ */
+DownloadDataHandler *FileMgrImpl::findFileDataHandler(uint16_t sessionId) {
+  DownloadDataHandler *onlyOne = NULL;
+  int activeCnt = 0;
+  for (int i = 0; i < MAX_FILE_DATA_DOWNLOADS; i++) {
+    DownloadDataHandler *handler = fileDataHandlers[i];
+    if ((handler->downloadState != RECVING_FILE_DATA) ||
+        (handler->finishStat != FILE_DATA_RUNNING))
+      continue;
+    if (handler->sessionId == sessionId) return handler;
+    onlyOne = handler;
+    activeCnt++;
   }
+  return (activeCnt == 1) ? onlyOne : NULL;
+}
+
+void FileMgrImpl::fileDataRawDataCB(dji_general_transfer_msg_ack *rsp) {
+  DownloadDataHandler *handler = findFileDataHandler(rsp->session_id);
+  if (!handler) return;
 
   /*! refresh the time stamp */
   uint32_t curMs = 0;
   OsdkOsal_GetTimeMs(&curMs);
-  fileDataHandler->updateTimeMs = curMs;
+  handler->updateTimeMs = curMs;
 
   /*! do data parsing, 边收边解包 */
-  parseFileData(rsp);
-
-  /*! 看看是否拿到了最后一个包 或者丢包了 */
-  bool packFinishFlag = false;
-  bool packLossFlag = false;
-  if ((rsp->msg_flag & 0x01) &&
-      (range_handler_->GetLastNotReceiveSeq() == rsp->seq + 1)) {
-    DSTATUS("Got the last one pack .");
-    packFinishFlag = true;
-  }
-  if (range_handler_->GetNoAckRanges().size() != 0) {
-    DERROR("pack loss !!!");
-    packLossFlag = true;
-  }
-
-  if (packLossFlag || packFinishFlag) {
-    E_OsdkStat ret =
-      (packFinishFlag && !packLossFlag) ? OSDK_STAT_OK : OSDK_STAT_SYS_ERR;
-    SendAbortPack(DJI_GENERAL_DOWNLOAD_FILE_TASK_TYPE_FILE);
-    if (fileDataHandler->reqCB) {
-      fileDataHandler->reqCB(ret, fileDataHandler->reqCBUserData);
-      fileDataHandler->reqCB = NULL;
-    }
-    DSTATUS("Finish req filedata task, reset downloadState to be DOWNLOAD_IDLE");
-    fileDataHandler->downloadState = DOWNLOAD_IDLE;
+  bool newGap = false;
+  FileDataReassembler::PackResult result =
+    handler->reassembler_->insertPack(rsp, newGap);
+
+  if (result == FileDataReassembler::PACK_INVALID) {
+    DERROR("Invalid pack %d in session %d", rsp->seq, (int) handler->sessionId);
+    finishFileData(handler, OSDK_STAT_SYS_ERR);
+  } else if ((result == FileDataReassembler::PACK_STORED) &&
+             handler->reassembler_->isComplete()) {
+    DSTATUS("Got all packs of session %d.", (int) handler->sessionId);
+    finishFileData(handler, OSDK_STAT_OK);
+  } else if (newGap) {
+    /*! NACK right away instead of waiting for the next ack period */
+    handler->nackPending = true;
+    OsdkOsal_SemaphorePost(handler->eventSem);
   }
 }
 
@@ -902,11 +844,8 @@ void FileMgrImpl::fileDataRawDataCB(dji_general_transfer_msg_ack *rsp) {
 void FileMgrImpl::OnReceiveDataPack(dji_general_transfer_msg_ack *rsp) {
   if (rsp->func_id != DJI_GENERAL_DOWNLOAD_FILE_FUNC_TYPE_DATA) return;
 
-  static uint32_t lastSeq = 0;
   //DSTATUS("\033[1;32;40m##[seq] = %d; [len] = %d; [flag] = %d;\033[0m", rsp->seq, rsp->msg_length, rsp->msg_flag);
-  if (rsp->seq == 0) DSTATUS("[First pack] get the first pack");
-  else if (rsp->seq != lastSeq + 1) DSTATUS("[Skip packs]------------------->skip seq : lastSeq = %d, rsp->seq = %d", lastSeq, rsp->seq);
-  lastSeq = rsp->seq;
+  if (rsp->seq == 0) DSTATUS("[First pack] get the first pack of session %d", rsp->session_id);
 
 #if LOG_EVERY_PACK
   DSTATUS(
@@ -953,7 +892,8 @@ void FileMgrImpl::HandlePushPack(dji_general_transfer_msg_ack *rsp) {
 }
 
 ErrorCode::ErrorCodeType FileMgrImpl::SendAbortPack(
-    DJI_GENERAL_DOWNLOAD_FILE_TASK_TYPE taskId) {
+    DJI_GENERAL_DOWNLOAD_FILE_TASK_TYPE taskId, E_OSDKCommandDeiveType type,
+    uint8_t index, uint16_t sessionId) {
   DSTATUS("SendAbortPack");
   uint8_t reqBuf[1024] = {0};
   dji_general_transfer_msg_req
@@ -963,7 +903,7 @@ ErrorCode::ErrorCodeType FileMgrImpl::SendAbortPack(
   setting->task_id = taskId;
   setting->func_id = DJI_GENERAL_DOWNLOAD_FILE_FUNC_TYPE_ABORT;
   setting->msg_flag = 1;
-  setting->session_id = 999;
+  setting->session_id = sessionId;
   setting->seq = 0;
 /*
   uint32_t abortReason = TransAbortReasonForce;
@@ -995,16 +935,16 @@ ErrorCode::ErrorCodeType FileMgrImpl::SendAbortPack(
 }
 
 
-ErrorCode::ErrorCodeType FileMgrImpl::SendACKPack(DJI_GENERAL_DOWNLOAD_FILE_TASK_TYPE taskId, dji_download_ack *ack) {
+ErrorCode::ErrorCodeType FileMgrImpl::SendACKPack(DownloadDataHandler *handler, dji_download_ack *ack) {
   uint8_t reqBuf[1024] = {0};
   dji_general_transfer_msg_req
       *setting = (dji_general_transfer_msg_req *) reqBuf;
   setting->version = 1;
   setting->header_length = 10;
-  setting->task_id = taskId;
+  setting->task_id = DJI_GENERAL_DOWNLOAD_FILE_TASK_TYPE_FILE;
   setting->func_id = DJI_GENERAL_DOWNLOAD_FILE_FUNC_TYPE_ACK;
   setting->msg_flag = 0;
-  setting->session_id = 999;
+  setting->session_id = handler->sessionId;
   setting->seq = 0;
 
   uint32_t reqDataLen = sizeof(dji_download_ack) - sizeof(dji_loss_desc) + ack->loss_nr * sizeof(dji_loss_desc);
@@ -1021,7 +961,7 @@ ErrorCode::ErrorCodeType FileMgrImpl::SendACKPack(DJI_GENERAL_DOWNLOAD_FILE_TASK
   cmdInfo.needAck = OSDK_COMMAND_NEED_ACK_NO_NEED;
   cmdInfo.packetType = OSDK_COMMAND_PACKET_TYPE_REQUEST;
   cmdInfo.addr = GEN_ADDR(0, ADDR_V1_COMMAND_INDEX);
-  cmdInfo.receiver = OSDK_COMMAND_DEVICE_ID(type, index);
+  cmdInfo.receiver = OSDK_COMMAND_DEVICE_ID(handler->type, handler->index);
   cmdInfo.sender = localSenderId; //linker->getLocalSenderId();
 
 //  printf("-------------->request data :\n");
@@ -1040,38 +980,15 @@ ErrorCode::ErrorCodeType FileMgrImpl::SendACKPack(DJI_GENERAL_DOWNLOAD_FILE_TASK
   return ErrorCode::SysCommonErr::Success;
 }
 
-ErrorCode::ErrorCodeType FileMgrImpl::SendMissedAckPack(DJI_GENERAL_DOWNLOAD_FILE_TASK_TYPE taskId) {
-  CommonDataRangeHandler *range_handler_;
-  if (taskId == DJI_GENERAL_DOWNLOAD_FILE_TASK_TYPE_LIST)
-    range_handler_ = fileListHandler->range_handler_;
-  else if (taskId == DJI_GENERAL_DOWNLOAD_FILE_TASK_TYPE_FILE)
-    range_handler_ = fileDataHandler->range_handler_;
-  else return ErrorCode::SysCommonErr::ReqNotSupported;
-
-  std::vector<Range> ranges = range_handler_->GetNoAckRanges();
-  if(ranges.empty()) {
-    uint8_t buf[1024] = {0};
-    dji_download_ack *ack = (dji_download_ack *)buf;
-    ack->expect_seq = range_handler_->GetLastNotReceiveSeq();
-    ack->loss_nr = 0;
-    //DSTATUS("[Confirming ...]---------------ack->expect_seq = %d ack->loss_nr = %d", ack->expect_seq, ack->loss_nr);
-    SendACKPack(taskId, ack);
-    return OSDK_STAT_OK;
-  }
-
-  auto rangeCnt = ranges.size() > 1 ? 1 : ranges.size();
-  uint8_t buf[1024] = {0};
+ErrorCode::ErrorCodeType FileMgrImpl::SendMissedAckPack(DownloadDataHandler *handler) {
+  uint8_t buf[sizeof(dji_download_ack) + (FILE_DATA_MAX_NACK_RANGES - 1) * sizeof(dji_loss_desc)] = {0};
   dji_download_ack *ack = (dji_download_ack *)buf;
-  ack->expect_seq = ranges[0].seq_num;
-  ack->loss_nr = rangeCnt;
-  DSTATUS("[ReqMissingPack ...]---------------ack->expect_seq = %d ack->loss_nr = %d", ack->expect_seq, ack->loss_nr);
-  for (int i = 0; i < rangeCnt; i++) {
-    auto range = ranges[i];
-    ack->loss_desc[i].seq = range.seq_num;
-    ack->loss_desc[i].cnt = range.length;
-    DSTATUS("[MissPack]---------------loss[%d] range.seq_num = %d, range.length = %d", i, range.seq_num, range.length);
+  uint32_t holes = handler->reassembler_->fillAck(ack, FILE_DATA_MAX_NACK_RANGES);
+  if (holes) {
+    DSTATUS("[ReqMissingPack ...]---------------session = %d ack->expect_seq = %d ack->loss_nr = %d (of %d)",
+            (int) handler->sessionId, ack->expect_seq, ack->loss_nr, holes);
   }
-  return SendACKPack(taskId, ack);
+  return SendACKPack(handler, ack);
 }
 
 DownloadListHandler::DownloadListHandler() : reqCB(nullptr), reqCBUserData(nullptr) {
@@ -1085,13 +1002,18 @@ DownloadListHandler::~DownloadListHandler() {
   if (download_buffer_) delete download_buffer_;
 }
 
-DownloadDataHandler::DownloadDataHandler() : reqCB(nullptr), reqCBUserData(nullptr) {
-  range_handler_ = new CommonDataRangeHandler();
-  mmap_file_buffer_ = new MmapFileBuffer();
+DownloadDataHandler::DownloadDataHandler(FileMgrImpl *impl)
+    : impl(impl), reqCB(nullptr), reqCBUserData(nullptr), eventSem(NULL) {
+  reassembler_ = new FileDataReassembler();
   downloadState = DOWNLOAD_IDLE;
+  finishStat = OSDK_STAT_OK;
+  sessionId = 0;
+  nackPending = false;
+  if (OsdkOsal_SemaphoreCreate(&eventSem, 0) != OSDK_STAT_OK)
+    DERROR("Create download event semaphore failed");
 }
 
 DownloadDataHandler::~DownloadDataHandler() {
-  if (range_handler_) delete range_handler_;
-  if (mmap_file_buffer_) delete mmap_file_buffer_;
+  if (reassembler_) delete reassembler_;
+  if (eventSem) OsdkOsal_SemaphoreDestroy(eventSem);
 }
\ No newline at end of file
@@ -0,0 +1,208 @@
+/** @file file_data_reassembler.cpp
+ *  @version 4.0.0
+ *  @date Oct 2026
+ *
+ *  @brief Places file download packs straight into the mapped target file
+ *
+ *  @Copyright (c) 2026 DJI
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#include "file_data_reassembler.hpp"
+#include "dji_log.hpp"
+#include <iterator>
+
+using namespace DJI::OSDK;
+
+#define TRANSFER_ACK_HEADER_LEN (sizeof(dji_general_transfer_msg_ack) - 1)
+#define FILE_DATA_RESP_HEADER_LEN (sizeof(dji_file_data_download_resp) - 1)
+
+FileDataReassembler::FileDataReassembler() : fileOpened(false) {
+  reset(std::string());
+  active = false;
+}
+
+FileDataReassembler::~FileDataReassembler() { close(); }
+
+void FileDataReassembler::reset(const std::string &path) {
+  std::lock_guard<std::mutex> lock(mutex);
+  if (fileOpened) file.deInit();
+  this->path = path;
+  active = true;
+  fileOpened = false;
+  received.clear();
+  recvPacks = 0;
+  recvBytes = 0;
+  nextSeq = 0;
+  lastKnown = false;
+  lastSeq = 0;
+  fileSize = 0;
+  firstDataSize = 0;
+  chunkSize = 0;
+}
+
+bool FileDataReassembler::isReceived(uint32_t seq) const {
+  auto it = received.upper_bound(seq);
+  if (it == received.begin()) return false;
+  --it;
+  return seq < it->second;
+}
+
+void FileDataReassembler::markReceived(uint32_t seq) {
+  auto next = received.upper_bound(seq);
+  bool joinNext = (next != received.end()) && (next->first == seq + 1);
+  if (next != received.begin()) {
+    auto prev = std::prev(next);
+    if (prev->second == seq) {
+      prev->second = joinNext ? next->second : seq + 1;
+      if (joinNext) received.erase(next);
+      recvPacks++;
+      return;
+    }
+  }
+  if (joinNext) {
+    uint32_t end = next->second;
+    received.erase(next);
+    received[seq] = end;
+  } else {
+    received[seq] = seq + 1;
+  }
+  recvPacks++;
+}
+
+bool FileDataReassembler::openFile(const dji_general_transfer_msg_ack *rsp,
+                                   uint32_t dataSize) {
+  if (dataSize < FILE_DATA_RESP_HEADER_LEN) return false;
+  auto resp = (const dji_file_data_download_resp *) (rsp->data);
+  if (resp->size < FILE_DATA_RESP_HEADER_LEN) return false;
+  fileSize = resp->size - FILE_DATA_RESP_HEADER_LEN;
+  firstDataSize = dataSize - FILE_DATA_RESP_HEADER_LEN;
+  if (firstDataSize > fileSize) return false;
+  if (!file.init(path, fileSize)) {
+    DERROR("Can not map %s for downloading", path.c_str());
+    return false;
+  }
+  fileOpened = true;
+  return true;
+}
+
+FileDataReassembler::PackResult FileDataReassembler::insertPack(
+    const dji_general_transfer_msg_ack *rsp, bool &newGap) {
+  newGap = false;
+  std::lock_guard<std::mutex> lock(mutex);
+  if (!active) return PACK_DROPPED;
+  if (rsp->msg_length < TRANSFER_ACK_HEADER_LEN) return PACK_INVALID;
+
+  uint32_t seq = rsp->seq;
+  uint32_t dataSize = rsp->msg_length - TRANSFER_ACK_HEADER_LEN;
+  bool isLast = (rsp->msg_flag & 0x01);
+
+  if (seq >= nextSeq) {
+    newGap = (seq > nextSeq);
+    nextSeq = seq + 1;
+  }
+  if (isLast) {
+    lastKnown = true;
+    lastSeq = seq;
+  }
+  if (isReceived(seq)) return PACK_DUPLICATE;
+
+  const uint8_t *data = rsp->data;
+  uint64_t offset = 0;
+  if (seq == 0) {
+    if (!openFile(rsp, dataSize)) return PACK_INVALID;
+    data = ((const dji_file_data_download_resp *) rsp->data)->file_data;
+    dataSize = firstDataSize;
+  } else {
+    if (!fileOpened) return PACK_DROPPED;
+    if (chunkSize == 0) {
+      /*! The last pack is short, only a full one tells the chunk size */
+      if (!isLast) chunkSize = dataSize;
+      else if (seq != 1) return PACK_DROPPED;
+    }
+    if (!isLast && dataSize != chunkSize) {
+      DERROR("Pack %u has %u bytes, expected %u", seq, dataSize, chunkSize);
+      return PACK_INVALID;
+    }
+    offset = firstDataSize + (uint64_t) (seq - 1) * chunkSize;
+  }
+
+  if ((offset + dataSize > fileSize) ||
+      (isLast && (offset + dataSize != fileSize))) {
+    DERROR("Pack %u does not fit in the file of %llu bytes", seq,
+           (unsigned long long) fileSize);
+    return PACK_INVALID;
+  }
+  if (dataSize) file.InsertBlock(data, dataSize, offset);
+  markReceived(seq);
+  recvBytes += dataSize;
+  return PACK_STORED;
+}
+
+bool FileDataReassembler::isComplete() {
+  std::lock_guard<std::mutex> lock(mutex);
+  return lastKnown && (received.size() == 1) &&
+         (received.begin()->first == 0) &&
+         (received.begin()->second > lastSeq);
+}
+
+uint32_t FileDataReassembler::fillAck(dji_download_ack *ack,
+                                      uint8_t maxLoss) {
+  std::lock_guard<std::mutex> lock(mutex);
+  uint32_t end = lastKnown ? lastSeq + 1 : nextSeq;
+  uint32_t holes = 0;
+  uint32_t from = 0;
+
+  ack->expect_seq = (!received.empty() && received.begin()->first == 0)
+                    ? received.begin()->second : 0;
+  ack->loss_nr = 0;
+  for (auto it = received.begin(); from < end; ++it) {
+    uint32_t to = (it == received.end() || it->first > end) ? end : it->first;
+    if (to > from) {
+      if (holes < maxLoss) {
+        ack->loss_desc[holes].seq = from;
+        ack->loss_desc[holes].cnt = to - from;
+        ack->loss_nr = holes + 1;
+      }
+      holes++;
+    }
+    if (it == received.end()) break;
+    from = it->second;
+  }
+  return holes;
+}
+
+void FileDataReassembler::getProgress(uint64_t &recvBytes, uint64_t &fileSize,
+                                      uint32_t &recvPacks,
+                                      uint32_t &lossPacks) {
+  std::lock_guard<std::mutex> lock(mutex);
+  recvBytes = this->recvBytes;
+  fileSize = this->fileSize;
+  recvPacks = this->recvPacks;
+  lossPacks = nextSeq - this->recvPacks;
+}
+
+void FileDataReassembler::close() {
+  std::lock_guard<std::mutex> lock(mutex);
+  active = false;
+  if (fileOpened) file.deInit();
+  fileOpened = false;
+}
@@ -3,14 +3,17 @@
 //
 #include "mmap_file_buffer.hpp"
 #include "dji_log.hpp"
+#include <stdio.h>
 #include <string.h>
 
 namespace DJI {
 namespace OSDK {
 
-MmapFileBuffer::MmapFileBuffer() : fdAddr(NULL), curFilePos(0) {}
+MmapFileBuffer::MmapFileBuffer() : fd(-1), fdAddr(NULL), fdAddrSize(0), curFilePos(0) {}
 
-MmapFileBuffer::~MmapFileBuffer() {}
+MmapFileBuffer::~MmapFileBuffer() {
+  if (fd >= 0) deInit();
+}
 
 bool MmapFileBuffer::init(std::string path, uint64_t fileSize) {
   currentLogFilePath = path;
@@ -21,13 +24,20 @@ bool MmapFileBuffer::init(std::string path, uint64_t fileSize) {
   DSTATUS("fd = %d", fd);
   if (fd < 0) return false;
 
-  ftruncate(fd, fdAddrSize);
-  fdAddr = (char *) mmap(NULL, fdAddrSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  if (ftruncate(fd, fdAddrSize) != 0) {
+    deInit();
+    return false;
+  }
+  /*! An empty file has nothing to map */
+  if (fdAddrSize == 0) return true;
 
-  if (fdAddr)
-    return true;
-  else
+  void *addr = mmap(NULL, fdAddrSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  if (addr == MAP_FAILED) {
+    deInit();
     return false;
+  }
+  fdAddr = (char *) addr;
+  return true;
 }
 
 bool MmapFileBuffer::deInit() {
@@ -46,7 +56,7 @@ bool MmapFileBuffer::InsertBlock(const uint8_t *pack, uint32_t data_length, uint
   static uint32_t tempAdaptingBufferCnt = 0;
   if (index == 1) tempAdaptingBufferCnt = data_length;
 #endif
-  if ((data_length <= 0) || !fdAddr) {
+  if ((data_length <= 0) || !fdAddr || (index + data_length > fdAddrSize)) {
     return false;
   }
 #if 0
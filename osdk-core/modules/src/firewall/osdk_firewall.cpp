@@ -41,6 +41,7 @@ using namespace DJI::OSDK;
 Firewall::Firewall(Linker *linker)
     : linker(linker), policyUpdated(false), appKeyBuffer({{0}, 0}) {
   OsdkOsal_MutexCreate(&policyUpdatedMutex);
+  OsdkOsal_SemaphoreCreate(&policyUpdatedSem, 0);
   OsdkOsal_MutexCreate(&appKeyBufferMutex);
   DSTATUS("Firewall is initializing ...");
   static T_RecvCmdItem bulkCmdList[] = {
@@ -60,19 +61,22 @@ Firewall::Firewall(Linker *linker)
   if (this->linker->isUSBPlugged()
       && !isPolicyUpdated()) {
    // setAppKey((uint8_t *) data->encKey, strlen(data->encKey) - 1);
-    do {
-      retryTimes ++;
+    DSTATUS("osdk policy file updating(1) ......");
+    while ((!RequestUpdatePolicy()) && (++retryTimes < 15)) {
       DSTATUS("osdk policy file updating(1) ......");
       OsdkOsal_TaskSleepMs(1000);
-    } while ((!RequestUpdatePolicy()) && (retryTimes < 15));
+    }
 
-    /*! pending for firewall logic finished */
-    retryTimes = 0;
-    do {
-      retryTimes++;
+    /*! pending for firewall logic finished, woken up by the upload handler */
+    uint32_t waitStartMs = 0;
+    uint32_t nowMs = 0;
+    OsdkOsal_GetTimeMs(&waitStartMs);
+    nowMs = waitStartMs;
+    while ((!isPolicyUpdated()) && (nowMs - waitStartMs < 15000)) {
       DSTATUS("osdk policy file updating(2) ......");
-      OsdkOsal_TaskSleepMs(1000);
-    } while ((!isPolicyUpdated()) && (retryTimes < 15));
+      OsdkOsal_SemaphoreTimedWait(policyUpdatedSem, 1000);
+      OsdkOsal_GetTimeMs(&nowMs);
+    }
   }
   E_OsdkStat osdkStat = OsdkOsal_TaskCreate(&firewallTaskHandle,
                                             (void *(*)(
@@ -83,6 +87,7 @@ Firewall::Firewall(Linker *linker)
 
 Firewall::~Firewall() {
   OsdkOsal_TaskDestroy(firewallTaskHandle);
+  OsdkOsal_SemaphoreDestroy(policyUpdatedSem);
 }
 
 bool Firewall::checkFireWallConnection() {
@@ -311,6 +316,7 @@ void Firewall::setPolicyUpdated(bool value) {
   OsdkOsal_MutexLock(policyUpdatedMutex);
   policyUpdated = value;
   OsdkOsal_MutexUnlock(policyUpdatedMutex);
+  if (value) OsdkOsal_SemaphorePost(policyUpdatedSem);
 }
 
 osdk_app_key_buffer_type Firewall::getAppKey() {
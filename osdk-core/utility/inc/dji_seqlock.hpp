@@ -0,0 +1,175 @@
+/** @file dji_seqlock.hpp
+ *  @version 4.0.0
+ *  @date Oct 2026
+ *
+ *  @brief Sequence lock for single-writer/multi-reader data in the DJI OSDK
+ *
+ *  @Copyright (c) 2026 DJI
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef ONBOARDSDK_DJI_SEQLOCK_H
+#define ONBOARDSDK_DJI_SEQLOCK_H
+
+#include <stdint.h>
+#include <string.h>
+#if defined(__linux__)
+#include <atomic>
+#include <sched.h>
+#else
+#include "osdk_platform.h"
+#endif
+
+namespace DJI
+{
+namespace OSDK
+{
+
+/*! @brief Sequence lock protecting a block of plain data
+ *
+ *  @details The single writer (usually the receive thread) never blocks.
+ *  Readers copy the data out and retry if a write happened meanwhile, so
+ *  any number of reader threads get a consistent copy without taking a
+ *  mutex. The sequence is odd while a write is in progress and grows by
+ *  two for every published write.
+ */
+class SeqLock
+{
+public:
+  SeqLock()
+    : sequence(0)
+  {
+  }
+
+  void writeBegin()
+  {
+#if defined(__linux__)
+    sequence.store(sequence.load(std::memory_order_relaxed) + 1,
+                   std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+#else
+    sequence = sequence + 1;
+    __sync_synchronize();
+#endif
+  }
+
+  void writeEnd()
+  {
+#if defined(__linux__)
+    sequence.store(sequence.load(std::memory_order_relaxed) + 1,
+                   std::memory_order_release);
+#else
+    __sync_synchronize();
+    sequence = sequence + 1;
+#endif
+  }
+
+  /*! @brief Spins of readBegin() before the reader gives up the CPU */
+  static const uint32_t READ_SPIN_LIMIT = 64;
+
+  /*! @brief Wait until no write is in progress and return the sequence
+   *  to be checked with readRetry() after the copy.
+   *
+   *  @details A write takes a memcpy, so the reader spins first. When the
+   *  writer was preempted instead, spinning on would starve it, so after
+   *  READ_SPIN_LIMIT spins the reader yields. Without Linux there may be a
+   *  single core and a lower priority writer, so it sleeps through the OSAL.
+   */
+  uint32_t readBegin() const
+  {
+    uint32_t start;
+    uint32_t spins = 0;
+#if defined(__linux__)
+    while ((start = sequence.load(std::memory_order_acquire)) & 1)
+    {
+      if (++spins >= READ_SPIN_LIMIT)
+      {
+        sched_yield();
+        spins = 0;
+      }
+    }
+#else
+    while ((start = sequence) & 1)
+    {
+      if (++spins >= READ_SPIN_LIMIT)
+      {
+        OsdkOsal_TaskSleepMs(1);
+        spins = 0;
+      }
+    }
+    __sync_synchronize();
+#endif
+    return start;
+  }
+
+  /*! @return true if the data read since readBegin() may be torn */
+  bool readRetry(uint32_t start) const
+  {
+#if defined(__linux__)
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return sequence.load(std::memory_order_relaxed) != start;
+#else
+    __sync_synchronize();
+    return sequence != start;
+#endif
+  }
+
+  /*! @brief Copy size bytes from src to dst as one consistent snapshot */
+  uint32_t read(void* dst, const void* src, size_t size) const
+  {
+    uint32_t start;
+    do
+    {
+      start = readBegin();
+      memcpy(dst, src, size);
+    } while (readRetry(start));
+    return start;
+  }
+
+  /*! @brief Publish size bytes from src into dst */
+  void write(void* dst, const void* src, size_t size)
+  {
+    writeBegin();
+    memcpy(dst, src, size);
+    writeEnd();
+  }
+
+  uint32_t getSequence() const
+  {
+#if defined(__linux__)
+    return sequence.load(std::memory_order_acquire);
+#else
+    return sequence;
+#endif
+  }
+
+private:
+#if defined(__linux__)
+  std::atomic<uint32_t> sequence;
+#else
+  volatile uint32_t sequence;
+#endif
+}; // class SeqLock
+
+} // namespace OSDK
+} // namespace DJI
+
+#endif // ONBOARDSDK_DJI_SEQLOCK_H
@@ -0,0 +1,52 @@
+/** @file dji_time.hpp
+ *  @version 4.0.0
+ *  @date Oct 2026
+ *
+ *  @brief Local monotonic clock for time stamps taken inside the DJI OSDK
+ *
+ *  @Copyright (c) 2026 DJI
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef ONBOARDSDK_DJI_TIME_H
+#define ONBOARDSDK_DJI_TIME_H
+
+#include <stdint.h>
+
+namespace DJI
+{
+namespace OSDK
+{
+
+/*!
+ * @brief Local time in microseconds from a clock that never steps back,
+ * for time stamps of received data, logs and recordings
+ *
+ * @details CLOCK_MONOTONIC on Linux, so the zero point is arbitrary and
+ * NTP or date changes do not move it. Elsewhere the OSAL clock is used,
+ * with millisecond resolution unless OS_DEBUG provides getTimeUs.
+ */
+uint64_t getMonotonicTimeUs();
+
+} // namespace OSDK
+} // namespace DJI
+
+#endif // ONBOARDSDK_DJI_TIME_H
@@ -0,0 +1,54 @@
+/** @file dji_time.cpp
+ *  @version 4.0.0
+ *  @date Oct 2026
+ *
+ *  @brief Local monotonic clock for time stamps taken inside the DJI OSDK
+ *
+ *  @Copyright (c) 2026 DJI
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#include "dji_time.hpp"
+
+#if defined(__linux__)
+#include <time.h>
+#else
+#include "dji_platform.hpp"
+#endif
+
+uint64_t
+DJI::OSDK::getMonotonicTimeUs()
+{
+  uint64_t timeUs = 0;
+#if defined(__linux__)
+  struct timespec time;
+  clock_gettime(CLOCK_MONOTONIC, &time);
+  timeUs = (uint64_t)time.tv_sec * 1000000 + time.tv_nsec / 1000;
+#elif defined(OS_DEBUG)
+  Platform::instance().getTimeUs(&timeUs);
+#else
+  // Only a millisecond clock here, stamps step by 1000 us
+  uint32_t timeMs = 0;
+  Platform::instance().getTimeMs(&timeMs);
+  timeUs = (uint64_t)timeMs * 1000;
+#endif
+  return timeUs;
+}
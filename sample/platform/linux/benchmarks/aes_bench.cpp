@@ -0,0 +1,182 @@
+/*! @file benchmarks/aes_bench.cpp
+ *  @version 4.0.0
+ *  @date Oct 2026
+ *
+ *  @brief
+ *  Cross-check and throughput of aes256_encrypt_ecb_blocks /
+ *  aes256_decrypt_ecb_blocks, which OpenProtocol frames are encrypted with.
+ *  The backend in use (AES-NI, ARMv8 or software) is compared with the
+ *  table AES block by block for random keys, random lengths up to the
+ *  largest frame and unaligned buffers, in both directions. Throughput is
+ *  measured for a 32 byte command, a 128 byte frame and the largest frame.
+ *
+ *  Usage: djiosdk-bench-aes [random keys] [MB per measurement]
+ *
+ *  @Copyright (c) 2026 DJI
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#include "dji_aes.hpp"
+
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+typedef std::chrono::steady_clock Clock;
+
+static const uint32_t BLOCK_SIZE = 16;
+//! OpenHeader limits a frame to 1023 bytes
+static const uint32_t MAX_BLOCKS = 1023 / BLOCK_SIZE;
+
+//! One block at a time through the table AES, as encodeData used to
+static void
+softwareEcb(bool decrypt, const uint8_t* key, uint8_t* buf, uint32_t blocks)
+{
+  aes256_context ctx;
+  aes256_init(&ctx, (uint8_t*)key);
+  for (uint32_t i = 0; i < blocks; i++)
+  {
+    if (decrypt)
+    {
+      aes256_decrypt_ecb(&ctx, buf + BLOCK_SIZE * i);
+    }
+    else
+    {
+      aes256_encrypt_ecb(&ctx, buf + BLOCK_SIZE * i);
+    }
+  }
+  aes256_done(&ctx);
+}
+
+static void
+acceleratedEcb(bool decrypt, const uint8_t* key, uint8_t* buf, uint32_t blocks)
+{
+  if (decrypt)
+  {
+    aes256_decrypt_ecb_blocks(key, buf, blocks);
+  }
+  else
+  {
+    aes256_encrypt_ecb_blocks(key, buf, blocks);
+  }
+}
+
+/*! Encrypt then decrypt the same random buffer with both implementations.
+ *  The buffer starts one byte into the allocation so it is never aligned.
+ */
+static unsigned
+crossCheck(unsigned keys)
+{
+  unsigned mismatches = 0;
+  uint8_t  key[32];
+
+  for (unsigned round = 0; round < keys; round++)
+  {
+    uint32_t             blocks = rand() % (MAX_BLOCKS + 1);
+    std::vector<uint8_t> expected(BLOCK_SIZE * blocks + 1);
+    for (size_t i = 0; i < sizeof(key); i++)
+    {
+      key[i] = rand();
+    }
+    for (size_t i = 0; i < expected.size(); i++)
+    {
+      expected[i] = rand();
+    }
+    std::vector<uint8_t> actual = expected;
+
+    for (int decrypt = 0; decrypt < 2; decrypt++)
+    {
+      softwareEcb(decrypt, key, &expected[1], blocks);
+      acceleratedEcb(decrypt, key, &actual[1], blocks);
+      if (actual != expected)
+      {
+        mismatches++;
+      }
+    }
+  }
+  return mismatches;
+}
+
+template <typename Func>
+static double
+megabytesPerSecond(Func func, bool decrypt, uint32_t blocks, size_t total)
+{
+  static uint8_t key[32] = { 0x60, 0x3d, 0xeb, 0x10, 0x15, 0xca, 0x71, 0xbe,
+                             0x2b, 0x73, 0xae, 0xf0, 0x85, 0x7d, 0x77, 0x81,
+                             0x1f, 0x35, 0x2c, 0x07, 0x3b, 0x61, 0x08, 0xd7,
+                             0x2d, 0x98, 0x10, 0xa3, 0x09, 0x14, 0xdf, 0xf4 };
+  uint8_t           buf[BLOCK_SIZE * MAX_BLOCKS];
+  size_t            bytes  = BLOCK_SIZE * blocks;
+  size_t            rounds = total / bytes + 1;
+  memset(buf, 0x5A, sizeof(buf));
+
+  Clock::time_point start = Clock::now();
+  for (size_t i = 0; i < rounds; i++)
+  {
+    func(decrypt, key, buf, blocks);
+  }
+  double seconds =
+    std::chrono::duration<double>(Clock::now() - start).count();
+  return (double)rounds * bytes / seconds / 1e6;
+}
+
+int
+main(int argc, char** argv)
+{
+  unsigned keys      = (argc > 1) ? atoi(argv[1]) : 20000;
+  unsigned megabytes = (argc > 2) ? atoi(argv[2]) : 16;
+  if (keys == 0 || megabytes == 0)
+  {
+    printf("Usage: %s [random keys] [MB per measurement]\n", argv[0]);
+    return 1;
+  }
+
+  srand(1);
+  printf("backend: %s\n", aes256_backend_name());
+  unsigned mismatches = crossCheck(keys);
+  printf("%u random keys, 0..%u blocks, both directions: %u mismatches\n\n",
+         keys, MAX_BLOCKS, mismatches);
+
+  printf("%6s %14s %14s %14s %14s\n", "bytes", "enc software", "enc backend",
+         "dec software", "dec backend");
+  const uint32_t blockCounts[] = { 2, 8, MAX_BLOCKS };
+  size_t         total         = (size_t)megabytes << 20;
+  for (size_t i = 0; i < sizeof(blockCounts) / sizeof(blockCounts[0]); i++)
+  {
+    uint32_t blocks = blockCounts[i];
+    printf("%6u %9.0f MB/s %9.0f MB/s %9.0f MB/s %9.0f MB/s\n",
+           BLOCK_SIZE * blocks,
+           megabytesPerSecond(softwareEcb, false, blocks, total),
+           megabytesPerSecond(acceleratedEcb, false, blocks, total),
+           megabytesPerSecond(softwareEcb, true, blocks, total),
+           megabytesPerSecond(acceleratedEcb, true, blocks, total));
+  }
+
+  if (mismatches)
+  {
+    printf("\nFAILED: the %s backend differs from the table AES\n",
+           aes256_backend_name());
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,384 @@
+/*! @file benchmarks/bench_fake_fc.hpp
+ *  @version 4.0.0
+ *  @date Oct 2026
+ *
+ *  @brief
+ *  Simulated flight controller behind a registered UART HAL, for benchmarks
+ *  that send commands through the linker without an aircraft. V1 and
+ *  OpenProtocol requests are both understood. Every request is answered
+ *  after the serial transfer time at fcBaud plus fcLatencyMs, and fcLossPct
+ *  percent of the ACKs are dropped. The benchmark decides what each ACK
+ *  carries.
+ *
+ *  @Copyright (c) 2026 DJI
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef DJIOSDK_BENCH_FAKE_FC_HPP
+#define DJIOSDK_BENCH_FAKE_FC_HPP
+
+#include "dji_crc.hpp"
+#include "dji_linker.hpp"
+#include "dji_platform.hpp"
+#include "dji_type.hpp"
+
+#include <chrono>
+#include <deque>
+#include <mutex>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <thread>
+#include <vector>
+
+using DJI::OSDK::OpenHeader;
+
+/*! V1 frame, used by the linker on the USB ACM channel: SOF, 10 bit length
+ *  and 6 bit version, CRC8 of the first three bytes, sender, receiver,
+ *  sequence number, command type, cmdSet, cmdId, payload and a CRC16 of
+ *  everything before it.
+ */
+static const uint8_t  V1_SOF        = 0x55;
+static const uint8_t  V1_VERSION    = 1;
+static const size_t   V1_HEADER_LEN = 11;
+static const size_t   V1_CRC16_LEN  = 2;
+static const uint8_t  V1_ACK_FLAG   = 0x80;
+static const uint8_t  V1_CRC8_INIT  = 0x77;
+static const uint16_t V1_CRC16_INIT = 0x3692;
+
+/*! OpenProtocol frame, used by LegacyLinker on the FC UART channel: an
+ *  OpenHeader, cmdSet and cmdId (requests only), payload and a CRC32 of
+ *  everything before it.
+ */
+static const uint8_t OPEN_SOF       = 0xAA;
+static const size_t  OPEN_CRC32_LEN = 4;
+static const size_t  OPEN_CMD_LEN   = 2;
+
+static const char* const FAKE_FC_V1_PORT   = "simulated-fc-v1";
+static const char* const FAKE_FC_OPEN_PORT = "simulated-fc-open";
+
+/*! Fills the ACK payload for one request. Returns false to leave the
+ *  request unanswered.
+ */
+typedef bool (*FakeFcAnswer)(uint8_t cmdSet, uint8_t cmdId,
+                             const uint8_t* payload, size_t len,
+                             std::vector<uint8_t>* ackPayload);
+
+typedef struct PendingAck
+{
+  std::chrono::steady_clock::time_point due;
+  std::vector<uint8_t>                  frame;
+} PendingAck;
+
+//! One simulated serial link, the HAL object's fd is its index
+typedef struct FakeFcPort
+{
+  std::vector<uint8_t>                  rxBuffer;
+  std::deque<PendingAck>                txQueue;
+  std::chrono::steady_clock::time_point linkFree;
+} FakeFcPort;
+
+enum
+{
+  FAKE_FC_V1,
+  FAKE_FC_OPEN,
+  FAKE_FC_PORTS
+};
+
+static std::mutex   fcLock;
+static FakeFcPort   fcPorts[FAKE_FC_PORTS];
+static FakeFcAnswer fcAnswer    = NULL;
+static unsigned     fcLatencyMs = 20;
+static unsigned     fcBaud      = 921600;
+static unsigned     fcLossPct   = 0;
+static unsigned     fcRequests  = 0;
+static unsigned     fcDropped   = 0;
+
+static uint8_t
+fakeFcCrc8(const uint8_t* data, size_t len)
+{
+  uint8_t crc = V1_CRC8_INIT;
+  for (size_t i = 0; i < len; i++)
+  {
+    crc ^= data[i];
+    for (int bit = 0; bit < 8; bit++)
+    {
+      crc = (crc & 1) ? (crc >> 1) ^ 0x8C : (crc >> 1);
+    }
+  }
+  return crc;
+}
+
+static uint16_t
+fakeFcCrc16(const uint8_t* data, size_t len)
+{
+  uint16_t crc = V1_CRC16_INIT;
+  for (size_t i = 0; i < len; i++)
+  {
+    crc ^= data[i];
+    for (int bit = 0; bit < 8; bit++)
+    {
+      crc = (crc & 1) ? (crc >> 1) ^ 0x8408 : (crc >> 1);
+    }
+  }
+  return crc;
+}
+
+static std::chrono::steady_clock::duration
+fakeFcWireTime(size_t bytes)
+{
+  //! 8N1: ten bits on the wire per byte
+  return std::chrono::microseconds((uint64_t)bytes * 10 * 1000000 / fcBaud);
+}
+
+static void
+fakeFcV1Ack(const uint8_t* frame, const std::vector<uint8_t>& payload,
+            std::vector<uint8_t>* ack)
+{
+  ack->resize(V1_HEADER_LEN + payload.size() + V1_CRC16_LEN);
+  uint8_t* out    = &(*ack)[0];
+  uint16_t lenVer = ack->size() | (V1_VERSION << 10);
+  out[0]          = V1_SOF;
+  out[1]          = lenVer & 0xFF;
+  out[2]          = lenVer >> 8;
+  out[3]          = fakeFcCrc8(out, 3);
+  out[4]          = frame[5];
+  out[5]          = frame[4];
+  out[6]          = frame[6];
+  out[7]          = frame[7];
+  out[8]          = V1_ACK_FLAG;
+  out[9]          = frame[9];
+  out[10]         = frame[10];
+  if (!payload.empty())
+  {
+    memcpy(out + V1_HEADER_LEN, &payload[0], payload.size());
+  }
+  uint16_t tail       = fakeFcCrc16(out, ack->size() - V1_CRC16_LEN);
+  out[ack->size() - 2] = tail & 0xFF;
+  out[ack->size() - 1] = tail >> 8;
+}
+
+static void
+fakeFcOpenAck(const uint8_t* frame, const std::vector<uint8_t>& payload,
+              std::vector<uint8_t>* ack)
+{
+  OpenHeader header;
+  memcpy(&header, frame, sizeof(header));
+  header.length    = sizeof(OpenHeader) + payload.size() + OPEN_CRC32_LEN;
+  header.isAck     = 1;
+  header.padding   = 0;
+  header.enc       = 0;
+  header.reserved1 = 0;
+  header.crc =
+    DJI::OSDK::crc16Block(DJI::OSDK::CRC_INIT, (const uint8_t*)&header,
+                          sizeof(header) - sizeof(uint16_t));
+
+  ack->resize(header.length);
+  uint8_t* out = &(*ack)[0];
+  memcpy(out, &header, sizeof(header));
+  if (!payload.empty())
+  {
+    memcpy(out + sizeof(header), &payload[0], payload.size());
+  }
+  uint32_t tail = DJI::OSDK::crc32Block(DJI::OSDK::CRC_INIT, out,
+                                        ack->size() - OPEN_CRC32_LEN);
+  memcpy(out + ack->size() - OPEN_CRC32_LEN, &tail, sizeof(tail));
+}
+
+static void
+fakeFcReceive(FakeFcPort* port, bool open, const uint8_t* frame, size_t len)
+{
+  std::vector<uint8_t> payload;
+  const uint8_t*       cmd;
+  size_t               end;
+  if (open)
+  {
+    OpenHeader header;
+    memcpy(&header, frame, sizeof(header));
+    //! Encrypted frames cannot be answered, run with encryption off
+    if (header.isAck || header.enc ||
+        len < sizeof(OpenHeader) + OPEN_CMD_LEN + OPEN_CRC32_LEN)
+    {
+      return;
+    }
+    cmd = frame + sizeof(OpenHeader);
+    end = len - OPEN_CRC32_LEN;
+  }
+  else
+  {
+    if ((frame[8] & V1_ACK_FLAG) || len < V1_HEADER_LEN + V1_CRC16_LEN)
+    {
+      return;
+    }
+    cmd = frame + 9;
+    end = len - V1_CRC16_LEN;
+  }
+  const uint8_t* data = cmd + OPEN_CMD_LEN;
+  if (!fcAnswer || !fcAnswer(cmd[0], cmd[1], data, frame + end - data,
+                             &payload))
+  {
+    return;
+  }
+  fcRequests++;
+
+  PendingAck reply;
+  if (open)
+  {
+    fakeFcOpenAck(frame, payload, &reply.frame);
+  }
+  else
+  {
+    fakeFcV1Ack(frame, payload, &reply.frame);
+  }
+
+  if ((unsigned)(rand() % 100) < fcLossPct)
+  {
+    fcDropped++;
+    return;
+  }
+
+  //! The request has to cross the wire before the FC can work on it
+  std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+  port->linkFree = ((port->linkFree > now) ? port->linkFree : now) +
+                   fakeFcWireTime(len);
+  reply.due = port->linkFree + std::chrono::milliseconds(fcLatencyMs) +
+              fakeFcWireTime(reply.frame.size());
+  port->txQueue.push_back(reply);
+}
+
+//! Length of the frame at the start of buf, 0 if it is not a frame
+static size_t
+fakeFcFrameLength(bool open, const std::vector<uint8_t>& buf)
+{
+  size_t headerLen = open ? sizeof(OpenHeader) : V1_HEADER_LEN;
+  size_t len       = (buf[1] | (buf[2] << 8)) & 0x3FF;
+  if (open)
+  {
+    uint16_t crc;
+    memcpy(&crc, &buf[sizeof(OpenHeader) - sizeof(crc)], sizeof(crc));
+    if (buf[0] != OPEN_SOF ||
+        DJI::OSDK::crc16Block(DJI::OSDK::CRC_INIT, &buf[0],
+                              sizeof(OpenHeader) - sizeof(crc)) != crc)
+    {
+      return 0;
+    }
+  }
+  else if (buf[0] != V1_SOF || fakeFcCrc8(&buf[0], 3) != buf[3])
+  {
+    return 0;
+  }
+  return (len < headerLen) ? 0 : len;
+}
+
+static E_OsdkStat
+fakeUartInit(const char* port, const int baudrate, T_HalObj* obj)
+{
+  (void)baudrate;
+  obj->uartObject.fd =
+    (strcmp(port, FAKE_FC_OPEN_PORT) == 0) ? FAKE_FC_OPEN : FAKE_FC_V1;
+  return OSDK_STAT_OK;
+}
+
+static E_OsdkStat
+fakeUartWrite(const T_HalObj* obj, const uint8_t* pBuf, uint32_t bufLen)
+{
+  bool                        open = (obj->uartObject.fd == FAKE_FC_OPEN);
+  FakeFcPort*                 port = &fcPorts[obj->uartObject.fd];
+  size_t                      headerLen = open ? sizeof(OpenHeader)
+                                               : V1_HEADER_LEN;
+  std::lock_guard<std::mutex> lock(fcLock);
+  port->rxBuffer.insert(port->rxBuffer.end(), pBuf, pBuf + bufLen);
+
+  while (port->rxBuffer.size() >= headerLen)
+  {
+    size_t len = fakeFcFrameLength(open, port->rxBuffer);
+    if (len == 0)
+    {
+      port->rxBuffer.erase(port->rxBuffer.begin());
+      continue;
+    }
+    if (port->rxBuffer.size() < len)
+    {
+      break;
+    }
+    fakeFcReceive(port, open, &port->rxBuffer[0], len);
+    port->rxBuffer.erase(port->rxBuffer.begin(),
+                         port->rxBuffer.begin() + len);
+  }
+  return OSDK_STAT_OK;
+}
+
+static E_OsdkStat
+fakeUartRead(const T_HalObj* obj, uint8_t* pBuf, uint32_t* bufLen)
+{
+  FakeFcPort* port = &fcPorts[obj->uartObject.fd];
+  //! The linker reads into a 1024 byte buffer, as the Linux UART HAL does
+  uint32_t size = 1024;
+  *bufLen       = 0;
+  {
+    std::lock_guard<std::mutex> lock(fcLock);
+    while (!port->txQueue.empty() &&
+           port->txQueue.front().due <= std::chrono::steady_clock::now() &&
+           *bufLen + port->txQueue.front().frame.size() <= size)
+    {
+      std::vector<uint8_t>& frame = port->txQueue.front().frame;
+      memcpy(pBuf + *bufLen, &frame[0], frame.size());
+      *bufLen += frame.size();
+      port->txQueue.pop_front();
+    }
+  }
+  if (*bufLen == 0)
+  {
+    std::this_thread::sleep_for(std::chrono::microseconds(200));
+  }
+  return OSDK_STAT_OK;
+}
+
+static E_OsdkStat
+fakeUartClose(T_HalObj* obj)
+{
+  (void)obj;
+  return OSDK_STAT_OK;
+}
+
+/*! Register the fake UART and open both command channels on it, V1 on the
+ *  USB ACM channel and OpenProtocol on the FC UART channel. The OSAL has to
+ *  be registered first.
+ */
+static bool
+startFakeFc(DJI::OSDK::Linker* linker, FakeFcAnswer answer)
+{
+  static const T_OsdkHalUartHandler uartHandler = {
+    fakeUartInit, fakeUartWrite, fakeUartRead, fakeUartClose
+  };
+  fcAnswer = answer;
+  if (!DJI::OSDK::Platform::instance().registerHalUartHandler(&uartHandler) ||
+      !linker->init() ||
+      !linker->addUartChannel(FAKE_FC_V1_PORT, fcBaud, USB_ACM_CHANNEL_ID) ||
+      !linker->addUartChannel(FAKE_FC_OPEN_PORT, fcBaud, FC_UART_CHANNEL_ID))
+  {
+    fprintf(stderr, "Linker init fail\n");
+    return false;
+  }
+  return true;
+}
+
+#endif // DJIOSDK_BENCH_FAKE_FC_HPP
@@ -0,0 +1,70 @@
+/*! @file benchmarks/bench_osal.hpp
+ *  @version 4.0.0
+ *  @date Oct 2026
+ *
+ *  @brief
+ *  Registers the Linux OSAL for benchmarks that run OSDK code without an
+ *  aircraft.
+ *
+ *  @Copyright (c) 2026 DJI
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef DJIOSDK_BENCH_OSAL_HPP
+#define DJIOSDK_BENCH_OSAL_HPP
+
+#include "dji_platform.hpp"
+#include "osdkosal_linux.h"
+
+#include <stdio.h>
+
+static bool
+registerLinuxOsal()
+{
+  static T_OsdkOsalHandler osalHandler = {
+      .TaskCreate = OsdkLinux_TaskCreate,
+      .TaskDestroy = OsdkLinux_TaskDestroy,
+      .TaskSleepMs = OsdkLinux_TaskSleepMs,
+      .MutexCreate = OsdkLinux_MutexCreate,
+      .MutexDestroy = OsdkLinux_MutexDestroy,
+      .MutexLock = OsdkLinux_MutexLock,
+      .MutexUnlock = OsdkLinux_MutexUnlock,
+      .SemaphoreCreate = OsdkLinux_SemaphoreCreate,
+      .SemaphoreDestroy = OsdkLinux_SemaphoreDestroy,
+      .SemaphoreWait = OsdkLinux_SemaphoreWait,
+      .SemaphoreTimedWait = OsdkLinux_SemaphoreTimedWait,
+      .SemaphorePost = OsdkLinux_SemaphorePost,
+      .GetTimeMs = OsdkLinux_GetTimeMs,
+#ifdef OS_DEBUG
+      .GetTimeUs = OsdkLinux_GetTimeUs,
+#endif
+      .Malloc = OsdkLinux_Malloc,
+      .Free = OsdkLinux_Free,
+  };
+  if (DJI_REG_OSAL_HANDLER(&osalHandler) != true)
+  {
+    fprintf(stderr, "Osal handler register fail\n");
+    return false;
+  }
+  return true;
+}
+
+#endif // DJIOSDK_BENCH_OSAL_HPP
@@ -0,0 +1,407 @@
+/*! @file benchmarks/broadcast_snapshot_bench.cpp
+ *  @version 4.0.0
+ *  @date Oct 2026
+ *
+ *  @brief
+ *  Reading eight broadcast fields per control loop. One writer stands in
+ *  for the receive thread and hands broadcast packages to DataBroadcast at
+ *  a fixed rate, a growing number of readers read the same eight fields in
+ *  a tight loop. Three ways of reading are compared: a mutex taken per
+ *  field, like the getters did when they shared m_msgLock with the unpack,
+ *  the current getters and one getSnapshot(). Every package number is
+ *  written into all eight fields, so a loop that mixes packages is seen.
+ *
+ *  Usage: djiosdk-bench-broadcast-snapshot [seconds per run] [writer Hz]
+ *
+ *  @Copyright (c) 2026 DJI
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#include "bench_osal.hpp"
+#include "dji_broadcast.hpp"
+#include "dji_vehicle.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <thread>
+#include <vector>
+
+using namespace DJI::OSDK;
+
+typedef std::chrono::steady_clock Clock;
+
+typedef enum Mode
+{
+  MODE_LOCKED,
+  MODE_GETTERS,
+  MODE_SNAPSHOT,
+  MODE_COUNT
+} Mode;
+
+static const char* modeNames[MODE_COUNT] = { "mutex", "getters", "snapshot" };
+
+//! Time, quaternion, acceleration, velocity, angular rate, position, GPS
+static const uint16_t PASS_FLAG = 0x007F;
+
+//! The fields present in PASS_FLAG, in the order the FC sends them
+typedef struct Fields
+{
+  Telemetry::TimeStamp        timeStamp;
+  Telemetry::SyncStamp        syncStamp;
+  Telemetry::Quaternion       q;
+  Telemetry::Vector3f         a;
+  Telemetry::Vector3f         v;
+  Telemetry::VelocityInfo     vi;
+  Telemetry::Vector3f         w;
+  Telemetry::GlobalPosition   gp;
+  Telemetry::RelativePosition rp;
+  Telemetry::GPSInfo          gps;
+} Fields;
+
+/*! The getters before the snapshot: one mutex guards the fields, the
+ *  unpack holds it for the whole package and every getter takes it again.
+ */
+typedef struct LockedBroadcast
+{
+  T_OsdkMutexHandle lock;
+  Fields            fields;
+} LockedBroadcast;
+
+//! What a control loop reads, one value per field it asked for
+typedef struct Reading
+{
+  uint32_t time;
+  float    q0;
+  float    ax;
+  float    vx;
+  float    wx;
+  double   latitude;
+  float    down;
+  int32_t  longitude;
+} Reading;
+
+typedef struct Result
+{
+  uint64_t loops;
+  uint64_t mixed;
+  uint64_t writes;
+  uint64_t writeMaxNs;
+  uint64_t loopMaxNs;
+} Result;
+
+static std::atomic<bool> running;
+static LockedBroadcast   locked;
+
+static uint64_t
+elapsedNs(Clock::time_point since)
+{
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() -
+                                                              since)
+    .count();
+}
+
+template <typename T>
+static void
+pack(uint8_t*& buf, const T& field)
+{
+  memcpy(buf, &field, sizeof(T));
+  buf += sizeof(T);
+}
+
+//! Fills every field the readers look at with the package number
+static size_t
+buildPackage(uint32_t number, uint8_t* payload)
+{
+  Fields fields;
+  memset(&fields, 0, sizeof(fields));
+  fields.timeStamp.time_ms = number;
+  fields.q.q0              = number;
+  fields.a.x               = number;
+  fields.v.x               = number;
+  fields.w.x               = number;
+  fields.gp.latitude       = number;
+  fields.rp.down           = number;
+  fields.gps.longitude     = number;
+
+  uint8_t* buf = payload;
+  pack(buf, PASS_FLAG);
+  pack(buf, fields.timeStamp);
+  pack(buf, fields.syncStamp);
+  pack(buf, fields.q);
+  pack(buf, fields.a);
+  pack(buf, fields.v);
+  pack(buf, fields.vi);
+  pack(buf, fields.w);
+  pack(buf, fields.gp);
+  pack(buf, fields.rp);
+  pack(buf, fields.gps);
+  return buf - payload;
+}
+
+template <typename T>
+static void
+unpack(const uint8_t*& buf, T* field)
+{
+  memcpy(field, buf, sizeof(T));
+  buf += sizeof(T);
+}
+
+static void
+unpackLocked(const uint8_t* payload)
+{
+  const uint8_t* buf = payload + sizeof(uint16_t);
+  Platform::instance().mutexLock(locked.lock);
+  unpack(buf, &locked.fields.timeStamp);
+  unpack(buf, &locked.fields.syncStamp);
+  unpack(buf, &locked.fields.q);
+  unpack(buf, &locked.fields.a);
+  unpack(buf, &locked.fields.v);
+  unpack(buf, &locked.fields.vi);
+  unpack(buf, &locked.fields.w);
+  unpack(buf, &locked.fields.gp);
+  unpack(buf, &locked.fields.rp);
+  unpack(buf, &locked.fields.gps);
+  Platform::instance().mutexUnlock(locked.lock);
+}
+
+template <typename T>
+static T
+getLocked(const T& field)
+{
+  Platform::instance().mutexLock(locked.lock);
+  T data = field;
+  Platform::instance().mutexUnlock(locked.lock);
+  return data;
+}
+
+static void
+readLocked(Reading* r)
+{
+  r->time      = getLocked(locked.fields.timeStamp).time_ms;
+  r->q0        = getLocked(locked.fields.q).q0;
+  r->ax        = getLocked(locked.fields.a).x;
+  r->vx        = getLocked(locked.fields.v).x;
+  r->wx        = getLocked(locked.fields.w).x;
+  r->latitude  = getLocked(locked.fields.gp).latitude;
+  r->down      = getLocked(locked.fields.rp).down;
+  r->longitude = getLocked(locked.fields.gps).longitude;
+}
+
+static void
+readGetters(DataBroadcast* broadcast, Reading* r)
+{
+  r->time      = broadcast->getTimeStamp().time_ms;
+  r->q0        = broadcast->getQuaternion().q0;
+  r->ax        = broadcast->getAcceleration().x;
+  r->vx        = broadcast->getVelocity().x;
+  r->wx        = broadcast->getAngularRate().x;
+  r->latitude  = broadcast->getGlobalPosition().latitude;
+  r->down      = broadcast->getRelativePosition().down;
+  r->longitude = broadcast->getGPSInfo().longitude;
+}
+
+static void
+readSnapshot(DataBroadcast* broadcast, Reading* r)
+{
+  BroadcastSnapshot snapshot;
+  broadcast->getSnapshot(snapshot);
+  r->time      = snapshot.timeStamp.time_ms;
+  r->q0        = snapshot.q.q0;
+  r->ax        = snapshot.a.x;
+  r->vx        = snapshot.v.x;
+  r->wx        = snapshot.w.x;
+  r->latitude  = snapshot.gp.latitude;
+  r->down      = snapshot.rp.down;
+  r->longitude = snapshot.gps.longitude;
+}
+
+static bool
+samePackage(const Reading& r)
+{
+  return r.q0 == r.time && r.ax == r.time && r.vx == r.time &&
+         r.wx == r.time && r.latitude == r.time && r.down == r.time &&
+         r.longitude == (int32_t)r.time;
+}
+
+static void
+writer(Mode mode, Vehicle* vehicle, DataBroadcast* broadcast, unsigned hz,
+       Result* result)
+{
+  RecvContainer     recvFrame;
+  uint32_t          number = 0;
+  Clock::time_point next   = Clock::now();
+  Clock::duration   period = std::chrono::microseconds(1000000 / hz);
+
+  memset(&recvFrame, 0, sizeof(recvFrame));
+  while (running)
+  {
+    recvFrame.recvInfo.len =
+      buildPackage(++number, recvFrame.recvData.raw_ack_array);
+
+    Clock::time_point start = Clock::now();
+    if (mode == MODE_LOCKED)
+    {
+      unpackLocked(recvFrame.recvData.raw_ack_array);
+    }
+    else
+    {
+      broadcast->unpackHandler.callback(vehicle, recvFrame,
+                                        broadcast->unpackHandler.userData);
+    }
+    uint64_t ns = elapsedNs(start);
+
+    result->writes++;
+    result->writeMaxNs = (ns > result->writeMaxNs) ? ns : result->writeMaxNs;
+
+    next += period;
+    std::this_thread::sleep_until(next);
+  }
+}
+
+static void
+reader(Mode mode, DataBroadcast* broadcast, Result* result)
+{
+  Reading reading;
+
+  while (running)
+  {
+    Clock::time_point start = Clock::now();
+    if (mode == MODE_LOCKED)
+    {
+      readLocked(&reading);
+    }
+    else if (mode == MODE_GETTERS)
+    {
+      readGetters(broadcast, &reading);
+    }
+    else
+    {
+      readSnapshot(broadcast, &reading);
+    }
+    uint64_t ns = elapsedNs(start);
+
+    result->loops++;
+    result->loopMaxNs = (ns > result->loopMaxNs) ? ns : result->loopMaxNs;
+    if (!samePackage(reading))
+    {
+      result->mixed++;
+    }
+  }
+}
+
+static Result
+run(Mode mode, Vehicle* vehicle, DataBroadcast* broadcast, int readers,
+    unsigned seconds, unsigned hz)
+{
+  std::vector<Result>      results(readers + 1);
+  std::vector<std::thread> threads;
+
+  running = true;
+  threads.push_back(
+    std::thread(writer, mode, vehicle, broadcast, hz, &results[0]));
+  for (int i = 0; i < readers; i++)
+  {
+    threads.push_back(std::thread(reader, mode, broadcast, &results[i + 1]));
+  }
+  std::this_thread::sleep_for(std::chrono::seconds(seconds));
+  running = false;
+  for (size_t i = 0; i < threads.size(); i++)
+  {
+    threads[i].join();
+  }
+
+  Result total = results[0];
+  for (int i = 1; i <= readers; i++)
+  {
+    total.loops += results[i].loops;
+    total.mixed += results[i].mixed;
+    if (results[i].loopMaxNs > total.loopMaxNs)
+    {
+      total.loopMaxNs = results[i].loopMaxNs;
+    }
+  }
+  return total;
+}
+
+int
+main(int argc, char** argv)
+{
+  unsigned seconds = (argc > 1) ? atoi(argv[1]) : 2;
+  unsigned hz      = (argc > 2) ? atoi(argv[2]) : 1000;
+  if (seconds == 0 || hz == 0 || hz > 1000000)
+  {
+    printf("Usage: %s [seconds per run] [writer Hz]\n", argv[0]);
+    return 1;
+  }
+
+  uint8_t payload[MAX_INCOMING_DATA_SIZE];
+  if (sizeof(uint16_t) + sizeof(Fields) > sizeof(payload))
+  {
+    printf("A package does not fit the %u byte receive buffer\n",
+           (unsigned)sizeof(payload));
+    return 1;
+  }
+  size_t payloadLen = buildPackage(0, payload);
+
+  if (!registerLinuxOsal())
+  {
+    return 1;
+  }
+  Platform::instance().mutexCreate(&locked.lock);
+
+  /*! The broadcast only asks the vehicle for its firmware, no link is
+   *  needed. Any firmware that sends the current format will do.
+   */
+  Version::FirmWare firmware = Version::A3_32;
+  Vehicle           vehicle(NULL);
+  vehicle.setVersion(firmware);
+  DataBroadcast broadcast(&vehicle);
+
+  printf("%u byte package, writer at %u Hz, %u s per run\n\n",
+         (unsigned)payloadLen, hz, seconds);
+  printf("%-9s %7s %12s %12s %14s %14s %10s\n", "read", "readers",
+         "loops/s", "ns/loop", "write max ns", "loop max ns", "mixed");
+
+  bool failed = false;
+  for (int readers = 1; readers <= 4; readers *= 2)
+  {
+    for (int mode = 0; mode < MODE_COUNT; mode++)
+    {
+      Result r = run((Mode)mode, &vehicle, &broadcast, readers, seconds, hz);
+      printf("%-9s %7d %12.0f %12.0f %14llu %14llu %10llu\n",
+             modeNames[mode], readers, (double)r.loops / seconds,
+             1e9 * seconds * readers / (double)(r.loops ? r.loops : 1),
+             (unsigned long long)r.writeMaxNs,
+             (unsigned long long)r.loopMaxNs, (unsigned long long)r.mixed);
+      failed = failed || (mode == MODE_SNAPSHOT && r.mixed != 0);
+    }
+  }
+
+  if (failed)
+  {
+    printf("\nFAILED: a snapshot mixed fields of two packages\n");
+    return 1;
+  }
+  return 0;
+}
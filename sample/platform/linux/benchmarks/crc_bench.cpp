@@ -0,0 +1,202 @@
+/*! @file benchmarks/crc_bench.cpp
+ *  @version 4.0.0
+ *  @date Oct 2026
+ *
+ *  @brief
+ *  Equivalence and throughput of crc16Block / crc32Block, which frame
+ *  checks in OpenProtocol go through. Both are compared with feeding the
+ *  same bytes one at a time through crc_tab16 / crc_tab32:
+ *  every 16-bit state with every byte value, then every length from 0 to
+ *  2048 at each of 8 buffer alignments with random seeds. Throughput is
+ *  measured for a header, a typical frame, the longest frame and a 4 KiB
+ *  buffer.
+ *
+ *  Usage: djiosdk-bench-crc [MB per measurement]
+ *
+ *  @Copyright (c) 2026 DJI
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#include "dji_crc.hpp"
+
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+
+using namespace DJI::OSDK;
+
+typedef std::chrono::steady_clock Clock;
+
+static const size_t MAX_CHECK_LEN = 2048;
+static const size_t ALIGNMENTS    = 8;
+
+static uint16_t
+byteWise16(uint16_t crc, const uint8_t* data, size_t len)
+{
+  for (size_t i = 0; i < len; i++)
+  {
+    crc = (crc >> 8) ^ crc_tab16[(crc ^ data[i]) & 0xff];
+  }
+  return crc;
+}
+
+static uint32_t
+byteWise32(uint32_t crc, const uint8_t* data, size_t len)
+{
+  for (size_t i = 0; i < len; i++)
+  {
+    crc = (crc >> 8) ^ crc_tab32[(crc ^ data[i]) & 0xff];
+  }
+  return crc;
+}
+
+/*! Every state with every byte, alone and as the first of an 8 byte block
+ *  so the sliced path sees it too. CRC32 states are spread over 32 bits.
+ */
+static uint64_t
+checkAllStates()
+{
+  uint64_t mismatches = 0;
+  for (uint32_t state = 0; state <= 0xFFFF; state++)
+  {
+    uint32_t state32 = state * 0x9E3779B1u;
+    for (uint32_t byte = 0; byte <= 0xFF; byte++)
+    {
+      uint8_t block[8] = { (uint8_t)byte, 0x5A, 0xA5, 0x00,
+                           0xFF,          0x12, 0x34, (uint8_t)~byte };
+      mismatches += crc16Block(state, block, 1) != byteWise16(state, block, 1);
+      mismatches += crc16Block(state, block, 8) != byteWise16(state, block, 8);
+      mismatches +=
+        crc32Block(state32, block, 1) != byteWise32(state32, block, 1);
+      mismatches +=
+        crc32Block(state32, block, 8) != byteWise32(state32, block, 8);
+    }
+  }
+  return mismatches;
+}
+
+static uint64_t
+checkLengths(const std::vector<uint8_t>& data)
+{
+  uint64_t mismatches = 0;
+  for (size_t offset = 0; offset < ALIGNMENTS; offset++)
+  {
+    for (size_t len = 0; len <= MAX_CHECK_LEN; len++)
+    {
+      uint16_t seed16 = rand();
+      uint32_t seed32 = ((uint32_t)rand() << 16) ^ rand();
+      mismatches += crc16Block(seed16, &data[offset], len) !=
+                    byteWise16(seed16, &data[offset], len);
+      mismatches += crc32Block(seed32, &data[offset], len) !=
+                    byteWise32(seed32, &data[offset], len);
+    }
+  }
+  return mismatches;
+}
+
+template <typename Func>
+static double
+megabytesPerSecond(Func func, const uint8_t* data, size_t len, size_t total)
+{
+  size_t            rounds = total / len + 1;
+  volatile uint32_t sink   = 0;
+  Clock::time_point start  = Clock::now();
+  for (size_t i = 0; i < rounds; i++)
+  {
+    sink = sink + func(CRC_INIT, data, len);
+  }
+  double seconds =
+    std::chrono::duration<double>(Clock::now() - start).count();
+  return (double)rounds * len / seconds / 1e6;
+}
+
+//! Out of line like the old per-frame crc16Calc / crc32Calc
+__attribute__((noinline)) static uint32_t
+ref16(uint32_t crc, const uint8_t* data, size_t len)
+{
+  return byteWise16(crc, data, len);
+}
+
+static uint32_t
+fast16(uint32_t crc, const uint8_t* data, size_t len)
+{
+  return crc16Block(crc, data, len);
+}
+
+__attribute__((noinline)) static uint32_t
+ref32(uint32_t crc, const uint8_t* data, size_t len)
+{
+  return byteWise32(crc, data, len);
+}
+
+static uint32_t
+fast32(uint32_t crc, const uint8_t* data, size_t len)
+{
+  return crc32Block(crc, data, len);
+}
+
+int
+main(int argc, char** argv)
+{
+  unsigned megabytes = (argc > 1) ? atoi(argv[1]) : 64;
+  if (megabytes == 0)
+  {
+    printf("Usage: %s [MB per measurement]\n", argv[0]);
+    return 1;
+  }
+
+  std::vector<uint8_t> data(4096 + ALIGNMENTS);
+  srand(1);
+  for (size_t i = 0; i < data.size(); i++)
+  {
+    data[i] = rand();
+  }
+
+  uint64_t stateMismatches  = checkAllStates();
+  uint64_t lengthMismatches = checkLengths(data);
+  printf("every state x byte: %llu mismatches\n",
+         (unsigned long long)stateMismatches);
+  printf("lengths 0..%u at %u alignments: %llu mismatches\n\n",
+         (unsigned)MAX_CHECK_LEN, (unsigned)ALIGNMENTS,
+         (unsigned long long)lengthMismatches);
+
+  printf("%6s %14s %14s %14s %14s\n", "bytes", "crc16 byte", "crc16 block",
+         "crc32 byte", "crc32 block");
+  const size_t lengths[] = { 10, 100, 1023, 4096 };
+  size_t       total     = (size_t)megabytes << 20;
+  for (size_t i = 0; i < sizeof(lengths) / sizeof(lengths[0]); i++)
+  {
+    size_t len = lengths[i];
+    printf("%6u %9.0f MB/s %9.0f MB/s %9.0f MB/s %9.0f MB/s\n", (unsigned)len,
+           megabytesPerSecond(ref16, &data[0], len, total),
+           megabytesPerSecond(fast16, &data[0], len, total),
+           megabytesPerSecond(ref32, &data[0], len, total),
+           megabytesPerSecond(fast32, &data[0], len, total));
+  }
+
+  if (stateMismatches || lengthMismatches)
+  {
+    printf("\nFAILED: crc16Block / crc32Block differ from the tables\n");
+    return 1;
+  }
+  return 0;
+}
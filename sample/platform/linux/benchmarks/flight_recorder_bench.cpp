@@ -0,0 +1,323 @@
+/*! @file benchmarks/flight_recorder_bench.cpp
+ *  @version 4.0.0
+ *  @date Oct 2026
+ *
+ *  @brief
+ *  Receive thread cost of the flight recorder. Subscription packages at
+ *  400, 200 and 50 Hz and broadcast frames at 50 Hz are handed to
+ *  DataSubscription::dispatchFrame and DataBroadcast::unpackCallback, as
+ *  the receive thread does, first with the recorder off and then with it
+ *  on. The time of every call is compared. Afterwards every frame is read
+ *  back from the segments through FlightRecordReader and checked.
+ *
+ *  Usage: djiosdk-bench-flight-recorder [seconds per run] [segment KB]
+ *         [base path]
+ *
+ *  @Copyright (c) 2026 DJI
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#include "bench_osal.hpp"
+#include "dji_broadcast.hpp"
+#include "dji_flight_recorder.hpp"
+#include "dji_legacy_linker.hpp"
+#include "dji_log.hpp"
+#include "dji_subscription.hpp"
+#include "dji_vehicle.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+using namespace DJI::OSDK;
+using namespace DJI::OSDK::Telemetry;
+
+typedef std::chrono::steady_clock Clock;
+
+//! Rate of the fastest package, every other rate divides it
+static const unsigned TICK_HZ      = 400;
+static const unsigned BROADCAST_HZ = 50;
+//! The broadcast frames carry the time stamp only
+static const uint16_t BROADCAST_PASS_FLAG = 0x0001;
+
+typedef struct BenchPackage
+{
+  int       id;
+  uint16_t  freq;
+  int       numberOfTopics;
+  TopicName topics[4];
+} BenchPackage;
+
+//! A typical full rate setup: hardware sync, attitude and motion, position
+static BenchPackage packages[] = {
+  { 0, 400, 1, { TOPIC_HARD_SYNC } },
+  { 1, 200, 4, { TOPIC_QUATERNION, TOPIC_ACCELERATION_GROUND, TOPIC_VELOCITY,
+                 TOPIC_ANGULAR_RATE_FUSIONED } },
+  { 2, 50, 2, { TOPIC_GPS_FUSED, TOPIC_RC } }
+};
+static const int PACKAGES = sizeof(packages) / sizeof(packages[0]);
+
+typedef struct RunResult
+{
+  std::vector<uint32_t> ns;
+  uint32_t              sent[PACKAGES];
+  uint32_t              broadcasts;
+} RunResult;
+
+//! Counts the samples of one topic read back and the ones that are wrong
+typedef struct Check
+{
+  uint32_t samples;
+  uint32_t wrong;
+} Check;
+
+static uint32_t
+elapsedNs(Clock::time_point since)
+{
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() -
+                                                              since)
+    .count();
+}
+
+static uint32_t
+frameLength(const BenchPackage& pkg)
+{
+  uint32_t length = 1;
+  for (int i = 0; i < pkg.numberOfTopics; i++)
+  {
+    length += TopicDataBase[pkg.topics[i]].size;
+  }
+  return length;
+}
+
+/*! The n-th frame of a package carries n in every data byte, so any sample
+ *  read back tells which frame it came from.
+ */
+static void
+run(DataSubscription* subscribe, Vehicle* vehicle, DataBroadcast* broadcast,
+    unsigned seconds, RunResult* result)
+{
+  uint8_t       frames[PACKAGES][MAX_INCOMING_DATA_SIZE];
+  RecvContainer recvFrame;
+  memset(&recvFrame, 0, sizeof(recvFrame));
+  memset(result->sent, 0, sizeof(result->sent));
+  result->broadcasts = 0;
+  result->ns.clear();
+
+  Clock::time_point next   = Clock::now();
+  Clock::duration   period = std::chrono::microseconds(1000000 / TICK_HZ);
+  for (unsigned tick = 0; tick < seconds * TICK_HZ; tick++)
+  {
+    for (int i = 0; i < PACKAGES; i++)
+    {
+      if (tick % (TICK_HZ / packages[i].freq) != 0)
+      {
+        continue;
+      }
+      uint32_t length = frameLength(packages[i]);
+      frames[i][0]    = packages[i].id;
+      memset(frames[i] + 1, ++result->sent[i] & 0xFF, length - 1);
+
+      Clock::time_point start = Clock::now();
+      subscribe->dispatchFrame(frames[i], length);
+      result->ns.push_back(elapsedNs(start));
+    }
+
+    if (tick % (TICK_HZ / BROADCAST_HZ) == 0)
+    {
+      TimeStamp stamp = { ++result->broadcasts, 0 };
+      uint8_t*  pdata = recvFrame.recvData.raw_ack_array;
+      memcpy(pdata, &BROADCAST_PASS_FLAG, sizeof(uint16_t));
+      memcpy(pdata + sizeof(uint16_t), &stamp, sizeof(stamp));
+      recvFrame.recvInfo.len = OpenProtocol::PackageMin + sizeof(uint16_t) +
+                               sizeof(stamp) + sizeof(SyncStamp);
+
+      Clock::time_point start = Clock::now();
+      broadcast->unpackHandler.callback(vehicle, recvFrame,
+                                        broadcast->unpackHandler.userData);
+      result->ns.push_back(elapsedNs(start));
+    }
+
+    next += period;
+    std::this_thread::sleep_until(next);
+  }
+}
+
+static void
+report(const char* mode, std::vector<uint32_t>& ns)
+{
+  std::sort(ns.begin(), ns.end());
+  size_t n = ns.size();
+  printf("%-9s %8u %10u %10u %10u %10u\n", mode, (unsigned)n, ns[n / 2],
+         ns[n * 99 / 100], ns[n * 999 / 1000], ns[n - 1]);
+}
+
+static void
+checkTopic(TopicName topic, uint64_t timeUs, const uint8_t* data,
+           uint32_t size, void* userData)
+{
+  (void)topic;
+  (void)timeUs;
+  Check*  check    = (Check*)userData;
+  uint8_t expected = ++check->samples & 0xFF;
+  for (uint32_t i = 0; i < size; i++)
+  {
+    if (data[i] != expected)
+    {
+      check->wrong++;
+      return;
+    }
+  }
+}
+
+static void
+checkBroadcast(uint64_t timeUs, const uint8_t* data, uint32_t size,
+               void* userData)
+{
+  (void)timeUs;
+  Check*    check = (Check*)userData;
+  uint16_t  passFlag;
+  TimeStamp stamp;
+  check->samples++;
+  if (size < sizeof(passFlag) + sizeof(stamp))
+  {
+    check->wrong++;
+    return;
+  }
+  memcpy(&passFlag, data, sizeof(passFlag));
+  memcpy(&stamp, data + sizeof(passFlag), sizeof(stamp));
+  if (passFlag != BROADCAST_PASS_FLAG || stamp.time_ms != check->samples)
+  {
+    check->wrong++;
+  }
+}
+
+int
+main(int argc, char** argv)
+{
+  unsigned    seconds     = (argc > 1) ? atoi(argv[1]) : 5;
+  uint32_t    segmentSize = ((argc > 2) ? atoi(argv[2]) : 128) * 1024;
+  std::string basePath    = (argc > 3) ? argv[3] : "/tmp/djiosdk-bench-rec";
+  if (seconds == 0 || segmentSize == 0)
+  {
+    printf("Usage: %s [seconds per run] [segment KB] [base path]\n",
+           argv[0]);
+    return 1;
+  }
+
+  if (!registerLinuxOsal())
+  {
+    return 1;
+  }
+  Log::instance().disableStatusLogging();
+
+  /*! Frames are fed in directly, no link is needed. Any firmware that
+   *  sends the current broadcast format will do.
+   */
+  Version::FirmWare firmware = Version::A3_32;
+  Vehicle           vehicle(NULL);
+  vehicle.setVersion(firmware);
+  DataSubscription subscribe(&vehicle);
+  DataBroadcast    broadcast(&vehicle);
+  for (int i = 0; i < PACKAGES; i++)
+  {
+    if (!subscribe.startPackageLocally(packages[i].id,
+                                       packages[i].numberOfTopics,
+                                       packages[i].topics, false,
+                                       packages[i].freq))
+    {
+      printf("Package %d cannot be set up\n", packages[i].id);
+      return 1;
+    }
+  }
+
+  printf("Packages at 400, 200 and 50 Hz, broadcast at %u Hz, %u s per "
+         "run, %u KB segments\n\n",
+         BROADCAST_HZ, seconds, segmentSize / 1024);
+  printf("%-9s %8s %10s %10s %10s %10s\n", "recorder", "calls", "p50 ns",
+         "p99 ns", "p99.9 ns", "max ns");
+
+  RunResult off;
+  run(&subscribe, &vehicle, &broadcast, seconds, &off);
+  report("off", off.ns);
+
+  FlightRecorder& recorder = FlightRecorder::instance();
+  if (!recorder.start(basePath.c_str(), segmentSize))
+  {
+    printf("Cannot record to %s\n", basePath.c_str());
+    return 1;
+  }
+  RunResult on;
+  run(&subscribe, &vehicle, &broadcast, seconds, &on);
+  recorder.stop();
+  report("on", on.ns);
+
+  FlightRecorder::Stats stats = recorder.getStats();
+  printf("\n%llu records, %llu KB in %u segments, %llu dropped\n",
+         (unsigned long long)stats.records,
+         (unsigned long long)(stats.bytes / 1024), stats.segments,
+         (unsigned long long)stats.dropped);
+
+  //! Read back one topic of every package and the broadcast
+  Check topics[PACKAGES];
+  Check frames;
+  memset(topics, 0, sizeof(topics));
+  memset(&frames, 0, sizeof(frames));
+  for (uint32_t number = 0; number < stats.segments; number++)
+  {
+    char path[512];
+    snprintf(path, sizeof(path), "%s_%04u.frec", basePath.c_str(), number);
+    for (int i = 0; i < PACKAGES; i++)
+    {
+      FlightRecordReader::readTopic(path, packages[i].topics[0], checkTopic,
+                                    &topics[i]);
+    }
+    FlightRecordReader::readBroadcast(path, checkBroadcast, &frames);
+    unlink(path);
+  }
+
+  printf("\n%-9s %8s %8s %8s\n", "source", "sent", "read", "wrong");
+  bool failed = stats.dropped != 0;
+  for (int i = 0; i < PACKAGES; i++)
+  {
+    char name[16];
+    snprintf(name, sizeof(name), "package %d", packages[i].id);
+    printf("%-9s %8u %8u %8u\n", name, on.sent[i], topics[i].samples,
+           topics[i].wrong);
+    failed = failed || topics[i].samples != on.sent[i] || topics[i].wrong;
+  }
+  printf("%-9s %8u %8u %8u\n", "broadcast", on.broadcasts, frames.samples,
+         frames.wrong);
+  failed = failed || frames.samples != on.broadcasts || frames.wrong;
+
+  if (failed)
+  {
+    printf("\nFAILED: the recording does not hold every frame sent\n");
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,407 @@
+/*! @file benchmarks/image_convert_bench.cpp
+ *  @version 4.0.0
+ *  @date Oct 2026
+ *
+ *  @brief
+ *  Cost of each output format of DJICameraStreamDecoder once a frame is
+ *  decoded. DJIImageConverter::yuv420pToRgb24 is checked bit for bit
+ *  against the 6-bit fixed point formula, for every width up to 67 and
+ *  padded strides, in RGB and BGR order. Its distance to exact BT.601 may
+ *  not exceed MAX_EXACT_ERROR. Throughput is then compared with the scalar
+ *  formula and with the sws_scale conversion the decoder used before
+ *  (bicubic), next to the plane copies and NV12 interleave of the native
+ *  formats. The sws_scale column reads n/a if no context can be created.
+ *
+ *  Frames are synthetic unless a raw YUV420P dump is given. To test
+ *  recorded H.264 streams, convert them first, e.g.
+ *    ffmpeg -i stream.h264 -f rawvideo -pix_fmt yuv420p frames.yuv
+ *
+ *  Usage: djiosdk-bench-image-convert [frames] [width height frames.yuv]
+ *
+ *  @Copyright (c) 2026 DJI
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#include "dji_image_converter.hpp"
+
+extern "C" {
+#include <libswscale/swscale.h>
+}
+
+#include <chrono>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+typedef std::chrono::steady_clock Clock;
+
+static const int MAX_CHECK_WIDTH = 67;
+//! 6-bit coefficients and truncation stay within this of exact BT.601
+static const int MAX_EXACT_ERROR = 3;
+
+//! Several decoded frames of one size, tightly packed YUV420P
+typedef struct FrameSet
+{
+  int                  width;
+  int                  height;
+  std::vector<uint8_t> data;
+  size_t               frameSize;
+  size_t               count;
+} FrameSet;
+
+static void
+planes(const FrameSet& set, size_t index, const uint8_t** y,
+       const uint8_t** u, const uint8_t** v)
+{
+  size_t lumaSize   = (size_t)set.width * set.height;
+  size_t chromaSize = (size_t)((set.width + 1) / 2) * ((set.height + 1) / 2);
+  *y                = &set.data[index * set.frameSize];
+  *u                = *y + lumaSize;
+  *v                = *u + chromaSize;
+}
+
+//! Same 6-bit fixed point math as dji_image_converter.cpp
+static uint8_t
+clampShift(int value)
+{
+  value >>= 6;
+  return (value < 0) ? 0 : ((value > 255) ? 255 : value);
+}
+
+static void
+referenceToRgb24(const uint8_t* y, int yStride, const uint8_t* u, int uStride,
+                 const uint8_t* v, int vStride, uint8_t* dst, int dstStride,
+                 int width, int height, bool bgr)
+{
+  int rIndex = bgr ? 2 : 0;
+  int bIndex = bgr ? 0 : 2;
+  for (int row = 0; row < height; row++)
+  {
+    const uint8_t* py = y + (size_t)row * yStride;
+    const uint8_t* pu = u + (size_t)(row / 2) * uStride;
+    const uint8_t* pv = v + (size_t)(row / 2) * vStride;
+    uint8_t*       pd = dst + (size_t)row * dstStride;
+    for (int x = 0; x < width; x++)
+    {
+      int yy             = (py[x] - 16) * 74;
+      int uu             = pu[x / 2] - 128;
+      int vv             = pv[x / 2] - 128;
+      pd[3 * x + rIndex] = clampShift(yy + 102 * vv);
+      pd[3 * x + 1]      = clampShift(yy - 25 * uu - 52 * vv);
+      pd[3 * x + bIndex] = clampShift(yy + 129 * uu);
+    }
+  }
+}
+
+/*! Every width up to MAX_CHECK_WIDTH with padded, odd strides, so each SIMD
+ *  block size and scalar tail is hit. Returns the number of wrong bytes.
+ */
+static uint64_t
+checkKernel()
+{
+  uint64_t mismatches = 0;
+  for (int width = 1; width <= MAX_CHECK_WIDTH; width++)
+  {
+    int height       = 1 + width % 5;
+    int chromaWidth  = (width + 1) / 2;
+    int chromaHeight = (height + 1) / 2;
+    int yStride      = width + 3;
+    int cStride      = chromaWidth + 1;
+    int dstStride    = 3 * width + 5;
+
+    std::vector<uint8_t> y((size_t)yStride * height);
+    std::vector<uint8_t> u((size_t)cStride * chromaHeight);
+    std::vector<uint8_t> v((size_t)cStride * chromaHeight);
+    for (size_t i = 0; i < y.size(); i++)
+    {
+      y[i] = rand();
+    }
+    for (size_t i = 0; i < u.size(); i++)
+    {
+      u[i] = rand();
+      v[i] = rand();
+    }
+
+    for (int bgr = 0; bgr < 2; bgr++)
+    {
+      std::vector<uint8_t> expected((size_t)dstStride * height, 0);
+      std::vector<uint8_t> actual((size_t)dstStride * height, 0);
+      referenceToRgb24(&y[0], yStride, &u[0], cStride, &v[0], cStride,
+                       &expected[0], dstStride, width, height, bgr);
+      DJIImageConverter::yuv420pToRgb24(&y[0], yStride, &u[0], cStride, &v[0],
+                                        cStride, &actual[0], dstStride, width,
+                                        height, bgr);
+      for (size_t i = 0; i < actual.size(); i++)
+      {
+        mismatches += actual[i] != expected[i];
+      }
+    }
+  }
+  return mismatches;
+}
+
+//! Largest distance of the kernel to floating point BT.601 on one frame
+static int
+maxErrorToExact(const FrameSet& set)
+{
+  const uint8_t *y, *u, *v;
+  planes(set, 0, &y, &u, &v);
+  int                  chromaWidth = (set.width + 1) / 2;
+  std::vector<uint8_t> rgb((size_t)set.width * set.height * 3);
+  DJIImageConverter::yuv420pToRgb24(y, set.width, u, chromaWidth, v,
+                                    chromaWidth, &rgb[0], set.width * 3,
+                                    set.width, set.height, false);
+
+  int worst = 0;
+  for (int row = 0; row < set.height; row++)
+  {
+    for (int x = 0; x < set.width; x++)
+    {
+      size_t c       = (size_t)(row / 2) * chromaWidth + x / 2;
+      double yy      = 1.164 * (y[(size_t)row * set.width + x] - 16);
+      double uu      = u[c] - 128.0;
+      double vv      = v[c] - 128.0;
+      double exact[] = { yy + 1.596 * vv, yy - 0.392 * uu - 0.813 * vv,
+                         yy + 2.017 * uu };
+      for (int ch = 0; ch < 3; ch++)
+      {
+        double clamped = (exact[ch] < 0) ? 0 : (exact[ch] > 255) ? 255
+                                                                 : exact[ch];
+        int    err =
+          (int)fabs(rgb[((size_t)row * set.width + x) * 3 + ch] - clamped);
+        worst = (err > worst) ? err : worst;
+      }
+    }
+  }
+  return worst;
+}
+
+//! Smooth gradients with noise, closer to camera frames than pure noise
+static FrameSet
+syntheticFrames(int width, int height, size_t count)
+{
+  FrameSet set;
+  set.width     = width;
+  set.height    = height;
+  set.frameSize = DJIImageConverter::getImageSize(CAMERA_IMAGE_FORMAT_YUV420P,
+                                                  width, height);
+  set.count     = count;
+  set.data.resize(set.frameSize * count);
+  for (size_t i = 0; i < set.data.size(); i++)
+  {
+    size_t offset = i % set.frameSize;
+    set.data[i]   = (uint8_t)(offset / 7 + offset % width + rand() % 16);
+  }
+  return set;
+}
+
+static bool
+loadFrames(const char* path, int width, int height, size_t maxCount,
+           FrameSet* set)
+{
+  FILE* file = fopen(path, "rb");
+  if (!file)
+  {
+    perror(path);
+    return false;
+  }
+  set->width     = width;
+  set->height    = height;
+  set->frameSize = DJIImageConverter::getImageSize(CAMERA_IMAGE_FORMAT_YUV420P,
+                                                   width, height);
+  set->data.resize(set->frameSize * maxCount);
+  set->count = fread(&set->data[0], set->frameSize, maxCount, file);
+  fclose(file);
+  set->data.resize(set->frameSize * set->count);
+  if (set->count == 0)
+  {
+    fprintf(stderr, "%s holds no complete %dx%d frame\n", path, width, height);
+    return false;
+  }
+  return true;
+}
+
+typedef enum Conversion
+{
+  TO_RGB_KERNEL,
+  TO_RGB_REFERENCE,
+  TO_RGB_SWSCALE,
+  TO_NV12,
+  TO_YUV420P
+} Conversion;
+
+//! Frames per second, 0 if the conversion is not available
+static double
+framesPerSecond(const FrameSet& set, Conversion conversion)
+{
+  int                  width       = set.width;
+  int                  height      = set.height;
+  int                  chromaWidth  = (width + 1) / 2;
+  int                  chromaHeight = (height + 1) / 2;
+  size_t               lumaSize     = (size_t)width * height;
+  size_t               chromaSize   = (size_t)chromaWidth * chromaHeight;
+  std::vector<uint8_t> out(DJIImageConverter::getImageSize(
+    CAMERA_IMAGE_FORMAT_RGB24, width, height));
+
+  SwsContext* sws = NULL;
+  if (conversion == TO_RGB_SWSCALE)
+  {
+    sws = sws_getCachedContext(NULL, width, height, AV_PIX_FMT_YUV420P, width,
+                               height, AV_PIX_FMT_RGB24, SWS_BICUBIC, NULL,
+                               NULL, NULL);
+    if (!sws)
+    {
+      return 0;
+    }
+  }
+
+  //! At least a second of work so small frames are not dominated by noise
+  size_t            converted = 0;
+  double            seconds   = 0;
+  Clock::time_point start     = Clock::now();
+  while (seconds < 1.0 || converted < set.count)
+  {
+    const uint8_t *y, *u, *v;
+    planes(set, converted % set.count, &y, &u, &v);
+    switch (conversion)
+    {
+      case TO_RGB_KERNEL:
+        DJIImageConverter::yuv420pToRgb24(y, width, u, chromaWidth, v,
+                                          chromaWidth, &out[0], width * 3,
+                                          width, height, false);
+        break;
+      case TO_RGB_REFERENCE:
+        referenceToRgb24(y, width, u, chromaWidth, v, chromaWidth, &out[0],
+                         width * 3, width, height, false);
+        break;
+      case TO_RGB_SWSCALE:
+      {
+        const uint8_t* src[]       = { y, u, v };
+        const int      srcStride[] = { width, chromaWidth, chromaWidth };
+        uint8_t*       dst[]       = { &out[0] };
+        const int      dstStride[] = { width * 3 };
+        sws_scale(sws, src, srcStride, 0, height, dst, dstStride);
+        break;
+      }
+      case TO_NV12:
+        DJIImageConverter::copyPlane(y, width, &out[0], width, width, height);
+        DJIImageConverter::interleaveUV(u, chromaWidth, v, chromaWidth,
+                                        &out[lumaSize], chromaWidth * 2,
+                                        chromaWidth, chromaHeight);
+        break;
+      default:
+        DJIImageConverter::copyPlane(y, width, &out[0], width, width, height);
+        DJIImageConverter::copyPlane(u, chromaWidth, &out[lumaSize],
+                                     chromaWidth, chromaWidth, chromaHeight);
+        DJIImageConverter::copyPlane(v, chromaWidth,
+                                     &out[lumaSize + chromaSize], chromaWidth,
+                                     chromaWidth, chromaHeight);
+        break;
+    }
+    converted++;
+    seconds = std::chrono::duration<double>(Clock::now() - start).count();
+  }
+
+  if (sws)
+  {
+    sws_freeContext(sws);
+  }
+  return converted / seconds;
+}
+
+static void
+report(const FrameSet& set)
+{
+  double kernel = framesPerSecond(set, TO_RGB_KERNEL);
+  double sws    = framesPerSecond(set, TO_RGB_SWSCALE);
+  char   swsText[32];
+  if (sws > 0)
+  {
+    snprintf(swsText, sizeof(swsText), "%9.0f %5.1fx", sws, kernel / sws);
+  }
+  else
+  {
+    snprintf(swsText, sizeof(swsText), "%15s", "n/a");
+  }
+  printf("%5dx%-5d %10.0f %10.0f %s %10.0f %10.0f\n", set.width, set.height,
+         kernel, framesPerSecond(set, TO_RGB_REFERENCE), swsText,
+         framesPerSecond(set, TO_NV12), framesPerSecond(set, TO_YUV420P));
+}
+
+int
+main(int argc, char** argv)
+{
+  size_t frames = (argc > 1) ? atoi(argv[1]) : 8;
+  if (frames == 0 || (argc != 1 && argc != 2 && argc != 5))
+  {
+    printf("Usage: %s [frames] [width height frames.yuv]\n", argv[0]);
+    return 1;
+  }
+
+  srand(1);
+  uint64_t mismatches = checkKernel();
+  printf("kernel: %s\n", DJIImageConverter::getKernelName());
+  printf("widths 1..%d, padded strides, RGB and BGR: %llu mismatches\n",
+         MAX_CHECK_WIDTH, (unsigned long long)mismatches);
+
+  std::vector<FrameSet> sets;
+  if (argc == 5)
+  {
+    FrameSet recorded;
+    if (!loadFrames(argv[4], atoi(argv[2]), atoi(argv[3]), frames, &recorded))
+    {
+      return 1;
+    }
+    sets.push_back(recorded);
+  }
+  else
+  {
+    //! FPV, main camera sizes and an odd size for the scalar tails
+    sets.push_back(syntheticFrames(608, 448, frames));
+    sets.push_back(syntheticFrames(1280, 720, frames));
+    sets.push_back(syntheticFrames(1920, 1080, frames));
+    sets.push_back(syntheticFrames(1283, 721, frames));
+  }
+  int exactError = maxErrorToExact(sets[0]);
+  printf("largest distance to exact BT.601: %d\n\n", exactError);
+
+  printf("%-11s %10s %10s %15s %10s %10s\n", "frames/s", "RGB kernel",
+         "RGB scalar", "RGB sws_scale", "NV12", "YUV420P");
+  for (size_t i = 0; i < sets.size(); i++)
+  {
+    report(sets[i]);
+  }
+
+  if (mismatches)
+  {
+    printf("\nFAILED: the %s kernel differs from the fixed point formula\n",
+           DJIImageConverter::getKernelName());
+    return 1;
+  }
+  if (exactError > MAX_EXACT_ERROR)
+  {
+    printf("\nFAILED: RGB is %d away from exact BT.601\n", exactError);
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,191 @@
+/*! @file benchmarks/log_bench.cpp
+ *  @version 4.0.0
+ *  @date Oct 2026
+ *
+ *  @brief
+ *  Time of a single DSTATUS call with the text output on the calling
+ *  thread, with the asynchronous backend and with the binary log. The log
+ *  output goes to /dev/null, the results to stdout.
+ *
+ *  The crash check runs a child that logs, crashes with SIGSEGV and must
+ *  still deliver its queued messages through the crash handler.
+ *
+ *  Usage: djiosdk-bench-log [calls per mode]
+ *
+ *  @Copyright (c) 2026 DJI
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#include "bench_osal.hpp"
+#include "dji_log.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <fcntl.h>
+#include <signal.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <vector>
+
+using namespace DJI::OSDK;
+
+typedef std::chrono::steady_clock Clock;
+
+static const int CRASH_MESSAGES = 64;
+
+static FILE* results;
+
+static void
+report(const char* mode, std::vector<uint32_t>& ns, uint64_t dropped)
+{
+  std::sort(ns.begin(), ns.end());
+  size_t n = ns.size();
+  fprintf(results, "%-8s %10u %10u %10u %10u %12llu\n", mode, ns[n / 2],
+          ns[n * 99 / 100], ns[n * 999 / 1000], ns[n - 1],
+          (unsigned long long)dropped);
+}
+
+static void
+measure(const char* mode, int calls)
+{
+  std::vector<uint32_t> ns(calls);
+  uint64_t              dropped = Log::instance().getDroppedLogCount();
+  for (int i = 0; i < calls; i++)
+  {
+    Clock::time_point start = Clock::now();
+    DSTATUS("benchmark message %d, value %f, name %s", i, i * 0.5, mode);
+    ns[i] = std::chrono::duration_cast<std::chrono::nanoseconds>(
+              Clock::now() - start)
+              .count();
+  }
+  Log::instance().flush();
+  report(mode, ns, Log::instance().getDroppedLogCount() - dropped);
+}
+
+/* The child logs CRASH_MESSAGES lines into a pipe and crashes right away,
+ * most of them are still queued and only the crash handler writes them.
+ */
+static bool
+crashCheck()
+{
+  int fds[2];
+  if (pipe(fds) != 0)
+  {
+    return false;
+  }
+
+  pid_t child = fork();
+  if (child == 0)
+  {
+    dup2(fds[1], STDOUT_FILENO);
+    close(fds[0]);
+    Log::instance().enableAsyncLogging(CRASH_MESSAGES * 2);
+    Log::instance().installCrashFlushHandler();
+    for (int i = 0; i < CRASH_MESSAGES; i++)
+    {
+      DSTATUS("crash check %d", i);
+    }
+    raise(SIGSEGV);
+    _exit(0);
+  }
+  close(fds[1]);
+
+  std::string output;
+  char        buf[4096];
+  ssize_t     len;
+  while ((len = read(fds[0], buf, sizeof(buf))) > 0)
+  {
+    output.append(buf, len);
+  }
+  close(fds[0]);
+
+  int status = 0;
+  waitpid(child, &status, 0);
+
+  int found = 0;
+  for (int i = 0; i < CRASH_MESSAGES; i++)
+  {
+    char line[64];
+    snprintf(line, sizeof(line), ": crash check %d\n", i);
+    found += (output.find(line) != std::string::npos) ? 1 : 0;
+  }
+  bool signaled = WIFSIGNALED(status) && WTERMSIG(status) == SIGSEGV;
+  bool header   = output.find("STATUS/") != std::string::npos;
+
+  fprintf(results, "\ncrash check: %d of %d messages written, %s, %s\n",
+          found, CRASH_MESSAGES, header ? "headers ok" : "headers missing",
+          signaled ? "died of SIGSEGV" : "did not die of SIGSEGV");
+  return found == CRASH_MESSAGES && signaled && header;
+}
+
+int
+main(int argc, char** argv)
+{
+  int calls = (argc > 1) ? atoi(argv[1]) : 100000;
+  if (calls <= 0)
+  {
+    printf("Usage: %s [calls per mode]\n", argv[0]);
+    return 1;
+  }
+  if (!registerLinuxOsal())
+  {
+    return 1;
+  }
+
+  // Keep stdout for the results, the log output goes to /dev/null
+  fflush(stdout);
+  results = fdopen(dup(STDOUT_FILENO), "w");
+  int null = open("/dev/null", O_WRONLY);
+  dup2(null, STDOUT_FILENO);
+  close(null);
+
+  fprintf(results, "%d calls per mode, time per call in ns\n\n", calls);
+  fprintf(results, "%-8s %10s %10s %10s %10s %12s\n", "mode", "p50", "p99",
+          "p99.9", "max", "dropped");
+
+  measure("sync", calls);
+
+  if (Log::instance().enableAsyncLogging())
+  {
+    measure("async", calls);
+    Log::instance().disableAsyncLogging();
+  }
+
+  char path[] = "/tmp/djiosdk-bench-log-XXXXXX";
+  int  fd     = mkstemp(path);
+  if (fd >= 0 && Log::instance().enableBinaryLogging(path))
+  {
+    measure("binary", calls);
+    Log::instance().disableBinaryLogging();
+  }
+  if (fd >= 0)
+  {
+    close(fd);
+    unlink(path);
+  }
+
+  bool ok = crashCheck();
+  fclose(results);
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,249 @@
+/*! @file benchmarks/mmu_stress_bench.cpp
+ *  @version 4.0.0
+ *  @date Oct 2026
+ *
+ *  @brief
+ *  Session buffer allocator of the protocol layer under many concurrent
+ *  sessions. Each run keeps a number of session buffers live and replaces
+ *  one at random with every step, sized like the encrypted frames of the
+ *  send path. Every allocMemory and freeMemory call is timed, and the MMU
+ *  statistics are reported after the run.
+ *
+ *  Between the timed calls every live buffer is checked: it has to lie in
+ *  the arena, must not overlap another one, and has to hold the bytes it
+ *  was filled with, also after the arena was compacted.
+ *
+ *  Usage: djiosdk-bench-mmu-stress [steps per run]
+ *
+ *  @Copyright (c) 2026 DJI
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#include "dji_memory.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+using namespace DJI::OSDK;
+
+typedef std::chrono::steady_clock Clock;
+
+//! One tab per session buffer
+static const int MAX_SESSIONS = MMU::MMU_TABLE_NUM;
+
+//! Frame header, command set and id, CRC32, then padded for AES
+static const uint16_t FRAME_OVERHEAD = 12 + 2 + 4;
+
+static const int liveCounts[] = { 1, 4, 8, 16, 24, MAX_SESSIONS };
+static const int RUNS         = sizeof(liveCounts) / sizeof(liveCounts[0]);
+
+typedef struct Session
+{
+  MMU_Tab* tab;
+  uint8_t  fill;
+} Session;
+
+typedef struct RunResult
+{
+  std::vector<uint32_t> allocNs;
+  std::vector<uint32_t> freeNs;
+  uint32_t              wrong;
+} RunResult;
+
+static uint32_t
+nextRandom(uint32_t* seed)
+{
+  *seed = *seed * 1664525 + 1013904223;
+  return *seed >> 8;
+}
+
+static uint32_t
+elapsedNs(Clock::time_point since)
+{
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() -
+                                                              since)
+    .count();
+}
+
+//! Mostly short commands, one in ten carries a larger payload
+static uint16_t
+sessionSize(uint32_t* seed)
+{
+  uint16_t payload = (nextRandom(seed) % 10 == 0)
+                       ? 64 + nextRandom(seed) % 160
+                       : 1 + nextRandom(seed) % 40;
+  return ((FRAME_OVERHEAD + payload + 15) / 16) * 16;
+}
+
+//! Buffers out of the arena, overlapping another one or changed count
+static uint32_t
+check(const std::vector<Session>& live, const uint8_t* arenaBegin,
+      const uint8_t* arenaEnd)
+{
+  uint32_t wrong = 0;
+  for (size_t i = 0; i < live.size(); i++)
+  {
+    const MMU_Tab* tab = live[i].tab;
+    if (tab->pmem < arenaBegin || tab->pmem + tab->memSize > arenaEnd)
+    {
+      wrong++;
+      continue;
+    }
+    for (size_t j = i + 1; j < live.size(); j++)
+    {
+      const MMU_Tab* other = live[j].tab;
+      if (tab->pmem < other->pmem + other->memSize &&
+          other->pmem < tab->pmem + tab->memSize)
+      {
+        wrong++;
+      }
+    }
+    for (uint32_t k = 0; k < tab->memSize; k++)
+    {
+      if (tab->pmem[k] != live[i].fill)
+      {
+        wrong++;
+        break;
+      }
+    }
+  }
+  return wrong;
+}
+
+static void
+run(MMU* mmu, int liveCount, unsigned steps, RunResult* result,
+    MMU::Stats* stats)
+{
+  //! The arena is private, the first buffer of an empty one starts it
+  mmu->setupMMU();
+  uint8_t* begin = mmu->allocMemory(MMU::MEMORY_UNIT)->pmem;
+  uint8_t* end   = begin + MMU::MEMORY_SIZE;
+  mmu->setupMMU();
+
+  std::vector<Session> live;
+  uint32_t             seed = 1 + liveCount;
+  uint8_t              fill = 0;
+  bool                 full = false;
+  result->allocNs.clear();
+  result->freeNs.clear();
+  result->wrong = 0;
+
+  for (unsigned step = 0; step < steps; step++)
+  {
+    //! A full arena fails the command, a session ends before the next one
+    if ((int)live.size() == liveCount || (full && !live.empty()))
+    {
+      size_t  victim = nextRandom(&seed) % live.size();
+      Session session = live[victim];
+      live[victim]    = live.back();
+      live.pop_back();
+
+      Clock::time_point start = Clock::now();
+      mmu->freeMemory(session.tab);
+      result->freeNs.push_back(elapsedNs(start));
+    }
+
+    uint16_t          size  = sessionSize(&seed);
+    Clock::time_point start = Clock::now();
+    MMU_Tab*          tab   = mmu->allocMemory(size);
+    result->allocNs.push_back(elapsedNs(start));
+    full = (tab == NULL);
+    if (tab)
+    {
+      Session session = { tab, ++fill };
+      memset(tab->pmem, session.fill, tab->memSize);
+      live.push_back(session);
+    }
+    result->wrong += check(live, begin, end);
+  }
+
+  mmu->getStats(*stats);
+}
+
+//! Median of an empty timed section, part of every time reported
+static uint32_t
+clockOverheadNs(void)
+{
+  std::vector<uint32_t> ns;
+  for (int i = 0; i < 100000; i++)
+  {
+    Clock::time_point start = Clock::now();
+    ns.push_back(elapsedNs(start));
+  }
+  std::sort(ns.begin(), ns.end());
+  return ns[ns.size() / 2];
+}
+
+static void
+report(std::vector<uint32_t>& ns)
+{
+  std::sort(ns.begin(), ns.end());
+  size_t n = ns.size();
+  printf(" %6u %6u %6u", ns[n / 2], ns[n * 99 / 100], ns[n - 1]);
+}
+
+int
+main(int argc, char** argv)
+{
+  unsigned steps = (argc > 1) ? atoi(argv[1]) : 200000;
+  if (steps == 0)
+  {
+    printf("Usage: %s [steps per run]\n", argv[0]);
+    return 1;
+  }
+
+  printf("%u steps per run, %d byte arena, %d tabs, clock overhead %u ns\n\n",
+         steps, MMU::MEMORY_SIZE, MMU::MMU_TABLE_NUM, clockOverheadNs());
+  printf("%4s %20s %20s %35s\n", "", "alloc ns", "free ns",
+         "stats at the end of the run");
+  printf("%4s %6s %6s %6s %6s %6s %6s %6s %7s %5s %6s %7s %5s\n", "live",
+         "p50", "p99", "max", "p50", "p99", "max", "fail", "compact", "peak",
+         "blocks", "largest", "wrong");
+
+  MMU  mmu;
+  bool failed = false;
+  for (int r = 0; r < RUNS; r++)
+  {
+    RunResult  result;
+    MMU::Stats stats;
+    run(&mmu, liveCounts[r], steps, &result, &stats);
+
+    printf("%4d", liveCounts[r]);
+    report(result.allocNs);
+    report(result.freeNs);
+    printf(" %6u %7u %5u %6u %7u %5u\n", stats.failCount,
+           stats.compactCount, stats.peakUsedBytes, stats.freeBlocks,
+           stats.largestFreeBlock, result.wrong);
+    failed = failed || result.wrong != 0;
+  }
+
+  if (failed)
+  {
+    printf("\nFAILED: a session buffer was out of the arena, overlapped "
+           "another one or lost its contents\n");
+    return 1;
+  }
+  return 0;
+}
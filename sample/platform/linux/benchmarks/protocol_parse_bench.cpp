@@ -0,0 +1,430 @@
+/*! @file benchmarks/protocol_parse_bench.cpp
+ *  @version 4.0.0
+ *  @date Oct 2026
+ *
+ *  @brief
+ *  Receive parser of ProtocolBase, byte by byte against the bulk frame
+ *  scanner, on AdvancedSensingProtocol streams of 240p and VGA frames.
+ *  A stream is handed to the protocol in reads of random size, as the USB
+ *  driver returns them, and receive() is called until it is used up. The
+ *  noisy stream adds bursts of random bytes between the frames, with lone
+ *  SOF bytes and headers of impossible length the parsers have to skip.
+ *  Every frame has to come out, in order.
+ *
+ *  Usage: djiosdk-bench-protocol-parse [rounds] [capture]
+ *
+ *  A capture is a file of records, each a uint32_t length and that many
+ *  bytes as one USB read returned them. It is parsed in addition to the
+ *  generated streams, and both parsers have to find the same frames.
+ *
+ *  @Copyright (c) 2026 DJI
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#include "bench_osal.hpp"
+#include "dji_advanced_sensing_protocol.hpp"
+#include "dji_log.hpp"
+
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+using namespace DJI::OSDK;
+
+typedef std::chrono::steady_clock Clock;
+
+//! Wire layout of the frames, see dji_advanced_sensing_protocol.cpp
+static const int HEADER_SIZE     = 12;
+static const int IMG_DESC_SIZE   = CAMERA_PAIR_NUM * IMAGE_TYPE_NUM * 4;
+static const int VGA_DESC_SIZE   = 64 * 4;
+static const int IMAGES_PER_240P = 4;
+
+//! BUFFER_SIZE of AdvancedSensingProtocol, the largest read it asks for
+static const uint32_t MAX_READ = 1024 * 600;
+
+static uint32_t
+nextRandom(uint32_t* seed)
+{
+  *seed = *seed * 1664525 + 1013904223;
+  return *seed >> 8;
+}
+
+//! Replays a stream in reads of random size, or as recorded
+class ChunkDriver : public HardDriver
+{
+public:
+  //! Without recordEnds the reads are 1..maxRead bytes
+  ChunkDriver(const std::vector<uint8_t>&  data,
+              const std::vector<uint32_t>& recordEnds, uint32_t maxRead)
+    : data(data)
+    , recordEnds(recordEnds)
+    , maxRead(maxRead)
+    , pos(0)
+    , record(0)
+    , seed(7)
+  {
+  }
+
+  void init()
+  {
+  }
+
+  time_ms getTimeStamp()
+  {
+    return 0;
+  }
+
+  size_t send(const uint8_t* buf, size_t len)
+  {
+    (void)buf;
+    return len;
+  }
+
+  size_t readall(uint8_t* buf, size_t maxlen)
+  {
+    if (exhausted())
+    {
+      return (size_t)-1;
+    }
+    size_t len;
+    if (recordEnds.empty())
+    {
+      len = 1 + nextRandom(&seed) % maxRead;
+      len = (len < data.size() - pos) ? len : data.size() - pos;
+    }
+    else
+    {
+      len = recordEnds[record] - pos;
+    }
+    len = (len < maxlen) ? len : maxlen;
+    memcpy(buf, &data[pos], len);
+    pos += len;
+    if (!recordEnds.empty() && pos == recordEnds[record])
+    {
+      record++;
+    }
+    return len;
+  }
+
+  bool exhausted() const
+  {
+    return pos == data.size();
+  }
+
+private:
+  const std::vector<uint8_t>&  data;
+  const std::vector<uint32_t>& recordEnds;
+  uint32_t                     maxRead;
+  size_t                       pos;
+  size_t                       record;
+  uint32_t                     seed;
+};
+
+//! Switches the protocol between the byte path and the bulk scanner
+class ParseProtocol : public AdvancedSensingProtocol
+{
+public:
+  void setBulkScan(bool enable)
+  {
+    bulk_scan = enable;
+  }
+};
+
+typedef struct Stream
+{
+  const char*           name;
+  uint32_t              maxRead;
+  std::vector<uint8_t>  data;
+  std::vector<uint32_t> recordEnds; //! empty for reads of random size
+  std::vector<uint32_t> expected;   //! frame indices, empty for a capture
+} Stream;
+
+typedef struct RunResult
+{
+  std::vector<uint32_t> frames;
+  double                seconds;
+} RunResult;
+
+static void
+appendFrame(std::vector<uint8_t>* data, uint8_t cmdId, uint32_t length)
+{
+  uint8_t header[HEADER_SIZE] = { AdvancedSensingProtocol::SOF1,
+                                  AdvancedSensingProtocol::SOF2, cmdId };
+  memcpy(&header[4], &length, sizeof(length));
+  data->insert(data->end(), header, header + HEADER_SIZE);
+  data->resize(data->size() + length);
+}
+
+static void
+fillImage(uint8_t* image, int size, uint32_t* seed)
+{
+  for (int i = 0; i < size; i++)
+  {
+    image[i] = nextRandom(seed) >> 16;
+  }
+}
+
+/*! Random bytes, every eighth one a SOF1. A SOF2 never follows, so the
+ *  parsers only resync on the frames and the headers added here. One burst
+ *  in four ends in a header whose length is larger than any frame.
+ */
+static void
+addNoise(std::vector<uint8_t>* data, uint32_t* seed)
+{
+  uint32_t count = 1 + nextRandom(seed) % 256;
+  for (uint32_t i = 0; i < count; i++)
+  {
+    uint8_t byte = nextRandom(seed) >> 16;
+    if (nextRandom(seed) % 8 == 0)
+    {
+      byte = AdvancedSensingProtocol::SOF1;
+    }
+    else if (byte == AdvancedSensingProtocol::SOF2)
+    {
+      byte = 0;
+    }
+    data->push_back(byte);
+  }
+  if (nextRandom(seed) % 4 == 0)
+  {
+    appendFrame(data, AdvancedSensingProtocol::PROCESS_VGA_CMD_ID, 0);
+    uint32_t length = 0xFFFF0000;
+    memcpy(&(*data)[data->size() - HEADER_SIZE + 4], &length,
+           sizeof(length));
+  }
+}
+
+//! 240p and VGA frames in turn, the index is the frame number
+static void
+generateStream(Stream* stream, uint32_t frames, bool noisy)
+{
+  uint32_t seed = noisy ? 11 : 3;
+  for (uint32_t index = 0; index < frames; index++)
+  {
+    if (noisy)
+    {
+      addNoise(&stream->data, &seed);
+    }
+    if (index % 2 == 0)
+    {
+      //! front left/right, down back/front
+      uint32_t length =
+        IMAGES_PER_240P * ACK::IMG_240P_SIZE + 8 + IMG_DESC_SIZE;
+      appendFrame(&stream->data, AdvancedSensingProtocol::PROCESS_IMG_CMD_ID,
+                  length);
+      uint8_t* payload = &stream->data[stream->data.size() - length];
+      fillImage(payload, IMAGES_PER_240P * ACK::IMG_240P_SIZE, &seed);
+      uint8_t* trailer = payload + IMAGES_PER_240P * ACK::IMG_240P_SIZE;
+      memcpy(trailer, &index, 4);
+      memcpy(trailer + 4, &index, 4);
+      uint32_t desc[CAMERA_PAIR_NUM][IMAGE_TYPE_NUM] = { { 0 } };
+      desc[AdvancedSensingProtocol::DOWN][AdvancedSensingProtocol::LEFT]   = 1;
+      desc[AdvancedSensingProtocol::DOWN][AdvancedSensingProtocol::RIGHT]  = 1;
+      desc[AdvancedSensingProtocol::FRONT][AdvancedSensingProtocol::LEFT]  = 1;
+      desc[AdvancedSensingProtocol::FRONT][AdvancedSensingProtocol::RIGHT] = 1;
+      memcpy(trailer + 8, desc, IMG_DESC_SIZE);
+    }
+    else
+    {
+      //! VGADescription: index, time stamp, direction, ...
+      uint32_t length = 2 * ACK::IMG_VGA_SIZE + VGA_DESC_SIZE;
+      appendFrame(&stream->data, AdvancedSensingProtocol::PROCESS_VGA_CMD_ID,
+                  length);
+      uint8_t* payload = &stream->data[stream->data.size() - length];
+      fillImage(payload, 2 * ACK::IMG_VGA_SIZE, &seed);
+      uint8_t* desc = payload + 2 * ACK::IMG_VGA_SIZE;
+      memcpy(desc, &index, 4);
+      memcpy(desc + 4, &index, 4);
+    }
+    stream->expected.push_back(index);
+  }
+}
+
+static bool
+loadCapture(const char* path, Stream* stream)
+{
+  FILE* file = fopen(path, "rb");
+  if (!file)
+  {
+    perror(path);
+    return false;
+  }
+  uint32_t length;
+  while (fread(&length, sizeof(length), 1, file) == 1)
+  {
+    size_t start = stream->data.size();
+    stream->data.resize(start + length);
+    if (length && fread(&stream->data[start], length, 1, file) != 1)
+    {
+      fprintf(stderr, "%s: truncated record\n", path);
+      fclose(file);
+      return false;
+    }
+    stream->recordEnds.push_back(stream->data.size());
+  }
+  fclose(file);
+  return !stream->recordEnds.empty();
+}
+
+static uint32_t
+frameIndex(ParseProtocol* protocol, const RecvContainer* container)
+{
+  StereoFramePtr frame = protocol->takeStereoFrame();
+  if (frame)
+  {
+    return frame->frame_index;
+  }
+  //! Every buffer was held, the frame was copied into the container
+  if (container->recvInfo.cmd_id ==
+      AdvancedSensingProtocol::PROCESS_IMG_CMD_ID)
+  {
+    return container->recvData.stereoImgData->frame_index;
+  }
+  return container->recvData.stereoVGAImgData->frame_index;
+}
+
+//! A new protocol for every run, so that no parser state is carried over
+static RunResult
+parse(const Stream& stream, bool bulk)
+{
+  RunResult      result;
+  ParseProtocol* protocol = new ParseProtocol();
+  protocol->setBulkScan(bulk);
+  ChunkDriver* driver =
+    new ChunkDriver(stream.data, stream.recordEnds, stream.maxRead);
+  delete protocol->getDriver();
+  protocol->setDriver(driver);
+
+  Clock::time_point start = Clock::now();
+  while (!driver->exhausted() ||
+         protocol->getBufReadPos() < protocol->getReadLen())
+  {
+    RecvContainer* container = protocol->receive();
+    if (container->recvInfo.cmd_id != 0xFF)
+    {
+      result.frames.push_back(frameIndex(protocol, container));
+    }
+  }
+  result.seconds =
+    std::chrono::duration<double>(Clock::now() - start).count();
+
+  delete protocol;
+  return result;
+}
+
+//! Frames missing, out of order or not in the stream
+static size_t
+countWrong(const std::vector<uint32_t>& frames,
+           const std::vector<uint32_t>& expected)
+{
+  size_t wrong = (frames.size() > expected.size())
+                   ? frames.size() - expected.size()
+                   : expected.size() - frames.size();
+  for (size_t i = 0; i < frames.size() && i < expected.size(); i++)
+  {
+    wrong += (frames[i] != expected[i]) ? 1 : 0;
+  }
+  return wrong;
+}
+
+int
+main(int argc, char** argv)
+{
+  unsigned rounds = (argc > 1) ? atoi(argv[1]) : 3;
+  if (rounds == 0)
+  {
+    printf("Usage: %s [rounds] [capture]\n", argv[0]);
+    return 1;
+  }
+
+  if (!registerLinuxOsal())
+  {
+    return 1;
+  }
+  Log::instance().disableStatusLogging();
+  Log::instance().disableErrorLogging();
+
+  //! Reads up to the full buffer, and short ones that split every frame
+  std::vector<Stream> streams(3);
+  streams[0].name    = "clean";
+  streams[0].maxRead = MAX_READ;
+  streams[1].name    = "noisy";
+  streams[1].maxRead = MAX_READ;
+  streams[2].name    = "clean 4K";
+  streams[2].maxRead = 4096;
+  generateStream(&streams[0], 200, false);
+  generateStream(&streams[1], 200, true);
+  generateStream(&streams[2], 200, false);
+  if (argc > 2)
+  {
+    Stream capture;
+    capture.name    = "capture";
+    capture.maxRead = MAX_READ;
+    if (!loadCapture(argv[2], &capture))
+    {
+      return 1;
+    }
+    streams.push_back(capture);
+  }
+
+  printf("%u rounds, best round reported\n\n", rounds);
+  printf("%-9s %-6s %8s %8s %8s %10s\n", "stream", "parser", "MB", "frames",
+         "wrong", "MB/s");
+
+  bool failed = false;
+  for (size_t s = 0; s < streams.size(); s++)
+  {
+    const Stream& stream = streams[s];
+    RunResult     first[2];
+    for (int mode = 0; mode < 2; mode++)
+    {
+      double best = 0;
+      for (unsigned round = 0; round < rounds; round++)
+      {
+        RunResult r = parse(stream, mode == 1);
+        best        = (round == 0 || r.seconds < best) ? r.seconds : best;
+        if (round == 0)
+        {
+          first[mode] = r;
+        }
+      }
+
+      //! A capture has no known frames, the byte path is the reference
+      const std::vector<uint32_t>& expected =
+        stream.expected.empty() ? first[0].frames : stream.expected;
+      size_t wrong = countWrong(first[mode].frames, expected);
+      double mb    = stream.data.size() / 1e6;
+      printf("%-9s %-6s %8.1f %8u %8u %10.1f\n", stream.name,
+             mode ? "bulk" : "byte", mb, (unsigned)first[mode].frames.size(),
+             (unsigned)wrong, mb / best);
+      failed = failed || (mode == 1 && wrong != 0);
+    }
+  }
+
+  if (failed)
+  {
+    printf("\nFAILED: the bulk scanner lost or invented frames\n");
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,313 @@
+/*! @file benchmarks/read_thread_bench.cpp
+ *  @version 4.0.0
+ *  @date Oct 2026
+ *
+ *  @brief
+ *  Idle CPU and first-frame latency of the Linux read threads.
+ *
+ *  Serial: a thread reads a pseudo terminal the way the read thread
+ *  does. The previous loop (non-blocking read, then usleep(10)) is
+ *  compared with LinuxSerialDevice::readall, which polls for up to
+ *  READ_TIMEOUT_MS. Each read loop first idles for a while and reports
+ *  its own CPU time and wakeups. Then 32 byte frames are written after
+ *  random idle gaps, so the 50 ms poll is caught at every phase. The
+ *  latency until the whole frame has been read is reported.
+ *
+ *  USB: the adv_pthread loop calls LinuxUSBDevice::readall. Without an
+ *  M210 attached that used to return at once and the loop slept 10 us.
+ *  It now waits out the driver timeout. With a device attached, reads
+ *  wait in the bulk reader until a transfer completes.
+ *
+ *  Usage: djiosdk-bench-read-thread [idle seconds] [frames]
+ *
+ *  @Copyright (c) 2026 DJI
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#include "bench_osal.hpp"
+#include "linux_serial_device.hpp"
+#include "linux_usb_device.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fcntl.h>
+#include <pty.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <thread>
+#include <time.h>
+#include <unistd.h>
+#include <vector>
+
+using namespace DJI::OSDK;
+
+typedef std::chrono::steady_clock Clock;
+
+static const size_t FRAME_SIZE = 32;
+
+typedef enum ReadMode
+{
+  SLEEP_LOOP,
+  SERIAL_READALL,
+  USB_READALL
+} ReadMode;
+
+typedef struct ReaderState
+{
+  ReadMode              mode;
+  int                   fd;
+  LinuxSerialDevice*    serial;
+  LinuxUSBDevice*       usb;
+  std::atomic<bool>     running;
+  std::atomic<uint64_t> wakeups;
+  std::atomic<int64_t>  frameDoneNs;
+  uint64_t              cpuNs;
+} ReaderState;
+
+static int64_t
+nowNs()
+{
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+           Clock::now().time_since_epoch())
+    .count();
+}
+
+static uint64_t
+threadCpuNs()
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+static void
+readLoop(ReaderState* state)
+{
+  uint8_t  buf[LinuxSerialDevice::BUFFER_SIZE];
+  size_t   received = 0;
+  uint64_t cpuStart = threadCpuNs();
+
+  while (state->running)
+  {
+    int ret;
+    switch (state->mode)
+    {
+      case SLEEP_LOOP:
+        ret = read(state->fd, buf, sizeof(buf));
+        break;
+      case SERIAL_READALL:
+        ret = (int)state->serial->readall(buf, sizeof(buf));
+        break;
+      default:
+        ret = (int)state->usb->readall(buf, sizeof(buf));
+        break;
+    }
+    state->wakeups++;
+
+    if (ret > 0)
+    {
+      received += ret;
+      if (received >= FRAME_SIZE)
+      {
+        received = 0;
+        state->frameDoneNs = nowNs();
+      }
+    }
+    if (state->mode == SLEEP_LOOP)
+    {
+      usleep(10);
+    }
+  }
+  state->cpuNs = threadCpuNs() - cpuStart;
+}
+
+static void
+reportIdle(const char* name, ReaderState* state, unsigned seconds)
+{
+  state->running = true;
+  state->wakeups = 0;
+  std::thread reader(readLoop, state);
+  std::this_thread::sleep_for(std::chrono::seconds(seconds));
+  state->running = false;
+  reader.join();
+
+  printf("%-28s %8.2f %% CPU %10.0f wakeups/s\n", name,
+         100.0 * state->cpuNs / (seconds * 1e9),
+         (double)state->wakeups / seconds);
+}
+
+/*! Write a frame after a random idle gap and time until the reader has all
+ *  of it. Returns the worst latency in microseconds.
+ */
+static double
+reportLatency(const char* name, ReaderState* state, int master,
+              unsigned frames)
+{
+  std::vector<double> latencyUs;
+  uint8_t             frame[FRAME_SIZE];
+  memset(frame, 0xAA, sizeof(frame));
+
+  state->running     = true;
+  state->frameDoneNs = 0;
+  std::thread reader(readLoop, state);
+
+  for (unsigned i = 0; i < frames; i++)
+  {
+    std::this_thread::sleep_for(std::chrono::milliseconds(20 + rand() % 100));
+    state->frameDoneNs = 0;
+    int64_t sentNs     = nowNs();
+    if (write(master, frame, sizeof(frame)) != (ssize_t)sizeof(frame))
+    {
+      break;
+    }
+    while (state->frameDoneNs == 0 && nowNs() - sentNs < 1000000000ll)
+    {
+      std::this_thread::sleep_for(std::chrono::microseconds(20));
+    }
+    if (state->frameDoneNs != 0)
+    {
+      latencyUs.push_back((state->frameDoneNs - sentNs) / 1000.0);
+    }
+  }
+  state->running = false;
+  reader.join();
+
+  if (latencyUs.size() != frames)
+  {
+    printf("%-28s %u of %u frames arrived\n", name,
+           (unsigned)latencyUs.size(), frames);
+    return 1e9;
+  }
+  std::sort(latencyUs.begin(), latencyUs.end());
+  printf("%-28s %8.0f us p50 %8.0f us p99 %8.0f us max\n", name,
+         latencyUs[latencyUs.size() / 2],
+         latencyUs[latencyUs.size() * 99 / 100], latencyUs.back());
+  return latencyUs.back();
+}
+
+static bool
+openPty(int* master, int* slave, char* slaveName)
+{
+  if (openpty(master, slave, slaveName, NULL, NULL) != 0)
+  {
+    perror("openpty");
+    return false;
+  }
+  struct termios raw;
+  tcgetattr(*master, &raw);
+  cfmakeraw(&raw);
+  tcsetattr(*master, TCSANOW, &raw);
+  return true;
+}
+
+int
+main(int argc, char** argv)
+{
+  unsigned seconds = (argc > 1) ? atoi(argv[1]) : 2;
+  unsigned frames  = (argc > 2) ? atoi(argv[2]) : 50;
+  if (seconds == 0 || frames == 0)
+  {
+    printf("Usage: %s [idle seconds] [frames]\n", argv[0]);
+    return 1;
+  }
+  if (!registerLinuxOsal())
+  {
+    return 1;
+  }
+  srand(1);
+
+  //! Previous loop: non-blocking read and usleep(10)
+  int  oldMaster, oldSlave;
+  char oldName[64];
+  if (!openPty(&oldMaster, &oldSlave, oldName))
+  {
+    return 1;
+  }
+  struct termios raw;
+  tcgetattr(oldSlave, &raw);
+  cfmakeraw(&raw);
+  tcsetattr(oldSlave, TCSANOW, &raw);
+  fcntl(oldSlave, F_SETFL, fcntl(oldSlave, F_GETFL) | O_NONBLOCK);
+
+  //! LinuxSerialDevice opens and configures its own end of the terminal
+  int  newMaster, newSlave;
+  char newName[64];
+  if (!openPty(&newMaster, &newSlave, newName))
+  {
+    return 1;
+  }
+  LinuxSerialDevice serial(newName, 921600);
+  serial.init();
+  if (!serial.getDeviceStatus())
+  {
+    printf("Could not open %s\n", newName);
+    return 1;
+  }
+
+  ReaderState before;
+  before.mode   = SLEEP_LOOP;
+  before.fd     = oldSlave;
+  before.serial = NULL;
+  before.usb    = NULL;
+
+  ReaderState after;
+  after.mode   = SERIAL_READALL;
+  after.fd     = -1;
+  after.serial = &serial;
+  after.usb    = NULL;
+
+  printf("\nIdle for %u s\n", seconds);
+  reportIdle("serial read + usleep(10)", &before, seconds);
+  reportIdle("serial readall (poll)", &after, seconds);
+
+  printf("\nFirst %u byte frame after 20-120 ms idle, %u frames\n",
+         (unsigned)FRAME_SIZE, frames);
+  reportLatency("serial read + usleep(10)", &before, oldMaster, frames);
+  double worstUs =
+    reportLatency("serial readall (poll)", &after, newMaster, frames);
+
+  //! adv_pthread with no M210 attached
+  LinuxUSBDevice usb;
+  usb.init();
+  ReaderState usbState;
+  usbState.mode   = USB_READALL;
+  usbState.fd     = -1;
+  usbState.serial = NULL;
+  usbState.usb    = &usb;
+  printf("\nIdle for %u s, USB\n", seconds);
+  reportIdle("usb readall", &usbState, seconds);
+
+  close(oldMaster);
+  close(oldSlave);
+  close(newMaster);
+  close(newSlave);
+
+  if (worstUs >= LinuxSerialDevice::READ_TIMEOUT_MS * 1000)
+  {
+    printf("\nFAILED: a frame waited out the %d ms poll timeout\n",
+           LinuxSerialDevice::READ_TIMEOUT_MS);
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,221 @@
+/*! @file benchmarks/seqlock_bench.cpp
+ *  @version 4.0.0
+ *  @date Oct 2026
+ *
+ *  @brief
+ *  Reader/writer contention of the subscription data buffer. One writer
+ *  stands in for the receive thread and publishes a package at a fixed
+ *  rate, a growing number of readers call the equivalent of getValue in a
+ *  tight loop. The SeqLock used by SubscriptionPackage is compared with the
+ *  mutex it replaced. Every copy is checked for torn data.
+ *
+ *  Usage: djiosdk-bench-seqlock [seconds per run] [writer Hz]
+ *
+ *  @Copyright (c) 2026 DJI
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#include "dji_seqlock.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <thread>
+#include <vector>
+
+using namespace DJI::OSDK;
+
+typedef std::chrono::steady_clock Clock;
+
+// Size of a typical package: quaternion, velocity, GPS and RC topics
+static const size_t PACKAGE_SIZE = 256;
+
+static uint8_t           storage[PACKAGE_SIZE];
+static SeqLock           seqLock;
+static std::mutex        dataMutex;
+static std::atomic<bool> running;
+
+typedef struct Result
+{
+  uint64_t reads;
+  uint64_t torn;
+  uint64_t writes;
+  uint64_t writeMaxNs;
+  uint64_t readMaxNs;
+} Result;
+
+static bool
+consistent(const uint8_t* data)
+{
+  for (size_t i = 1; i < PACKAGE_SIZE; i++)
+  {
+    if (data[i] != data[0])
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+static uint64_t
+elapsedNs(Clock::time_point since)
+{
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() -
+                                                              since)
+    .count();
+}
+
+static void
+writer(bool useSeqLock, unsigned hz, Result* result)
+{
+  uint8_t           frame[PACKAGE_SIZE];
+  uint8_t           counter = 0;
+  Clock::time_point next    = Clock::now();
+  Clock::duration   period  = std::chrono::microseconds(1000000 / hz);
+
+  while (running)
+  {
+    memset(frame, ++counter, sizeof(frame));
+
+    Clock::time_point start = Clock::now();
+    if (useSeqLock)
+    {
+      seqLock.write(storage, frame, sizeof(frame));
+    }
+    else
+    {
+      std::lock_guard<std::mutex> lock(dataMutex);
+      memcpy(storage, frame, sizeof(frame));
+    }
+    uint64_t ns = elapsedNs(start);
+
+    result->writes++;
+    result->writeMaxNs = (ns > result->writeMaxNs) ? ns : result->writeMaxNs;
+
+    next += period;
+    std::this_thread::sleep_until(next);
+  }
+}
+
+static void
+reader(bool useSeqLock, Result* result)
+{
+  uint8_t copy[PACKAGE_SIZE];
+
+  while (running)
+  {
+    Clock::time_point start = Clock::now();
+    if (useSeqLock)
+    {
+      seqLock.read(copy, storage, sizeof(copy));
+    }
+    else
+    {
+      std::lock_guard<std::mutex> lock(dataMutex);
+      memcpy(copy, storage, sizeof(copy));
+    }
+    uint64_t ns = elapsedNs(start);
+
+    result->reads++;
+    result->readMaxNs = (ns > result->readMaxNs) ? ns : result->readMaxNs;
+    if (!consistent(copy))
+    {
+      result->torn++;
+    }
+  }
+}
+
+static Result
+run(bool useSeqLock, int readers, unsigned seconds, unsigned hz)
+{
+  std::vector<Result>      results(readers + 1);
+  std::vector<std::thread> threads;
+
+  memset(storage, 0, sizeof(storage));
+  running = true;
+
+  threads.push_back(std::thread(writer, useSeqLock, hz, &results[0]));
+  for (int i = 0; i < readers; i++)
+  {
+    threads.push_back(std::thread(reader, useSeqLock, &results[i + 1]));
+  }
+  std::this_thread::sleep_for(std::chrono::seconds(seconds));
+  running = false;
+  for (size_t i = 0; i < threads.size(); i++)
+  {
+    threads[i].join();
+  }
+
+  Result total = results[0];
+  for (int i = 1; i <= readers; i++)
+  {
+    total.reads += results[i].reads;
+    total.torn += results[i].torn;
+    if (results[i].readMaxNs > total.readMaxNs)
+    {
+      total.readMaxNs = results[i].readMaxNs;
+    }
+  }
+  return total;
+}
+
+int
+main(int argc, char** argv)
+{
+  unsigned seconds = (argc > 1) ? atoi(argv[1]) : 2;
+  unsigned hz      = (argc > 2) ? atoi(argv[2]) : 1000;
+  if (seconds == 0 || hz == 0 || hz > 1000000)
+  {
+    printf("Usage: %s [seconds per run] [writer Hz]\n", argv[0]);
+    return 1;
+  }
+
+  printf("%u byte package, writer at %u Hz, %u s per run\n\n",
+         (unsigned)PACKAGE_SIZE, hz, seconds);
+  printf("%-8s %7s %14s %12s %14s %14s %6s\n", "lock", "readers",
+         "reads/s", "writes/s", "write max ns", "read max ns", "torn");
+
+  bool failed = false;
+  for (int readers = 1; readers <= 8; readers *= 2)
+  {
+    for (int mode = 0; mode < 2; mode++)
+    {
+      bool   useSeqLock = (mode == 0);
+      Result r          = run(useSeqLock, readers, seconds, hz);
+      printf("%-8s %7d %14.0f %12.0f %14llu %14llu %6llu\n",
+             useSeqLock ? "seqlock" : "mutex", readers,
+             (double)r.reads / seconds, (double)r.writes / seconds,
+             (unsigned long long)r.writeMaxNs,
+             (unsigned long long)r.readMaxNs, (unsigned long long)r.torn);
+      failed = failed || r.torn != 0;
+    }
+  }
+
+  if (failed)
+  {
+    printf("\nFAILED: a reader saw a torn package\n");
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,411 @@
+/*! @file benchmarks/stereo_frame_bench.cpp
+ *  @version 4.0.0
+ *  @date Oct 2026
+ *
+ *  @brief
+ *  Frame rate and CPU time of M210 stereo image delivery. A USB capture is
+ *  replayed through AdvancedSensingProtocol::receive() as fast as the
+ *  parser goes, and every image is read once by a consumer that either
+ *  - copies the frame into ACK::StereoImgData / StereoVGAImgData, as
+ *    every frame was before and as a VehicleCallBack still gets it, or
+ *  - reads the StereoFrame views in the receive buffer, releasing each
+ *    frame at once or holding the last few like a slow consumer.
+ *  All consumers must see the same images.
+ *
+ *  A capture is a sequence of records, each a little-endian uint32 length
+ *  followed by the bytes one readall() of the USB device returned.
+ *  Without one, 240p frames of four images alternating with VGA pairs are
+ *  generated.
+ *
+ *  Usage: djiosdk-bench-stereo-frame [frames] [passes] [capture file]
+ *
+ *  @Copyright (c) 2026 DJI
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#include "bench_osal.hpp"
+#include "dji_advanced_sensing_protocol.hpp"
+#include "dji_log.hpp"
+
+#include <chrono>
+#include <deque>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <vector>
+
+using namespace DJI::OSDK;
+
+typedef std::chrono::steady_clock Clock;
+
+//! Wire layout of the frames, see dji_advanced_sensing_protocol.cpp
+static const int HEADER_SIZE     = 12;
+static const int IMG_DESC_SIZE   = CAMERA_PAIR_NUM * IMAGE_TYPE_NUM * 4;
+static const int VGA_DESC_SIZE   = 64 * 4;
+static const int IMAGES_PER_240P = 4;
+
+/*! Replays a capture, one record per readall() like the USB bulk reader.
+ *  Records longer than the read size are returned in pieces.
+ */
+class CaptureDriver : public HardDriver
+{
+public:
+  CaptureDriver(const std::vector<uint8_t>&  data,
+                const std::vector<uint32_t>& recordEnds)
+    : data(data)
+    , recordEnds(recordEnds)
+    , pos(0)
+    , record(0)
+  {
+  }
+
+  void init()
+  {
+  }
+
+  time_ms getTimeStamp()
+  {
+    return 0;
+  }
+
+  size_t send(const uint8_t* buf, size_t len)
+  {
+    (void)buf;
+    return len;
+  }
+
+  size_t readall(uint8_t* buf, size_t maxlen)
+  {
+    if (record == recordEnds.size())
+    {
+      return (size_t)-1;
+    }
+    size_t len = recordEnds[record] - pos;
+    len        = (len < maxlen) ? len : maxlen;
+    memcpy(buf, &data[pos], len);
+    pos += len;
+    if (pos == recordEnds[record])
+    {
+      record++;
+    }
+    return len;
+  }
+
+  bool exhausted() const
+  {
+    return record == recordEnds.size();
+  }
+
+  void rewind()
+  {
+    pos    = 0;
+    record = 0;
+  }
+
+private:
+  const std::vector<uint8_t>&  data;
+  const std::vector<uint32_t>& recordEnds;
+  size_t                       pos;
+  size_t                       record;
+};
+
+static void
+appendFrame(std::vector<uint8_t>* capture, std::vector<uint32_t>* recordEnds,
+            uint8_t cmdId, const std::vector<uint8_t>& payload)
+{
+  uint8_t  header[HEADER_SIZE] = { AdvancedSensingProtocol::SOF1,
+                                  AdvancedSensingProtocol::SOF2, cmdId };
+  uint32_t length              = payload.size();
+  memcpy(&header[4], &length, sizeof(length));
+  capture->insert(capture->end(), header, header + HEADER_SIZE);
+  capture->insert(capture->end(), payload.begin(), payload.end());
+  recordEnds->push_back(capture->size());
+}
+
+static void
+fillImage(uint8_t* image, int size, uint32_t* seed)
+{
+  for (int i = 0; i < size; i++)
+  {
+    *seed    = *seed * 1664525 + 1013904223;
+    image[i] = *seed >> 24;
+  }
+}
+
+static void
+generateCapture(unsigned frames, std::vector<uint8_t>* capture,
+                std::vector<uint32_t>* recordEnds)
+{
+  uint32_t seed = 1;
+  for (uint32_t index = 0; index < frames; index++)
+  {
+    std::vector<uint8_t> payload;
+    if (index % 2 == 0)
+    {
+      //! front left/right, down back/front
+      payload.resize(IMAGES_PER_240P * ACK::IMG_240P_SIZE + 8 + IMG_DESC_SIZE);
+      for (int i = 0; i < IMAGES_PER_240P; i++)
+      {
+        fillImage(&payload[i * ACK::IMG_240P_SIZE], ACK::IMG_240P_SIZE, &seed);
+      }
+      uint8_t* trailer = &payload[IMAGES_PER_240P * ACK::IMG_240P_SIZE];
+      memcpy(trailer, &index, 4);
+      memcpy(trailer + 4, &index, 4);
+      uint32_t desc[CAMERA_PAIR_NUM][IMAGE_TYPE_NUM] = { { 0 } };
+      desc[AdvancedSensingProtocol::DOWN][AdvancedSensingProtocol::LEFT]   = 1;
+      desc[AdvancedSensingProtocol::DOWN][AdvancedSensingProtocol::RIGHT]  = 1;
+      desc[AdvancedSensingProtocol::FRONT][AdvancedSensingProtocol::LEFT]  = 1;
+      desc[AdvancedSensingProtocol::FRONT][AdvancedSensingProtocol::RIGHT] = 1;
+      memcpy(trailer + 8, desc, IMG_DESC_SIZE);
+      appendFrame(capture, recordEnds,
+                  AdvancedSensingProtocol::PROCESS_IMG_CMD_ID, payload);
+    }
+    else
+    {
+      //! VGADescription: index, time stamp, direction, ...
+      payload.resize(2 * ACK::IMG_VGA_SIZE + VGA_DESC_SIZE);
+      fillImage(&payload[0], 2 * ACK::IMG_VGA_SIZE, &seed);
+      uint8_t* desc = &payload[2 * ACK::IMG_VGA_SIZE];
+      memcpy(desc, &index, 4);
+      memcpy(desc + 4, &index, 4);
+      appendFrame(capture, recordEnds,
+                  AdvancedSensingProtocol::PROCESS_VGA_CMD_ID, payload);
+    }
+  }
+}
+
+static bool
+loadCapture(const char* path, std::vector<uint8_t>* capture,
+            std::vector<uint32_t>* recordEnds)
+{
+  FILE* file = fopen(path, "rb");
+  if (!file)
+  {
+    perror(path);
+    return false;
+  }
+  uint32_t length;
+  while (fread(&length, sizeof(length), 1, file) == 1)
+  {
+    size_t start = capture->size();
+    capture->resize(start + length);
+    if (length && fread(&(*capture)[start], length, 1, file) != 1)
+    {
+      fprintf(stderr, "%s: truncated record\n", path);
+      fclose(file);
+      return false;
+    }
+    recordEnds->push_back(capture->size());
+  }
+  fclose(file);
+  return !recordEnds->empty();
+}
+
+//! Reads every byte of an image, as a consumer of it would
+static uint64_t
+checksum(uint64_t sum, const uint8_t* image, int size)
+{
+  for (int i = 0; i + 8 <= size; i += 8)
+  {
+    uint64_t word;
+    memcpy(&word, image + i, sizeof(word));
+    sum = (sum ^ word) * 1099511628211ULL;
+  }
+  return sum;
+}
+
+static uint64_t
+checksumLegacy(const RecvContainer* container, uint64_t sum)
+{
+  if (container->recvInfo.cmd_id == AdvancedSensingProtocol::PROCESS_IMG_CMD_ID)
+  {
+    const ACK::StereoImgData* data = container->recvData.stereoImgData;
+    sum += data->frame_index;
+    for (int i = 0; i < data->num_imgs; i++)
+    {
+      sum = checksum(sum, data->img_vec[i].image, ACK::IMG_240P_SIZE);
+    }
+  }
+  else
+  {
+    const ACK::StereoVGAImgData* data = container->recvData.stereoVGAImgData;
+    sum += data->frame_index;
+    for (int i = 0; i < 2; i++)
+    {
+      sum = checksum(sum, data->img_vec[i], ACK::IMG_VGA_SIZE);
+    }
+  }
+  return sum;
+}
+
+static uint64_t
+checksumViews(const StereoFrame& frame, uint64_t sum)
+{
+  sum += frame.frame_index;
+  for (int i = 0; i < frame.num_imgs; i++)
+  {
+    sum = checksum(sum, frame.img_vec[i].image, frame.img_vec[i].size);
+  }
+  return sum;
+}
+
+typedef struct RunResult
+{
+  unsigned frames;
+  unsigned copied;
+  double   seconds;
+  double   cpuSeconds;
+  uint64_t sum;
+} RunResult;
+
+static double
+cpuNow()
+{
+  timespec ts;
+  clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/*! @param held -1 copies every frame into the RecvContainer, otherwise
+ *  the views are read and the last held frames are kept
+ */
+static RunResult
+run(AdvancedSensingProtocol* protocol, CaptureDriver* driver, unsigned passes,
+    int held)
+{
+  RunResult                  result = { 0, 0, 0, 0, 0 };
+  std::deque<StereoFramePtr> holding;
+  Clock::time_point          start    = Clock::now();
+  double                     cpuStart = cpuNow();
+  for (unsigned pass = 0; pass < passes; pass++)
+  {
+    driver->rewind();
+    while (true)
+    {
+      RecvContainer* container = protocol->receive();
+      if (container->recvInfo.cmd_id == 0xFF)
+      {
+        if (driver->exhausted())
+        {
+          break;
+        }
+        continue;
+      }
+
+      StereoFramePtr frame = protocol->takeStereoFrame();
+      result.frames++;
+      result.copied += frame ? 0 : 1;
+      if (held < 0)
+      {
+        protocol->fillLegacyImageData(frame);
+        result.sum = checksumLegacy(container, result.sum);
+        continue;
+      }
+      //! Without a free buffer the frame was copied into the container
+      result.sum = frame ? checksumViews(*frame, result.sum)
+                         : checksumLegacy(container, result.sum);
+      if (frame && held > 0)
+      {
+        holding.push_back(frame);
+        if ((int)holding.size() > held)
+        {
+          holding.pop_front();
+        }
+      }
+    }
+  }
+  result.cpuSeconds = cpuNow() - cpuStart;
+  result.seconds =
+    std::chrono::duration<double>(Clock::now() - start).count();
+  return result;
+}
+
+int
+main(int argc, char** argv)
+{
+  unsigned    frames  = (argc > 1) ? atoi(argv[1]) : 200;
+  unsigned    passes  = (argc > 2) ? atoi(argv[2]) : 5;
+  const char* capture = (argc > 3) ? argv[3] : NULL;
+  if (frames == 0 || passes == 0)
+  {
+    printf("Usage: %s [frames] [passes] [capture file]\n", argv[0]);
+    return 1;
+  }
+  if (!registerLinuxOsal())
+  {
+    return 1;
+  }
+
+  std::vector<uint8_t>  data;
+  std::vector<uint32_t> recordEnds;
+  if (!capture)
+  {
+    generateCapture(frames, &data, &recordEnds);
+  }
+  else if (!loadCapture(capture, &data, &recordEnds))
+  {
+    return 1;
+  }
+
+  //! The protocol opens the USB device, the capture stands in for it
+  AdvancedSensingProtocol protocol;
+  CaptureDriver*          driver = new CaptureDriver(data, recordEnds);
+  delete protocol.getDriver();
+  //! Owned by the protocol from here on
+  protocol.setDriver(driver);
+  Log::instance().disableStatusLogging();
+
+  printf("%zu records, %.1f MB, %u passes, %d receive buffers\n\n",
+         recordEnds.size(), data.size() / 1e6, passes,
+         AdvancedSensingProtocol::STEREO_FRAME_BUFFERS);
+  printf("%-22s %10s %14s %10s %8s\n", "consumer", "frames/s", "CPU us/frame",
+         "MB/s", "copied");
+
+  const char* names[] = { "copy (VehicleCallBack)", "views",
+                          "views, 2 frames held", "views, 3 frames held" };
+  int         held[]  = { -1, 0, 2, 3 };
+  RunResult   first   = { 0, 0, 0, 0, 0 };
+  bool        same    = true;
+  for (int mode = 0; mode < 4; mode++)
+  {
+    RunResult r = run(&protocol, driver, passes, held[mode]);
+    if (r.frames == 0)
+    {
+      printf("\nFAILED: no frame in the capture\n");
+      return 1;
+    }
+    printf("%-22s %10.0f %14.0f %10.0f %8u\n", names[mode],
+           r.frames / r.seconds, r.cpuSeconds * 1e6 / r.frames,
+           data.size() * (double)passes / r.seconds / 1e6, r.copied);
+    first = (mode == 0) ? r : first;
+    same  = same && r.frames == first.frames && r.sum == first.sum;
+  }
+  //! A generated capture has to come through whole
+  same = same && (capture || first.frames == frames * passes);
+
+  if (!same)
+  {
+    printf("\nFAILED: consumers saw different images\n");
+    return 1;
+  }
+  return 0;
+}
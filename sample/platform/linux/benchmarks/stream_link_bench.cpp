@@ -0,0 +1,351 @@
+/*! @file benchmarks/stream_link_bench.cpp
+ *  @version 4.0.0
+ *  @date Oct 2026
+ *
+ *  @brief
+ *  Throughput and chunk latency of the camera stream link over a local UDT
+ *  loopback. A sender thread stands in for the camera. DJICameraStreamLink,
+ *  which waits on UDT epoll and drains the socket per wakeup, is compared
+ *  with the previous reader (blocking recv, then usleep(20 ms)).
+ *
+ *  Latency: frames of a fixed size are sent at a fixed rate, as an H.264
+ *  stream would. A frame's latency runs from the start of its send until
+ *  the reader's callback has received its last byte.
+ *  Throughput: the sender writes as fast as UDT accepts and the rate at
+ *  which the callback receives the data is reported.
+ *
+ *  Usage: djiosdk-bench-stream-link [frames] [frame KB] [fps] [MB] [port]
+ *
+ *  @Copyright (c) 2026 DJI
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#include "bench_osal.hpp"
+#include "ccc.h"
+#include "dji_camera_stream_link.hpp"
+#include "dji_log.hpp"
+#include "udt.h"
+
+#include <algorithm>
+#include <arpa/inet.h>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+typedef std::chrono::steady_clock Clock;
+
+//! Same as the link's receive buffer
+static const int RECEIVE_SIZE = 128000;
+//! Pace of the sender, about 75 MB/s with 1500 byte packets
+static const double SEND_PERIOD_US = 20;
+
+/*! UDT's default congestion control backs off for seconds after a single
+ *  loss on loopback, which would be measured instead of the reader. The
+ *  sender keeps a fixed rate, like the UDPBlast example shipped with UDT.
+ */
+class FixedRateCC : public CCC
+{
+public:
+  FixedRateCC()
+  {
+    m_dPktSndPeriod = SEND_PERIOD_US;
+    m_dCWndSize     = 83333.0;
+  }
+};
+
+//! What the callback has seen, reset for every run
+typedef struct ReceiveState
+{
+  std::atomic<uint64_t>          bytes;
+  std::atomic<uint64_t>          callbacks;
+  uint64_t                       frameSize;
+  std::vector<Clock::time_point> sent;
+  std::vector<double>            latencyMs;
+  std::mutex                     lock;
+} ReceiveState;
+
+static ReceiveState state;
+
+static void
+onData(void* param, uint8_t* buf, int len)
+{
+  (void)param;
+  (void)buf;
+  Clock::time_point now    = Clock::now();
+  uint64_t          before = state.bytes;
+  uint64_t          after  = before + len;
+  state.bytes              = after;
+  state.callbacks++;
+
+  std::lock_guard<std::mutex> lock(state.lock);
+  if (state.frameSize == 0)
+  {
+    return;
+  }
+  //! Frames whose last byte arrived in this chunk
+  for (uint64_t frame = before / state.frameSize;
+       frame < after / state.frameSize && frame < state.sent.size(); frame++)
+  {
+    state.latencyMs.push_back(
+      std::chrono::duration<double, std::milli>(now - state.sent[frame])
+        .count());
+  }
+}
+
+static std::atomic<bool> previousRunning;
+
+//! The reading thread before the epoll change
+static void
+previousReader(UDTSOCKET sock)
+{
+  std::vector<char> rcvBuffer(RECEIVE_SIZE);
+  while (previousRunning)
+  {
+    int rcvLen = UDT::recv(sock, &rcvBuffer[0], RECEIVE_SIZE, 0);
+    if (UDT::ERROR != rcvLen && rcvLen > 0)
+    {
+      onData(NULL, (uint8_t*)&rcvBuffer[0], rcvLen);
+    }
+    usleep(2e4);
+  }
+}
+
+static UDTSOCKET
+connectPrevious(const char* port)
+{
+  static int optval = 100;
+  UDTSOCKET  sock   = UDT::socket(AF_INET, SOCK_STREAM, 0);
+  UDT::setsockopt(sock, 0, UDT_RCVTIMEO, &optval, sizeof(int));
+
+  sockaddr_in addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sin_family      = AF_INET;
+  addr.sin_port        = htons(atoi(port));
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  if (UDT::ERROR == UDT::connect(sock, (sockaddr*)&addr, sizeof(addr)))
+  {
+    fprintf(stderr, "connect: %s\n", UDT::getlasterror().getErrorMessage());
+    UDT::close(sock);
+    return UDT::INVALID_SOCK;
+  }
+  return sock;
+}
+
+static bool
+sendAll(UDTSOCKET sock, const char* data, int len)
+{
+  while (len > 0)
+  {
+    int sent = UDT::send(sock, data, len, 0);
+    if (UDT::ERROR == sent)
+    {
+      fprintf(stderr, "send: %s\n", UDT::getlasterror().getErrorMessage());
+      return false;
+    }
+    data += sent;
+    len -= sent;
+  }
+  return true;
+}
+
+static void
+waitForBytes(uint64_t total)
+{
+  Clock::time_point deadline = Clock::now() + std::chrono::seconds(30);
+  while (state.bytes < total && Clock::now() < deadline)
+  {
+    std::this_thread::sleep_for(std::chrono::microseconds(100));
+  }
+}
+
+typedef struct RunResult
+{
+  double p50Ms;
+  double p99Ms;
+  double maxMs;
+  double megabytesPerSecond;
+  double callbacksPerSecond;
+  bool   complete;
+} RunResult;
+
+/*! Paced frames, then a burst, over one accepted connection. The reader
+ *  is already running when this is called.
+ */
+static RunResult
+measure(UDTSOCKET peer, unsigned frames, unsigned frameSize, unsigned fps,
+        unsigned megabytes)
+{
+  RunResult         result;
+  std::vector<char> frame(frameSize, 0x5A);
+  state.bytes     = 0;
+  state.callbacks = 0;
+  state.frameSize = frameSize;
+  state.sent.assign(frames, Clock::time_point());
+  state.latencyMs.clear();
+
+  Clock::time_point next = Clock::now();
+  for (unsigned i = 0; i < frames; i++)
+  {
+    std::this_thread::sleep_until(next);
+    {
+      std::lock_guard<std::mutex> lock(state.lock);
+      state.sent[i] = Clock::now();
+    }
+    sendAll(peer, &frame[0], frameSize);
+    next += std::chrono::microseconds(1000000 / fps);
+  }
+  waitForBytes((uint64_t)frames * frameSize);
+  {
+    std::lock_guard<std::mutex> lock(state.lock);
+    std::vector<double>& l = state.latencyMs;
+    result.complete        = (l.size() == frames);
+    std::sort(l.begin(), l.end());
+    result.p50Ms = l.empty() ? 0 : l[l.size() / 2];
+    result.p99Ms = l.empty() ? 0 : l[l.size() * 99 / 100];
+    result.maxMs = l.empty() ? 0 : l.back();
+    state.frameSize = 0;
+  }
+
+  uint64_t          total = (uint64_t)megabytes << 20;
+  std::vector<char> chunk(RECEIVE_SIZE, 0x5A);
+  state.bytes                   = 0;
+  state.callbacks               = 0;
+  Clock::time_point start       = Clock::now();
+  std::thread       burstSender([&]() {
+    for (uint64_t sent = 0; sent < total; sent += chunk.size())
+    {
+      if (!sendAll(peer, &chunk[0], chunk.size()))
+      {
+        break;
+      }
+    }
+  });
+  uint64_t expected = (total + chunk.size() - 1) / chunk.size() * chunk.size();
+  waitForBytes(expected);
+  double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+  burstSender.join();
+
+  result.complete           = result.complete && state.bytes >= expected;
+  result.megabytesPerSecond = state.bytes / seconds / 1e6;
+  result.callbacksPerSecond = state.callbacks / seconds;
+  return result;
+}
+
+static void
+print(const char* name, const RunResult& r)
+{
+  printf("%-22s %8.1f %8.1f %8.1f %10.1f %12.0f%s\n", name, r.p50Ms, r.p99Ms,
+         r.maxMs, r.megabytesPerSecond, r.callbacksPerSecond,
+         r.complete ? "" : "  INCOMPLETE");
+}
+
+int
+main(int argc, char** argv)
+{
+  unsigned    frames    = (argc > 1) ? atoi(argv[1]) : 150;
+  unsigned    frameSize = ((argc > 2) ? atoi(argv[2]) : 30) * 1000;
+  unsigned    fps       = (argc > 3) ? atoi(argv[3]) : 30;
+  unsigned    megabytes = (argc > 4) ? atoi(argv[4]) : 32;
+  const char* port      = (argc > 5) ? argv[5] : "40111";
+  if (frames == 0 || frameSize == 0 || fps == 0 || fps > 1000 ||
+      megabytes == 0)
+  {
+    printf("Usage: %s [frames] [frame KB] [fps] [MB] [port]\n", argv[0]);
+    return 1;
+  }
+
+  if (!registerLinuxOsal())
+  {
+    return 1;
+  }
+  DJI::OSDK::Log::instance().disableStatusLogging();
+
+  UDT::startup();
+  UDTSOCKET   server = UDT::socket(AF_INET, SOCK_STREAM, 0);
+  //! Inherited by the accepted sockets, which do the sending
+  CCCFactory<FixedRateCC> fixedRate;
+  UDT::setsockopt(server, 0, UDT_CC, &fixedRate, sizeof(fixedRate));
+  sockaddr_in addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sin_family      = AF_INET;
+  addr.sin_port        = htons(atoi(port));
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  if (UDT::ERROR == UDT::bind(server, (sockaddr*)&addr, sizeof(addr)) ||
+      UDT::ERROR == UDT::listen(server, 2))
+  {
+    fprintf(stderr, "listen on %s: %s\n", port,
+            UDT::getlasterror().getErrorMessage());
+    return 1;
+  }
+
+  printf("%u frames of %u bytes at %u fps, then %u MB burst\n\n", frames,
+         frameSize, fps, megabytes);
+  printf("%-22s %8s %8s %8s %10s %12s\n", "reader", "p50 ms", "p99 ms",
+         "max ms", "MB/s", "callbacks/s");
+
+  //! Previous reader
+  UDTSOCKET previous = connectPrevious(port);
+  UDTSOCKET peer     = UDT::accept(server, NULL, NULL);
+  if (previous == UDT::INVALID_SOCK || peer == UDT::INVALID_SOCK)
+  {
+    return 1;
+  }
+  previousRunning = true;
+  std::thread previousThread(previousReader, previous);
+  RunResult   before = measure(peer, frames, frameSize, fps, megabytes);
+  previousRunning    = false;
+  previousThread.join();
+  UDT::close(peer);
+  UDT::close(previous);
+  print("recv + usleep(20 ms)", before);
+
+  //! DJICameraStreamLink on UDT epoll
+  DJICameraStreamLink link(FPV_CAMERA);
+  link.setServerAddress("127.0.0.1", port);
+  if (!link.init())
+  {
+    fprintf(stderr, "DJICameraStreamLink could not connect\n");
+    return 1;
+  }
+  peer = UDT::accept(server, NULL, NULL);
+  link.registerCallback(onData, NULL);
+  link.start();
+  RunResult after = measure(peer, frames, frameSize, fps, megabytes);
+  link.cleanup();
+  UDT::close(peer);
+  print("DJICameraStreamLink", after);
+
+  UDT::close(server);
+  UDT::cleanup();
+
+  if (!after.complete)
+  {
+    printf("\nFAILED: DJICameraStreamLink lost data\n");
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,219 @@
+/*! @file benchmarks/subscription_bench.cpp
+ *  @version 4.0.0
+ *  @date Oct 2026
+ *
+ *  @brief
+ *  Time to start and remove several subscription packages, one blocking
+ *  startPackage / removePackage per package against one startPackages /
+ *  removePackages batch. The linker talks to the simulated flight
+ *  controller of bench_fake_fc.hpp, which accepts every add and remove.
+ *  With ACK loss the batch is still bounded by its timeout and the lost
+ *  packages report NO_RESPONSE_ERROR.
+ *
+ *  Usage: djiosdk-bench-subscription [packages] [FC latency ms] [rounds]
+ *                                    [ACK loss %]
+ *
+ *  @Copyright (c) 2026 DJI
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#include "bench_fake_fc.hpp"
+#include "bench_osal.hpp"
+#include "dji_legacy_linker.hpp"
+#include "dji_subscription.hpp"
+#include "dji_vehicle.hpp"
+
+using namespace DJI::OSDK;
+using namespace DJI::OSDK::Telemetry;
+
+typedef std::chrono::steady_clock Clock;
+
+//! Upper bound of every blocking call in seconds
+static const int TIMEOUT_S = 1;
+
+//! Accept every add and remove, the ACK is a single result byte
+static bool
+answerSubscribe(uint8_t cmdSet, uint8_t cmdId, const uint8_t* payload,
+                size_t len, std::vector<uint8_t>* ackPayload)
+{
+  (void)cmdSet;
+  (void)cmdId;
+  (void)payload;
+  (void)len;
+  ackPayload->assign(1, OpenProtocolCMD::ErrorCode::SubscribeACK::SUCCESS);
+  return true;
+}
+
+static void
+setUpPackages(DataSubscription* subscribe, int packages)
+{
+  TopicName topics[] = { TOPIC_QUATERNION, TOPIC_VELOCITY, TOPIC_GPS_FUSED,
+                         TOPIC_RC };
+  for (int id = 0; id < packages; id++)
+  {
+    subscribe->initPackageFromTopicList(
+      id, sizeof(topics) / sizeof(topics[0]), topics, false, 50);
+  }
+}
+
+static double
+elapsedMs(Clock::time_point since)
+{
+  return std::chrono::duration<double, std::milli>(Clock::now() - since)
+    .count();
+}
+
+//! Returns the number of packages that did not succeed
+static int
+oneByOne(DataSubscription* subscribe, int packages, bool add, double* ms)
+{
+  int               failed = 0;
+  Clock::time_point start  = Clock::now();
+  for (int id = 0; id < packages; id++)
+  {
+    ACK::ErrorCode ack = add ? subscribe->startPackage(id, TIMEOUT_S)
+                             : subscribe->removePackage(id, TIMEOUT_S);
+    failed += ACK::getError(ack) ? 1 : 0;
+  }
+  *ms = elapsedMs(start);
+  return failed;
+}
+
+static int
+batched(DataSubscription* subscribe, int packages, bool add, double* ms)
+{
+  int            ids[DataSubscription::MAX_NUMBER_OF_PACKAGE];
+  ACK::ErrorCode results[DataSubscription::MAX_NUMBER_OF_PACKAGE];
+  for (int id = 0; id < packages; id++)
+  {
+    ids[id] = id;
+  }
+
+  Clock::time_point start = Clock::now();
+  if (add)
+  {
+    subscribe->startPackages(ids, packages, results, TIMEOUT_S);
+  }
+  else
+  {
+    subscribe->removePackages(ids, packages, results, TIMEOUT_S);
+  }
+  *ms = elapsedMs(start);
+
+  int failed = 0;
+  for (int i = 0; i < packages; i++)
+  {
+    failed += ACK::getError(results[i]) ? 1 : 0;
+  }
+  return failed;
+}
+
+int
+main(int argc, char** argv)
+{
+  int      packages = (argc > 1) ? atoi(argv[1]) : 5;
+  fcLatencyMs       = (argc > 2) ? atoi(argv[2]) : 20;
+  unsigned rounds   = (argc > 3) ? atoi(argv[3]) : 10;
+  fcLossPct         = (argc > 4) ? atoi(argv[4]) : 0;
+  if (packages < 1 || packages > DataSubscription::MAX_NUMBER_OF_PACKAGE ||
+      rounds == 0 || fcLossPct > 50)
+  {
+    printf("Usage: %s [packages] [FC latency ms] [rounds] [ACK loss %%]\n",
+           argv[0]);
+    return 1;
+  }
+
+  Linker linker;
+  if (!registerLinuxOsal() || !startFakeFc(&linker, answerSubscribe))
+  {
+    return 1;
+  }
+  Log::instance().disableStatusLogging();
+  Log::instance().disableErrorLogging();
+
+  Vehicle vehicle(&linker);
+  vehicle.setEncryption(false);
+  vehicle.initLegacyLinker();
+  //! Owned by the vehicle from here on
+  vehicle.subscribe = new DataSubscription(&vehicle);
+  setUpPackages(vehicle.subscribe, packages);
+
+  printf("%d packages, FC latency %u ms, %u rounds, %u%% ACK loss\n\n",
+         packages, fcLatencyMs, rounds, fcLossPct);
+  printf("%-12s %12s %12s %12s %12s %8s\n", "mode", "start avg", "start max",
+         "remove avg", "remove max", "failed");
+
+  int    lostPackages = 0;
+  double worstBatchMs = 0;
+  for (int mode = 0; mode < 2; mode++)
+  {
+    bool   useBatch = (mode == 1);
+    double sum[2]   = { 0, 0 };
+    double max[2]   = { 0, 0 };
+    int    failed   = 0;
+    for (unsigned round = 0; round < rounds; round++)
+    {
+      for (int step = 0; step < 2; step++)
+      {
+        bool   add = (step == 0);
+        double ms  = 0;
+        failed += useBatch ? batched(vehicle.subscribe, packages, add, &ms)
+                           : oneByOne(vehicle.subscribe, packages, add, &ms);
+        sum[step] += ms;
+        max[step] = (ms > max[step]) ? ms : max[step];
+        if (!add)
+        {
+          //! A lost remove ACK leaves the package occupied
+          setUpPackages(vehicle.subscribe, packages);
+        }
+      }
+    }
+    printf("%-12s %9.1f ms %9.1f ms %9.1f ms %9.1f ms %8d\n",
+           useBatch ? "batch" : "one by one", sum[0] / rounds, max[0],
+           sum[1] / rounds, max[1], failed);
+    if (useBatch)
+    {
+      lostPackages = failed;
+      worstBatchMs = (max[0] > max[1]) ? max[0] : max[1];
+    }
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(fcLock);
+    printf("\nSimulated FC: %u requests, %u ACKs dropped\n", fcRequests,
+           fcDropped);
+  }
+
+  //! Small margin for the scheduler on top of the timeout
+  if (worstBatchMs > TIMEOUT_S * 1000 + 100)
+  {
+    printf("\nFAILED: a batch took %.1f ms, longer than its %d s timeout\n",
+           worstBatchMs, TIMEOUT_S);
+    return 1;
+  }
+  if (fcLossPct == 0 && lostPackages != 0)
+  {
+    printf("\nFAILED: %d batched packages failed without ACK loss\n",
+           lostPackages);
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,465 @@
+/*! @file benchmarks/usb_bulk_read_bench.cpp
+ *  @version 4.0.0
+ *  @date Oct 2026
+ *
+ *  @brief
+ *  Throughput and frame latency of USB bulk IN reads, one synchronous
+ *  libusb_bulk_transfer at a time against UsbBulkReader with several
+ *  transfers in flight.
+ *
+ *  No device is needed: the libusb calls both paths make are served by a
+ *  simulated device in this file, which take precedence over libusb. The
+ *  device produces frames at a fixed rate into a small FIFO and moves them
+ *  over the bus only while an IN transfer is pending, a transfer ends with
+ *  a short packet when the FIFO runs empty. A frame that finds the FIFO
+ *  full is dropped, as a camera does. The host reads like
+ *  LinuxUSBDevice::readall and spends a fixed time on every read.
+ *
+ *  Frames carry a sequence number and their production time, so frames
+ *  out of order or cut apart make the benchmark fail.
+ *
+ *  Usage: djiosdk-bench-usb-bulk-read [frame KB] [fps] [host us per read]
+ *                                     [bus MB/s] [seconds]
+ *
+ *  @Copyright (c) 2026 DJI
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#include "linux_usb_bulk_reader.h"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <thread>
+#include <vector>
+
+typedef std::chrono::steady_clock Clock;
+
+//! Same as the read size of LinuxUSBDevice
+static const int     READ_SIZE   = 1024 * 600;
+static const uint8_t IN_ENDPOINT = 0x83;
+//! The camera keeps the frame it is sending and nothing more
+static const int     FIFO_FRAMES = 1;
+static const int     TIMEOUT_MS  = 1000;
+
+//! Start of every frame
+typedef struct FrameHeader
+{
+  uint32_t magic;
+  uint32_t seq;
+  uint64_t producedUs;
+} FrameHeader;
+
+static const uint32_t FRAME_MAGIC = 0x44534946;
+
+static uint64_t
+nowUs()
+{
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+           Clock::now().time_since_epoch())
+    .count();
+}
+
+typedef struct SimFrame
+{
+  FrameHeader header;
+  uint32_t    sent;
+} SimFrame;
+
+/*! The simulated device. Transfers without a callback are synchronous ones
+ *  waited for in libusb_bulk_transfer.
+ */
+static struct SimDevice
+{
+  std::mutex                   lock;
+  std::condition_variable      done;
+  std::deque<libusb_transfer*> pending;
+  std::deque<libusb_transfer*> completed;
+  std::deque<SimFrame>         fifo;
+  uint32_t                     frameSize;
+  uint64_t                     intervalUs;
+  double                       busBytesPerUs;
+  uint64_t                     nextFrameUs;
+  uint32_t                     produced;
+  uint32_t                     dropped;
+  bool                         running;
+} device;
+
+static void
+completeTransfer(libusb_transfer* transfer, libusb_transfer_status status)
+{
+  transfer->status = status;
+  if (transfer->callback)
+  {
+    device.completed.push_back(transfer);
+  }
+  device.done.notify_all();
+}
+
+static void
+deviceThread()
+{
+  uint64_t last = nowUs();
+  std::unique_lock<std::mutex> lock(device.lock);
+  while (device.running)
+  {
+    lock.unlock();
+    std::this_thread::sleep_for(std::chrono::microseconds(100));
+    lock.lock();
+
+    uint64_t now = nowUs();
+    while (now >= device.nextFrameUs)
+    {
+      if (device.fifo.size() < (size_t)FIFO_FRAMES)
+      {
+        SimFrame frame = { { FRAME_MAGIC, device.produced,
+                             device.nextFrameUs },
+                           0 };
+        device.fifo.push_back(frame);
+      }
+      else
+      {
+        device.dropped++;
+      }
+      device.produced++;
+      device.nextFrameUs += device.intervalUs;
+    }
+
+    //! The bus is idle without a pending transfer, its time is lost
+    uint64_t budget = std::min<uint64_t>(now - last, 1000) *
+                      device.busBytesPerUs;
+    last = now;
+    while (budget && !device.pending.empty() && !device.fifo.empty())
+    {
+      libusb_transfer* transfer = device.pending.front();
+      SimFrame&        frame    = device.fifo.front();
+      uint32_t n = std::min<uint64_t>(
+        budget, std::min<uint32_t>(device.frameSize - frame.sent,
+                                   transfer->length -
+                                     transfer->actual_length));
+      uint8_t* out = transfer->buffer + transfer->actual_length - frame.sent;
+      for (uint32_t i = frame.sent;
+           i < frame.sent + n && i < sizeof(FrameHeader); i++)
+      {
+        out[i] = ((const uint8_t*)&frame.header)[i];
+      }
+      transfer->actual_length += n;
+      frame.sent += n;
+      budget -= n;
+      if (frame.sent == device.frameSize)
+      {
+        device.fifo.pop_front();
+      }
+      //! Full, or ended by a short packet
+      if (transfer->actual_length == transfer->length || device.fifo.empty())
+      {
+        device.pending.pop_front();
+        completeTransfer(transfer, LIBUSB_TRANSFER_COMPLETED);
+      }
+    }
+  }
+}
+
+static void
+resetDevice(uint32_t frameSize, unsigned fps, double busMegabytes)
+{
+  std::lock_guard<std::mutex> lock(device.lock);
+  device.fifo.clear();
+  device.frameSize     = frameSize;
+  device.intervalUs    = 1000000 / fps;
+  device.busBytesPerUs = busMegabytes;
+  device.nextFrameUs   = nowUs();
+  device.produced      = 0;
+  device.dropped       = 0;
+}
+
+//! libusb as far as the two read paths use it
+extern "C" {
+
+struct libusb_transfer*
+libusb_alloc_transfer(int iso_packets)
+{
+  //! Only bulk transfers are simulated
+  (void)iso_packets;
+  return (libusb_transfer*)calloc(1, sizeof(libusb_transfer));
+}
+
+void
+libusb_free_transfer(struct libusb_transfer* transfer)
+{
+  free(transfer);
+}
+
+int
+libusb_submit_transfer(struct libusb_transfer* transfer)
+{
+  std::lock_guard<std::mutex> lock(device.lock);
+  transfer->actual_length = 0;
+  device.pending.push_back(transfer);
+  return LIBUSB_SUCCESS;
+}
+
+int
+libusb_cancel_transfer(struct libusb_transfer* transfer)
+{
+  std::lock_guard<std::mutex> lock(device.lock);
+  std::deque<libusb_transfer*>::iterator it =
+    std::find(device.pending.begin(), device.pending.end(), transfer);
+  if (it == device.pending.end())
+  {
+    return LIBUSB_ERROR_NOT_FOUND;
+  }
+  device.pending.erase(it);
+  completeTransfer(transfer, LIBUSB_TRANSFER_CANCELLED);
+  return LIBUSB_SUCCESS;
+}
+
+int
+libusb_handle_events_timeout_completed(libusb_context* ctx, struct timeval* tv,
+                                       int* completed)
+{
+  (void)ctx;
+  (void)completed;
+  std::deque<libusb_transfer*> ready;
+  {
+    std::unique_lock<std::mutex> lock(device.lock);
+    device.done.wait_for(
+      lock,
+      std::chrono::microseconds(tv->tv_sec * 1000000 + tv->tv_usec),
+      []() { return !device.completed.empty(); });
+    ready.swap(device.completed);
+  }
+  for (size_t i = 0; i < ready.size(); i++)
+  {
+    ready[i]->callback(ready[i]);
+  }
+  return LIBUSB_SUCCESS;
+}
+
+int
+libusb_clear_halt(libusb_device_handle* dev_handle, unsigned char endpoint)
+{
+  (void)dev_handle;
+  (void)endpoint;
+  return LIBUSB_SUCCESS;
+}
+
+int
+libusb_bulk_transfer(libusb_device_handle* dev_handle, unsigned char endpoint,
+                     unsigned char* data, int length, int* actual_length,
+                     unsigned int timeout)
+{
+  libusb_transfer transfer;
+  memset(&transfer, 0, sizeof(transfer));
+  libusb_fill_bulk_transfer(&transfer, dev_handle, endpoint, data, length,
+                            NULL, NULL, timeout);
+  transfer.status = (libusb_transfer_status)-1;
+
+  std::unique_lock<std::mutex> lock(device.lock);
+  device.pending.push_back(&transfer);
+  bool finished = device.done.wait_for(
+    lock, std::chrono::milliseconds(timeout),
+    [&]() { return transfer.status != (libusb_transfer_status)-1; });
+  if (!finished)
+  {
+    device.pending.erase(
+      std::find(device.pending.begin(), device.pending.end(), &transfer));
+  }
+  *actual_length = transfer.actual_length;
+  return finished ? LIBUSB_SUCCESS : LIBUSB_ERROR_TIMEOUT;
+}
+
+} // extern "C"
+
+typedef struct RunResult
+{
+  double   megabytesPerSecond;
+  uint32_t frames;
+  uint32_t dropped;
+  double   p50Ms;
+  double   p99Ms;
+  double   maxMs;
+  bool     intact;
+} RunResult;
+
+/*! Splits the byte stream into frames again and times each of them from
+ *  production to the read that returned its last byte
+ */
+typedef struct HostStream
+{
+  uint32_t            frameSize;
+  uint32_t            offset;
+  FrameHeader         header;
+  int64_t             lastSeq;
+  bool                intact;
+  std::vector<double> latencyMs;
+} HostStream;
+
+static void
+consume(HostStream* stream, const uint8_t* data, int len)
+{
+  while (len > 0)
+  {
+    uint32_t take = std::min<uint32_t>(len, stream->frameSize - stream->offset);
+    for (uint32_t i = stream->offset;
+         i < stream->offset + take && i < sizeof(FrameHeader); i++)
+    {
+      ((uint8_t*)&stream->header)[i] = data[i - stream->offset];
+    }
+    stream->offset += take;
+    data += take;
+    len -= take;
+    if (stream->offset == stream->frameSize)
+    {
+      stream->intact = stream->intact &&
+                       stream->header.magic == FRAME_MAGIC &&
+                       (int64_t)stream->header.seq > stream->lastSeq;
+      stream->lastSeq = stream->header.seq;
+      stream->latencyMs.push_back((nowUs() - stream->header.producedUs) /
+                                  1000.0);
+      stream->offset = 0;
+    }
+  }
+}
+
+/*! @param depth transfers in flight, 0 for synchronous transfers */
+static RunResult
+run(int depth, uint32_t frameSize, unsigned fps, unsigned hostUs,
+    double busMegabytes, double seconds)
+{
+  libusb_device_handle* handle = (libusb_device_handle*)&device;
+  std::vector<uint8_t>  buf(READ_SIZE);
+  HostStream            stream;
+  stream.frameSize = frameSize;
+  stream.offset    = 0;
+  stream.lastSeq   = -1;
+  stream.intact    = true;
+
+  resetDevice(frameSize, fps, busMegabytes);
+  T_UsbBulkReader* reader =
+    depth ? UsbBulkReader_Create(handle, IN_ENDPOINT, depth, READ_SIZE) : NULL;
+
+  uint64_t          bytes = 0;
+  Clock::time_point start = Clock::now();
+  Clock::time_point end   = start + std::chrono::microseconds(
+                                    (uint64_t)(seconds * 1000000));
+  while (Clock::now() < end)
+  {
+    int len = 0;
+    if (reader)
+    {
+      len = UsbBulkReader_Read(reader, &buf[0], READ_SIZE, TIMEOUT_MS);
+    }
+    else if (LIBUSB_SUCCESS != libusb_bulk_transfer(handle, IN_ENDPOINT,
+                                                    &buf[0], READ_SIZE, &len,
+                                                    TIMEOUT_MS))
+    {
+      len = 0;
+    }
+    if (len > 0)
+    {
+      bytes += len;
+      consume(&stream, &buf[0], len);
+    }
+    //! Parsing and handing the data on
+    std::this_thread::sleep_for(std::chrono::microseconds(hostUs));
+  }
+  double elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+  if (reader)
+  {
+    UsbBulkReader_Destroy(reader);
+  }
+
+  RunResult result;
+  {
+    std::lock_guard<std::mutex> lock(device.lock);
+    result.dropped = device.dropped;
+  }
+  std::vector<double>& l = stream.latencyMs;
+  std::sort(l.begin(), l.end());
+  result.megabytesPerSecond = bytes / elapsed / 1e6;
+  result.frames             = l.size();
+  result.p50Ms              = l.empty() ? 0 : l[l.size() / 2];
+  result.p99Ms              = l.empty() ? 0 : l[l.size() * 99 / 100];
+  result.maxMs              = l.empty() ? 0 : l.back();
+  result.intact             = stream.intact && !l.empty();
+  return result;
+}
+
+int
+main(int argc, char** argv)
+{
+  uint32_t frameSize = ((argc > 1) ? atoi(argv[1]) : 300) * 1000;
+  unsigned fps       = (argc > 2) ? atoi(argv[2]) : 40;
+  unsigned hostUs    = (argc > 3) ? atoi(argv[3]) : 20000;
+  double   busMB     = (argc > 4) ? atof(argv[4]) : 40;
+  double   seconds   = (argc > 5) ? atof(argv[5]) : 3;
+  if (frameSize < sizeof(FrameHeader) || fps == 0 || fps > 1000 ||
+      busMB <= 0 || seconds <= 0)
+  {
+    printf("Usage: %s [frame KB] [fps] [host us per read] [bus MB/s] "
+           "[seconds]\n",
+           argv[0]);
+    return 1;
+  }
+
+  device.running = true;
+  resetDevice(frameSize, fps, busMB);
+  std::thread deviceWorker(deviceThread);
+
+  printf("%u byte frames at %u fps (%.1f MB/s), bus %.0f MB/s, host %u us "
+         "per read\n\n",
+         frameSize, fps, frameSize * (double)fps / 1e6, busMB, hostUs);
+  printf("%-20s %8s %8s %8s %8s %8s %8s\n", "reader", "MB/s", "frames",
+         "dropped", "p50 ms", "p99 ms", "max ms");
+
+  int  depths[] = { 0, 1, 2, 4 };
+  bool intact   = true;
+  for (int i = 0; i < 4; i++)
+  {
+    char name[32];
+    snprintf(name, sizeof(name), depths[i] ? "async, %d in flight" : "sync",
+             depths[i]);
+    RunResult r = run(depths[i], frameSize, fps, hostUs, busMB, seconds);
+    printf("%-20s %8.1f %8u %8u %8.1f %8.1f %8.1f%s\n", name,
+           r.megabytesPerSecond, r.frames, r.dropped, r.p50Ms, r.p99Ms,
+           r.maxMs, r.intact ? "" : "  BROKEN");
+    intact = intact && r.intact;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(device.lock);
+    device.running = false;
+  }
+  deviceWorker.join();
+
+  if (!intact)
+  {
+    printf("\nFAILED: frames arrived out of order or cut apart\n");
+    return 1;
+  }
+  return 0;
+}
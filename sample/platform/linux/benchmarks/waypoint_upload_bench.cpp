@@ -0,0 +1,164 @@
+/*! @file benchmarks/waypoint_upload_bench.cpp
+ *  @version 4.0.0
+ *  @date Oct 2026
+ *
+ *  @brief
+ *  Waypoint v2 mission upload throughput against the upload window size.
+ *  The linker talks to a simulated flight controller through a registered
+ *  UART HAL on the channel that carries V1 commands. Every request is
+ *  answered after the serial transfer time at the given baud rate plus a
+ *  fixed processing latency, and a share of the ACKs can be dropped to
+ *  exercise retransmission. The mission is uploaded through
+ *  WaypointV2MissionOperator::uploadMission and the counters come from
+ *  getUploadStats. "resent" only counts chunks the operator sent again
+ *  after the linker gave up on its own retry.
+ *
+ *  Usage: djiosdk-bench-waypoint-upload [waypoints] [FC latency ms] [baud]
+ *                                       [ACK loss %]
+ *
+ *  @Copyright (c) 2026 DJI
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#include "bench_fake_fc.hpp"
+#include "bench_osal.hpp"
+#include "dji_vehicle.hpp"
+#include "dji_waypoint_v2.hpp"
+
+using namespace DJI::OSDK;
+
+/*! Answer a mission chunk the way the flight controller does: result 0 and
+ *  the index range the chunk started with.
+ */
+static bool
+answerChunk(uint8_t cmdSet, uint8_t cmdId, const uint8_t* payload, size_t len,
+            std::vector<uint8_t>* ackPayload)
+{
+  (void)cmdSet;
+  (void)cmdId;
+  if (len < 2 * sizeof(uint16_t))
+  {
+    return false;
+  }
+  UploadMissionRawAck ack;
+  ack.result = 0;
+  memcpy(&ack.startIndex, payload, sizeof(ack.startIndex));
+  memcpy(&ack.endIndex, payload + 2, sizeof(ack.endIndex));
+  ackPayload->assign((uint8_t*)&ack, (uint8_t*)&ack + sizeof(ack));
+  return true;
+}
+
+static std::vector<WaypointV2>
+generateMission(unsigned count)
+{
+  std::vector<WaypointV2> mission;
+  WaypointV2              waypoint;
+  memset(&waypoint, 0, sizeof(waypoint));
+  waypoint.waypointType =
+    DJIWaypointV2FlightPathModeGoToPointInAStraightLineAndStop;
+  waypoint.headingMode     = DJIWaypointV2HeadingModeAuto;
+  waypoint.dampingDistance = 40;
+  waypoint.turnMode        = DJIWaypointV2TurnModeClockwise;
+  waypoint.relativeHeight  = 15;
+  waypoint.maxFlightSpeed  = 9;
+  waypoint.autoFlightSpeed = 2;
+
+  for (unsigned i = 0; i < count; i++)
+  {
+    waypoint.latitude  = 0.39 + 1e-6 * (i % 100);
+    waypoint.longitude = 2.00 + 1e-6 * (i / 100);
+    mission.push_back(waypoint);
+  }
+  return mission;
+}
+
+int
+main(int argc, char** argv)
+{
+  unsigned waypoints = (argc > 1) ? atoi(argv[1]) : 1000;
+  fcLatencyMs        = (argc > 2) ? atoi(argv[2]) : 20;
+  fcBaud             = (argc > 3) ? atoi(argv[3]) : 921600;
+  fcLossPct          = (argc > 4) ? atoi(argv[4]) : 0;
+  if (waypoints < 2 || waypoints > 65535 || fcBaud == 0 || fcLossPct > 50)
+  {
+    printf("Usage: %s [waypoints] [FC latency ms] [baud] [ACK loss %%]\n",
+           argv[0]);
+    return 1;
+  }
+
+  Linker linker;
+  if (!registerLinuxOsal() || !startFakeFc(&linker, answerChunk))
+  {
+    return 1;
+  }
+  Vehicle vehicle(&linker);
+  vehicle.setEncryption(false);
+
+  WaypointV2MissionOperator op(&vehicle);
+  WayPointV2InitSettings    settings = WayPointV2InitSettings();
+  settings.missionID       = 1;
+  settings.repeatTimes     = 1;
+  settings.finishedAction  = DJIWaypointV2MissionFinishedNoAction;
+  settings.maxFlightSpeed  = 10;
+  settings.autoFlightSpeed = 2;
+  settings.gotoFirstWaypointMode =
+    DJIWaypointV2MissionGotoFirstWaypointModePointToPoint;
+  settings.mission      = generateMission(waypoints);
+  settings.missTotalLen = waypoints;
+  if (op.init(&settings, 2) != ErrorCode::SysCommonErr::Success)
+  {
+    fprintf(stderr, "Mission init got no ACK from the simulated FC\n");
+    return 1;
+  }
+
+  printf("%u waypoints, FC latency %u ms, %u baud, %u%% ACK loss\n\n",
+         waypoints, fcLatencyMs, fcBaud, fcLossPct);
+  printf("%6s %8s %8s %8s %10s %10s %8s\n", "window", "chunks", "bytes",
+         "resent", "ms", "B/s", "speedup");
+
+  bool     failed         = false;
+  uint32_t stopAndWaitBps = 0;
+  for (int window = 1;
+       window <= WaypointV2MissionOperator::MAX_UPLOAD_WINDOW_SIZE;
+       window *= 2)
+  {
+    op.setUploadWindowSize(window);
+    ErrorCode::ErrorCodeType ret   = op.uploadMission(2);
+    WaypointV2UploadStats    stats = op.getUploadStats();
+    if (window == 1)
+    {
+      stopAndWaitBps = stats.bytesPerSecond;
+    }
+    printf("%6d %8u %8u %8u %10u %10u %7.2fx%s\n", window, stats.chunks,
+           stats.bytes, stats.retransmissions, stats.elapsedMs,
+           stats.bytesPerSecond,
+           stopAndWaitBps ? (double)stats.bytesPerSecond / stopAndWaitBps : 0.0,
+           (ret == ErrorCode::SysCommonErr::Success) ? "" : "  FAILED");
+    failed = failed || ret != ErrorCode::SysCommonErr::Success;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(fcLock);
+    printf("\nSimulated FC: %u requests, %u ACKs dropped\n", fcRequests,
+           fcDropped);
+  }
+  return failed ? 1 : 0;
+}
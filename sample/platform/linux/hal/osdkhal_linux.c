@@ -187,6 +187,125 @@ E_OsdkStat OsdkLinux_UartInit(const char *port, const int baudrate,
 
 #ifdef ADVANCED_SENSING
 
+#include "pthread.h"
+
+/* Bulk IN transfers kept in flight per channel. T_HalObj is shared with
+ * the linker and has no room for the reader, so the readers are kept in a
+ * small table keyed by the hal object.
+ */
+#define USB_BULK_MAX_CHANNELS           8
+#define USB_BULK_DEFAULT_QUEUE_DEPTH    4
+/* Bounds how long a read holds its reader, so close and reopen never wait
+ * on a quiet channel for long.
+ */
+#define USB_BULK_READ_TIMEOUT_MS        100
+
+typedef struct {
+  const T_HalObj *obj;
+  void *handle;
+  T_UsbBulkReader *reader;
+  int users;     /* reads in progress on reader */
+  int closing;
+} T_UsbBulkReaderEntry;
+
+static T_UsbBulkReaderEntry s_bulkReaders[USB_BULK_MAX_CHANNELS];
+static pthread_mutex_t s_bulkReadersMutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t s_bulkReadersCond = PTHREAD_COND_INITIALIZER;
+static int s_bulkReadQueueDepth = USB_BULK_DEFAULT_QUEUE_DEPTH;
+
+static T_UsbBulkReaderEntry *OsdkLinux_USBBulkFindReader(const T_HalObj *obj) {
+  for (int i = 0; i < USB_BULK_MAX_CHANNELS; i++) {
+    if (s_bulkReaders[i].obj == obj) {
+      return &s_bulkReaders[i];
+    }
+  }
+  return NULL;
+}
+
+/* Called with s_bulkReadersMutex. Waits for the reads still using the
+ * entry's reader, then clears the entry and hands the reader back to be
+ * destroyed outside the lock.
+ */
+static T_UsbBulkReader *OsdkLinux_USBBulkDetachReader(
+    T_UsbBulkReaderEntry *entry) {
+  const T_HalObj *obj = entry->obj;
+  T_UsbBulkReader *reader = NULL;
+
+  entry->closing = 1;
+  while (entry->users > 0) {
+    pthread_cond_wait(&s_bulkReadersCond, &s_bulkReadersMutex);
+  }
+  /* another detach of the same entry may have finished first */
+  if (entry->obj == obj) {
+    reader = entry->reader;
+    memset(entry, 0, sizeof(T_UsbBulkReaderEntry));
+  }
+  return reader;
+}
+
+static void OsdkLinux_USBBulkRemoveReader(const T_HalObj *obj) {
+  T_UsbBulkReader *reader = NULL;
+
+  pthread_mutex_lock(&s_bulkReadersMutex);
+  T_UsbBulkReaderEntry *entry = OsdkLinux_USBBulkFindReader(obj);
+  if (entry) {
+    reader = OsdkLinux_USBBulkDetachReader(entry);
+  }
+  pthread_mutex_unlock(&s_bulkReadersMutex);
+
+  UsbBulkReader_Destroy(reader);
+}
+
+/* The first read sets the transfer size, as the synchronous transfer it
+ * replaces would have used the same length. Every reader handed out must be
+ * given back with OsdkLinux_USBBulkPutReader.
+ */
+static T_UsbBulkReaderEntry *OsdkLinux_USBBulkGetReader(const T_HalObj *obj,
+                                                       uint32_t transferSize) {
+  T_UsbBulkReader *stale = NULL;
+
+  pthread_mutex_lock(&s_bulkReadersMutex);
+  T_UsbBulkReaderEntry *entry = OsdkLinux_USBBulkFindReader(obj);
+  if (entry && entry->closing) {
+    pthread_mutex_unlock(&s_bulkReadersMutex);
+    return NULL;
+  }
+  if (entry && entry->handle != obj->bulkObject.handle) {
+    /* reopened by hotplug */
+    stale = OsdkLinux_USBBulkDetachReader(entry);
+    entry = NULL;
+  }
+  if (!entry) {
+    entry = OsdkLinux_USBBulkFindReader(NULL);
+  }
+  if (entry) {
+    if (!entry->reader) {
+      entry->obj = obj;
+      entry->handle = obj->bulkObject.handle;
+      entry->reader = UsbBulkReader_Create(
+          (struct libusb_device_handle *)obj->bulkObject.handle,
+          obj->bulkObject.epIn, s_bulkReadQueueDepth, transferSize);
+    }
+    if (entry->reader) {
+      entry->users++;
+    } else {
+      entry = NULL;
+    }
+  }
+  pthread_mutex_unlock(&s_bulkReadersMutex);
+
+  UsbBulkReader_Destroy(stale);
+  return entry;
+}
+
+static void OsdkLinux_USBBulkPutReader(T_UsbBulkReaderEntry *entry) {
+  pthread_mutex_lock(&s_bulkReadersMutex);
+  if (--entry->users == 0) {
+    pthread_cond_broadcast(&s_bulkReadersCond);
+  }
+  pthread_mutex_unlock(&s_bulkReadersMutex);
+}
+
 /**
  * @brief USBBulk interface init function.
  * @param pid: USBBulk product id.
@@ -218,6 +337,7 @@ E_OsdkStat OsdkLinux_USBBulkInit(uint16_t pid, uint16_t vid, uint16_t num, uint1
     return OSDK_STAT_ERR;
   }
 
+  OsdkLinux_USBBulkRemoveReader(obj);
   obj->bulkObject.handle = (void *)handle;
   obj->bulkObject.epIn = epIn;
   obj->bulkObject.epOut = epOut;
@@ -252,27 +372,30 @@ E_OsdkStat OsdkLinux_USBBulkSendData(const T_HalObj *obj, const uint8_t *pBuf,
 
 E_OsdkStat OsdkLinux_USBBulkReadData(const T_HalObj *obj, uint8_t *pBuf,
                                      uint32_t *bufLen) {
-  struct libusb_device_handle *handle = NULL;
+  T_UsbBulkReaderEntry *entry = NULL;
   int ret;
   
   if((obj == NULL) || (obj->bulkObject.handle == NULL)) {
     return OSDK_STAT_ERR; 
   }
 
-  handle = (struct libusb_device_handle *)obj->bulkObject.handle;
-  ret = libusb_bulk_transfer(handle, obj->bulkObject.epIn,
-                             pBuf, *bufLen, bufLen, (unsigned int)(-1));
-  if (ret != 0) {
-    if (-7 == ret)
+  entry = OsdkLinux_USBBulkGetReader(obj, *bufLen);
+  if (!entry) {
+    return OSDK_STAT_ERR;
+  }
+
+  ret = UsbBulkReader_Read(entry->reader, pBuf, *bufLen,
+                           USB_BULK_READ_TIMEOUT_MS);
+  OsdkLinux_USBBulkPutReader(entry);
+  if (ret <= 0) {
+    *bufLen = 0;
+    if (LIBUSB_ERROR_TIMEOUT == ret)
       return OSDK_STAT_ERR_TIMEOUT;
     else
       return OSDK_STAT_ERR;
   }
 
-  if(*bufLen == 0) {
-    return OSDK_STAT_ERR;
-  }
-
+  *bufLen = ret;
   return OSDK_STAT_OK;
 }
 
@@ -283,11 +406,37 @@ E_OsdkStat OsdkLinux_USBBulkClose(T_HalObj *obj) {
     return OSDK_STAT_ERR; 
   }
 
+  OsdkLinux_USBBulkRemoveReader(obj);
   handle = (struct libusb_device_handle *)obj->bulkObject.handle;
   libusb_close(handle);
   return OSDK_STAT_OK;
 }
 
+/**
+ * @brief Set how many bulk IN transfers each channel keeps in flight.
+ * Applies to channels that start reading afterwards.
+ */
+void OsdkLinux_USBBulkSetReadQueueDepth(int depth) {
+  s_bulkReadQueueDepth = (depth < 1) ? 1 : depth;
+}
+
+/**
+ * @brief Throughput and latency counters of a channel's bulk IN reads.
+ */
+E_OsdkStat OsdkLinux_USBBulkGetReadStats(const T_HalObj *obj,
+                                         T_UsbBulkReaderStats *stats) {
+  E_OsdkStat ret = OSDK_STAT_ERR;
+
+  pthread_mutex_lock(&s_bulkReadersMutex);
+  T_UsbBulkReaderEntry *entry = OsdkLinux_USBBulkFindReader(obj);
+  if (entry && entry->reader && stats) {
+    UsbBulkReader_GetStats(entry->reader, stats);
+    ret = OSDK_STAT_OK;
+  }
+  pthread_mutex_unlock(&s_bulkReadersMutex);
+  return ret;
+}
+
 #endif
 
 #ifdef OSDK_HOTPLUG
@@ -45,6 +45,7 @@
 
 #ifdef ADVANCED_SENSING
 #include <libusb-1.0/libusb.h>
+#include "linux_usb_bulk_reader.h"
 #endif
 
 #ifdef __cplusplus
@@ -70,6 +71,9 @@ E_OsdkStat OsdkLinux_USBBulkSendData(const T_HalObj *obj, const uint8_t *pBuf,
 E_OsdkStat OsdkLinux_USBBulkReadData(const T_HalObj *obj, uint8_t *pBuf,
                                      uint32_t *bufLen);
 E_OsdkStat OsdkLinux_USBBulkClose(T_HalObj *obj);
+void OsdkLinux_USBBulkSetReadQueueDepth(int depth);
+E_OsdkStat OsdkLinux_USBBulkGetReadStats(const T_HalObj *obj,
+                                         T_UsbBulkReaderStats *stats);
 #endif
 
 #ifdef __cplusplus
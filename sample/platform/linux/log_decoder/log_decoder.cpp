@@ -0,0 +1,323 @@
+/*! @file log_decoder/log_decoder.cpp
+ *  @version 4.0.0
+ *  @date Oct 2026
+ *
+ *  @brief
+ *  Renders a binary OSDK log, written after Log::enableBinaryLogging, as the
+ *  same text the logger prints to stdout.
+ *
+ *  Usage: djiosdk-log-decoder <binary log file>
+ *
+ *  @Copyright (c) 2026 DJI
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#include "dji_log_binary.hpp"
+
+#include <map>
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+using namespace DJI::OSDK;
+
+typedef std::map<uint32_t, std::string> StringTable;
+
+static const char*
+lookup(const StringTable& strings, uint32_t id)
+{
+  StringTable::const_iterator it = strings.find(id);
+  return (it == strings.end()) ? "?" : it->second.c_str();
+}
+
+// Copy literal text of a format string, "%%" stands for one '%'
+static void
+appendLiteral(std::string& out, const char* begin, const char* end)
+{
+  for (const char* p = begin; p < end; ++p)
+  {
+    out += *p;
+    if (*p == '%' && p + 1 < end && p[1] == '%')
+    {
+      ++p;
+    }
+  }
+}
+
+static bool
+readArg(const uint8_t*& args, const uint8_t* end, uint64_t& value)
+{
+  if (end - args < 8)
+  {
+    return false;
+  }
+  memcpy(&value, args, 8);
+  args += 8;
+  return true;
+}
+
+/*! Render one entry with its format string and recorded arguments. Every
+ *  conversion is passed to snprintf on its own with a length modifier that
+ *  matches the stored 64 bit value.
+ */
+static std::string
+render(const char* fmt, const uint8_t* args, const uint8_t* end)
+{
+  std::string           out;
+  const char*           pos     = fmt;
+  const char*           literal = fmt;
+  BinaryLogFormat::Spec spec;
+  char                  buf[512];
+
+  while (BinaryLogFormat::next(pos, spec))
+  {
+    appendLiteral(out, literal, spec.begin);
+    literal = spec.end;
+
+    // Flags, width and precision with every '*' replaced by its value
+    std::string conv;
+    bool        complete = true;
+    for (const char* p = spec.begin; p < spec.lengthPos; ++p)
+    {
+      uint64_t star;
+      if (*p != '*')
+      {
+        conv += *p;
+      }
+      else if (readArg(args, end, star))
+      {
+        snprintf(buf, sizeof(buf), "%d", (int)(int64_t)star);
+        conv += buf;
+      }
+      else
+      {
+        complete = false;
+      }
+    }
+
+    uint64_t value = 0;
+    if (spec.type == BinaryLogFormat::ARG_STRING)
+    {
+      uint16_t len;
+      if (!complete || end - args < 2)
+      {
+        out += "<?>";
+        continue;
+      }
+      memcpy(&len, args, 2);
+      args += 2;
+      if (end - args < len)
+      {
+        out += "<?>";
+        args = end;
+        continue;
+      }
+      std::string str((const char*)args, len);
+      args += len;
+      conv += 's';
+      snprintf(buf, sizeof(buf), conv.c_str(), str.c_str());
+      out += buf;
+      continue;
+    }
+
+    if (!complete || !readArg(args, end, value))
+    {
+      out += "<?>";
+      continue;
+    }
+
+    if (spec.type == BinaryLogFormat::ARG_DOUBLE)
+    {
+      double d;
+      memcpy(&d, &value, 8);
+      conv += spec.conversion;
+      snprintf(buf, sizeof(buf), conv.c_str(), d);
+    }
+    else if (spec.conversion == 'c')
+    {
+      conv += 'c';
+      snprintf(buf, sizeof(buf), conv.c_str(), (int)value);
+    }
+    else if (spec.conversion == 'p')
+    {
+      conv += 'p';
+      snprintf(buf, sizeof(buf), conv.c_str(), (void*)(uintptr_t)value);
+    }
+    else
+    {
+      // Narrow to the width the caller passed, then print as long long
+      int64_t  s = (int64_t)value;
+      uint64_t u = value;
+      switch (spec.length)
+      {
+        case BinaryLogFormat::LEN_CHAR:
+          s = (signed char)s;
+          u = (unsigned char)u;
+          break;
+        case BinaryLogFormat::LEN_SHORT:
+          s = (short)s;
+          u = (unsigned short)u;
+          break;
+        case BinaryLogFormat::LEN_DEFAULT:
+          s = (int)s;
+          u = (unsigned int)u;
+          break;
+        default:
+          break;
+      }
+      conv += "ll";
+      conv += spec.conversion;
+      if (spec.type == BinaryLogFormat::ARG_INT)
+      {
+        snprintf(buf, sizeof(buf), conv.c_str(), (long long)s);
+      }
+      else
+      {
+        snprintf(buf, sizeof(buf), conv.c_str(), (unsigned long long)u);
+      }
+    }
+    out += buf;
+  }
+  appendLiteral(out, literal, literal + strlen(literal));
+  return out;
+}
+
+int
+main(int argc, char** argv)
+{
+  if (argc != 2)
+  {
+    fprintf(stderr, "Usage: %s <binary log file>\n", argv[0]);
+    return 1;
+  }
+
+  FILE* file = fopen(argv[1], "rb");
+  if (!file)
+  {
+    perror(argv[1]);
+    return 1;
+  }
+  std::vector<uint8_t> data;
+  uint8_t              chunk[65536];
+  size_t               got;
+  while ((got = fread(chunk, 1, sizeof(chunk), file)) > 0)
+  {
+    data.insert(data.end(), chunk, chunk + got);
+  }
+  fclose(file);
+
+  BinaryLogFileHeader header;
+  if (data.size() < sizeof(header))
+  {
+    fprintf(stderr, "%s: file too short\n", argv[1]);
+    return 1;
+  }
+  memcpy(&header, data.data(), sizeof(header));
+  if (memcmp(header.magic, BINARY_LOG_MAGIC, sizeof(header.magic)) != 0 ||
+      header.version != BINARY_LOG_VERSION)
+  {
+    fprintf(stderr, "%s: not a binary OSDK log of version %u\n", argv[1],
+            BINARY_LOG_VERSION);
+    return 1;
+  }
+
+  const uint8_t* records = data.data() + header.headerSize;
+  size_t         size    = data.size() - header.headerSize;
+  if (header.usedBytes && header.usedBytes < size)
+  {
+    size = header.usedBytes;
+  }
+
+  // Entries may come before the definition of their strings, so collect all
+  // strings first
+  StringTable strings;
+  size_t      end = 0;
+  while (end + sizeof(BinaryLogRecordHeader) <= size)
+  {
+    BinaryLogRecordHeader record;
+    memcpy(&record, records + end, sizeof(record));
+    if (record.size < sizeof(record) || end + record.size > size)
+    {
+      // Never committed, the process stopped while writing it
+      break;
+    }
+    if (record.type == BINARY_LOG_STRING)
+    {
+      const char* str = (const char*)(records + end + sizeof(record));
+      strings[record.id] =
+        std::string(str, strnlen(str, record.size - sizeof(record)));
+    }
+    end += (record.size + 7) & ~(size_t)7;
+  }
+
+  unsigned long entries = 0;
+  for (size_t offset = 0; offset < end;)
+  {
+    BinaryLogRecordHeader record;
+    memcpy(&record, records + offset, sizeof(record));
+    const uint8_t* payload = records + offset + sizeof(record);
+    const uint8_t* recEnd  = records + offset + record.size;
+    offset += (record.size + 7) & ~(size_t)7;
+
+    BinaryLogEntry entry;
+    if (record.type != BINARY_LOG_ENTRY ||
+        recEnd - payload < (ptrdiff_t)sizeof(entry))
+    {
+      continue;
+    }
+    memcpy(&entry, payload, sizeof(entry));
+    payload += sizeof(entry);
+    if (entry.argsSize < (size_t)(recEnd - payload))
+    {
+      recEnd = payload + entry.argsSize;
+    }
+
+    // Same header as Log::title prints
+    if (record.level && entry.funcId != BINARY_LOG_NO_STRING)
+    {
+      uint32_t timeMs = (uint32_t)(entry.timeUs / 1000);
+      printf("[%d.%03d]%s/%d @ %s, L%d: ", timeMs / 1000, timeMs % 1000,
+             lookup(strings, entry.prefixId), record.level,
+             lookup(strings, entry.funcId), entry.line);
+    }
+    else if (record.level)
+    {
+      printf("%s/%d", lookup(strings, entry.prefixId), record.level);
+    }
+
+    StringTable::const_iterator fmt = strings.find(record.id);
+    if (fmt == strings.end())
+    {
+      printf("<unknown format %u>\n", record.id);
+    }
+    else
+    {
+      printf("%s\n", render(fmt->second.c_str(), payload, recEnd).c_str());
+    }
+    ++entries;
+  }
+
+  fprintf(stderr, "%lu entries, %lu dropped%s\n", entries,
+          (unsigned long)header.dropped,
+          header.usedBytes ? "" : ", file was not closed cleanly");
+  return 0;
+}